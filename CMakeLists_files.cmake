@@ -25,7 +25,27 @@
 
 # originally generated with the command:
 # find opm -name '*.c*' -printf '\t%p\n' | sort
-#list (APPEND MAIN_SOURCE_FILES)
+#
+# without the explicit instantiations, opm-material is header-only
+if (OPM_MATERIAL_EXPLICIT_INSTANTIATION)
+  list (APPEND MAIN_SOURCE_FILES
+	opm/material/components/CO2Tables.cpp
+	opm/material/densead/Evaluation.cpp
+	opm/material/fluidsystems/BlackOilFluidSystem.cpp
+	opm/material/fluidsystems/blackoilpvt/GasPvtMultiplexer.cpp
+	opm/material/fluidsystems/blackoilpvt/OilPvtMultiplexer.cpp
+	opm/material/fluidsystems/blackoilpvt/SolventPvt.cpp
+	opm/material/fluidsystems/blackoilpvt/WaterPvtMultiplexer.cpp
+	)
+  # the material law manager can only be used with the ECL input support of opm-common
+  if (HAVE_ECL_INPUT)
+    list (APPEND MAIN_SOURCE_FILES
+	opm/material/fluidmatrixinteractions/EclMaterialLawManager.cpp
+	)
+  else()
+    message(STATUS "opm-common lacks ECL input support: EclMaterialLawManager is not explicitly instantiated")
+  endif()
+endif()
 
 # originally generated with the command:
 # find tests -name '*.cpp' -a ! -wholename '*/not-unit/*' -printf '\t%p\n' | sort
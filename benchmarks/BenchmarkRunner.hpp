@@ -0,0 +1,236 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BenchmarkRunner
+ */
+#ifndef OPM_BENCHMARK_RUNNER_HPP
+#define OPM_BENCHMARK_RUNNER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Prevent the compiler from optimizing away the computation of a value.
+ */
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/*!
+ * \brief Returns a vector of uniformly distributed pseudo-random numbers.
+ *
+ * The seed is fixed so that all runs of a benchmark see the same input.
+ */
+template <class Scalar>
+std::vector<Scalar> benchmarkSamples(std::size_t n, Scalar minValue, Scalar maxValue, unsigned seed = 42)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<Scalar> dist(minValue, maxValue);
+    std::vector<Scalar> result(n);
+    for (auto& x : result)
+        x = dist(rng);
+    return result;
+}
+
+/*!
+ * \brief A minimal driver for microbenchmarks.
+ *
+ * Each benchmark is a callable which executes the kernel once. The number of
+ * iterations is calibrated such that every repetition takes roughly the requested
+ * minimum time, the results are reported as nanoseconds per call in CSV or JSON
+ * format. The following command line arguments are recognized:
+ *
+ * - --format=csv|json: the output format (default: csv)
+ * - --output=FILE: write the results to a file instead of the standard output
+ * - --filter=STRING: only run the benchmarks whose name contains STRING
+ * - --min-time=SECONDS: the minimum run time of each repetition (default: 0.1)
+ * - --repetitions=N: the number of repetitions of each benchmark (default: 5)
+ */
+class BenchmarkRunner
+{
+public:
+    struct Result
+    {
+        std::string name;
+        std::size_t iterations;
+        double minNs;
+        double medianNs;
+        double meanNs;
+    };
+
+    BenchmarkRunner(int argc, char** argv)
+        : format_("csv")
+        , minTime_(0.1)
+        , numRepetitions_(5)
+    {
+        suiteName_ = argc > 0 ? baseName_(argv[0]) : "benchmark";
+        for (int i = 1; i < argc; ++i) {
+            std::string arg(argv[i]);
+            if (hasPrefix_(arg, "--format="))
+                format_ = arg.substr(9);
+            else if (hasPrefix_(arg, "--output="))
+                outputFile_ = arg.substr(9);
+            else if (hasPrefix_(arg, "--filter="))
+                filter_ = arg.substr(9);
+            else if (hasPrefix_(arg, "--min-time="))
+                minTime_ = std::atof(arg.substr(11).c_str());
+            else if (hasPrefix_(arg, "--repetitions="))
+                numRepetitions_ = std::max(1, std::atoi(arg.substr(14).c_str()));
+            else
+                throw std::invalid_argument("Unknown argument '"+arg+"'");
+        }
+
+        if (format_ != "csv" && format_ != "json")
+            throw std::invalid_argument("Unknown output format '"+format_+"'");
+    }
+
+    /*!
+     * \brief Run a benchmark and record its result.
+     */
+    template <class Kernel>
+    void run(const std::string& name, Kernel&& kernel)
+    {
+        if (!filter_.empty() && name.find(filter_) == std::string::npos)
+            return;
+
+        // calibrate the number of iterations
+        std::size_t n = 1;
+        while (true) {
+            double t = time_(kernel, n);
+            if (t >= minTime_ || n >= (std::size_t(1) << 40))
+                break;
+            // aim a bit above the minimum time to avoid another round
+            double factor = t > 0.0 ? 1.2*minTime_/t : 10.0;
+            n = static_cast<std::size_t>(n*std::min(10.0, std::max(2.0, factor)));
+        }
+
+        std::vector<double> nsPerCall(numRepetitions_);
+        for (auto& x : nsPerCall)
+            x = time_(kernel, n)/n*1e9;
+        std::sort(nsPerCall.begin(), nsPerCall.end());
+
+        Result r;
+        r.name = name;
+        r.iterations = n;
+        r.minNs = nsPerCall.front();
+        r.medianNs = nsPerCall[nsPerCall.size()/2];
+        r.meanNs = 0.0;
+        for (double x : nsPerCall)
+            r.meanNs += x/nsPerCall.size();
+        results_.push_back(r);
+
+        std::cerr << name << ": " << r.medianNs << " ns\n";
+    }
+
+    /*!
+     * \brief Write the results of all benchmarks which have been run so far.
+     */
+    void report() const
+    {
+        if (outputFile_.empty()) {
+            report(std::cout);
+            return;
+        }
+
+        std::ofstream os(outputFile_);
+        if (!os)
+            throw std::runtime_error("Could not open output file '"+outputFile_+"'");
+        report(os);
+    }
+
+    void report(std::ostream& os) const
+    {
+        os.precision(6);
+        if (format_ == "csv") {
+            os << "suite,name,iterations,min_ns,median_ns,mean_ns\n";
+            for (const auto& r : results_)
+                os << suiteName_ << "," << r.name << "," << r.iterations << ","
+                   << r.minNs << "," << r.medianNs << "," << r.meanNs << "\n";
+            return;
+        }
+
+        os << "{\n  \"suite\": \"" << suiteName_ << "\",\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            os << (i == 0 ? "\n" : ",\n")
+               << "    {\"name\": \"" << r.name << "\""
+               << ", \"iterations\": " << r.iterations
+               << ", \"min_ns\": " << r.minNs
+               << ", \"median_ns\": " << r.medianNs
+               << ", \"mean_ns\": " << r.meanNs << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    const std::vector<Result>& results() const
+    { return results_; }
+
+private:
+    template <class Kernel>
+    static double time_(Kernel& kernel, std::size_t n)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; ++i)
+            kernel();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    static bool hasPrefix_(const std::string& s, const std::string& prefix)
+    { return s.compare(0, prefix.size(), prefix) == 0; }
+
+    static std::string baseName_(const std::string& path)
+    {
+        auto pos = path.find_last_of('/');
+        return pos == std::string::npos ? path : path.substr(pos + 1);
+    }
+
+    std::string suiteName_;
+    std::string format_;
+    std::string outputFile_;
+    std::string filter_;
+    double minTime_;
+    int numRepetitions_;
+    std::vector<Result> results_;
+};
+
+} // namespace Opm
+
+#endif
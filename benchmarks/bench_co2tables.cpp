@@ -0,0 +1,197 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Accuracy and performance of the bi-linear and bi-cubic interpolation of the
+ *        CO2 tables.
+ *
+ * The tables of co2tables.inc are resampled to coarser grids. The accuracy of the
+ * coarse tables is determined at the sampling points of the original tables, which
+ * are exact, and written to the standard error output. The time to evaluate the
+ * density is measured for each table as well as for the CO2 component.
+ */
+#include "config.h"
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+#include <opm/material/components/CO2.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+namespace Opm {
+namespace BenchCO2 {
+#include <opm/material/components/co2tables.inc>
+}}
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+typedef Opm::UniformTabulated2DFunction<double> Table;
+typedef Table::InterpolationType InterpolationType;
+
+static const std::size_t numSamples = 1024;
+
+// the CO2 tables resampled to a quarter of the sampling points in each direction
+struct CoarseCO2Tables
+{
+    static const Table tabulatedEnthalpy;
+    static const Table tabulatedDensity;
+    static constexpr double brineSalinity = Opm::BenchCO2::CO2Tables::brineSalinity;
+};
+
+const Table CoarseCO2Tables::tabulatedEnthalpy =
+    Opm::BenchCO2::CO2Tables::tabulatedEnthalpy.resampled(50, 125);
+const Table CoarseCO2Tables::tabulatedDensity =
+    Opm::BenchCO2::CO2Tables::tabulatedDensity.resampled(50, 125);
+
+static std::string tableName(const Table& table)
+{
+    return std::string(table.interpolationType() == InterpolationType::Bicubic ? "bicubic" : "bilinear")
+        + "/" + std::to_string(table.numX()) + "x" + std::to_string(table.numY());
+}
+
+static std::size_t memoryUsage(const Table& table)
+{
+    std::size_t valuesPerPoint = table.interpolationType() == InterpolationType::Bicubic ? 4 : 1;
+    return table.numX()*table.numY()*valuesPerPoint*sizeof(double);
+}
+
+// compare a table to the sampling points of the reference table which it has been
+// resampled from
+static void reportAccuracy(const std::string& quantity, const Table& reference, const Table& table)
+{
+    double maxErr = 0.0;
+    double sumErr2 = 0.0;
+    std::vector<double> errors;
+    for (unsigned i = 0; i < reference.numX(); ++i) {
+        double T = std::min(table.xMax(), std::max(table.xMin(), reference.iToX(i)));
+        for (unsigned j = 0; j < reference.numY(); ++j) {
+            double p = std::min(table.yMax(), std::max(table.yMin(), reference.jToY(j)));
+            double refValue = reference.getSamplePoint(i, j);
+            double err = std::abs(table.eval(T, p) - refValue)/std::max(1.0, std::abs(refValue));
+            maxErr = std::max(maxErr, err);
+            sumErr2 += err*err;
+            errors.push_back(err);
+        }
+    }
+    std::sort(errors.begin(), errors.end());
+
+    std::cerr << "accuracy of CO2 " << quantity << " " << tableName(table)
+              << " (" << memoryUsage(table)/1024 << " KiB)"
+              << ": rms relative error " << std::sqrt(sumErr2/errors.size())
+              << ", 99th percentile " << errors[errors.size()*99/100]
+              << ", max " << maxErr << "\n";
+}
+
+template <class Evaluation>
+void benchTable(Opm::BenchmarkRunner& runner,
+                const std::string& evalName,
+                const Table& table,
+                const std::vector<Evaluation>& T,
+                const std::vector<Evaluation>& p)
+{
+    std::size_t i = 0;
+    runner.run("CO2Table/density/"+tableName(table)+"/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(table.eval(T[i], p[i]));
+    });
+}
+
+template <class Evaluation>
+void benchCO2(Opm::BenchmarkRunner& runner, const std::string& evalName, const std::vector<Table>& tables)
+{
+    typedef Opm::CO2<double, Opm::BenchCO2::CO2Tables> CO2;
+    typedef Opm::CO2<double, CoarseCO2Tables> CoarseCO2;
+
+    // reservoir conditions including the vicinity of the critical point
+    const auto TValues = Opm::benchmarkSamples<double>(numSamples, 290.0, 390.0, /*seed=*/1);
+    const auto pValues = Opm::benchmarkSamples<double>(numSamples, 1e6, 5e7, /*seed=*/2);
+    std::vector<Evaluation> T(numSamples);
+    std::vector<Evaluation> p(numSamples);
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        T[i] = TValues[i];
+        p[i] = pValues[i];
+    }
+
+    for (const auto& table : tables)
+        benchTable(runner, evalName, table, T, p);
+
+    std::size_t i = 0;
+    runner.run("CO2/gasDensity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CO2::gasDensity(T[i], p[i]));
+    });
+    runner.run("CO2/gasDensity/coarse/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CoarseCO2::gasDensity(T[i], p[i]));
+    });
+    runner.run("CO2/gasViscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CO2::gasViscosity(T[i], p[i]));
+    });
+    runner.run("CO2/gasViscosityCorrelation/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CO2::gasViscosityCorrelation(T[i], p[i]));
+    });
+    runner.run("CO2/gasHeatCapacity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CO2::gasHeatCapacity(T[i], p[i]));
+    });
+    runner.run("CO2/gasHeatCapacityFromEnthalpy/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(CO2::gasHeatCapacityFromEnthalpy(T[i], p[i]));
+    });
+}
+
+int main(int argc, char** argv)
+{
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    const Table& density = Opm::BenchCO2::CO2Tables::tabulatedDensity;
+    const Table& enthalpy = Opm::BenchCO2::CO2Tables::tabulatedEnthalpy;
+
+    std::vector<Table> densityTables;
+    densityTables.push_back(density);
+    for (unsigned factor : {2, 4, 8}) {
+        unsigned m = density.numX()/factor;
+        unsigned n = density.numY()/factor;
+        for (auto type : {InterpolationType::Bilinear, InterpolationType::Bicubic}) {
+            densityTables.push_back(density.resampled(m, n, type));
+            reportAccuracy("density", density, densityTables.back());
+            reportAccuracy("enthalpy", enthalpy, enthalpy.resampled(m, n, type));
+        }
+    }
+
+    typedef Opm::DenseAd::Evaluation<double, 3> Eval3;
+    benchCO2<double>(runner, "double", densityTables);
+    benchCO2<Eval3>(runner, "Evaluation3", densityTables);
+
+    runner.report();
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the IAPWS water component.
+ */
+#include "config.h"
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <string>
+#include <vector>
+
+static const std::size_t numSamples = 1024;
+
+template <class Evaluation>
+void benchH2O(Opm::BenchmarkRunner& runner, const std::string& evalName)
+{
+    typedef Opm::H2O<double> H2O;
+
+    // liquid conditions: 280 K to 360 K, 1 to 100 bar
+    const auto TValues = Opm::benchmarkSamples<double>(numSamples, 280.0, 360.0, /*seed=*/1);
+    const auto pValues = Opm::benchmarkSamples<double>(numSamples, 1e5, 1e7, /*seed=*/2);
+    std::vector<Evaluation> T(numSamples);
+    std::vector<Evaluation> p(numSamples);
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        T[i] = TValues[i];
+        p[i] = pValues[i];
+    }
+    std::size_t i = 0;
+
+    runner.run("H2O/vaporPressure/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(H2O::vaporPressure(T[i]));
+    });
+    runner.run("H2O/liquidDensity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(H2O::liquidDensity(T[i], p[i]));
+    });
+    runner.run("H2O/liquidEnthalpy/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(H2O::liquidEnthalpy(T[i], p[i]));
+    });
+    runner.run("H2O/liquidViscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(H2O::liquidViscosity(T[i], p[i]));
+    });
+}
+
+int main(int argc, char** argv)
+{
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    typedef Opm::DenseAd::Evaluation<double, 3> Eval3;
+    benchH2O<double>(runner, "double");
+    benchH2O<Eval3>(runner, "Evaluation3");
+
+    runner.report();
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the arithmetic and the mathematical functions of the
+ *        forward automatic differentiation code.
+ */
+#include "config.h"
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/DynamicEvaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/FastMath.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+static const std::size_t numSamples = 1024;
+
+// create a set of evaluations with random values and derivatives. 'seed' specifies
+// the number of derivatives.
+template <class Eval>
+std::vector<Eval> createSamples(const Eval& seed, double minValue, double maxValue)
+{
+    const auto values = Opm::benchmarkSamples<double>(numSamples, minValue, maxValue);
+    const auto derivs = Opm::benchmarkSamples<double>(numSamples*seed.size(), -1.0, 1.0, /*seed=*/7);
+
+    std::vector<Eval> result(numSamples, seed);
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        result[i].setValue(values[i]);
+        for (int varIdx = 0; varIdx < seed.size(); ++varIdx)
+            result[i].setDerivative(varIdx, derivs[i*seed.size() + varIdx]);
+    }
+    return result;
+}
+
+template <class Eval>
+void benchEvaluation(Opm::BenchmarkRunner& runner, const std::string& prefix, const Eval& seed)
+{
+    const auto x = createSamples(seed, 0.5, 2.0);
+    const auto y = createSamples(seed, 0.5, 2.0);
+    std::size_t i = 0;
+
+    runner.run(prefix+"/add", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Eval(x[i] + y[i]));
+    });
+    runner.run(prefix+"/mul", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Eval(x[i]*y[i]));
+    });
+    runner.run(prefix+"/div", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Eval(x[i]/y[i]));
+    });
+    runner.run(prefix+"/axpy", [&]() {
+        i = (i + 1) % numSamples;
+        Eval z = x[i];
+        z += 2.0*y[i];
+        Opm::doNotOptimize(z);
+    });
+    runner.run(prefix+"/exp", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::exp(x[i]));
+    });
+    runner.run(prefix+"/log", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::log(x[i]));
+    });
+    runner.run(prefix+"/sqrt", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::sqrt(x[i]));
+    });
+    runner.run(prefix+"/pow", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::pow(x[i], y[i]));
+    });
+    runner.run(prefix+"/max", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::max(x[i], y[i]));
+    });
+}
+
+template <int numVars>
+void benchStaticEvaluations(Opm::BenchmarkRunner& runner)
+{
+    typedef Opm::DenseAd::Evaluation<double, numVars> Eval;
+    benchEvaluation(runner, "static/N="+std::to_string(numVars), Eval(0.0));
+
+    benchStaticEvaluations<numVars + 1>(runner);
+}
+
+// the statically sized evaluations are specialized for up to 12 derivatives
+template <>
+void benchStaticEvaluations<13>(Opm::BenchmarkRunner&)
+{}
+
+// compare the functions of the standard library with their polynomial approximations.
+// the Evaluations use the latter if the benchmark is compiled with
+// -DOPM_DENSEAD_FAST_MATH=1.
+void benchScalarMath(Opm::BenchmarkRunner& runner)
+{
+    const auto x = Opm::benchmarkSamples<double>(numSamples, 0.5, 2.0);
+    std::size_t i = 0;
+
+    runner.run("scalar/exp/std", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(std::exp(x[i]));
+    });
+    runner.run("scalar/exp/fast", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::FastMath::exp(x[i]));
+    });
+    runner.run("scalar/log/std", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(std::log(x[i]));
+    });
+    runner.run("scalar/log/fast", [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(Opm::FastMath::log(x[i]));
+    });
+    for (double y : {0.8, 1.5, 3.0}) {
+        runner.run("scalar/pow^"+std::to_string(y).substr(0, 3)+"/std", [&]() {
+            i = (i + 1) % numSamples;
+            Opm::doNotOptimize(std::pow(x[i], y));
+        });
+        runner.run("scalar/pow^"+std::to_string(y).substr(0, 3)+"/fast", [&]() {
+            i = (i + 1) % numSamples;
+            Opm::doNotOptimize(Opm::FastMath::pow(x[i], y));
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    benchScalarMath(runner);
+    benchStaticEvaluations<1>(runner);
+
+    typedef Opm::DenseAd::Evaluation<double, Opm::DenseAd::DynamicSize> DynamicEval;
+    for (int numVars : {1, 3, 6, 12})
+        benchEvaluation(runner, "dynamic/N="+std::to_string(numVars), DynamicEval(numVars, 0.0));
+
+    runner.report();
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the PVT relations of the black-oil and the CO2-brine
+ *        fluid systems.
+ *
+ * The PVT tables are specified by decks which are embedded into the benchmark.
+ */
+#include "config.h"
+
+#if !HAVE_ECL_INPUT
+#error "The PVT benchmark requires eclipse input support in opm-common"
+#endif
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/fluidsystems/blackoilpvt/LiveOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/WetGasPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/BrineCo2Pvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/Co2GasPvt.hpp>
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/Python/Python.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+static const char* blackOilDeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   10 10 3 /\n"
+    "\n"
+    "TABDIMS\n"
+    " * 1 /\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "DISGAS\n"
+    "VAPOIL\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   	300*1000 /\n"
+    "DY\n"
+    "	300*1000 /\n"
+    "DZ\n"
+    "	100*20 100*30 100*50 /\n"
+    "\n"
+    "TOPS\n"
+    "	100*1234 /\n"
+    "\n"
+    "PORO\n"
+    "  300*0.15 /\n"
+    "PROPS\n"
+    "\n"
+    "DENSITY\n"
+    "      859.5  1033.0    0.854  /\n"
+    "\n"
+    "PVTW\n"
+    " 	1.0  1.1 1e-6 1.1 2.0e-9 /\n"
+    "\n"
+    "PVTO\n"
+    "-- RS      PRESSURE    BO       VISCOSITY\n"
+    "   20.0     40.0      1.10      1.20\n"
+    "           100.0      1.09      1.25\n"
+    "           200.0      1.08      1.30 /\n"
+    "   60.0    100.0      1.20      1.00\n"
+    "           200.0      1.18      1.05\n"
+    "           300.0      1.17      1.10 /\n"
+    "  120.0    200.0      1.35      0.80\n"
+    "           300.0      1.33      0.85\n"
+    "           400.0      1.32      0.90 /\n"
+    "/\n"
+    "\n"
+    "PVTG\n"
+    "-- PRESSURE       RV        BG     VISCOSITY\n"
+    "    40.0        2.0e-5    0.0300    0.0130\n"
+    "                0.0       0.0290    0.0129 /\n"
+    "   100.0        5.0e-5    0.0120    0.0150\n"
+    "                0.0       0.0118    0.0148 /\n"
+    "   200.0        1.0e-4    0.0060    0.0200\n"
+    "                0.0       0.0059    0.0198 /\n"
+    "/\n"
+    "\n";
+
+static const char* co2DeckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   10 10 3 /\n"
+    "\n"
+    "TABDIMS\n"
+    " * 1 /\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "CO2STOR\n"
+    "\n"
+    "DISGAS\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   	300*1000 /\n"
+    "DY\n"
+    "	300*1000 /\n"
+    "DZ\n"
+    "	100*20 100*30 100*50 /\n"
+    "\n"
+    "TOPS\n"
+    "	100*1234 /\n"
+    "\n"
+    "PORO\n"
+    "  300*0.15 /\n"
+    "PROPS\n"
+    "\n";
+
+static const std::size_t numSamples = 1024;
+
+template <class Evaluation>
+std::vector<Evaluation> createArguments(double minValue, double maxValue, unsigned seed, unsigned varIdx)
+{
+    const auto values = Opm::benchmarkSamples<double>(numSamples, minValue, maxValue, seed);
+    std::vector<Evaluation> result(numSamples);
+    for (std::size_t i = 0; i < numSamples; ++i)
+        result[i] = Evaluation::createVariable(values[i], varIdx);
+    return result;
+}
+
+template <>
+std::vector<double> createArguments<double>(double minValue, double maxValue, unsigned seed, unsigned)
+{ return Opm::benchmarkSamples<double>(numSamples, minValue, maxValue, seed); }
+
+template <class Evaluation>
+void benchBlackOilPvt(Opm::BenchmarkRunner& runner,
+                      const std::string& evalName,
+                      const Opm::LiveOilPvt<double>& oilPvt,
+                      const Opm::WetGasPvt<double>& gasPvt)
+{
+    const auto T = createArguments<Evaluation>(273.15 + 70.0, 273.15 + 90.0, /*seed=*/1, /*varIdx=*/0);
+    const auto p = createArguments<Evaluation>(50e5, 350e5, /*seed=*/2, /*varIdx=*/0);
+    const auto Rs = createArguments<Evaluation>(20.0, 120.0, /*seed=*/3, /*varIdx=*/1);
+    const auto Rv = createArguments<Evaluation>(0.0, 1e-4, /*seed=*/4, /*varIdx=*/1);
+    std::size_t i = 0;
+
+    runner.run("LiveOilPvt/inverseFormationVolumeFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(oilPvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i], Rs[i]));
+    });
+    runner.run("LiveOilPvt/viscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(oilPvt.viscosity(/*regionIdx=*/0, T[i], p[i], Rs[i]));
+    });
+    runner.run("LiveOilPvt/saturatedGasDissolutionFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(oilPvt.saturatedGasDissolutionFactor(/*regionIdx=*/0, T[i], p[i]));
+    });
+    runner.run("LiveOilPvt/saturationPressure/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(oilPvt.saturationPressure(/*regionIdx=*/0, T[i], Rs[i]));
+    });
+
+    runner.run("WetGasPvt/inverseFormationVolumeFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(gasPvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i], Rv[i]));
+    });
+    runner.run("WetGasPvt/viscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(gasPvt.viscosity(/*regionIdx=*/0, T[i], p[i], Rv[i]));
+    });
+    runner.run("WetGasPvt/saturatedOilVaporizationFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(gasPvt.saturatedOilVaporizationFactor(/*regionIdx=*/0, T[i], p[i]));
+    });
+}
+
+template <class Evaluation>
+void benchCo2BrinePvt(Opm::BenchmarkRunner& runner,
+                      const std::string& evalName,
+                      const Opm::BrineCo2Pvt<double>& brinePvt,
+                      const Opm::Co2GasPvt<double>& co2Pvt)
+{
+    const auto T = createArguments<Evaluation>(273.15 + 30.0, 273.15 + 100.0, /*seed=*/1, /*varIdx=*/0);
+    const auto p = createArguments<Evaluation>(50e5, 350e5, /*seed=*/2, /*varIdx=*/1);
+    const auto Rs = createArguments<Evaluation>(0.0, 20.0, /*seed=*/3, /*varIdx=*/2);
+    std::size_t i = 0;
+
+    runner.run("BrineCo2Pvt/inverseFormationVolumeFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(brinePvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i], Rs[i]));
+    });
+    runner.run("BrineCo2Pvt/viscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(brinePvt.viscosity(/*regionIdx=*/0, T[i], p[i], Rs[i]));
+    });
+    runner.run("BrineCo2Pvt/saturatedGasDissolutionFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(brinePvt.saturatedGasDissolutionFactor(/*regionIdx=*/0, T[i], p[i]));
+    });
+
+    runner.run("Co2GasPvt/inverseFormationVolumeFactor/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(co2Pvt.saturatedInverseFormationVolumeFactor(/*regionIdx=*/0, T[i], p[i]));
+    });
+    runner.run("Co2GasPvt/viscosity/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(co2Pvt.saturatedViscosity(/*regionIdx=*/0, T[i], p[i]));
+    });
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    Opm::Parser parser;
+    auto python = std::make_shared<Opm::Python>();
+
+    {
+        auto deck = parser.parseString(blackOilDeckString);
+        Opm::EclipseState eclState(deck);
+        Opm::Schedule schedule(deck, eclState, python);
+
+        Opm::LiveOilPvt<double> oilPvt;
+        Opm::WetGasPvt<double> gasPvt;
+        oilPvt.initFromState(eclState, schedule);
+        gasPvt.initFromState(eclState, schedule);
+
+        benchBlackOilPvt<double>(runner, "double", oilPvt, gasPvt);
+        benchBlackOilPvt<Opm::DenseAd::Evaluation<double, 3> >(runner, "Evaluation3", oilPvt, gasPvt);
+    }
+
+    {
+        auto deck = parser.parseString(co2DeckString);
+        Opm::EclipseState eclState(deck);
+        Opm::Schedule schedule(deck, eclState, python);
+
+        Opm::BrineCo2Pvt<double> brinePvt;
+        Opm::Co2GasPvt<double> co2Pvt;
+        brinePvt.initFromState(eclState, schedule);
+        co2Pvt.initFromState(eclState, schedule);
+
+        benchCo2BrinePvt<double>(runner, "double", brinePvt, co2Pvt);
+        benchCo2BrinePvt<Opm::DenseAd::Evaluation<double, 3> >(runner, "Evaluation3", brinePvt, co2Pvt);
+    }
+
+    runner.report();
+
+    return 0;
+}
@@ -0,0 +1,254 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the saturation functions of the EclMaterialLawManager.
+ *
+ * The saturation functions are specified by a deck which is embedded into the
+ * benchmark.
+ */
+#include "config.h"
+
+#if !HAVE_ECL_INPUT
+#error "The benchmark for EclMaterialLawManager requires eclipse input support in opm-common"
+#endif
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
+#include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <string>
+#include <vector>
+
+// values of strings taken from the SPE1 test case1 of opm-data
+static const char* deckString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   10 10 3 /\n"
+    "\n"
+    "TABDIMS\n"
+    "/\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "DISGAS\n"
+    "\n"
+    "FIELD\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "       300*1000 /\n"
+    "DY\n"
+    "   300*1000 /\n"
+    "DZ\n"
+    "   100*20 100*30 100*50 /\n"
+    "\n"
+    "TOPS\n"
+    "   100*8325 /\n"
+    "\n"
+    "\n"
+    "PORO\n"
+    "  300*0.15 /\n"
+    "PROPS\n"
+    "\n"
+    "SWOF\n"
+    "0.12   0               1   0\n"
+    "0.18   4.64876033057851E-008   1   0\n"
+    "0.24   0.000000186     0.997   0\n"
+    "0.3    4.18388429752066E-007   0.98    0\n"
+    "0.36   7.43801652892562E-007   0.7 0\n"
+    "0.42   1.16219008264463E-006   0.35    0\n"
+    "0.48   1.67355371900826E-006   0.2 0\n"
+    "0.54   2.27789256198347E-006   0.09    0\n"
+    "0.6    2.97520661157025E-006   0.021   0\n"
+    "0.66   3.7654958677686E-006    0.01    0\n"
+    "0.72   4.64876033057851E-006   0.001   0\n"
+    "0.78   0.000005625     0.0001  0\n"
+    "0.84   6.69421487603306E-006   0   0\n"
+    "0.91   8.05914256198347E-006   0   0\n"
+    "1      0.984           0   0 /\n"
+    "\n"
+    "\n"
+    "SGOF\n"
+    "0  0   1   0\n"
+    "0.001  0   1   0\n"
+    "0.02   0   0.997   0\n"
+    "0.05   0.005   0.980   0\n"
+    "0.12   0.025   0.700   0\n"
+    "0.2    0.075   0.350   0\n"
+    "0.25   0.125   0.200   0\n"
+    "0.3    0.190   0.090   0\n"
+    "0.4    0.410   0.021   0\n"
+    "0.45   0.60    0.010   0\n"
+    "0.5    0.72    0.001   0\n"
+    "0.6    0.87    0.0001  0\n"
+    "0.7    0.94    0.000   0\n"
+    "0.85   0.98    0.000   0\n"
+    "0.88   0.984   0.000   0 /\n";
+
+enum { numPhases = 3 };
+enum { waterPhaseIdx = 0 };
+enum { oilPhaseIdx = 1 };
+enum { gasPhaseIdx = 2 };
+
+typedef Opm::ThreePhaseMaterialTraits<double,
+                                      /*wettingPhaseIdx=*/waterPhaseIdx,
+                                      /*nonWettingPhaseIdx=*/oilPhaseIdx,
+                                      /*gasPhaseIdx=*/gasPhaseIdx> MaterialTraits;
+typedef Opm::EclMaterialLawManager<MaterialTraits> MaterialLawManager;
+typedef MaterialLawManager::MaterialLaw MaterialLaw;
+
+template <class Evaluation>
+Evaluation createVariable(double value, unsigned varIdx)
+{ return Evaluation::createVariable(value, varIdx); }
+
+template <>
+double createVariable<double>(double value, unsigned)
+{ return value; }
+
+template <class Evaluation>
+using BenchFluidState = Opm::SimpleModularFluidState<Evaluation,
+                                                     /*numPhases=*/3,
+                                                     /*numComponents=*/3,
+                                                     void,
+                                                     /*storePressure=*/false,
+                                                     /*storeTemperature=*/false,
+                                                     /*storeComposition=*/false,
+                                                     /*storeFugacity=*/false,
+                                                     /*storeSaturation=*/true,
+                                                     /*storeDensity=*/false,
+                                                     /*storeViscosity=*/false,
+                                                     /*storeEnthalpy=*/false>;
+
+// random three-phase saturations
+template <class Evaluation>
+std::vector<BenchFluidState<Evaluation> > createFluidStates()
+{
+    const std::size_t numSamples = 1024;
+    const auto r1 = Opm::benchmarkSamples<double>(numSamples, 0.0, 1.0, /*seed=*/1);
+    const auto r2 = Opm::benchmarkSamples<double>(numSamples, 0.0, 1.0, /*seed=*/2);
+    std::vector<BenchFluidState<Evaluation> > fluidStates(numSamples);
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        double Sw = 0.12 + 0.88*r1[i];
+        double So = (1.0 - Sw)*r2[i];
+        const Evaluation SwEval = createVariable<Evaluation>(Sw, /*varIdx=*/0);
+        const Evaluation SgEval = createVariable<Evaluation>(1.0 - Sw - So, /*varIdx=*/1);
+        const Evaluation SoEval = 1.0 - SwEval - SgEval;
+        fluidStates[i].setSaturation(waterPhaseIdx, SwEval);
+        fluidStates[i].setSaturation(oilPhaseIdx, SoEval);
+        fluidStates[i].setSaturation(gasPhaseIdx, SgEval);
+    }
+    return fluidStates;
+}
+
+// benchmark a three-phase law; paramsFn maps an element index to its parameters
+template <class Law, class Evaluation, class ParamsFn>
+void benchLaw(Opm::BenchmarkRunner& runner,
+              const std::string& lawName,
+              const std::string& evalName,
+              const std::vector<BenchFluidState<Evaluation> >& fluidStates,
+              unsigned numElements,
+              ParamsFn paramsFn)
+{
+    const std::size_t numSamples = fluidStates.size();
+    std::size_t i = 0;
+    unsigned elemIdx = 0;
+
+    runner.run(lawName+"/relativePermeabilities/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        elemIdx = (elemIdx + 1) % numElements;
+        Evaluation kr[numPhases];
+        Law::relativePermeabilities(kr, paramsFn(elemIdx), fluidStates[i]);
+        Opm::doNotOptimize(kr);
+    });
+    runner.run(lawName+"/capillaryPressures/"+evalName, [&]() {
+        i = (i + 1) % numSamples;
+        elemIdx = (elemIdx + 1) % numElements;
+        Evaluation pc[numPhases];
+        Law::capillaryPressures(pc, paramsFn(elemIdx), fluidStates[i]);
+        Opm::doNotOptimize(pc);
+    });
+}
+
+template <class Evaluation>
+void benchMaterialLaw(Opm::BenchmarkRunner& runner,
+                      const std::string& evalName,
+                      const MaterialLawManager& materialLawManager,
+                      unsigned numElements)
+{
+    const auto fluidStates = createFluidStates<Evaluation>();
+
+    benchLaw<MaterialLaw>(runner, "EclMaterialLaw", evalName, fluidStates, numElements,
+                          [&](unsigned elemIdx) -> const auto&
+                          { return materialLawManager.materialLawParams(elemIdx); });
+
+    // the same deck with the three-phase law selected at compile time. the deck uses
+    // the default three-phase model without hysteresis and end-point scaling.
+    constexpr auto approach = Opm::EclMultiplexerApproach::EclDefaultApproach;
+    auto staticParams = [&](unsigned elemIdx) -> const auto&
+        { return materialLawManager.staticMaterialLawParams<approach>(elemIdx); };
+    if (materialLawManager.supportsStaticMaterialLaw<approach>())
+        benchLaw<MaterialLawManager::StaticMaterialLaw<approach> >(
+            runner, "EclStaticMaterialLaw", evalName, fluidStates, numElements, staticParams);
+    if (materialLawManager.supportsStaticMaterialLaw<approach, /*hyst=*/false, /*eps=*/false>())
+        benchLaw<MaterialLawManager::StaticMaterialLaw<approach, false, false> >(
+            runner, "EclStaticMaterialLawNoHystNoEps", evalName, fluidStates, numElements, staticParams);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    Opm::Parser parser;
+    const auto deck = parser.parseString(deckString);
+    const Opm::EclipseState eclState(deck);
+    const auto& eclGrid = eclState.getInputGrid();
+    unsigned n = eclGrid.getCartesianSize();
+
+    MaterialLawManager materialLawManager;
+    materialLawManager.initFromState(eclState);
+    materialLawManager.initParamsForElements(eclState, n);
+
+    benchMaterialLaw<double>(runner, "double", materialLawManager, n);
+    benchMaterialLaw<Opm::DenseAd::Evaluation<double, 3> >(runner, "Evaluation3", materialLawManager, n);
+
+    runner.report();
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the flash calculations.
+ *
+ * The reference fluid states are set up in the same way as in the correctness tests of
+ * the NCP and the immiscible flash solvers.
+ */
+#include "config.h"
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/constraintsolvers/ComputeFromReferencePhase.hpp>
+#include <opm/material/constraintsolvers/MiscibleMultiPhaseComposition.hpp>
+#include <opm/material/constraintsolvers/ImmiscibleFlash.hpp>
+#include <opm/material/constraintsolvers/NcpFlash.hpp>
+
+#include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/fluidstates/ImmiscibleFluidState.hpp>
+
+#include <opm/material/fluidsystems/H2ON2FluidSystem.hpp>
+
+#include <opm/material/fluidmatrixinteractions/RegularizedBrooksCorey.hpp>
+#include <opm/material/fluidmatrixinteractions/EffToAbsLaw.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+
+#include <dune/common/fvector.hh>
+
+typedef double Scalar;
+typedef Opm::H2ON2FluidSystem<Scalar> FluidSystem;
+
+enum { numPhases = FluidSystem::numPhases };
+enum { numComponents = FluidSystem::numComponents };
+enum { liquidPhaseIdx = FluidSystem::liquidPhaseIdx };
+enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+enum { H2OIdx = FluidSystem::H2OIdx };
+enum { N2Idx = FluidSystem::N2Idx };
+
+typedef Opm::TwoPhaseMaterialTraits<Scalar, liquidPhaseIdx, gasPhaseIdx> MaterialTraits;
+typedef Opm::RegularizedBrooksCorey<MaterialTraits> EffMaterialLaw;
+typedef Opm::EffToAbsLaw<EffMaterialLaw> MaterialLaw;
+typedef MaterialLaw::Params MaterialLawParams;
+
+typedef Dune::FieldVector<Scalar, numComponents> ComponentVector;
+typedef Dune::FieldVector<Scalar, numPhases> PhaseVector;
+
+template <class FluidState>
+ComponentVector totalMolarities(const FluidState& fs)
+{
+    ComponentVector globalMolarities(0.0);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            globalMolarities[compIdx] += fs.saturation(phaseIdx)*fs.molarity(phaseIdx, compIdx);
+    return globalMolarities;
+}
+
+void benchNcpFlash(Opm::BenchmarkRunner& runner, MaterialLawParams& matParams)
+{
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef Opm::NcpFlash<Scalar, FluidSystem> NcpFlash;
+    typedef Opm::MiscibleMultiPhaseComposition<Scalar, FluidSystem> MiscibleMultiPhaseComposition;
+    typedef Opm::ComputeFromReferencePhase<Scalar, FluidSystem> ComputeFromReferencePhase;
+
+    FluidSystem::ParameterCache<Scalar> paramCache;
+
+    // single-phase liquid
+    FluidState fsLiquid;
+    fsLiquid.setTemperature(273.15 + 25);
+    fsLiquid.setSaturation(liquidPhaseIdx, 1.0);
+    fsLiquid.setSaturation(gasPhaseIdx, 0.0);
+    fsLiquid.setPressure(liquidPhaseIdx, 2e5);
+    fsLiquid.setMoleFraction(liquidPhaseIdx, N2Idx, 0.0);
+    fsLiquid.setMoleFraction(liquidPhaseIdx, H2OIdx, 1.0);
+    PhaseVector pC;
+    MaterialLaw::capillaryPressures(pC, matParams, fsLiquid);
+    fsLiquid.setPressure(gasPhaseIdx, 2e5 + (pC[gasPhaseIdx] - pC[liquidPhaseIdx]));
+    ComputeFromReferencePhase::solve(fsLiquid, paramCache, liquidPhaseIdx,
+                                     /*setViscosity=*/false, /*setEnthalpy=*/false);
+
+    // two-phase
+    FluidState fsTwoPhase;
+    fsTwoPhase.setTemperature(273.15 + 25);
+    fsTwoPhase.setSaturation(liquidPhaseIdx, 0.5);
+    fsTwoPhase.setSaturation(gasPhaseIdx, 0.5);
+    fsTwoPhase.setPressure(liquidPhaseIdx, 1e6);
+    MaterialLaw::capillaryPressures(pC, matParams, fsTwoPhase);
+    fsTwoPhase.setPressure(gasPhaseIdx, 1e6 + (pC[gasPhaseIdx] - pC[liquidPhaseIdx]));
+    MiscibleMultiPhaseComposition::solve(fsTwoPhase, paramCache,
+                                         /*setViscosity=*/false, /*setEnthalpy=*/false);
+
+    const ComponentVector liquidMolarities = totalMolarities(fsLiquid);
+    const ComponentVector twoPhaseMolarities = totalMolarities(fsTwoPhase);
+
+    runner.run("NcpFlash/liquid/cold", [&]() {
+        FluidState fsFlash;
+        fsFlash.setTemperature(fsLiquid.temperature(/*phaseIdx=*/0));
+        NcpFlash::guessInitial(fsFlash, liquidMolarities);
+        NcpFlash::solve<MaterialLaw>(fsFlash, matParams, paramCache, liquidMolarities);
+        Opm::doNotOptimize(fsFlash);
+    });
+    runner.run("NcpFlash/twoPhase/cold", [&]() {
+        FluidState fsFlash;
+        fsFlash.setTemperature(fsTwoPhase.temperature(/*phaseIdx=*/0));
+        NcpFlash::guessInitial(fsFlash, twoPhaseMolarities);
+        NcpFlash::solve<MaterialLaw>(fsFlash, matParams, paramCache, twoPhaseMolarities);
+        Opm::doNotOptimize(fsFlash);
+    });
+    runner.run("NcpFlash/twoPhase/warm", [&]() {
+        FluidState fsFlash;
+        fsFlash.setTemperature(fsTwoPhase.temperature(/*phaseIdx=*/0));
+        Opm::ConstraintSolverStatistics<Scalar> stats;
+        NcpFlash::solveFromInitial<MaterialLaw>(fsFlash, fsTwoPhase, matParams, paramCache,
+                                                twoPhaseMolarities, stats);
+        Opm::doNotOptimize(fsFlash);
+    });
+}
+
+void benchImmiscibleFlash(Opm::BenchmarkRunner& runner, MaterialLawParams& matParams)
+{
+    typedef Opm::ImmiscibleFluidState<Scalar, FluidSystem> FluidState;
+    typedef Opm::ImmiscibleFlash<Scalar, FluidSystem> ImmiscibleFlash;
+
+    FluidSystem::ParameterCache<Scalar> paramCache;
+
+    FluidState fsRef;
+    fsRef.setTemperature(273.15 + 25);
+    fsRef.setSaturation(liquidPhaseIdx, 0.5);
+    fsRef.setSaturation(gasPhaseIdx, 0.5);
+    fsRef.setPressure(liquidPhaseIdx, 1e6);
+    PhaseVector pC;
+    MaterialLaw::capillaryPressures(pC, matParams, fsRef);
+    fsRef.setPressure(gasPhaseIdx, 1e6 + (pC[gasPhaseIdx] - pC[liquidPhaseIdx]));
+    paramCache.updateAll(fsRef);
+    for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+        fsRef.setDensity(phaseIdx, FluidSystem::density(fsRef, paramCache, phaseIdx));
+
+    const ComponentVector globalMolarities = totalMolarities(fsRef);
+
+    runner.run("ImmiscibleFlash/twoPhase", [&]() {
+        FluidState fsFlash;
+        fsFlash.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+        ImmiscibleFlash::guessInitial(fsFlash, globalMolarities);
+        ImmiscibleFlash::solve<MaterialLaw>(fsFlash, matParams, paramCache, globalMolarities);
+        Opm::doNotOptimize(fsFlash);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    FluidSystem::init(/*Tmin=*/273.15 + 24, /*Tmax=*/273.15 + 26, /*nT=*/3,
+                      /*pmin=*/0.0, /*pmax=*/1.25*2e6, /*np=*/100);
+
+    MaterialLawParams matParams;
+    matParams.setResidualSaturation(MaterialLaw::wettingPhaseIdx, 0.0);
+    matParams.setResidualSaturation(MaterialLaw::nonWettingPhaseIdx, 0.0);
+    matParams.setEntryPressure(1e3);
+    matParams.setLambda(2.0);
+    matParams.finalize();
+
+    benchNcpFlash(runner, matParams);
+    benchImmiscibleFlash(runner, matParams);
+
+    runner.report();
+
+    return 0;
+}
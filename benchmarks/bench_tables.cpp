@@ -0,0 +1,133 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Microbenchmarks for the lookups in the tabulated functions.
+ */
+#include "config.h"
+
+#include "BenchmarkRunner.hpp"
+
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+#include <opm/material/common/Spline.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+static const std::size_t numSamples = 1024;
+
+template <class Evaluation>
+std::vector<Evaluation> createArguments(double minValue, double maxValue, unsigned seed)
+{
+    const auto values = Opm::benchmarkSamples<double>(numSamples, minValue, maxValue, seed);
+    std::vector<Evaluation> result(numSamples);
+    for (std::size_t i = 0; i < numSamples; ++i)
+        result[i] = Evaluation::createVariable(values[i], /*varIdx=*/0);
+    return result;
+}
+
+template <>
+std::vector<double> createArguments<double>(double minValue, double maxValue, unsigned seed)
+{ return Opm::benchmarkSamples<double>(numSamples, minValue, maxValue, seed); }
+
+template <class Evaluation>
+void benchTables(Opm::BenchmarkRunner& runner, const std::string& evalName, unsigned numTableSamples)
+{
+    const std::string suffix = "/n="+std::to_string(numTableSamples)+"/"+evalName;
+
+    // sampling points of a smooth function on [0, 10]
+    std::vector<double> xSamples(numTableSamples);
+    std::vector<double> ySamples(numTableSamples);
+    for (unsigned i = 0; i < numTableSamples; ++i) {
+        xSamples[i] = 10.0*i/(numTableSamples - 1);
+        ySamples[i] = std::exp(-0.1*xSamples[i])*std::sin(xSamples[i]);
+    }
+
+    const auto x = createArguments<Evaluation>(0.0, 10.0, /*seed=*/1);
+    const auto y = createArguments<Evaluation>(0.0, 10.0, /*seed=*/2);
+    const auto xOutside = createArguments<Evaluation>(-1.0, 11.0, /*seed=*/3);
+    std::size_t i = 0;
+
+    Opm::Tabulated1DFunction<double> tab1d(xSamples, ySamples, /*sortInputs=*/false);
+    runner.run("Tabulated1DFunction/eval"+suffix, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(tab1d.eval(x[i]));
+    });
+    runner.run("Tabulated1DFunction/evalExtrapolate"+suffix, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(tab1d.eval(xOutside[i], /*extrapolate=*/true));
+    });
+
+    Opm::Spline<double> spline(xSamples, ySamples, Opm::Spline<double>::Natural);
+    runner.run("Spline/eval"+suffix, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(spline.eval(x[i]));
+    });
+
+    // two dimensional tables with the same number of sampling points in each
+    // direction. for the UniformXTabulated2DFunction the y sampling points are
+    // different for each x sampling point, like for the saturated PVT tables.
+    Opm::UniformXTabulated2DFunction<double> uniformX2d;
+    for (unsigned xIdx = 0; xIdx < numTableSamples; ++xIdx) {
+        size_t k = uniformX2d.appendXPos(xSamples[xIdx]);
+        for (unsigned yIdx = 0; yIdx < numTableSamples; ++yIdx) {
+            double yPos = 10.0*yIdx/(numTableSamples - 1)*(1.0 + 0.01*xIdx);
+            uniformX2d.appendSamplePoint(k, yPos, std::sin(xSamples[xIdx])*std::cos(yPos));
+        }
+    }
+    runner.run("UniformXTabulated2DFunction/eval"+suffix, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(uniformX2d.eval(x[i], y[i], /*extrapolate=*/true));
+    });
+
+    Opm::UniformTabulated2DFunction<double> uniform2d(0.0, 10.0, numTableSamples,
+                                                      0.0, 10.0, numTableSamples);
+    for (unsigned xIdx = 0; xIdx < numTableSamples; ++xIdx)
+        for (unsigned yIdx = 0; yIdx < numTableSamples; ++yIdx)
+            uniform2d.setSamplePoint(xIdx, yIdx, std::sin(uniform2d.iToX(xIdx))*std::cos(uniform2d.jToY(yIdx)));
+    runner.run("UniformTabulated2DFunction/eval"+suffix, [&]() {
+        i = (i + 1) % numSamples;
+        Opm::doNotOptimize(uniform2d.eval(x[i], y[i]));
+    });
+}
+
+int main(int argc, char** argv)
+{
+    Opm::BenchmarkRunner runner(argc, argv);
+
+    typedef Opm::DenseAd::Evaluation<double, 3> Eval3;
+    for (unsigned n : {10, 100, 1000}) {
+        benchTables<double>(runner, "double", n);
+        benchTables<Eval3>(runner, "Evaluation3", n);
+    }
+
+    runner.report();
+
+    return 0;
+}
@@ -5,6 +5,7 @@ set (opm-material_CONFIG_VAR
   HAVE_VALGRIND
   HAVE_FINAL
   HAVE_ECL_INPUT
+  OPM_MATERIAL_EXPLICIT_INSTANTIATION
   )
 
 # dependencies
@@ -0,0 +1,342 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::BinarySerializer
+ */
+#ifndef OPM_BINARY_SERIALIZER_HPP
+#define OPM_BINARY_SERIALIZER_HPP
+
+#include <opm/material/common/TableArray.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Converts objects to and from a flat sequence of bytes.
+ *
+ * The same serializer type is used for both directions: Classes which can be
+ * serialized provide a method
+ *
+ * \code
+ * template <class Serializer>
+ * void serializeOp(Serializer& serializer)
+ * {
+ *     serializer(member1_);
+ *     serializer(member2_);
+ * }
+ * \endcode
+ *
+ * which either appends the members to the buffer or overwrites them with the data
+ * read from it, depending on isReading(). Arithmetic types, enumerations, strings,
+ * table arrays and the standard containers std::vector, std::array, std::pair and
+ * std::tuple are supported directly. The byte order and the sizes of the types are
+ * those of the host, i.e., the data is not meant to be portable between platforms.
+ *
+ * The elements of table arrays can optionally be kept apart from the rest of the data,
+ * see enableSharedArrays() and setSharedArrays(). This is used to place the tables of
+ * an object in shared memory.
+ */
+class BinarySerializer
+{
+public:
+    /*!
+     * \brief Create a serializer which writes to an internal buffer.
+     */
+    BinarySerializer()
+        : isReading_(false)
+        , pos_(0)
+        , sharedArraysEnabled_(false)
+        , sharedArrays_(nullptr)
+        , sharedArraysSize_(0)
+    { }
+
+    /*!
+     * \brief Create a serializer which reads from the given buffer.
+     */
+    explicit BinarySerializer(std::vector<char> buffer)
+        : buffer_(std::move(buffer))
+        , isReading_(true)
+        , pos_(0)
+        , sharedArraysEnabled_(false)
+        , sharedArrays_(nullptr)
+        , sharedArraysSize_(0)
+    { }
+
+    /*!
+     * \brief Write the elements of table arrays to sharedArrays() instead of the buffer.
+     *
+     * The buffer only records the position of each array. The objects must then be
+     * read by a serializer for which setSharedArrays() was called.
+     */
+    void enableSharedArrays()
+    {
+        if (isReading_)
+            throw std::logic_error("enableSharedArrays() is only valid for writing serializers");
+        sharedArraysEnabled_ = true;
+    }
+
+    /*!
+     * \brief The elements of the table arrays written by a serializer for which
+     *        enableSharedArrays() was called.
+     *
+     * Every array starts at a multiple of sharedArrayAlignment bytes.
+     */
+    const std::vector<char>& sharedArrays() const
+    { return sharedArrayBuffer_; }
+
+    /*!
+     * \brief Let the table arrays refer to the elements written by a serializer for
+     *        which enableSharedArrays() was called instead of copying them.
+     *
+     * The memory must be aligned to sharedArrayAlignment bytes and must stay valid as
+     * long as the objects refer to it, see TableArray::share().
+     */
+    void setSharedArrays(const void* data, std::size_t size)
+    {
+        if (!isReading_)
+            throw std::logic_error("setSharedArrays() is only valid for reading serializers");
+        sharedArraysEnabled_ = true;
+        sharedArrays_ = static_cast<const char*>(data);
+        sharedArraysSize_ = size;
+    }
+
+    //! The alignment of the table arrays which are kept apart from the rest of the data
+    static const std::size_t sharedArrayAlignment = 64;
+
+    /*!
+     * \brief Returns true if the objects are restored from the buffer.
+     */
+    bool isReading() const
+    { return isReading_; }
+
+    /*!
+     * \brief The serialized data.
+     */
+    const std::vector<char>& buffer() const
+    { return buffer_; }
+
+    /*!
+     * \brief The number of bytes which have not been read yet.
+     */
+    std::size_t remaining() const
+    { return buffer_.size() - pos_; }
+
+    /*!
+     * \brief Write or read an object.
+     */
+    template <class T>
+    void operator()(T& value)
+    { serialize_(value, std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>()); }
+
+private:
+    // arithmetic types and enumerations are copied bitwise
+    template <class T>
+    void serialize_(T& value, std::true_type)
+    { raw_(&value, sizeof(T)); }
+
+    // everything else must provide a serializeOp() method
+    template <class T>
+    void serialize_(T& value, std::false_type)
+    { value.serializeOp(*this); }
+
+    template <class T, class Alloc>
+    void serialize_(std::vector<T, Alloc>& values, std::false_type)
+    {
+        std::uint64_t n = values.size();
+        raw_(&n, sizeof(n));
+        if (isReading_) {
+            // do not trust the size of truncated or foreign data
+            if (std::is_arithmetic<T>::value && n > remaining()/sizeof(T))
+                throw std::runtime_error("Serialized data is truncated");
+            values.resize(n);
+        }
+        serializeElements_(values, std::integral_constant<bool, std::is_arithmetic<T>::value>());
+    }
+
+    template <class T, class Alloc>
+    void serializeElements_(std::vector<T, Alloc>& values, std::true_type)
+    {
+        if (!values.empty())
+            raw_(values.data(), values.size()*sizeof(T));
+    }
+
+    template <class T, class Alloc>
+    void serializeElements_(std::vector<T, Alloc>& values, std::false_type)
+    {
+        for (auto& value : values)
+            (*this)(value);
+    }
+
+    // std::vector<bool> does not store its elements contiguously
+    template <class Alloc>
+    void serializeElements_(std::vector<bool, Alloc>& values, std::true_type)
+    {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            bool value = values[i];
+            (*this)(value);
+            values[i] = value;
+        }
+    }
+
+    // table arrays use the same format as vectors unless they are kept apart. they are
+    // only accessed read-only when written, so arrays which refer to shared memory
+    // stay shared.
+    template <class T>
+    void serialize_(TableArray<T>& values, std::false_type)
+    {
+        if (sharedArraysEnabled_) {
+            serializeSharedArray_(values);
+            return;
+        }
+
+        const TableArray<T>& constValues = values;
+        std::uint64_t n = values.size();
+        raw_(&n, sizeof(n));
+        if (isReading_) {
+            if (std::is_arithmetic<T>::value && n > remaining()/sizeof(T))
+                throw std::runtime_error("Serialized data is truncated");
+            values.resize(n);
+        }
+
+        if (std::is_arithmetic<T>::value) {
+            // raw_() does not modify the data when writing
+            if (n > 0)
+                raw_(isReading_ ? values.data() : const_cast<T*>(constValues.data()), n*sizeof(T));
+            return;
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (isReading_)
+                (*this)(values[i]);
+            else {
+                T value = constValues[i];
+                (*this)(value);
+            }
+        }
+    }
+
+    template <class T>
+    void serializeSharedArray_(TableArray<T>& values)
+    {
+        std::uint64_t n = values.size();
+        std::uint64_t offset = 0;
+        if (!isReading_) {
+            offset = (sharedArrayBuffer_.size() + sharedArrayAlignment - 1)/sharedArrayAlignment*sharedArrayAlignment;
+            sharedArrayBuffer_.resize(offset + n*sizeof(T));
+            if (n > 0)
+                std::memcpy(sharedArrayBuffer_.data() + offset, static_cast<const TableArray<T>&>(values).data(), n*sizeof(T));
+        }
+
+        raw_(&n, sizeof(n));
+        raw_(&offset, sizeof(offset));
+
+        if (isReading_) {
+            if (offset % sharedArrayAlignment != 0
+                || offset > sharedArraysSize_
+                || n > (sharedArraysSize_ - offset)/sizeof(T))
+                throw std::runtime_error("Shared table array out of range");
+            values.share(reinterpret_cast<const T*>(sharedArrays_ + offset), n);
+        }
+    }
+
+    template <class T, std::size_t n>
+    void serialize_(std::array<T, n>& values, std::false_type)
+    {
+        for (auto& value : values)
+            (*this)(value);
+    }
+
+    template <class T1, class T2>
+    void serialize_(std::pair<T1, T2>& value, std::false_type)
+    {
+        (*this)(value.first);
+        (*this)(value.second);
+    }
+
+    template <class... T>
+    void serialize_(std::tuple<T...>& value, std::false_type)
+    { serializeTuple_<0>(value); }
+
+    template <std::size_t i, class Tuple>
+    typename std::enable_if<(i < std::tuple_size<Tuple>::value)>::type
+    serializeTuple_(Tuple& value)
+    {
+        (*this)(std::get<i>(value));
+        serializeTuple_<i + 1>(value);
+    }
+
+    template <std::size_t i, class Tuple>
+    typename std::enable_if<(i == std::tuple_size<Tuple>::value)>::type
+    serializeTuple_(Tuple&)
+    { }
+
+    void serialize_(std::string& value, std::false_type)
+    {
+        std::uint64_t n = value.size();
+        raw_(&n, sizeof(n));
+        if (isReading_) {
+            if (n > remaining())
+                throw std::runtime_error("Serialized data is truncated");
+            value.resize(n);
+        }
+        if (n > 0)
+            raw_(&value[0], n);
+    }
+
+    void raw_(void* data, std::size_t size)
+    {
+        if (!isReading_) {
+            const char* bytes = static_cast<const char*>(data);
+            buffer_.insert(buffer_.end(), bytes, bytes + size);
+            return;
+        }
+
+        if (size > remaining())
+            throw std::runtime_error("Serialized data is truncated");
+        std::memcpy(data, buffer_.data() + pos_, size);
+        pos_ += size;
+    }
+
+    std::vector<char> buffer_;
+    bool isReading_;
+    std::size_t pos_;
+
+    bool sharedArraysEnabled_;
+    std::vector<char> sharedArrayBuffer_;
+    const char* sharedArrays_;
+    std::size_t sharedArraysSize_;
+};
+
+} // namespace Opm
+
+#endif
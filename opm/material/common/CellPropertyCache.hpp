@@ -0,0 +1,259 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::CellPropertyCache
+ */
+#ifndef OPM_CELL_PROPERTY_CACHE_HPP
+#define OPM_CELL_PROPERTY_CACHE_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Opm {
+
+namespace Detail {
+/*!
+ * \brief The hit and miss counters of a CellPropertyCache.
+ *
+ * If statistics are disabled, counting is a no-op which the compiler removes, so the
+ * lookups of concurrent threads do not write to shared memory.
+ */
+template <bool enabled>
+class CellPropertyCacheStatistics
+{
+public:
+    void countHit()
+    {}
+
+    void countMiss()
+    {}
+
+    void reset()
+    {}
+};
+
+template <>
+class CellPropertyCacheStatistics<true>
+{
+public:
+    CellPropertyCacheStatistics()
+        : numHits_(0)
+        , numMisses_(0)
+    {}
+
+    void countHit()
+    { numHits_.fetch_add(1, std::memory_order_relaxed); }
+
+    void countMiss()
+    { numMisses_.fetch_add(1, std::memory_order_relaxed); }
+
+    std::uint64_t numHits() const
+    { return numHits_.load(std::memory_order_relaxed); }
+
+    std::uint64_t numMisses() const
+    { return numMisses_.load(std::memory_order_relaxed); }
+
+    void reset()
+    {
+        numHits_ = 0;
+        numMisses_ = 0;
+    }
+
+private:
+    std::atomic<std::uint64_t> numHits_;
+    std::atomic<std::uint64_t> numMisses_;
+};
+} // namespace Detail
+
+/*!
+ * \brief Memoizes the results of per-cell property computations.
+ *
+ * For each cell, the cache stores the inputs of the last computation, the region which
+ * was used for it and the resulting outputs. If a property is requested with inputs
+ * and a region which match the stored ones, the stored outputs are returned and the
+ * computation is skipped. Inputs match if MathToolbox::isSame() considers them equal
+ * for the configured tolerance, i.e., for evaluations the derivatives are compared as
+ * well. A tolerance of zero, the default, means that the cached results are only used
+ * if the inputs are identical.
+ *
+ * This is intended for the late iterations of a non-linear solver where most cells do
+ * not change. A typical use looks like this:
+ *
+ * \code
+ * CellPropertyCache<Evaluation, 3, 2> cache(numCells);
+ * ...
+ * const auto& out = cache.get(cellIdx, pvtRegionIdx, {{p, T, Rs}},
+ *                             [&](std::array<Evaluation, 2>& result) {
+ *                                 result[0] = FluidSystem::inverseFormationVolumeFactor(fs, oilPhaseIdx, pvtRegionIdx);
+ *                                 result[1] = FluidSystem::viscosity(fs, oilPhaseIdx, pvtRegionIdx);
+ *                             });
+ * \endcode
+ *
+ * Different cells may be accessed concurrently. The hit and miss counts are only kept
+ * if enableStatisticsV is true: they are shared by all threads and updated atomically,
+ * which causes contention if many threads use the cache at the same time. They are
+ * thus meant for tuning the tolerance rather than for production runs.
+ */
+template <class Evaluation, unsigned numInputsV, unsigned numOutputsV, bool enableStatisticsV = false>
+class CellPropertyCache
+{
+    typedef MathToolbox<Evaluation> Toolbox;
+    typedef typename Toolbox::Scalar Scalar;
+
+    static unsigned invalidRegion_()
+    { return std::numeric_limits<unsigned>::max(); }
+
+public:
+    static const unsigned numInputs = numInputsV;
+    static const unsigned numOutputs = numOutputsV;
+    static const bool enableStatistics = enableStatisticsV;
+
+    typedef std::array<Evaluation, numInputs> Inputs;
+    typedef std::array<Evaluation, numOutputs> Outputs;
+
+    explicit CellPropertyCache(unsigned numCells = 0, Scalar tolerance = 0.0)
+        : tolerance_(tolerance)
+    { resize(numCells); }
+
+    /*!
+     * \brief Set the number of cells and invalidate all entries.
+     */
+    void resize(unsigned numCells)
+    {
+        inputs_.assign(numCells, Inputs());
+        outputs_.assign(numCells, Outputs());
+        regions_.assign(numCells, invalidRegion_());
+    }
+
+    unsigned numCells() const
+    { return regions_.size(); }
+
+    /*!
+     * \brief Set the tolerance below which inputs are considered to be unchanged.
+     */
+    void setTolerance(Scalar value)
+    { tolerance_ = value; }
+
+    Scalar tolerance() const
+    { return tolerance_; }
+
+    /*!
+     * \brief Return the outputs for a cell, recomputing them only if the inputs or the
+     *        region differ from the ones of the last call.
+     *
+     * \param compute A callable which takes an Outputs object by reference and fills it.
+     */
+    template <class ComputeFn>
+    const Outputs& get(unsigned cellIdx, unsigned regionIdx, const Inputs& inputs, ComputeFn&& compute)
+    {
+        assert(cellIdx < numCells());
+
+        if (matches_(cellIdx, regionIdx, inputs)) {
+            statistics_.countHit();
+            return outputs_[cellIdx];
+        }
+
+        statistics_.countMiss();
+        compute(outputs_[cellIdx]);
+        inputs_[cellIdx] = inputs;
+        regions_[cellIdx] = regionIdx;
+        return outputs_[cellIdx];
+    }
+
+    /*!
+     * \brief Force the recomputation of the properties of a cell.
+     */
+    void invalidate(unsigned cellIdx)
+    { regions_[cellIdx] = invalidRegion_(); }
+
+    /*!
+     * \brief Force the recomputation of the properties of all cells.
+     *
+     * This must be called whenever the parameters which are not part of the inputs,
+     * e.g., the PVT tables, are changed.
+     */
+    void invalidateAll()
+    { regions_.assign(regions_.size(), invalidRegion_()); }
+
+    //! The number of calls for which the computation was skipped
+    std::uint64_t numHits() const
+    {
+        static_assert(enableStatistics, "The statistics of the cache are disabled");
+        return statistics_.numHits();
+    }
+
+    //! The number of calls for which the properties were computed
+    std::uint64_t numMisses() const
+    {
+        static_assert(enableStatistics, "The statistics of the cache are disabled");
+        return statistics_.numMisses();
+    }
+
+    //! The fraction of calls for which the computation was skipped
+    double hitRate() const
+    {
+        static_assert(enableStatistics, "The statistics of the cache are disabled");
+        const std::uint64_t hits = numHits();
+        const std::uint64_t total = hits + numMisses();
+        return total > 0 ? double(hits)/total : 0.0;
+    }
+
+    void resetStatistics()
+    { statistics_.reset(); }
+
+private:
+    bool matches_(unsigned cellIdx, unsigned regionIdx, const Inputs& inputs) const
+    {
+        if (regions_[cellIdx] != regionIdx)
+            return false;
+
+        const Inputs& cached = inputs_[cellIdx];
+        for (unsigned i = 0; i < numInputs; ++i) {
+            if (tolerance_ > 0.0) {
+                if (!Toolbox::isSame(inputs[i], cached[i], tolerance_))
+                    return false;
+            }
+            else if (!(inputs[i] == cached[i]))
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<Inputs> inputs_;
+    std::vector<Outputs> outputs_;
+    std::vector<unsigned> regions_;
+    Scalar tolerance_;
+
+    Detail::CellPropertyCacheStatistics<enableStatistics> statistics_;
+};
+
+} // namespace Opm
+
+#endif
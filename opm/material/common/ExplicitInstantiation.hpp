@@ -0,0 +1,90 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Switches for the optional library of explicitly instantiated templates.
+ *
+ * If opm-material is configured with -DOPM_MATERIAL_EXPLICIT_INSTANTIATION=ON, the
+ * commonly used specializations of the Evaluation class, the black-oil fluid system,
+ * the black-oil PVT classes and the ECL material law manager are compiled into the
+ * opm-material library. config.h then defines OPM_MATERIAL_EXPLICIT_INSTANTIATION to 1
+ * and the headers declare these specializations as 'extern template', i.e., code which
+ * includes them does not need to instantiate and emit them again.
+ *
+ * The library is built for 'double' and the default index traits. Other
+ * specializations are instantiated implicitly as usual.
+ */
+#ifndef OPM_MATERIAL_EXPLICIT_INSTANTIATION_HPP
+#define OPM_MATERIAL_EXPLICIT_INSTANTIATION_HPP
+
+#ifndef OPM_MATERIAL_EXPLICIT_INSTANTIATION
+#define OPM_MATERIAL_EXPLICIT_INSTANTIATION 0
+#endif
+
+namespace Opm {
+namespace DenseAd {
+template <class ValueT, int numVars, unsigned staticSize>
+class Evaluation;
+} // namespace DenseAd
+
+namespace ExplicitInstantiation {
+typedef DenseAd::Evaluation<double, 1, 0> Evaluation1;
+typedef DenseAd::Evaluation<double, 2, 0> Evaluation2;
+typedef DenseAd::Evaluation<double, 3, 0> Evaluation3;
+typedef DenseAd::Evaluation<double, 4, 0> Evaluation4;
+typedef DenseAd::Evaluation<double, 5, 0> Evaluation5;
+typedef DenseAd::Evaluation<double, 6, 0> Evaluation6;
+typedef DenseAd::Evaluation<double, 7, 0> Evaluation7;
+typedef DenseAd::Evaluation<double, 8, 0> Evaluation8;
+typedef DenseAd::Evaluation<double, 9, 0> Evaluation9;
+typedef DenseAd::Evaluation<double, 10, 0> Evaluation10;
+typedef DenseAd::Evaluation<double, 11, 0> Evaluation11;
+typedef DenseAd::Evaluation<double, 12, 0> Evaluation12;
+} // namespace ExplicitInstantiation
+} // namespace Opm
+
+/*!
+ * \brief Invoke a macro for each value type for which the evaluation functions are
+ *        compiled into the library.
+ *
+ * These are double and Evaluation<double, N> for 1 <= N <= 12, i.e. the sizes for
+ * which the Evaluation class is specialized. The Evaluation class must be defined
+ * where the code generated by the macro is instantiated.
+ */
+#define OPM_MATERIAL_FOR_EACH_EVALUATION(MACRO)                 \
+    MACRO(double)                                               \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation1)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation2)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation3)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation4)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation5)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation6)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation7)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation8)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation9)            \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation10)           \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation11)           \
+    MACRO(::Opm::ExplicitInstantiation::Evaluation12)
+
+#endif
@@ -0,0 +1,316 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Inlinable polynomial approximations of exp(), log() and pow().
+ */
+#ifndef OPM_MATERIAL_FAST_MATH_HPP
+#define OPM_MATERIAL_FAST_MATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief Polynomial approximations of the exponential, the natural logarithm and the
+ *        power function for float and double.
+ *
+ * The functions are header-only and do not use lookup tables. exp() and log() do not
+ * branch: special arguments like zero, infinity and NaN as well as results that
+ * over- or underflow are handled by selections, so that loops over these functions
+ * can be vectorized by the compiler. pow() calls the standard library for
+ * non-positive bases unless the exponent is integral. The following bounds for the
+ * error have been determined by comparison with long double reference values at
+ * 4*10^6 random points, both for float and for double:
+ *
+ * - exp(x), log(x): at most 1.5 ulp
+ * - pow(x, n) with integral |n| <= 16: at most |n| ulp
+ * - pow(x, n + 1/2) with integral |n| <= 16: at most 3*(|n| + 1) ulp
+ * - pow(x, y) otherwise: at most 1.5*(2 + |y*log(x)|) ulp
+ *
+ * Subnormal results of exp() are accurate to one unit of the smallest subnormal
+ * number. In contrast to the standard library, the results are thus not always
+ * correctly rounded. For a single evaluation, the standard library is usually at least
+ * as fast for exp() and log(); the benefit of these functions is that the compiler can
+ * inline and vectorize them and that integral and half-integral exponents avoid
+ * computing exp(y*log(x)).
+ */
+namespace FastMath {
+
+//! \cond SKIP
+namespace Detail {
+
+template <class Scalar>
+struct Traits;
+
+template <>
+struct Traits<double>
+{
+    typedef std::uint64_t Bits;
+    static constexpr int mantissaBits = 52;
+    static constexpr int exponentBias = 1023;
+    // e^x is zero below and infinite above these values
+    static constexpr double minExpArg = -746.0;
+    static constexpr double maxExpArg = 710.0;
+    // ln(2) split into a part with trailing zeros and a correction
+    static constexpr double ln2Hi = 6.93147180369123816490e-01;
+    static constexpr double ln2Lo = 1.90821492927058770002e-10;
+};
+
+template <>
+struct Traits<float>
+{
+    typedef std::uint32_t Bits;
+    static constexpr int mantissaBits = 23;
+    static constexpr int exponentBias = 127;
+    static constexpr float minExpArg = -104.0f;
+    static constexpr float maxExpArg = 89.0f;
+    static constexpr float ln2Hi = 6.9314575195e-01f;
+    static constexpr float ln2Lo = 1.4286067653e-06f;
+};
+
+template <class Scalar>
+typename Traits<Scalar>::Bits toBits(Scalar x)
+{
+    typename Traits<Scalar>::Bits b;
+    std::memcpy(&b, &x, sizeof(x));
+    return b;
+}
+
+template <class Scalar>
+Scalar fromBits(typename Traits<Scalar>::Bits b)
+{
+    Scalar x;
+    std::memcpy(&x, &b, sizeof(x));
+    return x;
+}
+
+// the following helpers avoid conversions between integers and floating point values
+// because vector instruction sets before AVX-512 do not provide them for 64 bit
+// integers. 'shifter' is 1.5*2^mantissaBits: adding it to a value of a magnitude below
+// 2^(mantissaBits - 1) moves the rounded integer part to the lowest mantissa bits.
+
+// round a value of a magnitude below 2^(mantissaBits - 1) to the nearest integer
+template <class Scalar>
+Scalar roundToInt(Scalar x)
+{
+    const Scalar shifter = static_cast<Scalar>(typename Traits<Scalar>::Bits(3) << (Traits<Scalar>::mantissaBits - 1));
+    return (x + shifter) - shifter;
+}
+
+// 2^k for an integral value k which results in a normal number
+template <class Scalar>
+Scalar twoPow(Scalar k)
+{
+    typedef Traits<Scalar> T;
+    const Scalar shifter = static_cast<Scalar>(typename T::Bits(3) << (T::mantissaBits - 1));
+    const typename T::Bits biasedK = toBits(k + shifter) - toBits(shifter) + T::exponentBias;
+    return fromBits<Scalar>(biasedK << T::mantissaBits);
+}
+
+// convert a non-negative integer below 2^mantissaBits
+template <class Scalar>
+Scalar toScalar(typename Traits<Scalar>::Bits n)
+{
+    const Scalar twoPowMantissa = static_cast<Scalar>(typename Traits<Scalar>::Bits(1) << Traits<Scalar>::mantissaBits);
+    return fromBits<Scalar>(n | toBits(twoPowMantissa)) - twoPowMantissa;
+}
+
+// the Taylor polynomial of e^r for |r| <= ln(2)/2
+inline double expPoly(double r)
+{
+    double p = 1.0/6227020800.0;
+    p = p*r + 1.0/479001600.0;
+    p = p*r + 1.0/39916800.0;
+    p = p*r + 1.0/3628800.0;
+    p = p*r + 1.0/362880.0;
+    p = p*r + 1.0/40320.0;
+    p = p*r + 1.0/5040.0;
+    p = p*r + 1.0/720.0;
+    p = p*r + 1.0/120.0;
+    p = p*r + 1.0/24.0;
+    p = p*r + 1.0/6.0;
+    p = p*r + 0.5;
+    return 1.0 + r*(1.0 + r*p);
+}
+
+inline float expPoly(float r)
+{
+    float p = 1.0f/5040.0f;
+    p = p*r + 1.0f/720.0f;
+    p = p*r + 1.0f/120.0f;
+    p = p*r + 1.0f/24.0f;
+    p = p*r + 1.0f/6.0f;
+    p = p*r + 0.5f;
+    return 1.0f + r*(1.0f + r*p);
+}
+
+// 2*atanh(s)/s - 2 as a polynomial of s^2 for |s| <= 3 - 2*sqrt(2)
+inline double logPoly(double s2)
+{
+    double p = 2.0/21.0;
+    p = p*s2 + 2.0/19.0;
+    p = p*s2 + 2.0/17.0;
+    p = p*s2 + 2.0/15.0;
+    p = p*s2 + 2.0/13.0;
+    p = p*s2 + 2.0/11.0;
+    p = p*s2 + 2.0/9.0;
+    p = p*s2 + 2.0/7.0;
+    p = p*s2 + 2.0/5.0;
+    p = p*s2 + 2.0/3.0;
+    return p*s2;
+}
+
+inline float logPoly(float s2)
+{
+    float p = 2.0f/9.0f;
+    p = p*s2 + 2.0f/7.0f;
+    p = p*s2 + 2.0f/5.0f;
+    p = p*s2 + 2.0f/3.0f;
+    return p*s2;
+}
+
+} // namespace Detail
+//! \endcond
+
+/*!
+ * \brief The exponential function.
+ */
+template <class Scalar>
+inline Scalar exp(Scalar x)
+{
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "FastMath is only implemented for float and double");
+    typedef Detail::Traits<Scalar> Traits;
+
+    // beyond these bounds the result is zero or infinite anyway. NaNs are propagated by
+    // the clamping.
+    const Scalar xc = std::min(std::max(x, Traits::minExpArg), Traits::maxExpArg);
+
+    // x = k*ln(2) + r with |r| <= ln(2)/2. k*ln2Hi is exact.
+    const Scalar k = Detail::roundToInt(xc*static_cast<Scalar>(1.44269504088896338700));
+    const Scalar r = (xc - k*Traits::ln2Hi) - k*Traits::ln2Lo;
+
+    // 2^k is split into two factors which are both normal numbers. this avoids branches
+    // for results that over- or underflow.
+    const Scalar k1 = Detail::roundToInt(k/2);
+    return (Detail::expPoly(r)*Detail::twoPow(k1))*Detail::twoPow(k - k1);
+}
+
+/*!
+ * \brief The natural logarithm.
+ */
+template <class Scalar>
+inline Scalar log(Scalar x)
+{
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "FastMath is only implemented for float and double");
+    typedef Detail::Traits<Scalar> Traits;
+    typedef typename Traits::Bits Bits;
+
+    // subnormal values are scaled into the normal range
+    const bool subnormal = x < std::numeric_limits<Scalar>::min();
+    const Scalar scale = Detail::twoPow(static_cast<Scalar>(Traits::mantissaBits + 1));
+    const Scalar xs = subnormal ? x*scale : x;
+
+    // x = m*2^e with sqrt(1/2) <= m < sqrt(2)
+    const Bits bits = Detail::toBits(xs);
+    const Bits mantissaMask = (Bits(1) << Traits::mantissaBits) - 1;
+    Scalar e = Detail::toScalar<Scalar>(bits >> Traits::mantissaBits) - Traits::exponentBias;
+    e -= subnormal ? static_cast<Scalar>(Traits::mantissaBits + 1) : 0;
+    Scalar m = Detail::fromBits<Scalar>((bits & mantissaMask)
+                                        | (Bits(Traits::exponentBias) << Traits::mantissaBits));
+    const bool large = m > static_cast<Scalar>(1.41421356237309504880);
+    m = large ? m/2 : m;
+    e += large ? 1 : 0;
+
+    // log(m) = 2*atanh(s) with s = (m - 1)/(m + 1)
+    const Scalar f = m - 1;
+    const Scalar s = f/(m + 1);
+    const Scalar s2 = s*s;
+    const Scalar logM = f - s*(f - Detail::logPoly(s2));
+    Scalar result = e*Traits::ln2Hi + (logM + e*Traits::ln2Lo);
+
+    // zero, negative, infinite and NaN arguments
+    result = x > std::numeric_limits<Scalar>::max() ? x : result;
+    result = x == 0 ? -std::numeric_limits<Scalar>::infinity() : result;
+    return x < 0 || x != x ? std::numeric_limits<Scalar>::quiet_NaN() : result;
+}
+
+/*!
+ * \brief Raise a value to an integral power by repeated squaring.
+ */
+template <class Scalar>
+inline Scalar powInt(Scalar x, int n)
+{
+    unsigned k = static_cast<unsigned>(n < 0 ? -n : n);
+    Scalar result = 1;
+    Scalar y = x;
+    while (k) {
+        if (k & 1)
+            result *= y;
+        y *= y;
+        k >>= 1;
+    }
+    return n < 0 ? 1/result : result;
+}
+
+/*!
+ * \brief The power function.
+ *
+ * Integral and half-integral exponents of a magnitude up to 16 are computed by
+ * multiplications and a square root.
+ */
+template <class Scalar>
+inline Scalar pow(Scalar x, Scalar y)
+{
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "FastMath is only implemented for float and double");
+
+    const Scalar twoY = 2*y;
+    if (std::abs(y) <= 16 && twoY == std::floor(twoY)) {
+        if (y == std::floor(y))
+            return powInt(x, static_cast<int>(y));
+
+        // x^(n + 1/2) = x^n*sqrt(x)
+        if (!(x > 0))
+            return std::pow(x, y);
+        const int n = static_cast<int>(std::floor(y));
+        return powInt(x, n)*std::sqrt(x);
+    }
+
+    if (!(x > 0))
+        return std::pow(x, y);
+    return FastMath::exp(y*FastMath::log(x));
+}
+
+} // namespace FastMath
+} // namespace Opm
+
+#endif
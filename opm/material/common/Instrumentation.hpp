@@ -0,0 +1,426 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::Instrumentation
+ */
+#ifndef OPM_MATERIAL_INSTRUMENTATION_HPP
+#define OPM_MATERIAL_INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Set this to 1 (e.g. via -DOPM_MATERIAL_INSTRUMENTATION=1) to collect call counts,
+// extrapolation counts, iteration counts and sampled timings for the PVT and
+// material law multiplexers and for the tabulated functions. If it is 0, all
+// instrumentation macros expand to nothing.
+#ifndef OPM_MATERIAL_INSTRUMENTATION
+#define OPM_MATERIAL_INSTRUMENTATION 0
+#endif
+
+namespace Opm {
+
+/*!
+ * \brief The counters which are collected for an instrumented method.
+ */
+struct InstrumentationCounters
+{
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> extrapolations{0};
+    std::atomic<std::uint64_t> iterations{0};
+    std::atomic<std::uint64_t> timedCalls{0};
+    std::atomic<std::uint64_t> timedNanoseconds{0};
+
+    void reset()
+    {
+        calls = 0;
+        extrapolations = 0;
+        iterations = 0;
+        timedCalls = 0;
+        timedNanoseconds = 0;
+    }
+};
+
+/*!
+ * \brief The aggregated counters of a method for a given region.
+ */
+struct InstrumentationRecord
+{
+    std::string category;
+    std::string method;
+    unsigned regionIdx = 0;
+
+    std::uint64_t calls = 0;
+    std::uint64_t extrapolations = 0;
+    std::uint64_t iterations = 0;
+    std::uint64_t timedCalls = 0;
+    double timedSeconds = 0.0;
+
+    /*!
+     * \brief Returns the estimated total time spent in the method [s].
+     *
+     * This is extrapolated from the calls which have been timed.
+     */
+    double estimatedSeconds() const
+    { return timedCalls > 0 ? timedSeconds*calls/timedCalls : 0.0; }
+};
+
+/*!
+ * \brief The counters of an instrumented code location.
+ *
+ * Each location is identified by a category (e.g. the class) and a method name and
+ * keeps separate counters for each region. Regions beyond maxRegions share the
+ * counters of the last one. Objects of this class are static variables which are
+ * created by the instrumentation macros.
+ */
+class InstrumentationSite
+{
+public:
+    static const unsigned maxRegions = 64;
+
+    InstrumentationSite(const char* category, const char* method);
+
+    InstrumentationCounters& counters(unsigned regionIdx)
+    { return counters_[std::min(regionIdx, maxRegions - 1)]; }
+
+    const InstrumentationCounters& counters(unsigned regionIdx) const
+    { return counters_[std::min(regionIdx, maxRegions - 1)]; }
+
+    const char* category() const
+    { return category_; }
+
+    const char* method() const
+    { return method_; }
+
+    void reset()
+    {
+        for (auto& c : counters_)
+            c.reset();
+    }
+
+private:
+    const char* category_;
+    const char* method_;
+    std::array<InstrumentationCounters, maxRegions> counters_;
+};
+
+/*!
+ * \brief Registry and query interface of the optional instrumentation layer.
+ *
+ * The instrumented code is compiled in only if OPM_MATERIAL_INSTRUMENTATION is
+ * non-zero. The query methods are always available, they just report nothing if
+ * the instrumentation is disabled. Counters of the same category, method and region
+ * are summed up, i.e., the instantiations of a method for different evaluation types
+ * are reported together.
+ *
+ * To limit the overhead, only every samplingInterval()-th call of a scope is timed.
+ */
+class Instrumentation
+{
+public:
+    /*!
+     * \brief Returns true if the instrumentation has been compiled in.
+     */
+    static constexpr bool enabled()
+    { return OPM_MATERIAL_INSTRUMENTATION != 0; }
+
+    /*!
+     * \brief Specify that every n-th call of an instrumented scope is timed.
+     *
+     * A value of 0 disables the timings.
+     */
+    static void setSamplingInterval(unsigned n)
+    { samplingInterval_() = n; }
+
+    static unsigned samplingInterval()
+    { return samplingInterval_(); }
+
+    /*!
+     * \brief Register a code location. This is called by the constructor of the site.
+     */
+    static void registerSite(const InstrumentationSite* site)
+    {
+        std::lock_guard<std::mutex> lock(mutex_());
+        sites_().push_back(site);
+    }
+
+    /*!
+     * \brief Returns the aggregated counters of all methods and regions which have
+     *        been called at least once.
+     */
+    static std::vector<InstrumentationRecord> records()
+    {
+        typedef std::tuple<std::string, std::string, unsigned> Key;
+        std::map<Key, InstrumentationRecord> result;
+
+        std::lock_guard<std::mutex> lock(mutex_());
+        for (const auto* site : sites_()) {
+            for (unsigned regionIdx = 0; regionIdx < InstrumentationSite::maxRegions; ++regionIdx) {
+                const auto& c = site->counters(regionIdx);
+                if (c.calls == 0 && c.extrapolations == 0 && c.iterations == 0)
+                    continue;
+
+                auto& r = result[Key(site->category(), site->method(), regionIdx)];
+                r.category = site->category();
+                r.method = site->method();
+                r.regionIdx = regionIdx;
+                addTo_(r, c);
+            }
+        }
+
+        std::vector<InstrumentationRecord> ret;
+        for (const auto& kv : result)
+            ret.push_back(kv.second);
+        return ret;
+    }
+
+    /*!
+     * \brief Returns the aggregated counters of a method for a given region.
+     */
+    static InstrumentationRecord query(const std::string& category,
+                                       const std::string& method,
+                                       unsigned regionIdx = 0)
+    {
+        InstrumentationRecord r;
+        r.category = category;
+        r.method = method;
+        r.regionIdx = regionIdx;
+
+        std::lock_guard<std::mutex> lock(mutex_());
+        for (const auto* site : sites_())
+            if (category == site->category() && method == site->method())
+                addTo_(r, site->counters(regionIdx));
+        return r;
+    }
+
+    /*!
+     * \brief Returns the aggregated counters of a method summed over all regions.
+     */
+    static InstrumentationRecord queryAllRegions(const std::string& category,
+                                                 const std::string& method)
+    {
+        InstrumentationRecord r;
+        r.category = category;
+        r.method = method;
+
+        std::lock_guard<std::mutex> lock(mutex_());
+        for (const auto* site : sites_())
+            if (category == site->category() && method == site->method())
+                for (unsigned regionIdx = 0; regionIdx < InstrumentationSite::maxRegions; ++regionIdx)
+                    addTo_(r, site->counters(regionIdx));
+        return r;
+    }
+
+    /*!
+     * \brief Set all counters to zero.
+     */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_());
+        for (const auto* site : sites_())
+            const_cast<InstrumentationSite*>(site)->reset();
+    }
+
+    /*!
+     * \brief Print a table of all counters.
+     */
+    static void dump(std::ostream& os = std::cout)
+    {
+        if (!enabled()) {
+            os << "Instrumentation is disabled (compile with OPM_MATERIAL_INSTRUMENTATION=1)\n";
+            return;
+        }
+
+        const auto recs = records();
+        os << std::left
+           << std::setw(24) << "category" << " "
+           << std::setw(40) << "method" << " "
+           << std::right
+           << std::setw(6) << "region" << " "
+           << std::setw(14) << "calls" << " "
+           << std::setw(14) << "extrapolated" << " "
+           << std::setw(14) << "iterations" << " "
+           << std::setw(14) << "est. time [s]" << "\n";
+        for (const auto& r : recs) {
+            os << std::left
+               << std::setw(24) << r.category << " "
+               << std::setw(40) << r.method << " "
+               << std::right
+               << std::setw(6) << r.regionIdx << " "
+               << std::setw(14) << r.calls << " "
+               << std::setw(14) << r.extrapolations << " "
+               << std::setw(14) << r.iterations << " "
+               << std::setw(14) << r.estimatedSeconds() << "\n";
+        }
+    }
+
+private:
+    static void addTo_(InstrumentationRecord& r, const InstrumentationCounters& c)
+    {
+        r.calls += c.calls;
+        r.extrapolations += c.extrapolations;
+        r.iterations += c.iterations;
+        r.timedCalls += c.timedCalls;
+        r.timedSeconds += c.timedNanoseconds*1e-9;
+    }
+
+    static std::mutex& mutex_()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<const InstrumentationSite*>& sites_()
+    {
+        static std::vector<const InstrumentationSite*> sites;
+        return sites;
+    }
+
+    static std::atomic<unsigned>& samplingInterval_()
+    {
+        static std::atomic<unsigned> interval{1024};
+        return interval;
+    }
+};
+
+inline InstrumentationSite::InstrumentationSite(const char* category, const char* method)
+    : category_(category)
+    , method_(method)
+{ Instrumentation::registerSite(this); }
+
+/*!
+ * \brief Counts a call of an instrumented method and times it if it is sampled.
+ *
+ * The innermost active scope of a thread also collects the extrapolated table
+ * lookups and the iterations which happen while it is alive.
+ */
+class InstrumentationScope
+{
+public:
+    InstrumentationScope(InstrumentationSite& site, unsigned regionIdx)
+        : counters_(site.counters(regionIdx))
+        , parent_(current_())
+        , timed_(false)
+    {
+        std::uint64_t n = counters_.calls.fetch_add(1, std::memory_order_relaxed);
+        unsigned interval = Instrumentation::samplingInterval();
+        if (interval > 0 && n % interval == 0) {
+            timed_ = true;
+            start_ = std::chrono::steady_clock::now();
+        }
+        current_() = this;
+    }
+
+    InstrumentationScope(const InstrumentationScope&) = delete;
+    InstrumentationScope& operator=(const InstrumentationScope&) = delete;
+
+    ~InstrumentationScope()
+    {
+        if (timed_) {
+            auto dt = std::chrono::steady_clock::now() - start_;
+            counters_.timedNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count(),
+                                                 std::memory_order_relaxed);
+            counters_.timedCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+        current_() = parent_;
+    }
+
+    /*!
+     * \brief Record that a table lookup was extrapolated.
+     *
+     * This is attributed to the table and to the innermost active scope.
+     */
+    static void countExtrapolation(InstrumentationSite& tableSite)
+    {
+        tableSite.counters(0).extrapolations.fetch_add(1, std::memory_order_relaxed);
+        if (current_())
+            current_()->counters_.extrapolations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Record an iteration of a non-linear solver in the innermost active scope.
+     */
+    static void countIteration()
+    {
+        if (current_())
+            current_()->counters_.iterations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    static InstrumentationScope*& current_()
+    {
+        static thread_local InstrumentationScope* current = nullptr;
+        return current;
+    }
+
+    InstrumentationCounters& counters_;
+    InstrumentationScope* parent_;
+    bool timed_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace Opm
+
+#if OPM_MATERIAL_INSTRUMENTATION
+/*!
+ * \brief Count and time the enclosing block as method 'method' of 'category'.
+ */
+#define OPM_INSTRUMENT_SCOPE(category, method, regionIdx)                           \
+    static ::Opm::InstrumentationSite opmInstrumentationSite_(category, method);   \
+    ::Opm::InstrumentationScope opmInstrumentationScope_(opmInstrumentationSite_, regionIdx)
+
+/*!
+ * \brief Count a table lookup and whether it was extrapolated.
+ *
+ * The extrapolation condition is only evaluated if the instrumentation is enabled.
+ */
+#define OPM_INSTRUMENT_LOOKUP(category, method, isExtrapolated)                      \
+    do {                                                                             \
+        static ::Opm::InstrumentationSite opmInstrumentationSite_(category, method); \
+        opmInstrumentationSite_.counters(0).calls.fetch_add(1, std::memory_order_relaxed); \
+        if (isExtrapolated)                                                          \
+            ::Opm::InstrumentationScope::countExtrapolation(opmInstrumentationSite_); \
+    } while (false)
+
+/*!
+ * \brief Count an iteration of a non-linear solver in the innermost scope.
+ */
+#define OPM_INSTRUMENT_ITERATION()                                                   \
+    ::Opm::InstrumentationScope::countIteration()
+#else
+#define OPM_INSTRUMENT_SCOPE(category, method, regionIdx) do { } while (false)
+#define OPM_INSTRUMENT_LOOKUP(category, method, isExtrapolated) do { } while (false)
+#define OPM_INSTRUMENT_ITERATION() do { } while (false)
+#endif
+
+#endif
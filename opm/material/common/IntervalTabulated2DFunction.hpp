@@ -31,8 +31,10 @@
 #include <opm/material/common/Valgrind.hpp>
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Unused.hpp>
+#include <opm/material/common/Instrumentation.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
+#include <cmath>
 #include <vector>
 #include <limits>
 #include <sstream>
@@ -46,6 +48,10 @@ namespace Opm {
  *
  * The function is sampled in regular intervals in both directions, i.e., the
  * interpolation cells are rectangles. The table can be extrapolated in either direction.
+ *
+ * The samples are stored in a single row-major buffer. If the sampling points of an
+ * axis are equidistant, the interval of a position on that axis is computed directly
+ * instead of being searched for.
  */
 template <class Scalar>
 class IntervalTabulated2DFunction
@@ -62,7 +68,6 @@ public:
                                 const bool yExtrapolate = false)
         : xPos_(xPos)
         , yPos_(yPos)
-        , samples_(data)
         , xExtrapolate_(xExtrapolate)
         , yExtrapolate_(yExtrapolate)
     {
@@ -81,16 +86,21 @@ public:
 #endif
 
         // make sure the size is correct
-        if (numX() != samples_.size())
+        if (numX() != data.size())
             throw std::runtime_error("numX() is not equal to the number of rows of the sampling points");
 
+        samples_.resize(numX()*numY());
         for (unsigned xIdx = 0; xIdx < numX(); ++xIdx) {
-            if (samples_[xIdx].size() != numY()) {
+            if (data[xIdx].size() != numY()) {
                 std::ostringstream oss;
                 oss << "The " << xIdx << "-th row of the sampling points has different size than numY() ";
                 throw std::runtime_error(oss.str());
             }
+            std::copy(data[xIdx].begin(), data[xIdx].end(), samples_.begin() + xIdx*numY());
         }
+
+        xInvSpacing_ = uniformInvSpacing_(xPos_);
+        yInvSpacing_ = uniformInvSpacing_(yPos_);
     }
 
     /*!
@@ -135,7 +145,24 @@ public:
     const std::vector<Scalar>& yPos() const
     { return yPos_; }
 
-    const std::vector<std::vector<Scalar>>& samples() const
+    /*!
+     * \brief Returns a copy of the sampling points, one row per x position.
+     */
+    std::vector<std::vector<Scalar>> samples() const
+    {
+        std::vector<std::vector<Scalar>> result(numX());
+        for (unsigned xIdx = 0; xIdx < numX(); ++xIdx)
+            result[xIdx].assign(samples_.begin() + xIdx*numY(),
+                                samples_.begin() + (xIdx + 1)*numY());
+        return result;
+    }
+
+    /*!
+     * \brief Returns the sampling points in row-major order.
+     *
+     * The value at (xPos()[i], yPos()[j]) is located at index i*numY() + j.
+     */
+    const std::vector<Scalar>& flatSamples() const
     { return samples_; }
 
     bool xExtrapolate() const
@@ -144,10 +171,22 @@ public:
     bool yExtrapolate() const
     { return yExtrapolate_; }
 
+    /*!
+     * \brief Returns true if the sampling points in x direction are equidistant.
+     */
+    bool xUniform() const
+    { return xInvSpacing_ > 0.0; }
+
+    /*!
+     * \brief Returns true if the sampling points in y direction are equidistant.
+     */
+    bool yUniform() const
+    { return yInvSpacing_ > 0.0; }
+
     bool operator==(const IntervalTabulated2DFunction<Scalar>& data) const {
         return this->xPos() == data.xPos() &&
                this->yPos() == data.yPos() &&
-               this->samples() == data.samples() &&
+               this->flatSamples() == data.flatSamples() &&
                this->xExtrapolate() == data.xExtrapolate() &&
                this->yExtrapolate() == data.yExtrapolate();
     }
@@ -156,7 +195,7 @@ public:
      * \brief Returns the value of a sampling point.
      */
     Scalar valueAt(size_t i, size_t j) const
-    { return samples_[i][j]; }
+    { return samples_[i*numY() + j]; }
 
     /*!
      * \brief Returns true if a coordinate lies in the tabulated range
@@ -186,31 +225,70 @@ public:
      * If this method is called for a value outside of the tabulated
      * range, and extrapolation is not allowed in the corresponding direction,
      * a \c Opm::NumericalIssue exception is thrown.
+     *
+     * For automatic differentiation, the derivatives of the result are computed from
+     * the gradient returned by evalWithGradient() instead of propagating them through
+     * the interpolation.
      */
     template <typename Evaluation>
     Evaluation eval(const Evaluation& x, const Evaluation& y) const
+    {
+        const Scalar xv = scalarValue(x);
+        const Scalar yv = scalarValue(y);
+        Scalar dfdx;
+        Scalar dfdy;
+        const Scalar f = evalWithGradient(xv, yv, dfdx, dfdy);
+
+        // the value part of (x - xv) and (y - yv) is exactly zero. the constant is added
+        // last because evaluations with a dynamic number of derivatives cannot be
+        // created from a scalar alone
+        return (x - xv)*dfdx + (y - yv)*dfdy + f;
+    }
+
+    /*!
+     * \brief Evaluate the function and its partial derivatives at a given (x,y) position.
+     *
+     * All quantities are computed from the four sampling points of the interpolation
+     * cell. If the position is outside of the tabulated range and extrapolation is not
+     * allowed in the corresponding direction, a \c Opm::NumericalIssue exception is
+     * thrown.
+     */
+    Scalar evalWithGradient(Scalar x, Scalar y, Scalar& dfdx, Scalar& dfdy) const
     {
         if ((!xExtrapolate_ && !appliesX(x)) || (!yExtrapolate_ && !appliesY(y))) {
             std::ostringstream oss;
             oss << "Attempt to get undefined table value (" << x << ", " << y << ")";
             throw NumericalIssue(oss.str());
         };
+        OPM_INSTRUMENT_LOOKUP("IntervalTabulated2DFunction", "eval", !applies(x, y));
 
         // bi-linear interpolation: first, calculate the x and y indices in the lookup
         // table ...
         const unsigned i = xSegmentIndex_(x);
         const unsigned j = ySegmentIndex_(y);
 
-        // bi-linear interpolation / extrapolation
-        const Evaluation alpha = xToAlpha(x, i);
-        const Evaluation beta = yToBeta(y, j);
+        const Scalar dx = xPos_[i + 1] - xPos_[i];
+        const Scalar dy = yPos_[j + 1] - yPos_[j];
+        const Scalar alpha = (x - xPos_[i])/dx;
+        const Scalar beta = (y - yPos_[j])/dy;
+
+        const Scalar* row1 = samples_.data() + i*numY() + j;
+        const Scalar* row2 = row1 + numY();
+        const Scalar f11 = row1[0];
+        const Scalar f12 = row1[1];
+        const Scalar f21 = row2[0];
+        const Scalar f22 = row2[1];
 
-        const Evaluation s1 = valueAt(i, j) * (1.0 - beta) + valueAt(i, j + 1) * beta;
-        const Evaluation s2 = valueAt(i + 1, j) * (1.0 - beta) + valueAt(i + 1, j + 1) * beta;
+        // bi-linear interpolation / extrapolation
+        const Scalar s1 = f11*(1.0 - beta) + f12*beta;
+        const Scalar s2 = f21*(1.0 - beta) + f22*beta;
 
         Valgrind::CheckDefined(s1);
         Valgrind::CheckDefined(s2);
 
+        dfdx = (s2 - s1)/dx;
+        dfdy = ((f12 - f11)*(1.0 - alpha) + (f22 - f21)*alpha)/dy;
+
         // ... and combine them using the x position
         return s1*(1.0 - alpha) + s2*alpha;
     }
@@ -220,8 +298,13 @@ private:
     std::vector<Scalar> xPos_;
     // the sampling points in the y-drection
     std::vector<Scalar> yPos_;
-    // data at the sampling points
-    std::vector<std::vector<Scalar> > samples_;
+    // data at the sampling points, row-major with one row per x position
+    std::vector<Scalar> samples_;
+
+    // the inverse distance between the sampling points if they are equidistant, zero
+    // otherwise
+    Scalar xInvSpacing_ = 0.0;
+    Scalar yInvSpacing_ = 0.0;
 
     bool xExtrapolate_ = false;
     bool yExtrapolate_ = false;
@@ -229,28 +312,40 @@ private:
     /*!
      * \brief Return the interval index of a given position on the x-axis.
      */
-    template <class Evaluation>
-    unsigned xSegmentIndex_(const Evaluation& x) const
+    unsigned xSegmentIndex_(Scalar x) const
     {
         assert(xExtrapolate_ || appliesX(x) );
 
-        return segmentIndex_(x, xPos_);
+        return segmentIndex_(x, xPos_, xInvSpacing_);
     }
 
     /*!
      * \brief Return the interval index of a given position on the y-axis.
      */
-    template <class Evaluation>
-    unsigned ySegmentIndex_(const Evaluation& y) const
+    unsigned ySegmentIndex_(Scalar y) const
     {
         assert(yExtrapolate_ || appliesY(y) );
 
-        return segmentIndex_(y, yPos_);
+        return segmentIndex_(y, yPos_, yInvSpacing_);
     }
 
+    // returns the inverse spacing of equidistant sampling points or zero
+    static Scalar uniformInvSpacing_(const std::vector<Scalar>& vPos)
+    {
+        const size_t n = vPos.size();
+        if (n < 3)
+            return 0.0;
 
-    template <class Evaluation>
-    static unsigned segmentIndex_(const Evaluation& v, const std::vector<Scalar>& vPos)
+        const Scalar h = (vPos.back() - vPos.front())/(n - 1);
+        const Scalar tol = 1e-3*h;
+        for (size_t i = 1; i < n - 1; ++i)
+            if (std::abs(vPos[i] - (vPos.front() + i*h)) > tol)
+                return 0.0;
+
+        return 1.0/h;
+    }
+
+    static unsigned segmentIndex_(Scalar v, const std::vector<Scalar>& vPos, Scalar invSpacing)
     {
         const unsigned n = vPos.size();
         assert(n >= 2);
@@ -262,6 +357,17 @@ private:
 
         assert(n > 2 && v > vPos.front() && v < vPos.back());
 
+        if (invSpacing > 0.0) {
+            // equidistant sampling points: the spacing may differ slightly from the
+            // one of the actual points, so correct the index by at most one position
+            unsigned idx = std::min(static_cast<unsigned>((v - vPos.front())*invSpacing), n - 2);
+            if (v < vPos[idx])
+                --idx;
+            else if (idx + 2 < n && v >= vPos[idx + 1])
+                ++idx;
+            return idx;
+        }
+
         // bisection. this assumes that the vPos array is strictly mononically
         // increasing.
         size_t lowerIdx = 0;
@@ -278,35 +384,6 @@ private:
         assert(v <= vPos[lowerIdx + 1]);
         return lowerIdx;
     }
-
-    /*!
-     * \brief Return the relative position of an x value in an intervall
-     *
-     * The returned value can be larger than 1 or smaller than zero if it is outside of
-     * the range of the segment. In particular this happens for the extrapolation case.
-     */
-    template <class Evaluation>
-    Evaluation xToAlpha(const Evaluation& x, unsigned xSegmentIdx) const
-    {
-        Scalar x1 = xPos_[xSegmentIdx];
-        Scalar x2 = xPos_[xSegmentIdx + 1];
-        return (x - x1)/(x2 - x1);
-    }
-
-    /*!
-     * \brief Return the relative position of an y value in an interval
-     *
-     * The returned value can be larger than 1 or smaller than zero if it is outside of
-     * the range of the segment. In particular this happens for the extrapolation case.
-     */
-    template <class Evaluation>
-    Evaluation yToBeta(const Evaluation& y, unsigned ySegmentIdx) const
-    {
-        Scalar y1 = yPos_[ySegmentIdx];
-        Scalar y2 = yPos_[ySegmentIdx + 1];
-        return (y - y1)/(y2 - y1);
-    }
-
 };
 } // namespace Opm
 
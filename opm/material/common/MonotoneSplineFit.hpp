@@ -0,0 +1,185 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::fitMonotoneSpline
+ */
+#ifndef OPM_MONOTONE_SPLINE_FIT_HPP
+#define OPM_MONOTONE_SPLINE_FIT_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace Opm {
+
+// the derivative at sampling point i of the parabola through it and its neighbors
+template <class Scalar>
+Scalar parabolicSlope_(const std::vector<Scalar>& x, const std::vector<Scalar>& y, std::size_t i)
+{
+    const std::size_t n = x.size();
+    if (n == 2)
+        return (y[1] - y[0])/(x[1] - x[0]);
+
+    // use one-sided parabolas at the end points
+    std::size_t a = (i == 0) ? 0 : ((i == n - 1) ? n - 3 : i - 1);
+    Scalar x0 = x[a], x1 = x[a + 1], x2 = x[a + 2];
+    Scalar xi = x[i];
+    return
+        y[a]*(2*xi - x1 - x2)/((x0 - x1)*(x0 - x2))
+        + y[a + 1]*(2*xi - x0 - x2)/((x1 - x0)*(x1 - x2))
+        + y[a + 2]*(2*xi - x0 - x1)/((x2 - x0)*(x2 - x1));
+}
+
+/*!
+ * \brief Select a subset of sampling points such that a monotonicity preserving cubic
+ *        spline through them reproduces all sampling points within a given tolerance.
+ *
+ * The fit starts with the first and the last sampling point. As long as the spline
+ * misses any of the sampling points by more than the tolerance, the worst fitted
+ * sampling point of each offending segment is added and the spline is recomputed.
+ *
+ * The spline is a cubic Hermite spline. Its slopes are the derivatives of the
+ * parabolas through the original sampling points, limited by the method of Fritsch
+ * and Carlson which is also used by Spline::Monotonic, i.e., the spline is monotonic
+ * wherever the selected points are. Since the slopes are estimated from the dense
+ * data, they are second order accurate and thus much fewer points are required than
+ * for slopes which are derived from the selected points alone.
+ *
+ * \param x The sorted x values of the sampling points
+ * \param y The y values of the sampling points
+ * \param tolerance The maximum deviation of the spline from the sampling points,
+ *                  relative to the largest absolute y value
+ * \param xFit Receives the x values of the selected sampling points
+ * \param yFit Receives the y values of the selected sampling points
+ * \param slopesFit Receives the slopes of the spline at the selected sampling points
+ */
+template <class Scalar>
+void fitMonotoneSpline(const std::vector<Scalar>& x,
+                       const std::vector<Scalar>& y,
+                       Scalar tolerance,
+                       std::vector<Scalar>& xFit,
+                       std::vector<Scalar>& yFit,
+                       std::vector<Scalar>& slopesFit)
+{
+    assert(x.size() == y.size());
+
+    const std::size_t n = x.size();
+    if (n < 2) {
+        // nothing to fit
+        xFit = x;
+        yFit = y;
+        slopesFit.assign(n, 0.0);
+        return;
+    }
+
+    Scalar yMax = 0.0;
+    for (const auto& yi : y)
+        yMax = std::max(yMax, std::abs(yi));
+    const Scalar absTolerance = yMax > 0.0 ? tolerance*yMax : tolerance;
+
+    std::vector<std::size_t> knots = {0, n - 1};
+    std::vector<Scalar> slopes;
+    while (true) {
+        const std::size_t numKnots = knots.size();
+        slopes.resize(numKnots);
+        for (std::size_t k = 0; k < numKnots; ++k)
+            slopes[k] = parabolicSlope_(x, y, knots[k]);
+
+        // make the slopes consistent with the secants of the selected points
+        for (std::size_t k = 0; k + 1 < numKnots; ++k) {
+            Scalar delta = (y[knots[k + 1]] - y[knots[k]])/(x[knots[k + 1]] - x[knots[k]]);
+            if (delta == 0.0) {
+                slopes[k] = 0.0;
+                slopes[k + 1] = 0.0;
+                continue;
+            }
+
+            Scalar alpha = slopes[k]/delta;
+            Scalar beta = slopes[k + 1]/delta;
+            if (alpha < 0.0) {
+                slopes[k] = 0.0;
+                alpha = 0.0;
+            }
+            if (beta < 0.0) {
+                slopes[k + 1] = 0.0;
+                beta = 0.0;
+            }
+
+            // limit (alpha, beta) to a circle of radius 3
+            if (alpha*alpha + beta*beta > 3*3) {
+                Scalar tau = 3.0/std::sqrt(alpha*alpha + beta*beta);
+                slopes[k] = tau*alpha*delta;
+                slopes[k + 1] = tau*beta*delta;
+            }
+        }
+
+        // find the worst fitted sampling point of each segment
+        std::vector<std::size_t> newKnots;
+        for (std::size_t k = 0; k + 1 < numKnots; ++k) {
+            Scalar x0 = x[knots[k]];
+            Scalar y0 = y[knots[k]];
+            Scalar h = x[knots[k + 1]] - x0;
+            Scalar dy = y[knots[k + 1]] - y0;
+            Scalar c1 = h*slopes[k];
+            Scalar c2 = 3*dy - 2*h*slopes[k] - h*slopes[k + 1];
+            Scalar c3 = -2*dy + h*slopes[k] + h*slopes[k + 1];
+
+            Scalar maxError = absTolerance;
+            std::size_t worstIdx = 0;
+            for (std::size_t i = knots[k] + 1; i < knots[k + 1]; ++i) {
+                Scalar t = (x[i] - x0)/h;
+                Scalar error = std::abs(y0 + t*(c1 + t*(c2 + t*c3)) - y[i]);
+                if (!(error <= maxError)) {
+                    maxError = error;
+                    worstIdx = i;
+                }
+            }
+            if (worstIdx > 0)
+                newKnots.push_back(worstIdx);
+        }
+
+        if (newKnots.empty())
+            break;
+
+        std::vector<std::size_t> tmp;
+        tmp.reserve(knots.size() + newKnots.size());
+        std::merge(knots.begin(), knots.end(), newKnots.begin(), newKnots.end(), std::back_inserter(tmp));
+        knots.swap(tmp);
+    }
+
+    xFit.resize(knots.size());
+    yFit.resize(knots.size());
+    for (std::size_t k = 0; k < knots.size(); ++k) {
+        xFit[k] = x[knots[k]];
+        yFit[k] = y[knots[k]];
+    }
+    slopesFit.swap(slopes);
+}
+
+} // namespace Opm
+
+#endif
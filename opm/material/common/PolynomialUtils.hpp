@@ -29,6 +29,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 #include <opm/material/common/MathToolbox.hpp>
 
@@ -309,6 +310,165 @@ unsigned invertCubicPolynomial(SolContainer* sol,
 
     return 3;
 }
+
+//! \cond SKIP_THIS
+// find the real root of a monic cubic polynomial which lies in a region where the
+// polynomial is monotonically increasing and does not change its curvature. the
+// starting point x must be right of the root if the polynomial is convex there and
+// left of it if it is concave, so that Newton's method does not overshoot.
+template <class Scalar>
+Scalar monotonicCubicNewton_(Scalar x,
+                             Scalar b,
+                             Scalar c,
+                             Scalar d)
+{
+    for (unsigned i = 0; i < 100; ++i) {
+        Scalar f = d + x*(c + x*(b + x));
+        Scalar fPrime = c + x*(2*b + 3*x);
+        if (f == 0.0 || fPrime == 0.0)
+            break;
+
+        Scalar delta = f/fPrime;
+        x -= delta;
+        if (std::abs(delta) <= 1e2*std::numeric_limits<Scalar>::epsilon()*std::max<Scalar>(1.0, std::abs(x)))
+            break;
+    }
+
+    return x;
+}
+
+// find the middle root of a monic cubic polynomial which exhibits three real roots.
+// xLeft and xRight must be the local maximum and the local minimum of the
+// polynomial, i.e., the polynomial is decreasing in between and p(xLeft) >= 0 >=
+// p(xRight) holds. Newton's method is safeguarded by bisection: the interval which
+// brackets the root is shrunk in every iteration and steps which leave it or which do
+// not reduce the distance to the root quickly enough are replaced by bisection steps.
+// this is required if the root is close to one of the outer ones because the slope
+// of the polynomial is then small at the root.
+template <class Scalar>
+Scalar bracketedCubicNewton_(Scalar x,
+                             Scalar xLeft,
+                             Scalar xRight,
+                             Scalar b,
+                             Scalar c,
+                             Scalar d)
+{
+    Scalar lastDelta = xRight - xLeft;
+    for (unsigned i = 0; i < 200; ++i) {
+        Scalar f = d + x*(c + x*(b + x));
+        if (f == 0.0)
+            break;
+        else if (f > 0.0)
+            xLeft = x;
+        else
+            xRight = x;
+
+        Scalar fPrime = c + x*(2*b + 3*x);
+        Scalar xNew = x - f/fPrime;
+        if (!(fPrime < 0.0)
+            || !(xLeft < xNew && xNew < xRight)
+            || 2*std::abs(xNew - x) > std::abs(lastDelta))
+        {
+            xNew = (xLeft + xRight)/2;
+        }
+
+        lastDelta = xNew - x;
+        x = xNew;
+        if (xRight - xLeft <= 4*std::numeric_limits<Scalar>::epsilon()*std::max(std::abs(xLeft), std::abs(xRight))
+            || lastDelta == 0.0)
+            break;
+    }
+
+    return x;
+}
+//! \endcond
+
+/*!
+ * \ingroup Math
+ * \brief Invert a monic cubic polynomial without trigonometric functions
+ *
+ * The polynomial is defined as
+ * \f[ p(x) = x^3 + b\;x^2 + c\;x + d \f]
+ *
+ * In contrast to invertCubicPolynomial(), this function only works on plain
+ * floating point values: The roots are isolated using the extrema and the
+ * inflection point of the polynomial and then determined by Newton's method,
+ * which converges monotonically for the chosen starting points of the outer roots
+ * and which is safeguarded by bisection for the middle one. If the
+ * derivatives of the roots are required, they can be obtained by the implicit
+ * function theorem, i.e. \f$\partial x = - \partial p / p'(x)\f$.
+ *
+ * This method returns the number of solutions which are in the real numbers,
+ * i.e., either 1 or 3. The "sol" argument contains the real roots of the cubic
+ * polynomial in order with the smallest root first. (double roots are returned
+ * twice.)
+ *
+ * \param sol Container into which the solutions are written
+ * \param b The coefficient for the quadratic term
+ * \param c The coefficient for the linear term
+ * \param d The coefficient for the constant term
+ */
+template <class Scalar, class SolContainer>
+unsigned invertMonicCubicPolynomial(SolContainer* sol,
+                                    Scalar b,
+                                    Scalar c,
+                                    Scalar d)
+{
+    const auto p = [b, c, d](Scalar x) { return d + x*(c + x*(b + x)); };
+
+    // for the cubic, p(x0 + t) = p(x0) + p'(x0)*t + p''(x0)/2*t^2 + t^3 holds. if
+    // x0 is a point where p'' >= 0 and p' >= 0 (or p'' <= 0 and p' >= 0), the
+    // distance of the root to x0 is thus bounded by the cube root of |p(x0)|.
+    // starting at this bound, Newton's method cannot overshoot.
+    const Scalar xInflection = -b/3;
+    const Scalar slopeInflection = c - b*b/3;
+    if (slopeInflection >= 0.0) {
+        // the polynomial is monotonic: a single real root
+        const Scalar pInflection = p(xInflection);
+        if (pInflection == 0.0)
+            sol[0] = xInflection;
+        else
+            sol[0] = monotonicCubicNewton_(xInflection - std::cbrt(pInflection), b, c, d);
+        return 1;
+    }
+
+    // the polynomial exhibits a local maximum at x1 and a local minimum at x2
+    const Scalar halfWidth = std::sqrt(-slopeInflection/3);
+    const Scalar x1 = xInflection - halfWidth;
+    const Scalar x2 = xInflection + halfWidth;
+    const Scalar p1 = p(x1);
+    const Scalar p2 = p(x2);
+
+    if (p2 > 0.0) {
+        // only a single root left of the maximum
+        sol[0] = monotonicCubicNewton_(x1 - std::cbrt(p1), b, c, d);
+        return 1;
+    }
+    else if (p1 < 0.0) {
+        // only a single root right of the minimum
+        sol[0] = monotonicCubicNewton_(x2 + std::cbrt(-p2), b, c, d);
+        return 1;
+    }
+
+    // three real roots. the outer ones are found by Newton's method. the middle one is
+    // bracketed by the extrema and found by safeguarded Newton iterations starting at
+    // the estimate given by Vieta's formula. if two roots are almost identical,
+    // rounding errors may let the iterations for the outer roots cross the extrema, so
+    // the results are clamped to the respective intervals.
+    sol[0] = (p1 == 0.0)?x1:std::min(x1, monotonicCubicNewton_(x1 - std::cbrt(p1), b, c, d));
+    sol[2] = (p2 == 0.0)?x2:std::max(x2, monotonicCubicNewton_(x2 + std::cbrt(-p2), b, c, d));
+
+    Scalar xMid;
+    if (p1 == 0.0)
+        xMid = x1;
+    else if (p2 == 0.0)
+        xMid = x2;
+    else
+        xMid = bracketedCubicNewton_(std::min(x2, std::max(x1, -b - sol[0] - sol[2])), x1, x2, b, c, d);
+    sol[1] = xMid;
+
+    return 3;
+}
 }
 
 #endif
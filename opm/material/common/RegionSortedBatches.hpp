@@ -0,0 +1,217 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::RegionSortedBatches
+ */
+#ifndef OPM_REGION_SORTED_BATCHES_HPP
+#define OPM_REGION_SORTED_BATCHES_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Groups cells by their PVT and saturation function regions.
+ *
+ * If cells of many regions are interleaved, evaluating the properties in the order of
+ * the cells switches between the tables of different regions all the time. This class
+ * computes a stable permutation which sorts the cells by (PVT region, saturation
+ * region) and splits it into batches of cells which use the same tables. Iterating
+ * over the batches thus touches the tables of one region after another.
+ *
+ * The permutation only needs to be computed once, or after the cells have been
+ * repartitioned. Since the callbacks get the original cell indices, the results can be
+ * written to their final location directly. Alternatively, gather() and scatter()
+ * convert between arrays in cell order and arrays in region order.
+ */
+class RegionSortedBatches
+{
+public:
+    /*!
+     * \brief A range of cells which all belong to the same regions.
+     */
+    struct Batch
+    {
+        unsigned pvtRegionIdx;
+        unsigned satRegionIdx;
+
+        //! The range of the batch within order()
+        unsigned begin;
+        unsigned end;
+
+        unsigned size() const
+        { return end - begin; }
+    };
+
+    RegionSortedBatches()
+    {}
+
+    /*!
+     * \brief Compute the batches for the given region indices.
+     */
+    template <class PvtRegionContainer, class SatRegionContainer>
+    RegionSortedBatches(const PvtRegionContainer& pvtRegionIdx,
+                        const SatRegionContainer& satRegionIdx)
+    { update(pvtRegionIdx, satRegionIdx); }
+
+    /*!
+     * \brief Compute the batches for the given region indices.
+     *
+     * Both containers are indexed by the cell index. Either of them may be empty, in
+     * which case all cells are considered to belong to region 0.
+     */
+    template <class PvtRegionContainer, class SatRegionContainer>
+    void update(const PvtRegionContainer& pvtRegionIdx,
+                const SatRegionContainer& satRegionIdx)
+    {
+        const std::size_t numCells = std::max<std::size_t>(pvtRegionIdx.size(), satRegionIdx.size());
+        if ((!pvtRegionIdx.empty() && pvtRegionIdx.size() != numCells)
+            || (!satRegionIdx.empty() && satRegionIdx.size() != numCells))
+            throw std::invalid_argument("The region arrays must exhibit the same size");
+
+        pvtRegion_.assign(numCells, 0);
+        satRegion_.assign(numCells, 0);
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            if (!pvtRegionIdx.empty())
+                pvtRegion_[cellIdx] = static_cast<unsigned>(pvtRegionIdx[cellIdx]);
+            if (!satRegionIdx.empty())
+                satRegion_[cellIdx] = static_cast<unsigned>(satRegionIdx[cellIdx]);
+        }
+
+        order_.resize(numCells);
+        std::iota(order_.begin(), order_.end(), 0u);
+        std::stable_sort(order_.begin(), order_.end(),
+                         [this](unsigned a, unsigned b) {
+                             if (pvtRegion_[a] != pvtRegion_[b])
+                                 return pvtRegion_[a] < pvtRegion_[b];
+                             return satRegion_[a] < satRegion_[b];
+                         });
+
+        batches_.clear();
+        for (unsigned i = 0; i < numCells; ++i) {
+            const unsigned cellIdx = order_[i];
+            if (batches_.empty()
+                || batches_.back().pvtRegionIdx != pvtRegion_[cellIdx]
+                || batches_.back().satRegionIdx != satRegion_[cellIdx])
+            {
+                Batch batch;
+                batch.pvtRegionIdx = pvtRegion_[cellIdx];
+                batch.satRegionIdx = satRegion_[cellIdx];
+                batch.begin = i;
+                batch.end = i;
+                batches_.push_back(batch);
+            }
+            ++batches_.back().end;
+        }
+    }
+
+    //! The number of cells
+    unsigned numCells() const
+    { return order_.size(); }
+
+    //! The cell indices in region order
+    const std::vector<unsigned>& order() const
+    { return order_; }
+
+    //! The batches of cells which belong to the same regions
+    const std::vector<Batch>& batches() const
+    { return batches_; }
+
+    /*!
+     * \brief Call a function for each batch.
+     *
+     * The function is called with the batch object and a pointer to the first
+     * of its cell indices.
+     */
+    template <class Fn>
+    void forEachBatch(Fn&& fn) const
+    {
+        for (const auto& batch : batches_)
+            fn(batch, order_.data() + batch.begin);
+    }
+
+    /*!
+     * \brief Call a function for each cell in region order.
+     *
+     * The function is called with the cell index, the PVT region index and the
+     * saturation region index of the cell.
+     */
+    template <class Fn>
+    void forEachCell(Fn&& fn) const
+    { forEachCell(0, batches_.size(), fn); }
+
+    /*!
+     * \brief Call a function for each cell of a range of batches.
+     *
+     * This allows to distribute the batches among several threads.
+     */
+    template <class Fn>
+    void forEachCell(unsigned beginBatchIdx, unsigned endBatchIdx, Fn&& fn) const
+    {
+        assert(endBatchIdx <= batches_.size());
+        for (unsigned batchIdx = beginBatchIdx; batchIdx < endBatchIdx; ++batchIdx) {
+            const Batch& batch = batches_[batchIdx];
+            for (unsigned i = batch.begin; i < batch.end; ++i)
+                fn(order_[i], batch.pvtRegionIdx, batch.satRegionIdx);
+        }
+    }
+
+    /*!
+     * \brief Copy an array which is indexed by cells into region order.
+     */
+    template <class T>
+    void gather(const std::vector<T>& cellValues, std::vector<T>& sortedValues) const
+    {
+        assert(cellValues.size() == order_.size());
+        sortedValues.resize(order_.size());
+        for (unsigned i = 0; i < order_.size(); ++i)
+            sortedValues[i] = cellValues[order_[i]];
+    }
+
+    /*!
+     * \brief Copy an array which is in region order back to cell order.
+     */
+    template <class T>
+    void scatter(const std::vector<T>& sortedValues, std::vector<T>& cellValues) const
+    {
+        assert(sortedValues.size() == order_.size());
+        cellValues.resize(order_.size());
+        for (unsigned i = 0; i < order_.size(); ++i)
+            cellValues[order_[i]] = sortedValues[i];
+    }
+
+private:
+    std::vector<unsigned> pvtRegion_;
+    std::vector<unsigned> satRegion_;
+    std::vector<unsigned> order_;
+    std::vector<Batch> batches_;
+};
+
+} // namespace Opm
+
+#endif
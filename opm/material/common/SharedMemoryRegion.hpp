@@ -0,0 +1,377 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SharedMemoryRegion
+ */
+#ifndef OPM_SHARED_MEMORY_REGION_HPP
+#define OPM_SHARED_MEMORY_REGION_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm {
+
+/*!
+ * \brief A named POSIX shared memory segment for immutable tables.
+ *
+ * All processes on a node which open a region of the same name get the same memory.
+ * The process which manages to create the segment is its owner: it is expected to
+ * fill the payload and then call markReady(). All other processes map the segment
+ * read-only and block in the constructor until the owner has marked it as ready.
+ *
+ * Besides the size of the payload, the header of the segment stores a key which
+ * identifies the layout of the payload, e.g. a hash of the parameters which were used
+ * to compute it (see hash()). Attaching to a segment with a different key fails, so a
+ * segment which was left over by a run with other parameters is never used silently.
+ *
+ * The header also stores the process id of the owner. If the owner dies before the
+ * payload is complete, the waiting processes remove the stale segment and one of them
+ * takes over. This requires that all processes live in the same PID namespace, which is
+ * the case for the MPI ranks of a node.
+ *
+ * The owner removes the name of the segment when the region object is destroyed;
+ * processes which are already attached keep their mapping. Depending on the C
+ * library, linking against librt may be required for shm_open().
+ */
+class SharedMemoryRegion
+{
+    enum State_ : std::uint32_t {
+        Filling_ = 0,
+        Ready_ = 1,
+        Abandoned_ = 2
+    };
+
+    struct Header_
+    {
+        std::atomic<std::uint32_t> state;
+        std::uint32_t magic;
+        std::uint64_t payloadSize;
+        std::uint64_t layoutKey;
+        std::int64_t ownerPid;
+    };
+
+    static const std::uint32_t magicValue_ = 0x4f504d53; // "OPMS"
+    static const std::size_t headerSize_ = 64;
+
+public:
+    /*!
+     * \brief Create a shared memory segment or attach to an existing one.
+     *
+     * \param name The name of the segment. A leading slash is added if necessary.
+     * \param size The size of the payload in bytes.
+     * \param layoutKey Identifies the contents of the payload. All processes which
+     *                  attach to the segment must specify the same key.
+     * \param timeout Number of seconds to wait for the owner to finish the payload.
+     */
+    SharedMemoryRegion(const std::string& name,
+                       std::size_t size,
+                       std::uint64_t layoutKey = 0,
+                       double timeout = 600.0)
+        : name_(name.empty() || name[0] != '/' ? "/" + name : name)
+        , size_(size)
+        , layoutKey_(layoutKey)
+        , isOwner_(false)
+        , mapping_(nullptr)
+    {
+        const auto deadline =
+            std::chrono::steady_clock::now()
+            + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+
+        // retry if the segment was abandoned by its owner
+        while (!open_(deadline))
+        {}
+    }
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    ~SharedMemoryRegion()
+    {
+        if (isOwner_ && mapping_ && header_().state.load(std::memory_order_acquire) != Ready_)
+            // let the waiting processes know that the payload will never be completed
+            header_().state.store(Abandoned_, std::memory_order_release);
+        if (mapping_)
+            munmap(mapping_, headerSize_ + size_);
+        if (isOwner_)
+            shm_unlink(name_.c_str());
+    }
+
+    /*!
+     * \brief Returns true if the calling process created the segment.
+     *
+     * Only the owner may write to the payload.
+     */
+    bool isOwner() const
+    { return isOwner_; }
+
+    /*!
+     * \brief Signal the other processes that the payload is complete.
+     */
+    void markReady()
+    {
+        if (!isOwner_)
+            throw std::logic_error("Only the owner of a shared memory segment can mark it as ready");
+        header_().state.store(Ready_, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Returns a pointer to the payload.
+     *
+     * The memory is read-only for all processes except the owner.
+     */
+    void* data() const
+    { return mapping_ + headerSize_; }
+
+    /*!
+     * \brief The size of the payload in bytes.
+     */
+    std::size_t size() const
+    { return size_; }
+
+    /*!
+     * \brief The key which identifies the layout of the payload.
+     */
+    std::uint64_t layoutKey() const
+    { return layoutKey_; }
+
+    /*!
+     * \brief The name of the segment.
+     */
+    const std::string& name() const
+    { return name_; }
+
+    /*!
+     * \brief Combine the object representation of a value into a layout key.
+     *
+     * This is the 64 bit FNV-1a hash, so the key does not depend on the process
+     * which computes it.
+     */
+    template <class T>
+    static std::uint64_t hash(const T& value, std::uint64_t seed = 14695981039346656037ULL)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be hashed");
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            seed ^= bytes[i];
+            seed *= 1099511628211ULL;
+        }
+        return seed;
+    }
+
+    /*!
+     * \brief Remove a segment which may have been left over by a crashed process.
+     */
+    static void unlink(const std::string& name)
+    {
+        std::string shmName = name.empty() || name[0] != '/' ? "/" + name : name;
+        shm_unlink(shmName.c_str());
+    }
+
+private:
+    static_assert(sizeof(Header_) <= headerSize_, "The header must fit into its reserved space");
+
+    Header_& header_() const
+    { return *reinterpret_cast<Header_*>(mapping_); }
+
+    // create or attach to the segment. returns false if the segment was abandoned by
+    // its owner and the procedure must be repeated.
+    bool open_(std::chrono::steady_clock::time_point deadline)
+    {
+        const std::size_t mappingSize = headerSize_ + size_;
+
+        int fd = -1;
+        while (true) {
+            fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd >= 0) {
+                isOwner_ = true;
+                break;
+            }
+            if (errno != EEXIST)
+                throwErrno_("Could not create shared memory segment");
+
+            fd = shm_open(name_.c_str(), O_RDONLY, 0);
+            if (fd >= 0)
+                break;
+            // the owner may have removed the name in the mean time: try again
+            if (errno != ENOENT)
+                throwErrno_("Could not open shared memory segment");
+        }
+
+        struct stat st = {};
+        if (isOwner_) {
+            if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+                int err = errno;
+                close(fd);
+                shm_unlink(name_.c_str());
+                errno = err;
+                throwErrno_("Could not resize shared memory segment");
+            }
+        }
+        else {
+            // the owner might not have resized the segment yet
+            while (true) {
+                if (fstat(fd, &st) != 0) {
+                    close(fd);
+                    throwErrno_("Could not query shared memory segment");
+                }
+                if (static_cast<std::size_t>(st.st_size) >= mappingSize)
+                    break;
+                if (st.st_size != 0) {
+                    // the owner resizes the segment in one go, so a different
+                    // non-zero size means that it was created for another layout
+                    close(fd);
+                    throw std::runtime_error("Shared memory segment '"+name_+"' has an unexpected size");
+                }
+                waitOrThrow_(fd, deadline);
+            }
+        }
+
+        int prot = isOwner_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* ptr = mmap(nullptr, mappingSize, prot, MAP_SHARED, fd, 0);
+        int err = errno;
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            if (isOwner_)
+                shm_unlink(name_.c_str());
+            errno = err;
+            throwErrno_("Could not map shared memory segment");
+        }
+        mapping_ = static_cast<char*>(ptr);
+
+        if (isOwner_) {
+            Header_* header = new (mapping_) Header_;
+            header->magic = magicValue_;
+            header->payloadSize = size_;
+            header->layoutKey = layoutKey_;
+            header->ownerPid = static_cast<std::int64_t>(getpid());
+            header->state.store(Filling_, std::memory_order_release);
+            return true;
+        }
+
+        // wait until the owner has filled the payload
+        while (true) {
+            std::uint32_t state = header_().state.load(std::memory_order_acquire);
+            if (state == Ready_)
+                break;
+            if (state == Abandoned_ || !ownerAlive_()) {
+                unmap_();
+                if (state != Abandoned_)
+                    // the owner died before it could remove the name
+                    unlinkIfSame_(st);
+                return false;
+            }
+
+            try {
+                waitOrThrow_(-1, deadline);
+            }
+            catch (...) {
+                unmap_();
+                throw;
+            }
+        }
+
+        if (header_().magic != magicValue_ || header_().payloadSize != size_) {
+            unmap_();
+            throw std::runtime_error("Shared memory segment '"+name_+"' does not match the requested layout");
+        }
+        if (header_().layoutKey != layoutKey_) {
+            unmap_();
+            throw std::runtime_error("Shared memory segment '"+name_+"' was created with different parameters");
+        }
+
+        return true;
+    }
+
+    // the process id of the owner is written right after the segment has been mapped;
+    // an owner which did not get this far cannot be detected.
+    bool ownerAlive_() const
+    {
+        pid_t pid = static_cast<pid_t>(header_().ownerPid);
+        if (pid <= 0)
+            return true;
+        return kill(pid, 0) == 0 || errno != ESRCH;
+    }
+
+    // remove the name only if it still refers to the stale segment, i.e., if none of
+    // the other waiting processes did so and took over already
+    void unlinkIfSame_(const struct stat& staleStat) const
+    {
+        int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return;
+        struct stat st;
+        bool isSame =
+            fstat(fd, &st) == 0
+            && st.st_dev == staleStat.st_dev
+            && st.st_ino == staleStat.st_ino;
+        close(fd);
+        if (isSame)
+            shm_unlink(name_.c_str());
+    }
+
+    void unmap_()
+    {
+        munmap(mapping_, headerSize_ + size_);
+        mapping_ = nullptr;
+    }
+
+    void waitOrThrow_(int fd, std::chrono::steady_clock::time_point deadline) const
+    {
+        if (std::chrono::steady_clock::now() > deadline) {
+            if (fd >= 0)
+                close(fd);
+            throw std::runtime_error("Timeout while waiting for shared memory segment '"+name_+"'");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    [[noreturn]] void throwErrno_(const std::string& what) const
+    { throw std::runtime_error(what+" '"+name_+"': "+std::strerror(errno)); }
+
+    std::string name_;
+    std::size_t size_;
+    std::uint64_t layoutKey_;
+    bool isOwner_;
+    char* mapping_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,162 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SharedTables
+ */
+#ifndef OPM_SHARED_TABLES_HPP
+#define OPM_SHARED_TABLES_HPP
+
+#include <opm/material/common/BinarySerializer.hpp>
+#include <opm/material/common/SharedMemoryRegion.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief Places the table arrays of serializable objects in shared memory.
+ *
+ * All processes of a node construct a SharedTables object with the same name. The
+ * first one becomes the owner: it initializes the objects, serializes them and copies
+ * the elements of all their table arrays (see TableArray) into a shared memory
+ * segment. Then all processes, including the owner, deserialize the objects such that
+ * their table arrays refer to the shared segment instead of private copies. The
+ * processes which are not the owner do not need to initialize the objects at all.
+ *
+ * The objects are accessed by a function which calls a serializer on them, e.g.
+ *
+ * \code
+ * SharedTables tables("my-tables", layoutKey,
+ *                     [&]() { initTables(); },
+ *                     [&](BinarySerializer& serializer) { tables.serializeOp(serializer); });
+ * \endcode
+ *
+ * The segment is used as long as the SharedTables object lives, so it must not be
+ * destroyed before the objects. Two segments are used: "<name>" stores the sizes of
+ * the data and "<name>-data" the table arrays followed by the remaining serialized
+ * data.
+ */
+class SharedTables
+{
+    struct Sizes_
+    {
+        std::uint64_t arraysSize;
+        std::uint64_t objectSize;
+    };
+
+public:
+    /*!
+     * \brief Create the shared tables or attach to them.
+     *
+     * \param name The name of the segment.
+     * \param layoutKey Identifies the layout of the objects, see SharedMemoryRegion.
+     * \param init Initializes the objects. Only called by the owner.
+     * \param serialize Calls the given serializer on the objects.
+     * \param timeout Number of seconds to wait for the owner.
+     */
+    template <class InitFn, class SerializeFn>
+    SharedTables(const std::string& name,
+                 std::uint64_t layoutKey,
+                 InitFn&& init,
+                 SerializeFn&& serialize,
+                 double timeout = 600.0)
+        : control_(new SharedMemoryRegion(name, sizeof(Sizes_), layoutKey, timeout))
+    {
+        const std::string dataName = name + "-data";
+
+        Sizes_ sizes;
+        if (control_->isOwner()) {
+            // remove data which was left over by a crashed owner
+            SharedMemoryRegion::unlink(dataName);
+
+            init();
+
+            BinarySerializer writer;
+            writer.enableSharedArrays();
+            serialize(writer);
+
+            const std::vector<char>& arrays = writer.sharedArrays();
+            const std::vector<char>& object = writer.buffer();
+            sizes.arraysSize = arrays.size();
+            sizes.objectSize = object.size();
+
+            data_.reset(new SharedMemoryRegion(dataName, arrays.size() + object.size(), layoutKey, timeout));
+            if (!data_->isOwner())
+                throw std::runtime_error("Shared memory segment '"+dataName+"' is already in use");
+            char* dest = static_cast<char*>(data_->data());
+            std::memcpy(dest, arrays.data(), arrays.size());
+            std::memcpy(dest + arrays.size(), object.data(), object.size());
+            data_->markReady();
+
+            std::memcpy(control_->data(), &sizes, sizeof(sizes));
+        }
+        else {
+            std::memcpy(&sizes, control_->data(), sizeof(sizes));
+
+            data_.reset(new SharedMemoryRegion(dataName, sizes.arraysSize + sizes.objectSize, layoutKey, timeout));
+            if (data_->isOwner())
+                throw std::runtime_error("The owner of shared memory segment '"+dataName+"' vanished");
+        }
+
+        // replace the private tables by views of the shared ones
+        const char* src = static_cast<const char*>(data_->data());
+        BinarySerializer reader(std::vector<char>(src + sizes.arraysSize,
+                                                  src + sizes.arraysSize + sizes.objectSize));
+        reader.setSharedArrays(src, sizes.arraysSize);
+        serialize(reader);
+        if (reader.remaining() != 0)
+            throw std::runtime_error("Shared memory segment '"+dataName+"' does not match the objects");
+
+        if (control_->isOwner())
+            control_->markReady();
+    }
+
+    SharedTables(const SharedTables&) = delete;
+    SharedTables& operator=(const SharedTables&) = delete;
+
+    /*!
+     * \brief Returns true if the calling process initialized the tables.
+     */
+    bool isOwner() const
+    { return control_->isOwner(); }
+
+    /*!
+     * \brief The size of the shared data in bytes.
+     */
+    std::size_t size() const
+    { return data_->size(); }
+
+private:
+    std::unique_ptr<SharedMemoryRegion> control_;
+    std::unique_ptr<SharedMemoryRegion> data_;
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,458 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::SimdPack
+ */
+#ifndef OPM_SIMD_PACK_HPP
+#define OPM_SIMD_PACK_HPP
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \brief The result of a lane-wise comparison of two SIMD packs.
+ *
+ * Masks deliberately cannot be converted to bool: branches on packed values must be
+ * expressed using select() or by explicitly reducing the mask with all(), any() or
+ * none().
+ */
+template <unsigned widthV>
+class SimdMask
+{
+public:
+    static const unsigned width = widthV;
+
+    SimdMask() = default;
+
+    explicit SimdMask(bool value)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] = value;
+    }
+
+    bool operator[](unsigned laneIdx) const
+    { return lanes_[laneIdx]; }
+
+    bool& operator[](unsigned laneIdx)
+    { return lanes_[laneIdx]; }
+
+    //! Returns true iff the mask is set for all lanes
+    bool all() const
+    {
+        bool result = true;
+        for (unsigned i = 0; i < width; ++i)
+            result = result && lanes_[i];
+        return result;
+    }
+
+    //! Returns true iff the mask is set for at least one lane
+    bool any() const
+    {
+        bool result = false;
+        for (unsigned i = 0; i < width; ++i)
+            result = result || lanes_[i];
+        return result;
+    }
+
+    //! Returns true iff the mask is not set for any lane
+    bool none() const
+    { return !any(); }
+
+    SimdMask operator!() const
+    {
+        SimdMask result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = !lanes_[i];
+        return result;
+    }
+
+    friend SimdMask operator&&(const SimdMask& a, const SimdMask& b)
+    {
+        SimdMask result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = a.lanes_[i] && b.lanes_[i];
+        return result;
+    }
+
+    friend SimdMask operator||(const SimdMask& a, const SimdMask& b)
+    {
+        SimdMask result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = a.lanes_[i] || b.lanes_[i];
+        return result;
+    }
+
+private:
+    bool lanes_[width];
+};
+
+/*!
+ * \brief A fixed number of floating point values which are processed in lock step.
+ *
+ * The intended use is to evaluate the properties of several cells with a single call,
+ * i.e., each lane of the pack corresponds to a cell. Packs can be used as the value
+ * type of DenseAd::Evaluation and are supported by the MathToolbox. All operations
+ * are implemented as simple loops over the lanes which the compiler is expected to
+ * vectorize.
+ *
+ * Comparisons yield a SimdMask instead of a bool, code which branches on the value
+ * of its arguments thus needs to blend the results of both branches using select().
+ *
+ * Of the black-oil PVT relations, DeadOilPvt, DryGasPvt and the WaterPvtMultiplexer
+ * currently accept packs. The oil and gas multiplexers do not compile for packs yet
+ * because LiveOilPvt, WetGasPvt and the CO2 based relations branch on their
+ * arguments.
+ */
+template <class ScalarT, unsigned widthV>
+class SimdPack
+{
+    static_assert(std::is_floating_point<ScalarT>::value,
+                  "SIMD packs can only be composed of floating point values");
+    static_assert(widthV > 0, "SIMD packs must have at least one lane");
+
+public:
+    typedef ScalarT Scalar;
+    typedef SimdMask<widthV> Mask;
+    static const unsigned width = widthV;
+
+    SimdPack() = default;
+
+    /*!
+     * \brief Set all lanes to the same value.
+     */
+    SimdPack(Scalar value)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] = value;
+    }
+
+    /*!
+     * \brief Load the lanes from consecutive memory locations.
+     */
+    static SimdPack load(const Scalar* values)
+    {
+        SimdPack result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = values[i];
+        return result;
+    }
+
+    /*!
+     * \brief Load the lanes from the given indices of an array.
+     */
+    template <class Index>
+    static SimdPack gather(const Scalar* values, const Index* indices)
+    {
+        SimdPack result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = values[indices[i]];
+        return result;
+    }
+
+    /*!
+     * \brief Write the lanes to consecutive memory locations.
+     */
+    void store(Scalar* values) const
+    {
+        for (unsigned i = 0; i < width; ++i)
+            values[i] = lanes_[i];
+    }
+
+    Scalar operator[](unsigned laneIdx) const
+    { return lanes_[laneIdx]; }
+
+    Scalar& operator[](unsigned laneIdx)
+    { return lanes_[laneIdx]; }
+
+    SimdPack operator-() const
+    {
+        SimdPack result;
+        for (unsigned i = 0; i < width; ++i)
+            result.lanes_[i] = -lanes_[i];
+        return result;
+    }
+
+    SimdPack& operator+=(const SimdPack& other)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] += other.lanes_[i];
+        return *this;
+    }
+
+    SimdPack& operator-=(const SimdPack& other)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] -= other.lanes_[i];
+        return *this;
+    }
+
+    SimdPack& operator*=(const SimdPack& other)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] *= other.lanes_[i];
+        return *this;
+    }
+
+    SimdPack& operator/=(const SimdPack& other)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            lanes_[i] /= other.lanes_[i];
+        return *this;
+    }
+
+    // the binary operators are friends so that scalars get broadcast implicitly
+    friend SimdPack operator+(SimdPack a, const SimdPack& b)
+    { return a += b; }
+
+    friend SimdPack operator-(SimdPack a, const SimdPack& b)
+    { return a -= b; }
+
+    friend SimdPack operator*(SimdPack a, const SimdPack& b)
+    { return a *= b; }
+
+    friend SimdPack operator/(SimdPack a, const SimdPack& b)
+    { return a /= b; }
+
+    friend Mask operator<(const SimdPack& a, const SimdPack& b)
+    {
+        Mask result;
+        for (unsigned i = 0; i < width; ++i)
+            result[i] = a.lanes_[i] < b.lanes_[i];
+        return result;
+    }
+
+    friend Mask operator>(const SimdPack& a, const SimdPack& b)
+    { return b < a; }
+
+    friend Mask operator<=(const SimdPack& a, const SimdPack& b)
+    { return !(b < a); }
+
+    friend Mask operator>=(const SimdPack& a, const SimdPack& b)
+    { return !(a < b); }
+
+    friend Mask operator==(const SimdPack& a, const SimdPack& b)
+    {
+        Mask result;
+        for (unsigned i = 0; i < width; ++i)
+            result[i] = a.lanes_[i] == b.lanes_[i];
+        return result;
+    }
+
+    friend Mask operator!=(const SimdPack& a, const SimdPack& b)
+    { return !(a == b); }
+
+    friend std::ostream& operator<<(std::ostream& os, const SimdPack& pack)
+    {
+        os << "[";
+        for (unsigned i = 0; i < width; ++i)
+            os << (i == 0 ? "" : ", ") << pack.lanes_[i];
+        os << "]";
+        return os;
+    }
+
+private:
+    Scalar lanes_[width];
+};
+
+/*!
+ * \brief Blend two packs: Take the lanes of the first pack where the mask is set and
+ *        the ones of the second pack otherwise.
+ */
+template <class Scalar, unsigned width>
+SimdPack<Scalar, width> select(const SimdMask<width>& mask,
+                               const SimdPack<Scalar, width>& a,
+                               const SimdPack<Scalar, width>& b)
+{
+    SimdPack<Scalar, width> result;
+    for (unsigned i = 0; i < width; ++i)
+        result[i] = mask[i] ? a[i] : b[i];
+    return result;
+}
+
+/*!
+ * \brief Returns true if a type is a SIMD pack.
+ */
+template <class T>
+struct IsSimdPack : public std::false_type
+{};
+
+template <class Scalar, unsigned width>
+struct IsSimdPack<SimdPack<Scalar, width> > : public std::true_type
+{};
+
+template <class ScalarT, unsigned width>
+struct MathToolbox<SimdPack<ScalarT, width> >
+{
+private:
+    template <class Fn>
+    static SimdPack<ScalarT, width> apply_(const SimdPack<ScalarT, width>& arg, Fn fn)
+    {
+        SimdPack<ScalarT, width> result;
+        for (unsigned i = 0; i < width; ++i)
+            result[i] = fn(arg[i]);
+        return result;
+    }
+
+    template <class Fn>
+    static SimdPack<ScalarT, width> apply_(const SimdPack<ScalarT, width>& arg1,
+                                           const SimdPack<ScalarT, width>& arg2,
+                                           Fn fn)
+    {
+        SimdPack<ScalarT, width> result;
+        for (unsigned i = 0; i < width; ++i)
+            result[i] = fn(arg1[i], arg2[i]);
+        return result;
+    }
+
+public:
+    typedef ScalarT Scalar;
+    typedef SimdPack<ScalarT, width> ValueType;
+    typedef MathToolbox<Scalar> InnerToolbox;
+
+    static ValueType value(const ValueType& value)
+    { return value; }
+
+    // packs do not exhibit derivatives, their "scalar value" thus is the pack itself
+    static ValueType scalarValue(const ValueType& value)
+    { return value; }
+
+    static ValueType createBlank(const ValueType& value OPM_UNUSED)
+    { return ValueType(); }
+
+    static ValueType createConstant(const ValueType& value)
+    { return value; }
+
+    static ValueType createConstant(unsigned numDerivatives, const ValueType& value)
+    {
+        if (numDerivatives != 0)
+            throw std::logic_error("SIMD packs cannot represent any derivatives");
+        return value;
+    }
+
+    static ValueType createConstant(const ValueType& x OPM_UNUSED, const ValueType& value)
+    { return value; }
+
+    static ValueType createVariable(const ValueType& value OPM_UNUSED, unsigned varIdx OPM_UNUSED)
+    { throw std::logic_error("SIMD packs cannot represent variables"); }
+
+    static ValueType createVariable(const ValueType& x OPM_UNUSED,
+                                    const ValueType& value OPM_UNUSED,
+                                    unsigned varIdx OPM_UNUSED)
+    { throw std::logic_error("SIMD packs cannot represent variables"); }
+
+    template <class LhsEval>
+    static LhsEval decay(const ValueType& value)
+    {
+        static_assert(std::is_same<LhsEval, ValueType>::value,
+                      "SIMD packs can only decay to themselves");
+
+        return value;
+    }
+
+    //! Returns true if all lanes of the two packs are identical up to a tolerance
+    static bool isSame(const ValueType& a, const ValueType& b, Scalar tolerance)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            if (!InnerToolbox::isSame(a[i], b[i], tolerance))
+                return false;
+        return true;
+    }
+
+    ////////////
+    // arithmetic functions
+    ////////////
+
+    static ValueType max(const ValueType& arg1, const ValueType& arg2)
+    { return select(arg1 < arg2, arg2, arg1); }
+
+    static ValueType min(const ValueType& arg1, const ValueType& arg2)
+    { return select(arg2 < arg1, arg2, arg1); }
+
+    static ValueType abs(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::abs(x); }); }
+
+    static ValueType tan(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::tan(x); }); }
+
+    static ValueType atan(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::atan(x); }); }
+
+    static ValueType atan2(const ValueType& arg1, const ValueType& arg2)
+    { return apply_(arg1, arg2, [](Scalar x, Scalar y) { return std::atan2(x, y); }); }
+
+    static ValueType sin(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::sin(x); }); }
+
+    static ValueType asin(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::asin(x); }); }
+
+    static ValueType cos(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::cos(x); }); }
+
+    static ValueType acos(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::acos(x); }); }
+
+    static ValueType sqrt(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::sqrt(x); }); }
+
+    static ValueType exp(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::exp(x); }); }
+
+    static ValueType log10(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::log10(x); }); }
+
+    static ValueType log(const ValueType& arg)
+    { return apply_(arg, [](Scalar x) { return std::log(x); }); }
+
+    static ValueType pow(const ValueType& base, const ValueType& exp)
+    { return apply_(base, exp, [](Scalar x, Scalar y) { return std::pow(x, y); }); }
+
+    //! Return true iff all lanes are finite values
+    static bool isfinite(const ValueType& arg)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            if (!std::isfinite(arg[i]))
+                return false;
+        return true;
+    }
+
+    //! Return true iff any lane is a NaN value
+    static bool isnan(const ValueType& arg)
+    {
+        for (unsigned i = 0; i < width; ++i)
+            if (std::isnan(arg[i]))
+                return true;
+        return false;
+    }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,251 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::TableArray
+ */
+#ifndef OPM_TABLE_ARRAY_HPP
+#define OPM_TABLE_ARRAY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A contiguous array which stores the sampling points of a table.
+ *
+ * The array either owns its elements like a std::vector or it refers to immutable
+ * elements which are stored elsewhere, e.g., in a shared memory segment which is used
+ * by all processes of a node (see share() and SharedTables). Read access is the same
+ * for both cases. Copies of an array which refers to foreign elements refer to them as
+ * well, while modifying it copies the elements first, so the foreign memory is never
+ * written to.
+ *
+ * The elements are copied bitwise into and out of shared memory, so they must be
+ * scalars or aggregates of scalars like the sampling points of the tabulated
+ * functions.
+ */
+template <class T>
+class TableArray
+{
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Only plain values can be stored in a table array");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    TableArray()
+        : data_(nullptr)
+        , size_(0)
+        , isShared_(false)
+    {}
+
+    explicit TableArray(size_type n, const T& value = T())
+        : values_(n, value)
+        , isShared_(false)
+    { sync_(); }
+
+    TableArray(const std::vector<T>& values)
+        : values_(values)
+        , isShared_(false)
+    { sync_(); }
+
+    TableArray(std::vector<T>&& values)
+        : values_(std::move(values))
+        , isShared_(false)
+    { sync_(); }
+
+    TableArray(const TableArray& other)
+        : values_(other.values_)
+        , isShared_(other.isShared_)
+    {
+        if (isShared_) {
+            data_ = other.data_;
+            size_ = other.size_;
+        }
+        else
+            sync_();
+    }
+
+    TableArray(TableArray&& other)
+        : TableArray()
+    { swap(other); }
+
+    TableArray& operator=(TableArray other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(TableArray& other)
+    {
+        // the buffer of a vector does not move when the vector is swapped
+        values_.swap(other.values_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(isShared_, other.isShared_);
+    }
+
+    /*!
+     * \brief Refer to elements which are stored elsewhere.
+     *
+     * The array releases the elements it owns. The memory must stay valid and
+     * unchanged for the lifetime of the array or until it is modified.
+     */
+    void share(const T* data, size_type n)
+    {
+        std::vector<T>().swap(values_);
+        data_ = data;
+        size_ = n;
+        isShared_ = true;
+    }
+
+    /*!
+     * \brief Returns true if the array refers to elements which are stored elsewhere.
+     */
+    bool isShared() const
+    { return isShared_; }
+
+    size_type size() const
+    { return size_; }
+
+    bool empty() const
+    { return size_ == 0; }
+
+    const T* data() const
+    { return data_; }
+
+    T* data()
+    { makeOwned_(); return values_.data(); }
+
+    const T& operator[](size_type i) const
+    { assert(i < size_); return data_[i]; }
+
+    T& operator[](size_type i)
+    { makeOwned_(); return values_[i]; }
+
+    const T& at(size_type i) const
+    {
+        if (i >= size_)
+            throw std::out_of_range("Index of a table array out of range");
+        return data_[i];
+    }
+
+    T& at(size_type i)
+    { makeOwned_(); return values_.at(i); }
+
+    const T& front() const
+    { return (*this)[0]; }
+
+    T& front()
+    { return (*this)[0]; }
+
+    const T& back() const
+    { return (*this)[size_ - 1]; }
+
+    T& back()
+    { return (*this)[size_ - 1]; }
+
+    const_iterator begin() const
+    { return data_; }
+
+    const_iterator end() const
+    { return data_ + size_; }
+
+    iterator begin()
+    { return data(); }
+
+    iterator end()
+    { return data() + size_; }
+
+    void resize(size_type n, const T& value = T())
+    {
+        makeOwned_();
+        values_.resize(n, value);
+        sync_();
+    }
+
+    void clear()
+    {
+        std::vector<T>().swap(values_);
+        isShared_ = false;
+        sync_();
+    }
+
+    void push_back(const T& value)
+    {
+        makeOwned_();
+        values_.push_back(value);
+        sync_();
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        const size_type idx = static_cast<size_type>(pos - data_);
+        makeOwned_();
+        auto it = values_.insert(values_.begin() + idx, value);
+        sync_();
+        return values_.data() + (it - values_.begin());
+    }
+
+    bool operator==(const TableArray& other) const
+    { return size_ == other.size_ && std::equal(begin(), end(), other.begin()); }
+
+    bool operator!=(const TableArray& other) const
+    { return !(*this == other); }
+
+private:
+    void makeOwned_()
+    {
+        if (!isShared_)
+            return;
+
+        values_.assign(data_, data_ + size_);
+        isShared_ = false;
+        sync_();
+    }
+
+    void sync_()
+    {
+        data_ = values_.data();
+        size_ = values_.size();
+    }
+
+    std::vector<T> values_;
+    const T* data_;
+    size_type size_;
+    bool isShared_;
+};
+
+} // namespace Opm
+
+#endif
@@ -30,6 +30,10 @@
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Unused.hpp>
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/SimdPack.hpp>
+#include <opm/material/common/MonotoneSplineFit.hpp>
+#include <opm/material/common/TableArray.hpp>
 
 #include <algorithm>
 #include <cassert>
@@ -41,6 +45,11 @@ namespace Opm {
 /*!
  * \brief Implements a linearly interpolated scalar function that depends on one
  *        variable.
+ *
+ * Large tables can optionally be compressed, see compress(). The function is then
+ * represented by a monotonicity preserving cubic spline through a subset of the
+ * sampling points. The sampling points are stored in table arrays, so they can be
+ * placed in shared memory, see SharedTables.
  */
 template <class Scalar>
 class Tabulated1DFunction
@@ -226,10 +235,10 @@ public:
     Scalar xAt(size_t i) const
     { return xValues_[i]; }
 
-    const std::vector<Scalar>& xValues() const
+    const TableArray<Scalar>& xValues() const
     { return xValues_; }
 
-    const std::vector<Scalar>& yValues() const
+    const TableArray<Scalar>& yValues() const
     { return yValues_; }
 
     /*!
@@ -257,8 +266,17 @@ public:
     template <class Evaluation>
     Evaluation eval(const Evaluation& x, bool extrapolate = false) const
     {
+        OPM_INSTRUMENT_LOOKUP("Tabulated1DFunction", "eval", extrapolate && !applies(x));
+
         size_t segIdx = findSegmentIndex_(x, extrapolate);
 
+        if (isCompressed()) {
+            Scalar xa, h, c[4];
+            cubicSegment_(scalarValue(x), segIdx, xa, h, c);
+            const Evaluation& t = (x - xa)/h;
+            return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+        }
+
         Scalar x0 = xValues_[segIdx];
         Scalar x1 = xValues_[segIdx + 1];
 
@@ -282,15 +300,46 @@ public:
     template <class Evaluation>
     Evaluation evalDerivative(const Evaluation& x, bool extrapolate = false) const
     {
+        OPM_INSTRUMENT_LOOKUP("Tabulated1DFunction", "evalDerivative", extrapolate && !applies(x));
+
         unsigned segIdx = findSegmentIndex_(x, extrapolate);
         return evalDerivative_(x, segIdx);
     }
 
+    /*!
+     * \brief Evaluate the function for each lane of a SIMD pack.
+     *
+     * The segment is searched for every lane individually, the interpolation is then
+     * done lane-wise on the gathered sampling points.
+     */
+    template <class PackScalar, unsigned width>
+    SimdPack<PackScalar, width> eval(const SimdPack<PackScalar, width>& x, bool extrapolate = false) const
+    { return evalLanewise_(x, x, extrapolate); }
+
+    template <class PackScalar, unsigned width, int numVars, unsigned staticSize>
+    DenseAd::Evaluation<SimdPack<PackScalar, width>, numVars, staticSize>
+    eval(const DenseAd::Evaluation<SimdPack<PackScalar, width>, numVars, staticSize>& x,
+         bool extrapolate = false) const
+    { return evalLanewise_(x, x.value(), extrapolate); }
+
+    /*!
+     * \brief Evaluate the function's derivative for each lane of a SIMD pack.
+     */
+    template <class PackScalar, unsigned width>
+    SimdPack<PackScalar, width> evalDerivative(const SimdPack<PackScalar, width>& x, bool extrapolate = false) const
+    { return evalDerivativeLanewise_(x, x, extrapolate); }
+
+    template <class PackScalar, unsigned width, int numVars, unsigned staticSize>
+    DenseAd::Evaluation<SimdPack<PackScalar, width>, numVars, staticSize>
+    evalDerivative(const DenseAd::Evaluation<SimdPack<PackScalar, width>, numVars, staticSize>& x,
+                   bool extrapolate = false) const
+    { return evalDerivativeLanewise_(x, x.value(), extrapolate); }
+
     /*!
      * \brief Evaluate the function's second derivative at a given position.
      *
-     * Since this class represents a piecewise linear function, this method will always
-     * return 0.
+     * Unless the function is compressed, it is piecewise linear and this method will
+     * always return 0.
      *
      * \param x The value on the abscissa where the function's
      *          derivative ought to be evaluated
@@ -301,14 +350,22 @@ public:
      *                    cause a failed assertation.
      */
     template <class Evaluation>
-    Evaluation evalSecondDerivative(const Evaluation& x OPM_UNUSED, bool extrapolate OPM_UNUSED = false) const
-    { return 0.0; }
+    Evaluation evalSecondDerivative(const Evaluation& x, bool extrapolate = false) const
+    {
+        if (!isCompressed())
+            return 0.0;
+
+        Scalar xa, h, c[4];
+        cubicSegment_(scalarValue(x), findSegmentIndex_(x, extrapolate), xa, h, c);
+        const Evaluation& t = (x - xa)/h;
+        return (2*c[2] + 6*c[3]*t)/(h*h);
+    }
 
     /*!
      * \brief Evaluate the function's third derivative at a given position.
      *
-     * Since this class represents a piecewise linear function, this method will always
-     * return 0.
+     * Unless the function is compressed, it is piecewise linear and this method will
+     * always return 0.
      *
      * \param x The value on the abscissa where the function's
      *          derivative ought to be evaluated
@@ -319,8 +376,60 @@ public:
      *                    cause a failed assertation.
      */
     template <class Evaluation>
-    Evaluation evalThirdDerivative(const Evaluation& x OPM_UNUSED, bool extrapolate OPM_UNUSED = false) const
-    { return 0.0; }
+    Evaluation evalThirdDerivative(const Evaluation& x, bool extrapolate = false) const
+    {
+        if (!isCompressed())
+            return 0.0;
+
+        Scalar xa, h, c[4];
+        cubicSegment_(scalarValue(x), findSegmentIndex_(x, extrapolate), xa, h, c);
+        Evaluation ret = blank(x);
+        ret = 6*c[3]/(h*h*h);
+        return ret;
+    }
+
+    /*!
+     * \brief Replace the piecewise linear function by a monotonicity preserving cubic
+     *        spline through a subset of its sampling points.
+     *
+     * The sampling points are selected by fitMonotoneSpline() such that the spline
+     * deviates from none of the original sampling points by more than the tolerance
+     * times the largest absolute value of the function. Smooth tables, e.g., the PVT
+     * properties of a fluid, usually need much fewer points, which makes them more
+     * cache friendly and reduces the cost of searching the segment. The derivatives
+     * of the spline are continuous and monotonic data leads to a monotonic function.
+     * Outside of the tabulated range, the function is extrapolated by straight lines
+     * which continue the slope at the first and the last sampling point.
+     *
+     * The original sampling points are discarded, setting new sampling points turns
+     * the function into a piecewise linear one again.
+     *
+     * \return The number of sampling points after the compression.
+     */
+    size_t compress(Scalar tolerance)
+    {
+        std::vector<Scalar> x(xValues_.begin(), xValues_.end());
+        std::vector<Scalar> y(yValues_.begin(), yValues_.end());
+        std::vector<Scalar> xFit, yFit, slopesFit;
+        fitMonotoneSpline(x, y, tolerance, xFit, yFit, slopesFit);
+        xValues_ = std::move(xFit);
+        yValues_ = std::move(yFit);
+        slopes_ = std::move(slopesFit);
+        return numSamples();
+    }
+
+    /*!
+     * \brief Returns true if the function is represented by a spline, see compress().
+     */
+    bool isCompressed() const
+    { return !slopes_.empty(); }
+
+    /*!
+     * \brief The slopes of the spline at the sampling points if the function is
+     *        compressed, an empty vector otherwise.
+     */
+    const TableArray<Scalar>& slopes() const
+    { return slopes_; }
 
     /*!
      * \brief Returns 1 if the function is monotonically increasing, -1
@@ -446,7 +555,16 @@ public:
 
     bool operator==(const Tabulated1DFunction<Scalar>& data) const {
         return xValues_ == data.xValues_ &&
-               yValues_ == data.yValues_;
+               yValues_ == data.yValues_ &&
+               slopes_ == data.slopes_;
+    }
+
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(xValues_);
+        serializer(yValues_);
+        serializer(slopes_);
     }
 
 private:
@@ -481,9 +599,81 @@ private:
         }
     }
 
+    // gather the sampling points of the segments of all lanes of a pack
+    template <class Pack>
+    void gatherSegments_(const Pack& x, bool extrapolate,
+                         Pack& x0, Pack& x1, Pack& y0, Pack& y1) const
+    {
+        for (unsigned laneIdx = 0; laneIdx < Pack::width; ++laneIdx) {
+            OPM_INSTRUMENT_LOOKUP("Tabulated1DFunction", "evalLanewise", extrapolate && !applies(x[laneIdx]));
+
+            size_t segIdx = findSegmentIndex_(x[laneIdx], extrapolate);
+            x0[laneIdx] = xValues_[segIdx];
+            x1[laneIdx] = xValues_[segIdx + 1];
+            y0[laneIdx] = yValues_[segIdx];
+            y1[laneIdx] = yValues_[segIdx + 1];
+        }
+    }
+
+    // gather the cubic polynomials of the segments of all lanes of a pack
+    template <class Pack>
+    void gatherCubicSegments_(const Pack& x, bool extrapolate, Pack& xa, Pack& h, Pack* c) const
+    {
+        for (unsigned laneIdx = 0; laneIdx < Pack::width; ++laneIdx) {
+            OPM_INSTRUMENT_LOOKUP("Tabulated1DFunction", "evalLanewise", extrapolate && !applies(x[laneIdx]));
+
+            size_t segIdx = findSegmentIndex_(x[laneIdx], extrapolate);
+            Scalar laneC[4];
+            cubicSegment_(x[laneIdx], segIdx, xa[laneIdx], h[laneIdx], laneC);
+            for (unsigned k = 0; k < 4; ++k)
+                c[k][laneIdx] = laneC[k];
+        }
+    }
+
+    template <class Evaluation, class Pack>
+    Evaluation evalLanewise_(const Evaluation& x, const Pack& xValue, bool extrapolate) const
+    {
+        if (isCompressed()) {
+            Pack xa, h, c[4];
+            gatherCubicSegments_(xValue, extrapolate, xa, h, c);
+            const Evaluation& t = (x - xa)/h;
+            return c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+        }
+
+        Pack x0, x1, y0, y1;
+        gatherSegments_(xValue, extrapolate, x0, x1, y0, y1);
+
+        return y0 + (y1 - y0)*(x - x0)/(x1 - x0);
+    }
+
+    template <class Evaluation, class Pack>
+    Evaluation evalDerivativeLanewise_(const Evaluation& x, const Pack& xValue, bool extrapolate) const
+    {
+        if (isCompressed()) {
+            Pack xa, h, c[4];
+            gatherCubicSegments_(xValue, extrapolate, xa, h, c);
+            const Evaluation& t = (x - xa)/h;
+            return (c[1] + t*(2*c[2] + 3*c[3]*t))/h;
+        }
+
+        Pack x0, x1, y0, y1;
+        gatherSegments_(xValue, extrapolate, x0, x1, y0, y1);
+
+        Evaluation ret = blank(x);
+        ret = (y1 - y0)/(x1 - x0);
+        return ret;
+    }
+
     template <class Evaluation>
     Evaluation evalDerivative_(const Evaluation& x, size_t segIdx) const
     {
+        if (isCompressed()) {
+            Scalar xa, h, c[4];
+            cubicSegment_(scalarValue(x), segIdx, xa, h, c);
+            const Evaluation& t = (x - xa)/h;
+            return (c[1] + t*(2*c[2] + 3*c[3]*t))/h;
+        }
+
         Scalar x0 = xValues_[segIdx];
         Scalar x1 = xValues_[segIdx + 1];
 
@@ -495,6 +685,38 @@ private:
         return ret;
     }
 
+    // the polynomial c[0] + c[1]*t + c[2]*t^2 + c[3]*t^3 with t = (x - xa)/h which
+    // represents a compressed function in a segment. Outside of the tabulated range it
+    // is the straight line which continues the slope at the closest sampling point.
+    void cubicSegment_(Scalar x, size_t segIdx, Scalar& xa, Scalar& h, Scalar* c) const
+    {
+        Scalar x0 = xValues_[segIdx];
+        Scalar x1 = xValues_[segIdx + 1];
+        Scalar y0 = yValues_[segIdx];
+        Scalar y1 = yValues_[segIdx + 1];
+        Scalar m0 = slopes_[segIdx];
+        Scalar m1 = slopes_[segIdx + 1];
+
+        h = x1 - x0;
+        if (x < x0 || x > x1) {
+            bool left = x < x0;
+            xa = left ? x0 : x1;
+            c[0] = left ? y0 : y1;
+            c[1] = h*(left ? m0 : m1);
+            c[2] = 0.0;
+            c[3] = 0.0;
+            return;
+        }
+
+        // cubic Hermite interpolation in the monomial basis
+        Scalar dy = y1 - y0;
+        xa = x0;
+        c[0] = y0;
+        c[1] = h*m0;
+        c[2] = 3*dy - 2*h*m0 - h*m1;
+        c[3] = -2*dy + h*m0 + h*m1;
+    }
+
     // returns the monotonicity of a segment
     //
     // The return value have the following meaning:
@@ -530,14 +752,14 @@ private:
      */
     struct ComparatorX_
     {
-        ComparatorX_(const std::vector<Scalar>& x)
+        ComparatorX_(const TableArray<Scalar>& x)
             : x_(x)
         {}
 
         bool operator ()(size_t idxA, size_t idxB) const
         { return x_.at(idxA) < x_.at(idxB); }
 
-        const std::vector<Scalar>& x_;
+        const TableArray<Scalar>& x_;
     };
 
     /*!
@@ -588,10 +810,13 @@ private:
     {
         xValues_.resize(nSamples);
         yValues_.resize(nSamples);
+        slopes_.clear();
     }
 
-    std::vector<Scalar> xValues_;
-    std::vector<Scalar> yValues_;
+    TableArray<Scalar> xValues_;
+    TableArray<Scalar> yValues_;
+    // only used if the function is compressed
+    TableArray<Scalar> slopes_;
 };
 } // namespace Opm
 
@@ -31,7 +31,9 @@
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
-
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <vector>
 
 #include <assert.h>
@@ -44,12 +46,25 @@ namespace Opm {
  *
  * This class can be used when the sampling points are calculated at
  * run time.
+ *
+ * By default, the function is interpolated bi-linearly. Alternatively, a C1 continuous
+ * bi-cubic Hermite interpolation can be selected using setInterpolationType(). This
+ * requires the partial derivatives of the function at the sampling points, which are
+ * either specified explicitly via setSampleDerivatives() or estimated from the sample
+ * values. Since the Hermite interpolation is of higher order, the same accuracy can
+ * usually be achieved with a much coarser grid, see resampled().
  */
 template <class Scalar>
 class UniformTabulated2DFunction
 {
 public:
+    enum class InterpolationType {
+        Bilinear,
+        Bicubic
+    };
+
     UniformTabulated2DFunction()
+        : interpolationType_(InterpolationType::Bilinear)
     { }
 
      /*!
@@ -58,6 +73,7 @@ public:
       */
     UniformTabulated2DFunction(Scalar minX, Scalar maxX, unsigned m,
                                Scalar minY, Scalar maxY, unsigned n)
+        : interpolationType_(InterpolationType::Bilinear)
     {
         resize(minX, maxX, m, minY, maxY, n);
     }
@@ -65,6 +81,7 @@ public:
     UniformTabulated2DFunction(Scalar minX, Scalar maxX, unsigned m,
                                Scalar minY, Scalar maxY, unsigned n,
                                const std::vector<std::vector<Scalar>>& vals)
+        : interpolationType_(InterpolationType::Bilinear)
     {
         resize(minX, maxX, m, minY, maxY, n);
 
@@ -75,11 +92,16 @@ public:
 
     /*!
      * \brief Resize the tabulation to a new range.
+     *
+     * This discards the derivatives of the bi-cubic interpolation, i.e., the function
+     * is interpolated bi-linearly afterwards.
      */
     void resize(Scalar minX, Scalar maxX, unsigned m,
                 Scalar minY, Scalar maxY, unsigned n)
     {
         samples_.resize(m*n);
+        derivatives_.clear();
+        interpolationType_ = InterpolationType::Bilinear;
 
         m_ = m;
         n_ = n;
@@ -217,12 +239,82 @@ public:
         alpha -= i;
         beta -= j;
 
+        if (interpolationType_ == InterpolationType::Bicubic)
+            return evalBicubic_(i, j, alpha, beta);
+
         // bi-linear interpolation
         const Evaluation& s1 = getSamplePoint(i, j)*(1.0 - alpha) + getSamplePoint(i + 1, j)*alpha;
         const Evaluation& s2 = getSamplePoint(i, j + 1)*(1.0 - alpha) + getSamplePoint(i + 1, j + 1)*alpha;
         return s1*(1.0 - beta) + s2*beta;
     }
 
+    /*!
+     * \brief Returns the method which is used to interpolate between the sampling points.
+     */
+    InterpolationType interpolationType() const
+    { return interpolationType_; }
+
+    /*!
+     * \brief Specify the method which is used to interpolate between the sampling points.
+     *
+     * If bi-cubic interpolation is requested and no derivatives have been specified
+     * using setSampleDerivatives(), they are estimated from the current values of the
+     * sampling points. This estimate does not introduce overshoots, i.e., the
+     * interpolation is monotonic along each axis if the sampling points are. It must
+     * thus be called after all sampling points have been set.
+     */
+    void setInterpolationType(InterpolationType type)
+    {
+        if (type == InterpolationType::Bicubic && derivatives_.empty())
+            estimateDerivatives_();
+        interpolationType_ = type;
+    }
+
+    /*!
+     * \brief Set the partial derivatives of the function at a sampling point.
+     *
+     * These are used by the bi-cubic interpolation and must be specified for all
+     * sampling points before it is selected.
+     */
+    void setSampleDerivatives(unsigned i, unsigned j, Scalar dfdx, Scalar dfdy, Scalar d2fdxdy)
+    {
+        assert(0 <= i && i < m_);
+        assert(0 <= j && j < n_);
+
+        if (derivatives_.empty())
+            derivatives_.resize(m_*n_);
+
+        // the derivatives are stored with respect to the normalized coordinates of a
+        // grid cell
+        Scalar hx = (xMax() - xMin())/(numX() - 1);
+        Scalar hy = (yMax() - yMin())/(numY() - 1);
+        derivatives_[j*m_ + i] = {{dfdx*hx, dfdy*hy, d2fdxdy*hx*hy}};
+    }
+
+    /*!
+     * \brief Returns a table of the same range which is sampled on a different grid.
+     *
+     * The new sampling points are evaluated using the current interpolation of this
+     * object. This can be used to create a coarse table for the bi-cubic interpolation
+     * from a fine bi-linear one.
+     */
+    UniformTabulated2DFunction resampled(unsigned m, unsigned n,
+                                         InterpolationType type = InterpolationType::Bicubic) const
+    {
+        UniformTabulated2DFunction result(xMin(), xMax(), m, yMin(), yMax(), n);
+        for (unsigned i = 0; i < m; ++i) {
+            // make sure that the range of this table is not left due to rounding errors
+            Scalar x = std::min(xMax(), std::max(xMin(), result.iToX(i)));
+            for (unsigned j = 0; j < n; ++j) {
+                Scalar y = std::min(yMax(), std::max(yMin(), result.jToY(j)));
+                result.setSamplePoint(i, j, eval(x, y));
+            }
+        }
+        result.setInterpolationType(type);
+
+        return result;
+    }
+
     /*!
      * \brief Get the value of the sample point which is at the
      *         intersection of the \f$i\f$-th interval of the x-Axis
@@ -252,6 +344,8 @@ public:
     bool operator==(const UniformTabulated2DFunction<Scalar>& data) const
     {
         return samples_ == data.samples_ &&
+               derivatives_ == data.derivatives_ &&
+               interpolationType_ == data.interpolationType_ &&
                m_ == data.m_ &&
                n_ == data.n_ &&
                xMin_ == data.xMin_ &&
@@ -260,13 +354,133 @@ public:
                yMax_ == data.yMax_;
     }
 
-
 private:
+    template <class Evaluation>
+    Evaluation evalBicubic_(unsigned i, unsigned j, const Evaluation& alpha, const Evaluation& beta) const
+    {
+        assert(derivatives_.size() == samples_.size());
+
+        // the interpolation is carried out on scalars and the derivatives of the result
+        // are composed from the gradient afterwards
+        Scalar a = scalarValue(alpha);
+        Scalar b = scalarValue(beta);
+
+        // cubic Hermite basis functions and their derivatives
+        Scalar ha[4] = { (2*a - 3)*a*a + 1, ((a - 2)*a + 1)*a, (3 - 2*a)*a*a, (a - 1)*a*a };
+        Scalar dha[4] = { 6*(a - 1)*a, (3*a - 4)*a + 1, 6*(1 - a)*a, (3*a - 2)*a };
+        Scalar hb[4] = { (2*b - 3)*b*b + 1, ((b - 2)*b + 1)*b, (3 - 2*b)*b*b, (b - 1)*b*b };
+        Scalar dhb[4] = { 6*(b - 1)*b, (3*b - 4)*b + 1, 6*(1 - b)*b, (3*b - 2)*b };
+
+        Scalar f = 0.0;
+        Scalar dfda = 0.0;
+        Scalar dfdb = 0.0;
+        for (unsigned k = 0; k < 2; ++k) {
+            for (unsigned l = 0; l < 2; ++l) {
+                unsigned idx = (j + l)*m_ + i + k;
+                const auto& d = derivatives_[idx];
+                // interpolation along the x axis at the y position of the sampling point,
+                // once for the value and once for the derivative in y direction
+                Scalar v = samples_[idx]*ha[2*k] + d[0]*ha[2*k + 1];
+                Scalar dv = samples_[idx]*dha[2*k] + d[0]*dha[2*k + 1];
+                Scalar w = d[1]*ha[2*k] + d[2]*ha[2*k + 1];
+                Scalar dw = d[1]*dha[2*k] + d[2]*dha[2*k + 1];
+
+                f += v*hb[2*l] + w*hb[2*l + 1];
+                dfda += dv*hb[2*l] + dw*hb[2*l + 1];
+                dfdb += v*dhb[2*l] + w*dhb[2*l + 1];
+            }
+        }
+
+        // the value part of (alpha - a) and (beta - b) is exactly zero. the constant is
+        // added last because evaluations with a dynamic number of derivatives cannot be
+        // created from a scalar alone
+        return (alpha - a)*dfda + (beta - b)*dfdb + f;
+    }
+
+    // returns a finite difference estimate of the derivative at the middle of three
+    // points given the differences to its neighbors. this is the central difference,
+    // which is limited for monotonic data such that the Hermite interpolation does not
+    // overshoot, i.e., it is zero at plateaus and at most three times the smaller
+    // difference otherwise.
+    static Scalar limitedSlope_(Scalar deltaLeft, Scalar deltaRight)
+    {
+        Scalar s = (deltaLeft + deltaRight)/2;
+        if (deltaLeft*deltaRight < 0.0)
+            // local extremum
+            return s;
+        if (deltaLeft == 0.0 || deltaRight == 0.0)
+            return 0.0;
+
+        Scalar maxSlope = 3*std::min(std::abs(deltaLeft), std::abs(deltaRight));
+        if (std::abs(s) > maxSlope)
+            return s > 0.0 ? maxSlope : -maxSlope;
+        return s;
+    }
+
+    // the derivative with respect to the normalized coordinate of a sequence of values
+    // with a given stride. at the ends, a one-sided three-point formula is used which is
+    // limited like for the monotonicity preserving cubic Hermite splines.
+    static Scalar slope_(const Scalar* values, unsigned k, unsigned num, unsigned stride)
+    {
+        if (num < 2)
+            return 0.0;
+        if (num == 2)
+            return values[stride] - values[0];
+
+        if (k == 0 || k == num - 1) {
+            Scalar d0, d1;
+            if (k == 0) {
+                d0 = values[stride] - values[0];
+                d1 = values[2*stride] - values[stride];
+            }
+            else {
+                d0 = values[k*stride] - values[(k - 1)*stride];
+                d1 = values[(k - 1)*stride] - values[(k - 2)*stride];
+            }
+
+            Scalar s = (3*d0 - d1)/2;
+            if (s*d0 <= 0.0)
+                return 0.0;
+            if (d0*d1 <= 0.0 && std::abs(s) > std::abs(3*d0))
+                return 3*d0;
+            return s;
+        }
+
+        return limitedSlope_(values[k*stride] - values[(k - 1)*stride],
+                             values[(k + 1)*stride] - values[k*stride]);
+    }
+
+    void estimateDerivatives_()
+    {
+        derivatives_.resize(m_*n_);
+
+        std::vector<Scalar> dfdx(m_*n_);
+        for (unsigned j = 0; j < n_; ++j) {
+            for (unsigned i = 0; i < m_; ++i) {
+                dfdx[j*m_ + i] = slope_(&samples_[j*m_], i, m_, 1);
+                derivatives_[j*m_ + i][0] = dfdx[j*m_ + i];
+            }
+        }
+
+        for (unsigned j = 0; j < n_; ++j) {
+            for (unsigned i = 0; i < m_; ++i) {
+                derivatives_[j*m_ + i][1] = slope_(&samples_[i], j, n_, m_);
+                derivatives_[j*m_ + i][2] = slope_(&dfdx[i], j, n_, m_);
+            }
+        }
+    }
+
     // the vector which contains the values of the sample points
     // f(x_i, y_j). don't use this directly, use getSamplePoint(i,j)
     // instead!
     std::vector<Scalar> samples_;
 
+    // the derivatives df/dx, df/dy and d^2f/(dx dy) at the sample points for the
+    // bi-cubic interpolation. these are scaled by the size of a grid cell.
+    std::vector<std::array<Scalar, 3>> derivatives_;
+
+    InterpolationType interpolationType_;
+
     // the number of sample points in x direction
     unsigned m_;
 
@@ -31,7 +31,10 @@
 #include <opm/material/common/Valgrind.hpp>
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Unused.hpp>
+#include <opm/material/common/Instrumentation.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/MonotoneSplineFit.hpp>
+#include <opm/material/common/TableArray.hpp>
 
 #include <iostream>
 #include <vector>
@@ -48,12 +51,17 @@ namespace Opm {
  * "Uniform on the X-axis" means that all Y sampling points must be located along a line
  * for this value. This class can be used when the sampling points are calculated at run
  * time.
+ *
+ * The columns of large tables can optionally be compressed, see compress(). The
+ * sampling points are stored in table arrays, so they can be placed in shared memory,
+ * see SharedTables.
  */
 template <class Scalar>
 class UniformXTabulated2DFunction
 {
 public:
     typedef std::tuple</*x=*/Scalar, /*y=*/Scalar, /*value=*/Scalar> SamplePoint;
+    typedef TableArray<SamplePoint> SampleColumn;
 
     /*!
      * \brief Indicates how interpolation will be performed.
@@ -79,7 +87,7 @@ public:
                                 const std::vector<Scalar>& yPos,
                                 const std::vector<std::vector<SamplePoint>>& samples,
                                 InterpolationPolicy interpolationGuide)
-        : samples_(samples)
+        : samples_(samples.begin(), samples.end())
         , xPos_(xPos)
         , yPos_(yPos)
         , interpolationGuide_(interpolationGuide)
@@ -149,17 +157,17 @@ public:
         return xPos_.at(i);
     }
 
-    const std::vector<std::vector<SamplePoint>>& samples() const
+    const std::vector<SampleColumn>& samples() const
     {
         return samples_;
     }
 
-    const std::vector<Scalar>& xPos() const
+    const TableArray<Scalar>& xPos() const
     {
         return xPos_;
     }
 
-    const std::vector<Scalar>& yPos() const
+    const TableArray<Scalar>& yPos() const
     {
         return yPos_;
     }
@@ -315,6 +323,8 @@ public:
     template <class Evaluation>
     Evaluation eval(const Evaluation& x, const Evaluation& y, bool extrapolate=false) const
     {
+        OPM_INSTRUMENT_LOOKUP("UniformXTabulated2DFunction", "eval", extrapolate && !applies(x, y));
+
 #ifndef NDEBUG
         if (!extrapolate && !applies(x, y)) {
             std::ostringstream oss;
@@ -366,8 +376,8 @@ public:
         const Evaluation& beta2 = yToBeta(yUpper, i + 1, j2);
 
         // evaluate the two function values for the same y value ...
-        const Evaluation& s1 = valueAt(i, j1)*(1.0 - beta1) + valueAt(i, j1 + 1)*beta1;
-        const Evaluation& s2 = valueAt(i + 1, j2)*(1.0 - beta2) + valueAt(i + 1, j2 + 1)*beta2;
+        const Evaluation& s1 = evalColumn_(i, j1, beta1);
+        const Evaluation& s2 = evalColumn_(i + 1, j2, beta2);
 
         Valgrind::CheckDefined(s1);
         Valgrind::CheckDefined(s2);
@@ -386,6 +396,7 @@ public:
      */
     size_t appendXPos(Scalar nextX)
     {
+        slopes_.clear();
         if (xPos_.empty() || xPos_.back() < nextX) {
             xPos_.push_back(nextX);
             yPos_.push_back(-1e100);
@@ -396,7 +407,7 @@ public:
             // this is slow, but so what?
             xPos_.insert(xPos_.begin(), nextX);
             yPos_.insert(yPos_.begin(), -1e100);
-            samples_.insert(samples_.begin(), std::vector<SamplePoint>());
+            samples_.insert(samples_.begin(), SampleColumn());
             return 0;
         }
         throw std::invalid_argument("Sampling points should be specified either monotonically "
@@ -411,6 +422,7 @@ public:
     size_t appendSamplePoint(size_t i, Scalar y, Scalar value)
     {
         assert(0 <= i && i < numX());
+        slopes_.clear();
         Scalar x = iToX(i);
         if (samples_[i].empty() || std::get<1>(samples_[i].back()) < y) {
             samples_[i].push_back(SamplePoint(x, y, value));
@@ -432,6 +444,54 @@ public:
                                     "ascending or descending order.");
     }
 
+    /*!
+     * \brief Replace the linear interpolation along the columns by monotonicity
+     *        preserving cubic splines through a subset of their sampling points.
+     *
+     * Each column is compressed independently by fitMonotoneSpline(): the spline
+     * deviates from none of the original sampling points of a column by more than the
+     * tolerance times the largest absolute value of the column. The first and the last
+     * sampling point of each column are always kept, so the range of the table and the
+     * guide lines of the interpolation do not change. Outside of the tabulated range
+     * of a column, it is extrapolated by straight lines which continue the slope at the
+     * closest sampling point. The interpolation in x direction stays linear.
+     *
+     * Appending sampling points turns the function into a linearly interpolated one
+     * again.
+     *
+     * \return The total number of sampling points after the compression.
+     */
+    size_t compress(Scalar tolerance)
+    {
+        size_t numSamples = 0;
+        slopes_.resize(numX());
+        for (size_t i = 0; i < numX(); ++i) {
+            auto& col = samples_[i];
+            std::vector<Scalar> y(col.size()), value(col.size());
+            for (size_t j = 0; j < col.size(); ++j) {
+                y[j] = std::get<1>(col[j]);
+                value[j] = std::get<2>(col[j]);
+            }
+
+            std::vector<Scalar> yFit, valueFit, slopesFit;
+            fitMonotoneSpline(y, value, tolerance, yFit, valueFit, slopesFit);
+            slopes_[i] = std::move(slopesFit);
+
+            col.resize(yFit.size());
+            for (size_t j = 0; j < col.size(); ++j)
+                col[j] = SamplePoint(xPos_[i], yFit[j], valueFit[j]);
+            numSamples += col.size();
+        }
+
+        return numSamples;
+    }
+
+    /*!
+     * \brief Returns true if the columns are represented by splines, see compress().
+     */
+    bool isCompressed() const
+    { return !slopes_.empty(); }
+
     /*!
      * \brief Print the table for debugging purposes.
      *
@@ -469,20 +529,59 @@ public:
         return this->xPos() == data.xPos() &&
                this->yPos() == data.yPos() &&
                this->samples() == data.samples() &&
-               this->interpolationGuide() == data.interpolationGuide();
+               this->interpolationGuide() == data.interpolationGuide() &&
+               slopes_ == data.slopes_;
+    }
+
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(samples_);
+        serializer(xPos_);
+        serializer(yPos_);
+        serializer(interpolationGuide_);
+        serializer(slopes_);
     }
 
 private:
+    // evaluate a column at a relative position beta within one of its segments
+    template <class Evaluation>
+    Evaluation evalColumn_(unsigned i, unsigned j, const Evaluation& beta) const
+    {
+        Scalar v0 = valueAt(i, j);
+        Scalar v1 = valueAt(i, j + 1);
+        if (!isCompressed())
+            return v0*(1.0 - beta) + v1*beta;
+
+        // the slopes with respect to beta
+        Scalar h = yAt(i, j + 1) - yAt(i, j);
+        Scalar m0 = h*slopes_[i][j];
+        Scalar m1 = h*slopes_[i][j + 1];
+
+        // extrapolate by straight lines
+        if (beta < 0.0)
+            return v0 + m0*beta;
+        else if (beta > 1.0)
+            return v1 + m1*(beta - 1.0);
+
+        // cubic Hermite interpolation
+        Scalar dv = v1 - v0;
+        return v0 + beta*(m0 + beta*((3*dv - 2*m0 - m1) + beta*(-2*dv + m0 + m1)));
+    }
+
     // the vector which contains the values of the sample points
     // f(x_i, y_j). don't use this directly, use getSamplePoint(i,j)
     // instead!
-    std::vector<std::vector<SamplePoint> > samples_;
+    std::vector<SampleColumn> samples_;
 
     // the position of each vertical line on the x-axis
-    std::vector<Scalar> xPos_;
+    TableArray<Scalar> xPos_;
     // the position on the y-axis of the guide point
-    std::vector<Scalar> yPos_;
+    TableArray<Scalar> yPos_;
     InterpolationPolicy interpolationGuide_;
+    // the slopes of the splines along the columns. only used if the function is
+    // compressed
+    std::vector<TableArray<Scalar> > slopes_;
 };
 } // namespace Opm
 
@@ -31,6 +31,8 @@
 #include <opm/material/components/Component.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 
+#include <cmath>
+
 namespace Opm {
 
 /*!
@@ -38,6 +40,10 @@ namespace Opm {
  *
  * \brief A class for the brine fluid properties.
  *
+ * The salinity of the brine is either taken from the global \c salinity or it is
+ * specified explicitly by a SalinityTerms object. The latter does not use any global
+ * state, so brines of different salinity can be evaluated concurrently.
+ *
  * \tparam Scalar The type used for scalar values
  * \tparam H2O Static polymorphism: the Brine class can access all properties of the H2O class
  */
@@ -48,6 +54,79 @@ public:
     //! The mass fraction of salt assumed to be in the brine.
     static Scalar salinity;
 
+    /*!
+     * \brief The terms of the brine properties which only depend on the salinity.
+     *
+     * These are computed once for a given salinity instead of for each evaluation.
+     */
+    class SalinityTerms
+    {
+        friend class Brine;
+
+    public:
+        explicit SalinityTerms(Scalar S = 0.1)
+        { setSalinity(S); }
+
+        /*!
+         * \brief Set the mass fraction of salt in the brine.
+         */
+        void setSalinity(Scalar S)
+        {
+            salinity_ = S;
+            molality_ = S/(1 - S)/58.44e-3;
+
+            const Scalar M1 = H2O::molarMass();
+            const Scalar M2 = 58e-3; // molar mass of NaCl [kg/mol]
+            molarMass_ = M1*M2/(M2 + S*(M1 - M2));
+
+            // Batzle & Wang, as a polynomial of the temperature in degrees Celsius and
+            // the pressure in MPa
+            densityCoeffs_[0] = 1000*S*(0.668 + 0.44*S);
+            densityCoeffs_[1] = 1e-3*S*(300 - 2400*S);
+            densityCoeffs_[2] = 1e-3*S*(80 - 3300*S);
+            densityCoeffs_[3] = -3e-3*S;
+            densityCoeffs_[4] = 1e-3*S*(-13 + 47*S);
+
+            // Michaelides, as a polynomial of the temperature in degrees Celsius
+            const Scalar m = molality_;
+            const Scalar factor = 4.184/(1e3 + 58.44*m);
+            for (unsigned i = 0; i < 4; ++i)
+                enthalpyCoeffs_[i] =
+                    factor*(michaelidesCoeffs_()[i][0]
+                            + m*(michaelidesCoeffs_()[i][1] + m*michaelidesCoeffs_()[i][2]));
+
+            viscosityCoeffs_[0] = 0.42*std::pow(std::pow(S, 0.8) - 0.17, 2) + 0.045;
+            viscosityCoeffs_[1] = 0.1 + 0.333*S;
+            viscosityCoeffs_[2] = 1.65 + 91.9*S*S*S;
+        }
+
+        /*!
+         * \brief The mass fraction of salt in the brine.
+         */
+        Scalar salinity() const
+        { return salinity_; }
+
+        /*!
+         * \brief The molality of the salt [mol/kg].
+         */
+        Scalar molality() const
+        { return molality_; }
+
+        /*!
+         * \brief The molar mass of the brine [kg/mol].
+         */
+        Scalar molarMass() const
+        { return molarMass_; }
+
+    private:
+        Scalar salinity_;
+        Scalar molality_;
+        Scalar molarMass_;
+        Scalar densityCoeffs_[5];
+        Scalar enthalpyCoeffs_[4];
+        Scalar viscosityCoeffs_[3];
+    };
+
     /*!
      * \copydoc Component::name
      */
@@ -78,12 +157,13 @@ public:
      * This assumes that the salt is pure NaCl.
      */
     static Scalar molarMass()
-    {
-        const Scalar M1 = H2O::molarMass();
-        const Scalar M2 = 58e-3; // molar mass of NaCl [kg/mol]
-        const Scalar X2 = salinity; // mass fraction of salt in brine
-        return M1*M2/(M2 + X2*(M1 - M2));
-    }
+    { return globalSalinityTerms_().molarMass(); }
+
+    /*!
+     * \brief The molar mass of brine of a given salinity [kg/mol].
+     */
+    static Scalar molarMass(const SalinityTerms& terms)
+    { return terms.molarMass(); }
 
     /*!
      * \copydoc H2O::criticalTemperature
@@ -135,33 +215,29 @@ public:
     template <class Evaluation>
     static Evaluation liquidEnthalpy(const Evaluation& temperature,
                                      const Evaluation& pressure)
+    { return liquidEnthalpy(temperature, pressure, globalSalinityTerms_()); }
+
+    /*!
+     * \brief The specific enthalpy of liquid brine of a given salinity [J/kg].
+     */
+    template <class Evaluation>
+    static Evaluation liquidEnthalpy(const Evaluation& temperature,
+                                     const Evaluation& pressure,
+                                     const SalinityTerms& terms)
     {
         // Numerical coefficents from Palliser and McKibbin
         static const Scalar f[] = {
             2.63500e-1, 7.48368e-6, 1.44611e-6, -3.80860e-10
         };
 
-        // Numerical coefficents from Michaelides for the enthalpy of brine
-        static const Scalar a[4][3] = {
-            { -9633.6, -4080.0, +286.49 },
-            { +166.58, +68.577, -4.6856 },
-            { -0.90963, -0.36524, +0.249667e-1 },
-            { +0.17965e-2, +0.71924e-3, -0.4900e-4 }
-        };
-
         const Evaluation& theta = temperature - 273.15;
 
-        Evaluation S = salinity;
         const Evaluation& S_lSAT =
             f[0]
             + f[1]*theta
             + f[2]*pow(theta, 2)
             + f[3]*pow(theta, 3);
 
-        // Regularization
-        if (S > S_lSAT)
-            S = S_lSAT;
-
         const Evaluation& hw = H2O::liquidEnthalpy(temperature, pressure)/1e3; // [kJ/kg]
 
         // From Daubert and Danner
@@ -172,16 +248,26 @@ public:
              + (2.8000e-5/4)*pow(temperature, 4.0))/58.44e3
             - 2.045698e+02; // [kJ/kg]
 
-        const Evaluation& m = S/(1-S)/58.44e-3;
+        Evaluation S = terms.salinity();
+        Evaluation delta_h;
+        if (S > S_lSAT) {
+            // Regularization: the terms which only depend on the salinity cannot be used
+            S = S_lSAT;
+            const Evaluation& m = S/(1-S)/58.44e-3;
 
-        Evaluation d_h = 0;
-        for (int i = 0; i<=3; ++i) {
-            for (int j = 0; j <= 2; ++j) {
-                d_h += a[i][j] * pow(theta, i) * pow(m, j);
+            Evaluation d_h = 0;
+            for (int i = 0; i<=3; ++i) {
+                for (int j = 0; j <= 2; ++j) {
+                    d_h += michaelidesCoeffs_()[i][j] * pow(theta, i) * pow(m, j);
+                }
             }
-        }
 
-        const Evaluation& delta_h = 4.184/(1e3 + (58.44 * m))*d_h;
+            delta_h = 4.184/(1e3 + (58.44 * m))*d_h;
+        }
+        else {
+            const Scalar* c = terms.enthalpyCoeffs_;
+            delta_h = c[0] + theta*(c[1] + theta*(c[2] + theta*c[3]));
+        }
 
         // Enthalpy of brine
         const Evaluation& h_ls = (1-S)*hw + S*h_NaCl + S*delta_h; // [kJ/kg]
@@ -248,25 +334,26 @@ public:
      */
     template <class Evaluation>
     static Evaluation liquidDensity(const Evaluation& temperature, const Evaluation& pressure)
+    { return liquidDensity(temperature, pressure, globalSalinityTerms_()); }
+
+    /*!
+     * \brief The density of liquid brine of a given salinity [kg/m^3].
+     */
+    template <class Evaluation>
+    static Evaluation liquidDensity(const Evaluation& temperature,
+                                    const Evaluation& pressure,
+                                    const SalinityTerms& terms)
     {
-        Evaluation tempC = temperature - 273.15;
-        Evaluation pMPa = pressure/1.0E6;
+        const Evaluation& tempC = temperature - 273.15;
+        const Evaluation& pMPa = pressure/1.0E6;
+        const Scalar* c = terms.densityCoeffs_;
 
-        const Evaluation rhow = H2O::liquidDensity(temperature, pressure);
+        const Evaluation& rhow = H2O::liquidDensity(temperature, pressure);
         return
-            rhow +
-            1000*salinity*(
-                0.668 +
-                0.44*salinity +
-                1.0E-6*(
-                    300*pMPa -
-                    2400*pMPa*salinity +
-                    tempC*(
-                        80.0 -
-                        3*tempC -
-                        3300*salinity -
-                        13*pMPa +
-                        47*pMPa*salinity)));
+            rhow
+            + c[0]
+            + c[1]*pMPa
+            + tempC*(c[2] + c[3]*tempC + c[4]*pMPa);
     }
 
     /*!
@@ -324,17 +411,50 @@ public:
      *   "Equations of State for basin geofluids"
      */
     template <class Evaluation>
-    static Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& /*pressure*/)
+    static Evaluation liquidViscosity(const Evaluation& temperature, const Evaluation& pressure)
+    { return liquidViscosity(temperature, pressure, globalSalinityTerms_()); }
+
+    /*!
+     * \brief The dynamic viscosity of liquid brine of a given salinity [Pa s].
+     */
+    template <class Evaluation>
+    static Evaluation liquidViscosity(const Evaluation& temperature,
+                                      const Evaluation& /*pressure*/,
+                                      const SalinityTerms& terms)
     {
         Evaluation T_C = temperature - 273.15;
         if(temperature <= 275.) // regularization
             T_C = 275.0;
 
-        Evaluation A = (0.42*std::pow((std::pow(salinity, 0.8)-0.17), 2) + 0.045)*pow(T_C, 0.8);
-        Evaluation mu_brine = 0.1 + 0.333*salinity + (1.65+91.9*salinity*salinity*salinity)*exp(-A);
+        const Scalar* c = terms.viscosityCoeffs_;
+        const Evaluation& A = c[0]*pow(T_C, 0.8);
+        const Evaluation& mu_brine = c[1] + c[2]*exp(-A);
 
         return mu_brine/1000.0; // convert to [Pa s] (todo: check if correct cP->Pa s is times 10...)
     }
+
+private:
+    // the terms for the global salinity. these are cached per thread and are updated
+    // if the salinity was changed.
+    static const SalinityTerms& globalSalinityTerms_()
+    {
+        thread_local SalinityTerms terms(salinity);
+        if (terms.salinity() != salinity)
+            terms.setSalinity(salinity);
+        return terms;
+    }
+
+    // Numerical coefficents from Michaelides for the enthalpy of brine
+    static const Scalar (&michaelidesCoeffs_())[4][3]
+    {
+        static const Scalar a[4][3] = {
+            { -9633.6, -4080.0, +286.49 },
+            { +166.58, +68.577, -4.6856 },
+            { -0.90963, -0.36524, +0.249667e-1 },
+            { +0.17965e-2, +0.71924e-3, -0.4900e-4 }
+        };
+        return a;
+    }
 };
 
 /*!
@@ -32,7 +32,9 @@
 #include <opm/material/IdealGas.hpp>
 #include <opm/material/components/Component.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -47,6 +49,14 @@ namespace Opm {
  * fluidsystem \c BrineCO2FluidSystem. If thermodynamic precision
  * is not a top priority, the much simpler component \c Opm::SimpleCO2 can be
  * used instead
+ *
+ * The density and the enthalpy are evaluated using the tabulatedDensity and
+ * tabulatedEnthalpy objects of \c CO2Tables. If these use the bi-cubic
+ * interpolation of \c Opm::UniformTabulated2DFunction, much coarser tables can be
+ * used for the same accuracy, see UniformTabulated2DFunction::resampled().
+ *
+ * The viscosity and the heat capacity are tabulated on the same grids when they are
+ * used for the first time, see tabulatedGasViscosity() and tabulatedGasHeatCapacity().
  */
 template <class Scalar, class CO2Tables>
 class CO2 : public Component<Scalar, CO2<Scalar, CO2Tables> >
@@ -193,11 +203,110 @@ public:
     /*!
      * \brief The dynamic viscosity [Pa s] of CO2.
      *
+     * Within the range of the CO2 tables, the viscosity is interpolated from
+     * tabulatedGasViscosity(). Outside of it, gasViscosityCorrelation() is used.
+     */
+    template <class Evaluation>
+    static Evaluation gasViscosity(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        const auto& table = tabulatedGasViscosity();
+        if (table.applies(temperature, pressure))
+            return table.eval(temperature, pressure);
+        return gasViscosityCorrelation(temperature, pressure);
+    }
+
+    /*!
+     * \brief The dynamic viscosity [Pa s] of CO2 computed by the correlation.
+     *
      * Equations given in: - Vesovic et al., 1990
      *                        - Fenhour etl al., 1998
      */
     template <class Evaluation>
-    static Evaluation gasViscosity(Evaluation temperature, const Evaluation& pressure)
+    static Evaluation gasViscosityCorrelation(Evaluation temperature, const Evaluation& pressure)
+    {
+        if(temperature < 275.) // regularization, also applies to the density
+            temperature = 275.0;
+
+        const Evaluation& rho = gasDensity(temperature, pressure); // CO2 mass density [kg/m^3]
+        return viscosityFromDensity_(temperature, rho);
+    }
+
+    /*!
+     * \brief The viscosity of CO2 on the grid of the density table.
+     *
+     * The sampling points are computed by the correlation of gasViscosityCorrelation()
+     * from the sampling points of the density table, so both tables are exact at the
+     * same positions and use the same interpolation. Since the viscosity is a smooth
+     * function of the density, the interpolation error is of the same order as the one
+     * of the density. The table is computed when it is used for the first time.
+     */
+    static const UniformTabulated2DFunction<Scalar>& tabulatedGasViscosity()
+    {
+        static const UniformTabulated2DFunction<Scalar> table = makeViscosityTable_(CO2Tables::tabulatedDensity);
+        return table;
+    }
+
+    /*!
+     * \brief Specific isobaric heat capacity of gaseous CO2 [J/(kg K)].
+     *
+     * Within the range of the CO2 tables, the heat capacity is interpolated from
+     * tabulatedGasHeatCapacity(). Outside of it, gasHeatCapacityFromEnthalpy() is
+     * used.
+     *
+     * \param temperature Temperature of component \f$\mathrm{[K]}\f$
+     * \param pressure Pressure of component \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static Evaluation gasHeatCapacity(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        const auto& table = tabulatedGasHeatCapacity();
+        if (table.applies(temperature, pressure))
+            return table.eval(temperature, pressure);
+        return gasHeatCapacityFromEnthalpy(temperature, pressure);
+    }
+
+    /*!
+     * \brief Specific isobaric heat capacity of gaseous CO2 [J/(kg K)] computed by
+     *        differentiating the enthalpy table.
+     *
+     * This function uses the fact that heat capacity is the partial
+     * derivative of enthalpy function with respect to temperature.
+     *
+     * \param temperature Temperature of component \f$\mathrm{[K]}\f$
+     * \param pressure Pressure of component \f$\mathrm{[Pa]}\f$
+     */
+    template <class Evaluation>
+    static Evaluation gasHeatCapacityFromEnthalpy(const Evaluation& temperature, const Evaluation& pressure)
+    {
+        Scalar eps = 1e-6;
+
+        // use central differences here because one-sided methods do
+        // not come with a performance improvement. (central ones are
+        // more accurate, though...)
+        const Evaluation& h1 = gasEnthalpy(temperature - eps, pressure);
+        const Evaluation& h2 = gasEnthalpy(temperature + eps, pressure);
+
+        return (h2 - h1) / (2*eps) ;
+    }
+
+    /*!
+     * \brief The heat capacity of CO2 on the grid of the enthalpy table.
+     *
+     * The sampling points are the central differences of the enthalpy table with
+     * respect to temperature, or one-sided ones at the boundary of the table. In
+     * contrast to the derivative of the interpolated enthalpy, the interpolated heat
+     * capacity is thus continuous. The table is computed when it is used for the first
+     * time.
+     */
+    static const UniformTabulated2DFunction<Scalar>& tabulatedGasHeatCapacity()
+    {
+        static const UniformTabulated2DFunction<Scalar> table = makeHeatCapacityTable_(CO2Tables::tabulatedEnthalpy);
+        return table;
+    }
+
+private:
+    template <class Evaluation>
+    static Evaluation viscosityFromDensity_(Evaluation temperature, const Evaluation& rho)
     {
         const Scalar a0 = 0.235156;
         const Scalar a1 = -0.491266;
@@ -223,8 +332,6 @@ public:
 
         Evaluation mu0 = 1.00697*sqrt(temperature) / SigmaStar;
 
-        const Evaluation& rho = gasDensity(temperature, pressure); // CO2 mass density [kg/m^3]
-
         // dmu : excess viscosity at elevated density
         Evaluation dmu =
             d11*rho
@@ -236,28 +343,45 @@ public:
         return (mu0 + dmu)/1.0e6; // conversion to [Pa s]
     }
 
-    /*!
-     * \brief Specific isobaric heat capacity of the component [J/kg]
-     *        as a liquid.
-     *
-     * This function uses the fact that heat capacity is the partial
-     * derivative of enthalpy function with respect to temperature.
-     *
-     * \param temperature Temperature of component \f$\mathrm{[K]}\f$
-     * \param pressure Pressure of component \f$\mathrm{[Pa]}\f$
-     */
-    template <class Evaluation>
-    static Evaluation gasHeatCapacity(const Evaluation& temperature, const Evaluation& pressure)
+    template <class SourceTable>
+    static UniformTabulated2DFunction<Scalar> makeViscosityTable_(const SourceTable& density)
     {
-        Scalar eps = 1e-6;
-
-        // use central differences here because one-sided methods do
-        // not come with a performance improvement. (central ones are
-        // more accurate, though...)
-        const Evaluation& h1 = gasEnthalpy(temperature - eps, pressure);
-        const Evaluation& h2 = gasEnthalpy(temperature + eps, pressure);
+        UniformTabulated2DFunction<Scalar> table(density.xMin(), density.xMax(), density.numX(),
+                                                 density.yMin(), density.yMax(), density.numY());
+        for (unsigned i = 0; i < density.numX(); ++i) {
+            // the correlation is regularized below 275 K, cf. gasViscosityCorrelation()
+            const auto TSample = density.iToX(i);
+            const auto T = std::max(TSample, decltype(TSample)(275.0));
+            for (unsigned j = 0; j < density.numY(); ++j) {
+                const auto rho = (T == TSample)
+                    ? density.getSamplePoint(i, j)
+                    : density.eval(T, density.jToY(j));
+                table.setSamplePoint(i, j, viscosityFromDensity_<Scalar>(T, rho));
+            }
+        }
+        if (density.interpolationType() == SourceTable::InterpolationType::Bicubic)
+            table.setInterpolationType(UniformTabulated2DFunction<Scalar>::InterpolationType::Bicubic);
+
+        return table;
+    }
 
-        return (h2 - h1) / (2*eps) ;
+    template <class SourceTable>
+    static UniformTabulated2DFunction<Scalar> makeHeatCapacityTable_(const SourceTable& enthalpy)
+    {
+        const unsigned m = enthalpy.numX();
+        UniformTabulated2DFunction<Scalar> table(enthalpy.xMin(), enthalpy.xMax(), m,
+                                                 enthalpy.yMin(), enthalpy.yMax(), enthalpy.numY());
+        for (unsigned i = 0; i < m; ++i) {
+            unsigned iLow = i > 0 ? i - 1 : 0;
+            unsigned iHigh = i + 1 < m ? i + 1 : m - 1;
+            Scalar dT = enthalpy.iToX(iHigh) - enthalpy.iToX(iLow);
+            for (unsigned j = 0; j < enthalpy.numY(); ++j)
+                table.setSamplePoint(i, j, (enthalpy.getSamplePoint(iHigh, j) - enthalpy.getSamplePoint(iLow, j))/dT);
+        }
+        if (enthalpy.interpolationType() == SourceTable::InterpolationType::Bicubic)
+            table.setInterpolationType(UniformTabulated2DFunction<Scalar>::InterpolationType::Bicubic);
+
+        return table;
     }
 };
 
@@ -0,0 +1,46 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Definition of the CO2 tables for the opm-material library.
+ */
+#include "config.h"
+
+#include <opm/material/components/CO2Tables.hpp>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+namespace Opm {
+namespace CO2TablesData {
+#include <opm/material/components/co2tables.inc>
+} // namespace CO2TablesData
+} // namespace Opm
+
+static_assert(CO2Tables::brineSalinity == Opm::CO2TablesData::CO2Tables::brineSalinity,
+              "The declaration of CO2Tables does not match co2tables.inc");
+
+const Opm::UniformTabulated2DFunction<double>& CO2Tables::tabulatedEnthalpy =
+    Opm::CO2TablesData::CO2Tables::tabulatedEnthalpy;
+const Opm::UniformTabulated2DFunction<double>& CO2Tables::tabulatedDensity =
+    Opm::CO2TablesData::CO2Tables::tabulatedDensity;
+#endif
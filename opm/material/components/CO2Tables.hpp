@@ -0,0 +1,57 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Provides the global CO2Tables class for the black-oil PVT classes.
+ *
+ * By default, this includes co2tables.inc, i.e. every translation unit parses and
+ * initializes the tables. If the explicitly instantiated templates are compiled into
+ * the opm-material library, the tables are defined there and only their declaration is
+ * provided here. In this case, co2tables.inc must not be included at the global scope
+ * of the same translation unit.
+ */
+#ifndef OPM_CO2_TABLES_HPP
+#define OPM_CO2_TABLES_HPP
+
+#include <opm/material/common/ExplicitInstantiation.hpp>
+#include <opm/material/common/UniformTabulated2DFunction.hpp>
+
+#include <vector>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+/*!
+ * \brief The tabulated enthalpy and density of CO2 (see co2tables.inc).
+ *
+ * The tables are defined in CO2Tables.cpp.
+ */
+struct CO2Tables {
+    static const Opm::UniformTabulated2DFunction<double>& tabulatedEnthalpy;
+    static const Opm::UniformTabulated2DFunction<double>& tabulatedDensity;
+    static constexpr double brineSalinity = 1.000000000000000e-01;
+};
+#else
+#include <opm/material/components/co2tables.inc>
+#endif
+
+#endif
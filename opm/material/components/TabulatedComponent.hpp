@@ -31,9 +31,13 @@
 #include <cmath>
 #include <limits>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
 
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/SharedMemoryRegion.hpp>
 
 namespace Opm {
 /*!
@@ -72,141 +76,57 @@ public:
     static void init(Scalar tempMin, Scalar tempMax, unsigned nTemp,
                      Scalar pressMin, Scalar pressMax, unsigned nPress)
     {
-        tempMin_ = tempMin;
-        tempMax_ = tempMax;
-        nTemp_ = nTemp;
-        pressMin_ = pressMin;
-        pressMax_ = pressMax;
-        nPress_ = nPress;
-        nDensity_ = nPress_;
+        setRanges_(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
 
         // allocate the arrays
-        vaporPressure_ = new Scalar[nTemp_];
-        minGasDensity__ = new Scalar[nTemp_];
-        maxGasDensity__ = new Scalar[nTemp_];
-        minLiquidDensity__ = new Scalar[nTemp_];
-        maxLiquidDensity__ = new Scalar[nTemp_];
-
-        gasEnthalpy_ = new Scalar[nTemp_*nPress_];
-        liquidEnthalpy_ = new Scalar[nTemp_*nPress_];
-        gasHeatCapacity_ = new Scalar[nTemp_*nPress_];
-        liquidHeatCapacity_ = new Scalar[nTemp_*nPress_];
-        gasDensity_ = new Scalar[nTemp_*nPress_];
-        liquidDensity_ = new Scalar[nTemp_*nPress_];
-        gasViscosity_ = new Scalar[nTemp_*nPress_];
-        liquidViscosity_ = new Scalar[nTemp_*nPress_];
-        gasThermalConductivity_ = new Scalar[nTemp_*nPress_];
-        liquidThermalConductivity_ = new Scalar[nTemp_*nPress_];
-        gasPressure_ = new Scalar[nTemp_*nDensity_];
-        liquidPressure_ = new Scalar[nTemp_*nDensity_];
-
-        assert(std::numeric_limits<Scalar>::has_quiet_NaN);
-        Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
-
-        // fill the temperature-pressure arrays
-        for (unsigned iT = 0; iT < nTemp_; ++ iT) {
-            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
-
-            try { vaporPressure_[iT] = RawComponent::vaporPressure(temperature); }
-            catch (const std::exception&) { vaporPressure_[iT] = NaN; }
-
-            Scalar pgMax = maxGasPressure_(iT);
-            Scalar pgMin = minGasPressure_(iT);
-
-            // fill the temperature, pressure gas arrays
-            for (unsigned iP = 0; iP < nPress_; ++ iP) {
-                Scalar pressure = iP * (pgMax - pgMin)/(nPress_ - 1) + pgMin;
-
-                unsigned i = iT + iP*nTemp_;
-
-                try { gasEnthalpy_[i] = RawComponent::gasEnthalpy(temperature, pressure); }
-                catch (const std::exception&) { gasEnthalpy_[i] = NaN; }
-
-                try { gasHeatCapacity_[i] = RawComponent::gasHeatCapacity(temperature, pressure); }
-                catch (const std::exception&) { gasHeatCapacity_[i] = NaN; }
+        assignArrays_(new Scalar[numTabulatedValues_(nTemp, nPress)]);
 
-                try { gasDensity_[i] = RawComponent::gasDensity(temperature, pressure); }
-                catch (const std::exception&) { gasDensity_[i] = NaN; }
-
-                try { gasViscosity_[i] = RawComponent::gasViscosity(temperature, pressure); }
-                catch (const std::exception&) { gasViscosity_[i] = NaN; }
-
-                try { gasThermalConductivity_[i] = RawComponent::gasThermalConductivity(temperature, pressure); }
-                catch (const std::exception&) { gasThermalConductivity_[i] = NaN; }
-            };
-
-            Scalar plMin = minLiquidPressure_(iT);
-            Scalar plMax = maxLiquidPressure_(iT);
-            for (unsigned iP = 0; iP < nPress_; ++ iP) {
-                Scalar pressure = iP * (plMax - plMin)/(nPress_ - 1) + plMin;
-
-                unsigned i = iT + iP*nTemp_;
-
-                try { liquidEnthalpy_[i] = RawComponent::liquidEnthalpy(temperature, pressure); }
-                catch (const std::exception&) { liquidEnthalpy_[i] = NaN; }
-
-                try { liquidHeatCapacity_[i] = RawComponent::liquidHeatCapacity(temperature, pressure); }
-                catch (const std::exception&) { liquidHeatCapacity_[i] = NaN; }
-
-                try { liquidDensity_[i] = RawComponent::liquidDensity(temperature, pressure); }
-                catch (const std::exception&) { liquidDensity_[i] = NaN; }
-
-                try { liquidViscosity_[i] = RawComponent::liquidViscosity(temperature, pressure); }
-                catch (const std::exception&) { liquidViscosity_[i] = NaN; }
-
-                try { liquidThermalConductivity_[i] = RawComponent::liquidThermalConductivity(temperature, pressure); }
-                catch (const std::exception&) { liquidThermalConductivity_[i] = NaN; }
-            }
-        }
-
-        // fill the temperature-density arrays
-        for (unsigned iT = 0; iT < nTemp_; ++ iT) {
-            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
-
-            // calculate the minimum and maximum values for the gas
-            // densities
-            minGasDensity__[iT] = RawComponent::gasDensity(temperature, minGasPressure_(iT));
-            if (iT < nTemp_ - 1)
-                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT + 1));
-            else
-                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT));
-
-            // fill the temperature, density gas arrays
-            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
-                Scalar density =
-                    Scalar(iRho)/(nDensity_ - 1) *
-                    (maxGasDensity__[iT] - minGasDensity__[iT])
-                    +
-                    minGasDensity__[iT];
-
-                unsigned i = iT + iRho*nTemp_;
-
-                try { gasPressure_[i] = RawComponent::gasPressure(temperature, density); }
-                catch (const std::exception&) { gasPressure_[i] = NaN; };
-            };
-
-            // calculate the minimum and maximum values for the liquid
-            // densities
-            minLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, minLiquidPressure_(iT));
-            if (iT < nTemp_ - 1)
-                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT + 1));
-            else
-                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT));
-
-            // fill the temperature, density liquid arrays
-            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
-                Scalar density =
-                    Scalar(iRho)/(nDensity_ - 1) *
-                    (maxLiquidDensity__[iT] - minLiquidDensity__[iT])
-                    +
-                    minLiquidDensity__[iT];
-
-                unsigned i = iT + iRho*nTemp_;
+        fillArrays_();
+    }
 
-                try { liquidPressure_[i] = RawComponent::liquidPressure(temperature, density); }
-                catch (const std::exception&) { liquidPressure_[i] = NaN; };
-            };
-        }
+    /*!
+     * \brief Initialize the tables within a named POSIX shared memory segment.
+     *
+     * The first process on a node which calls this method for a given segment name
+     * computes the tables, all other processes attach to them read-only instead of
+     * computing their own copy. All processes must pass the same ranges; attaching to
+     * a segment which was computed for other ranges or another component throws.
+     *
+     * \param segmentName The name of the shared memory segment
+     * \copydetails init()
+     *
+     * \return true if the tables were computed by the calling process
+     */
+    static bool initShared(const std::string& segmentName,
+                           Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                           Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        std::uint64_t layoutKey = SharedMemoryRegion::hash(tempMin);
+        layoutKey = SharedMemoryRegion::hash(tempMax, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(nTemp, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(pressMin, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(pressMax, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(nPress, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(useVaporPressure, layoutKey);
+        for (const char* c = name(); *c; ++c)
+            layoutKey = SharedMemoryRegion::hash(*c, layoutKey);
+
+        // the current tables stay valid if attaching to the segment fails
+        std::unique_ptr<SharedMemoryRegion> region(
+            new SharedMemoryRegion(segmentName,
+                                   numTabulatedValues_(nTemp, nPress)*sizeof(Scalar),
+                                   layoutKey));
+
+        setRanges_(tempMin, tempMax, nTemp, pressMin, pressMax, nPress);
+        sharedRegion_ = std::move(region);
+        assignArrays_(static_cast<Scalar*>(sharedRegion_->data()));
+
+        if (!sharedRegion_->isOwner())
+            return false;
+
+        fillArrays_();
+        sharedRegion_->markReady();
+        return true;
     }
 
     /*!
@@ -508,6 +428,166 @@ public:
     }
 
 private:
+    static void setRanges_(Scalar tempMin, Scalar tempMax, unsigned nTemp,
+                           Scalar pressMin, Scalar pressMax, unsigned nPress)
+    {
+        tempMin_ = tempMin;
+        tempMax_ = tempMax;
+        nTemp_ = nTemp;
+        pressMin_ = pressMin;
+        pressMax_ = pressMax;
+        nPress_ = nPress;
+        nDensity_ = nPress_;
+    }
+
+    // the total number of values of all tables. the density tables use as many
+    // sampling points as the pressure tables.
+    static size_t numTabulatedValues_(unsigned nTemp, unsigned nPress)
+    {
+        const unsigned nDensity = nPress;
+        return
+            5*static_cast<size_t>(nTemp)
+            + 10*static_cast<size_t>(nTemp)*nPress
+            + 2*static_cast<size_t>(nTemp)*nDensity;
+    }
+
+    // let the tables point into a contiguous chunk of memory
+    static void assignArrays_(Scalar* storage)
+    {
+        const size_t nTP = static_cast<size_t>(nTemp_)*nPress_;
+        const size_t nTRho = static_cast<size_t>(nTemp_)*nDensity_;
+
+        vaporPressure_ = storage; storage += nTemp_;
+        minGasDensity__ = storage; storage += nTemp_;
+        maxGasDensity__ = storage; storage += nTemp_;
+        minLiquidDensity__ = storage; storage += nTemp_;
+        maxLiquidDensity__ = storage; storage += nTemp_;
+
+        gasEnthalpy_ = storage; storage += nTP;
+        liquidEnthalpy_ = storage; storage += nTP;
+        gasHeatCapacity_ = storage; storage += nTP;
+        liquidHeatCapacity_ = storage; storage += nTP;
+        gasDensity_ = storage; storage += nTP;
+        liquidDensity_ = storage; storage += nTP;
+        gasViscosity_ = storage; storage += nTP;
+        liquidViscosity_ = storage; storage += nTP;
+        gasThermalConductivity_ = storage; storage += nTP;
+        liquidThermalConductivity_ = storage; storage += nTP;
+        gasPressure_ = storage; storage += nTRho;
+        liquidPressure_ = storage;
+    }
+
+    static void fillArrays_()
+    {
+        assert(std::numeric_limits<Scalar>::has_quiet_NaN);
+        Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
+
+        // fill the temperature-pressure arrays
+        for (unsigned iT = 0; iT < nTemp_; ++ iT) {
+            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
+
+            try { vaporPressure_[iT] = RawComponent::vaporPressure(temperature); }
+            catch (const std::exception&) { vaporPressure_[iT] = NaN; }
+
+            Scalar pgMax = maxGasPressure_(iT);
+            Scalar pgMin = minGasPressure_(iT);
+
+            // fill the temperature, pressure gas arrays
+            for (unsigned iP = 0; iP < nPress_; ++ iP) {
+                Scalar pressure = iP * (pgMax - pgMin)/(nPress_ - 1) + pgMin;
+
+                unsigned i = iT + iP*nTemp_;
+
+                try { gasEnthalpy_[i] = RawComponent::gasEnthalpy(temperature, pressure); }
+                catch (const std::exception&) { gasEnthalpy_[i] = NaN; }
+
+                try { gasHeatCapacity_[i] = RawComponent::gasHeatCapacity(temperature, pressure); }
+                catch (const std::exception&) { gasHeatCapacity_[i] = NaN; }
+
+                try { gasDensity_[i] = RawComponent::gasDensity(temperature, pressure); }
+                catch (const std::exception&) { gasDensity_[i] = NaN; }
+
+                try { gasViscosity_[i] = RawComponent::gasViscosity(temperature, pressure); }
+                catch (const std::exception&) { gasViscosity_[i] = NaN; }
+
+                try { gasThermalConductivity_[i] = RawComponent::gasThermalConductivity(temperature, pressure); }
+                catch (const std::exception&) { gasThermalConductivity_[i] = NaN; }
+            };
+
+            Scalar plMin = minLiquidPressure_(iT);
+            Scalar plMax = maxLiquidPressure_(iT);
+            for (unsigned iP = 0; iP < nPress_; ++ iP) {
+                Scalar pressure = iP * (plMax - plMin)/(nPress_ - 1) + plMin;
+
+                unsigned i = iT + iP*nTemp_;
+
+                try { liquidEnthalpy_[i] = RawComponent::liquidEnthalpy(temperature, pressure); }
+                catch (const std::exception&) { liquidEnthalpy_[i] = NaN; }
+
+                try { liquidHeatCapacity_[i] = RawComponent::liquidHeatCapacity(temperature, pressure); }
+                catch (const std::exception&) { liquidHeatCapacity_[i] = NaN; }
+
+                try { liquidDensity_[i] = RawComponent::liquidDensity(temperature, pressure); }
+                catch (const std::exception&) { liquidDensity_[i] = NaN; }
+
+                try { liquidViscosity_[i] = RawComponent::liquidViscosity(temperature, pressure); }
+                catch (const std::exception&) { liquidViscosity_[i] = NaN; }
+
+                try { liquidThermalConductivity_[i] = RawComponent::liquidThermalConductivity(temperature, pressure); }
+                catch (const std::exception&) { liquidThermalConductivity_[i] = NaN; }
+            }
+        }
+
+        // fill the temperature-density arrays
+        for (unsigned iT = 0; iT < nTemp_; ++ iT) {
+            Scalar temperature = iT * (tempMax_ - tempMin_)/(nTemp_ - 1) + tempMin_;
+
+            // calculate the minimum and maximum values for the gas
+            // densities
+            minGasDensity__[iT] = RawComponent::gasDensity(temperature, minGasPressure_(iT));
+            if (iT < nTemp_ - 1)
+                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT + 1));
+            else
+                maxGasDensity__[iT] = RawComponent::gasDensity(temperature, maxGasPressure_(iT));
+
+            // fill the temperature, density gas arrays
+            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
+                Scalar density =
+                    Scalar(iRho)/(nDensity_ - 1) *
+                    (maxGasDensity__[iT] - minGasDensity__[iT])
+                    +
+                    minGasDensity__[iT];
+
+                unsigned i = iT + iRho*nTemp_;
+
+                try { gasPressure_[i] = RawComponent::gasPressure(temperature, density); }
+                catch (const std::exception&) { gasPressure_[i] = NaN; };
+            };
+
+            // calculate the minimum and maximum values for the liquid
+            // densities
+            minLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, minLiquidPressure_(iT));
+            if (iT < nTemp_ - 1)
+                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT + 1));
+            else
+                maxLiquidDensity__[iT] = RawComponent::liquidDensity(temperature, maxLiquidPressure_(iT));
+
+            // fill the temperature, density liquid arrays
+            for (unsigned iRho = 0; iRho < nDensity_; ++ iRho) {
+                Scalar density =
+                    Scalar(iRho)/(nDensity_ - 1) *
+                    (maxLiquidDensity__[iT] - minLiquidDensity__[iT])
+                    +
+                    minLiquidDensity__[iT];
+
+                unsigned i = iT + iRho*nTemp_;
+
+                try { liquidPressure_[i] = RawComponent::liquidPressure(temperature, density); }
+                catch (const std::exception&) { liquidPressure_[i] = NaN; };
+            };
+        }
+    }
+
     // returns an interpolated value depending on temperature
     template <class Evaluation>
     static Evaluation interpolateT_(const Scalar* values, const Evaluation& T)
@@ -796,6 +876,9 @@ private:
     static Scalar densityMin_;
     static Scalar densityMax_;
     static unsigned nDensity_;
+
+    // the shared memory segment which holds the tables if initShared() was used
+    static std::unique_ptr<SharedMemoryRegion> sharedRegion_;
 };
 
 template <class Scalar, class RawComponent, bool useVaporPressure>
@@ -850,6 +933,8 @@ template <class Scalar, class RawComponent, bool useVaporPressure>
 Scalar TabulatedComponent<Scalar, RawComponent, useVaporPressure>::densityMax_;
 template <class Scalar, class RawComponent, bool useVaporPressure>
 unsigned TabulatedComponent<Scalar, RawComponent, useVaporPressure>::nDensity_;
+template <class Scalar, class RawComponent, bool useVaporPressure>
+std::unique_ptr<SharedMemoryRegion> TabulatedComponent<Scalar, RawComponent, useVaporPressure>::sharedRegion_;
 
 
 } // namespace Opm
@@ -27,6 +27,7 @@
 #ifndef OPM_COMPOSITION_FROM_FUGACITIES_HPP
 #define OPM_COMPOSITION_FROM_FUGACITIES_HPP
 
+#include <opm/material/constraintsolvers/ConstraintSolverStatistics.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 #include <opm/material/common/Exceptions.hpp>
 #include <opm/material/common/Valgrind.hpp>
@@ -34,6 +35,8 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace Opm {
@@ -95,6 +98,75 @@ public:
             xInit[i] = fluidState.moleFraction(phaseIdx, i);
         }
 
+        ConstraintSolverStatistics<Scalar> stats;
+        if (!solveNewton_(fluidState, paramCache, phaseIdx, targetFug, stats))
+            throwNotConverged_(fluidState, phaseIdx, xInit, targetFug);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the component
+     *        fugacities in a phase and report convergence statistics.
+     *
+     * The composition of the phase which is stored in the fluid state is used as the
+     * initial guess, so passing the converged composition of the previous time step
+     * usually means that the Newton method only needs one or two iterations. If
+     * 'maxSubstitutionIterations' is larger than zero, up to this number of successive
+     * substitution steps \f$x^\kappa \leftarrow f^\kappa/(\phi^\kappa p)\f$ are
+     * done before the Newton method is started. In case the Newton method does not
+     * converge, it is restarted from the initial guess of guessInitial().
+     *
+     * The phase's fugacities must already be set.
+     */
+    template <class FluidState>
+    static void solve(FluidState& fluidState,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      unsigned phaseIdx,
+                      const ComponentVector& targetFug,
+                      ConstraintSolverStatistics<Scalar>& stats,
+                      unsigned maxSubstitutionIterations = 0)
+    {
+        stats.reset();
+
+        if (FluidSystem::isIdealMixture(phaseIdx)) {
+            solveIdealMix_(fluidState, paramCache, phaseIdx, targetFug);
+            stats.converged = true;
+            return;
+        }
+
+        Dune::FieldVector<Evaluation, numComponents> xInit;
+        for (unsigned i = 0; i < numComponents; ++i) {
+            xInit[i] = fluidState.moleFraction(phaseIdx, i);
+        }
+
+        if (maxSubstitutionIterations > 0)
+            successiveSubstitution_(fluidState, paramCache, phaseIdx, targetFug,
+                                    maxSubstitutionIterations, stats);
+
+        try {
+            if (solveNewton_(fluidState, paramCache, phaseIdx, targetFug, stats))
+                return;
+        }
+        catch (const NumericalIssue&) {
+            // restart from the default initial guess below
+        }
+
+        stats.fallbackTaken = true;
+        guessInitial(fluidState, phaseIdx, targetFug);
+        if (!solveNewton_(fluidState, paramCache, phaseIdx, targetFug, stats))
+            throwNotConverged_(fluidState, phaseIdx, xInit, targetFug);
+    }
+
+
+protected:
+    // run the Newton method starting at the composition which is stored in the fluid
+    // state. returns true if the method converged.
+    template <class FluidState>
+    static bool solveNewton_(FluidState& fluidState,
+                             typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                             unsigned phaseIdx,
+                             const ComponentVector& targetFug,
+                             ConstraintSolverStatistics<Scalar>& stats)
+    {
         /////////////////////////
         // Newton method
         /////////////////////////
@@ -108,50 +180,26 @@ public:
 
         paramCache.updatePhase(fluidState, phaseIdx);
 
+        stats.converged = false;
+
         // maximum number of iterations
         const int nMax = 25;
         for (int nIdx = 0; nIdx < nMax; ++nIdx) {
+            ++stats.numIterations;
+
             // calculate Jacobian matrix and right hand side
-            linearize_(J, b, fluidState, paramCache, phaseIdx, targetFug);
+            stats.residual = linearize_(J, b, fluidState, paramCache, phaseIdx, targetFug);
             Valgrind::CheckDefined(J);
             Valgrind::CheckDefined(b);
 
-            /*
-            std::cout << FluidSystem::phaseName(phaseIdx) << "Phase composition: ";
-            for (unsigned i = 0; i < FluidSystem::numComponents; ++i)
-                std::cout << fluidState.moleFraction(phaseIdx, i) << " ";
-            std::cout << "\n";
-            std::cout << FluidSystem::phaseName(phaseIdx) << "Phase phi: ";
-            for (unsigned i = 0; i < FluidSystem::numComponents; ++i)
-                std::cout << fluidState.fugacityCoefficient(phaseIdx, i) << " ";
-            std::cout << "\n";
-            */
-
             // Solve J*x = b
             x = 0.0;
             try { J.solve(x, b); }
             catch (const Dune::FMatrixError& e)
             { throw NumericalIssue(e.what()); }
 
-            //std::cout << "original delta: " << x << "\n";
-
             Valgrind::CheckDefined(x);
 
-            /*
-            std::cout << FluidSystem::phaseName(phaseIdx) << "Phase composition: ";
-            for (unsigned i = 0; i < FluidSystem::numComponents; ++i)
-                std::cout << fluidState.moleFraction(phaseIdx, i) << " ";
-            std::cout << "\n";
-            std::cout << "J: " << J << "\n";
-            std::cout << "rho: " << fluidState.density(phaseIdx) << "\n";
-            std::cout << "delta: " << x << "\n";
-            std::cout << "defect: " << b << "\n";
-
-            std::cout << "J: " << J << "\n";
-
-            std::cout << "---------------------------\n";
-            */
-
             // update the fluid composition. b is also used to store
             // the defect for the next iteration.
             Scalar relError = update_(fluidState, paramCache, x, b, phaseIdx, targetFug);
@@ -160,11 +208,63 @@ public:
                 const Evaluation& rho = FluidSystem::density(fluidState, paramCache, phaseIdx);
                 fluidState.setDensity(phaseIdx, rho);
 
-                //std::cout << "num iterations: " << nIdx << "\n";
-                return;
+                stats.converged = true;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // do a few steps of successive substitution, i.e., compute the composition which
+    // would yield the target fugacities if the fugacity coefficients were independent
+    // of the composition. this is cheap and it is typically a good way to get close
+    // to the solution for phases which are not far away from ideal mixtures.
+    template <class FluidState>
+    static void successiveSubstitution_(FluidState& fluidState,
+                                        typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                        unsigned phaseIdx,
+                                        const ComponentVector& targetFug,
+                                        unsigned maxIterations,
+                                        ConstraintSolverStatistics<Scalar>& stats)
+    {
+        paramCache.updatePhase(fluidState, phaseIdx);
+
+        ComponentVector newX;
+        for (unsigned iterIdx = 0; iterIdx < maxIterations; ++iterIdx) {
+            Scalar maxDelta = 0.0;
+            for (unsigned i = 0; i < numComponents; ++i) {
+                const Evaluation& phi = FluidSystem::fugacityCoefficient(fluidState,
+                                                                         paramCache,
+                                                                         phaseIdx,
+                                                                         i);
+                newX[i] = targetFug[i]/(phi*fluidState.pressure(phaseIdx));
+
+                // leave the problematic cases to the Newton method
+                if (!std::isfinite(scalarValue(newX[i])))
+                    return;
+
+                maxDelta = std::max<Scalar>(maxDelta,
+                                            std::abs(scalarValue(newX[i])
+                                                     - scalarValue(fluidState.moleFraction(phaseIdx, i))));
             }
+
+            ++stats.numSubstitutionIterations;
+            for (unsigned i = 0; i < numComponents; ++i)
+                fluidState.setMoleFraction(phaseIdx, i, newX[i]);
+            paramCache.updateComposition(fluidState, phaseIdx);
+
+            if (maxDelta < 1e-9)
+                return;
         }
+    }
 
+    template <class FluidState>
+    static void throwNotConverged_(const FluidState& fluidState,
+                                   unsigned phaseIdx,
+                                   const Dune::FieldVector<Evaluation, numComponents>& xInit,
+                                   const ComponentVector& targetFug)
+    {
         std::ostringstream oss;
         oss << "Calculating the " << FluidSystem::phaseName(phaseIdx)
             << "Phase composition failed. Initial {x} = {"
@@ -174,8 +274,6 @@ public:
         throw NumericalIssue(oss.str());
     }
 
-
-protected:
     // update the phase composition in case the phase is an ideal
     // mixture, i.e. the component's fugacity coefficients are
     // independent of the phase's composition.
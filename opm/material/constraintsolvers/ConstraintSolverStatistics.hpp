@@ -0,0 +1,76 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ConstraintSolverStatistics
+ */
+#ifndef OPM_CONSTRAINT_SOLVER_STATISTICS_HPP
+#define OPM_CONSTRAINT_SOLVER_STATISTICS_HPP
+
+namespace Opm {
+
+/*!
+ * \brief Convergence statistics reported by the non-linear constraint solvers.
+ *
+ * This is filled by the variants of NcpFlash::solve() and
+ * CompositionFromFugacities::solve() which take a statistics object. It allows to
+ * find out how "hard" a given cell is and how much was gained by providing a good
+ * initial guess.
+ */
+template <class Scalar>
+struct ConstraintSolverStatistics
+{
+    ConstraintSolverStatistics()
+    { reset(); }
+
+    /*!
+     * \brief Reset all counters to their initial values.
+     */
+    void reset()
+    {
+        numIterations = 0;
+        numSubstitutionIterations = 0;
+        residual = 0.0;
+        converged = false;
+        fallbackTaken = false;
+    }
+
+    //! The number of Newton iterations which were used (including the ones of a fallback)
+    unsigned numIterations;
+
+    //! The number of successive substitution steps done before the Newton method
+    unsigned numSubstitutionIterations;
+
+    //! The maximum norm of the defect of the last linearization
+    Scalar residual;
+
+    //! Specifies whether the solver has reached the requested tolerance
+    bool converged;
+
+    //! Specifies whether the solver had to fall back to the default initial guess
+    bool fallbackTaken;
+};
+
+} // namespace Opm
+
+#endif
@@ -27,6 +27,7 @@
 #ifndef OPM_NCP_FLASH_HPP
 #define OPM_NCP_FLASH_HPP
 
+#include <opm/material/constraintsolvers/ConstraintSolverStatistics.hpp>
 #include <opm/material/fluidmatrixinteractions/NullMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
@@ -41,6 +42,7 @@
 #include <dune/common/fmatrix.hh>
 #include <dune/common/version.hh>
 
+#include <algorithm>
 #include <limits>
 #include <iostream>
 
@@ -150,6 +152,109 @@ public:
                       typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
                       const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
                       Scalar tolerance = -1.0)
+    {
+        ConstraintSolverStatistics<Scalar> stats;
+        solve<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the component
+     *        fugacities in a phase and report convergence statistics.
+     *
+     * The quantities stored in the fluid state are used as the initial guess for the
+     * Newton method. The number of iterations and the final residual are written to
+     * the statistics object, even if the method does not converge. The statistics
+     * object is reset before the Newton method is started.
+     */
+    template <class MaterialLaw, class FluidState>
+    static void solve(FluidState& fluidState,
+                      const typename MaterialLaw::Params& matParams,
+                      typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                      const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                      ConstraintSolverStatistics<Scalar>& stats,
+                      Scalar tolerance = -1.0)
+    {
+        stats.reset();
+        solveNewton_<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium using a previously converged state
+     *        as the initial guess.
+     *
+     * This is intended for time stepping schemes where the solution of the last time
+     * step is normally only a few Newton iterations away from the current one: The
+     * pressure of the first phase, the saturations and the mole fractions of the
+     * initial fluid state are copied to the fluid state before the Newton method is
+     * started. (the temperature of the fluid state is left untouched.) If the Newton
+     * method does not converge from this starting point, the flash is repeated
+     * starting from the guess of guessInitial(). This is recorded in the
+     * 'fallbackTaken' attribute of the statistics object.
+     */
+    template <class MaterialLaw, class FluidState, class InitialFluidState>
+    static void solveFromInitial(FluidState& fluidState,
+                                 const InitialFluidState& initialFluidState,
+                                 const typename MaterialLaw::Params& matParams,
+                                 typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                                 const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                                 ConstraintSolverStatistics<Scalar>& stats,
+                                 Scalar tolerance = -1.0)
+    {
+        stats.reset();
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fluidState.setPressure(phaseIdx, initialFluidState.pressure(phaseIdx));
+            fluidState.setSaturation(phaseIdx, initialFluidState.saturation(phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fluidState.setMoleFraction(phaseIdx, compIdx,
+                                           initialFluidState.moleFraction(phaseIdx, compIdx));
+        }
+
+        try {
+            solveNewton_<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+            return;
+        }
+        catch (const NumericalIssue&) {
+            // fall back to the standard initial guess below
+        }
+
+        stats.fallbackTaken = true;
+        guessInitial(fluidState, globalMolarities);
+        solveNewton_<MaterialLaw>(fluidState, matParams, paramCache, globalMolarities, stats, tolerance);
+    }
+
+    /*!
+     * \brief Calculates the chemical equilibrium from the component
+     *        fugacities in a phase.
+     *
+     * This is a convenience method which assumes that the capillary pressure is
+     * zero...
+     */
+    template <class FluidState, class ComponentVector>
+    static void solve(FluidState& fluidState,
+                      const ComponentVector& globalMolarities,
+                      Scalar tolerance = 0.0)
+    {
+        typedef NullMaterialTraits<Scalar, numPhases> MaterialTraits;
+        typedef NullMaterial<MaterialTraits> MaterialLaw;
+        typedef typename MaterialLaw::Params MaterialLawParams;
+
+        MaterialLawParams matParams;
+        solve<MaterialLaw>(fluidState, matParams, globalMolarities, tolerance);
+    }
+
+
+protected:
+    // the Newton method of solve(). in contrast to the public method, the statistics
+    // object is not reset, i.e., the iterations are added to the ones which are
+    // already recorded
+    template <class MaterialLaw, class FluidState>
+    static void solveNewton_(FluidState& fluidState,
+                             const typename MaterialLaw::Params& matParams,
+                             typename FluidSystem::template ParameterCache<typename FluidState::Scalar>& paramCache,
+                             const Dune::FieldVector<typename FluidState::Scalar, numComponents>& globalMolarities,
+                             ConstraintSolverStatistics<Scalar>& stats,
+                             Scalar tolerance)
     {
         typedef typename FluidState::Scalar InputEval;
 
@@ -198,20 +303,26 @@ public:
         for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
             flashGlobalMolarities[compIdx] = globalMolarities[compIdx];
 
+        stats.converged = false;
+
         FlashDefectVector defect;
         const unsigned nMax = 50; // <- maximum number of newton iterations
         for (unsigned nIdx = 0; nIdx < nMax; ++nIdx) {
+            ++stats.numIterations;
+
             // calculate the defect of the flash equations and their derivatives
             evalDefect_(defect, flashFluidState, flashGlobalMolarities);
             Valgrind::CheckDefined(defect);
 
             // create field matrices and vectors out of the evaluation vector to solve
             // the linear system of equations.
+            stats.residual = 0.0;
             for (unsigned eqIdx = 0; eqIdx < numEq; ++ eqIdx) {
                 for (unsigned pvIdx = 0; pvIdx < numEq; ++ pvIdx)
                     J[eqIdx][pvIdx] = defect[eqIdx].derivative(pvIdx);
 
                 b[eqIdx] = defect[eqIdx].value();
+                stats.residual = std::max<Scalar>(stats.residual, std::abs(scalarValue(b[eqIdx])));
             }
             Valgrind::CheckDefined(J);
             Valgrind::CheckDefined(b);
@@ -228,6 +339,7 @@ public:
             Scalar relError = update_<MaterialLaw>(flashFluidState, matParams, flashParamCache, deltaX);
 
             if (relError < tolerance) {
+                stats.converged = true;
                 assignOutputFluidState_(flashFluidState, fluidState);
                 return;
             }
@@ -240,28 +352,7 @@ public:
         throw NumericalIssue(oss.str());
     }
 
-    /*!
-     * \brief Calculates the chemical equilibrium from the component
-     *        fugacities in a phase.
-     *
-     * This is a convenience method which assumes that the capillary pressure is
-     * zero...
-     */
-    template <class FluidState, class ComponentVector>
-    static void solve(FluidState& fluidState,
-                      const ComponentVector& globalMolarities,
-                      Scalar tolerance = 0.0)
-    {
-        typedef NullMaterialTraits<Scalar, numPhases> MaterialTraits;
-        typedef NullMaterial<MaterialTraits> MaterialLaw;
-        typedef typename MaterialLaw::Params MaterialLawParams;
-
-        MaterialLawParams matParams;
-        solve<MaterialLaw>(fluidState, matParams, globalMolarities, tolerance);
-    }
-
 
-protected:
     template <class FluidState>
     static void printFluidState_(const FluidState& fluidState)
     {
@@ -632,4 +632,26 @@ public:
 
 #include "EvaluationSpecializations.hpp"
 
+#include <opm/material/common/ExplicitInstantiation.hpp>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+namespace Opm {
+namespace DenseAd {
+// these are compiled into the opm-material library (see Evaluation.cpp)
+extern template class Evaluation<double, 1>;
+extern template class Evaluation<double, 2>;
+extern template class Evaluation<double, 3>;
+extern template class Evaluation<double, 4>;
+extern template class Evaluation<double, 5>;
+extern template class Evaluation<double, 6>;
+extern template class Evaluation<double, 7>;
+extern template class Evaluation<double, 8>;
+extern template class Evaluation<double, 9>;
+extern template class Evaluation<double, 10>;
+extern template class Evaluation<double, 11>;
+extern template class Evaluation<double, 12>;
+} // namespace DenseAd
+} // namespace Opm
+#endif
+
 #endif // OPM_DENSEAD_EVALUATION_HPP
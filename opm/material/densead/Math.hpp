@@ -34,7 +34,19 @@
 
 #include "Evaluation.hpp"
 
+#include <opm/material/common/FastMath.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/SimdPack.hpp>
+
+#include <type_traits>
+
+// If this macro is set to 1, the values of exp(), log(), log10() and pow() of
+// Evaluations with float or double values are computed by the polynomial
+// approximations of Opm::FastMath instead of the standard library. See FastMath.hpp
+// for their error bounds.
+#ifndef OPM_DENSEAD_FAST_MATH
+#define OPM_DENSEAD_FAST_MATH 0
+#endif
 
 namespace Opm {
 namespace DenseAd {
@@ -278,10 +290,50 @@ Evaluation<ValueType, numVars, staticSize> sqrt(const Evaluation<ValueType, numV
     return result;
 }
 
+//! \cond SKIP
+// the transcendental functions used for the values of the Evaluations
+template <class ValueType,
+          bool fast = OPM_DENSEAD_FAST_MATH && std::is_floating_point<ValueType>::value>
+struct ValueMath_
+{
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    static ValueType exp(const ValueType& x)
+    { return ValueTypeToolbox::exp(x); }
+
+    static ValueType log(const ValueType& x)
+    { return ValueTypeToolbox::log(x); }
+
+    static ValueType log10(const ValueType& x)
+    { return ValueTypeToolbox::log10(x); }
+
+    template <class ExpType>
+    static ValueType pow(const ValueType& base, const ExpType& exp)
+    { return ValueTypeToolbox::pow(base, exp); }
+};
+
+template <class ValueType>
+struct ValueMath_<ValueType, /*fast=*/true>
+{
+    static ValueType exp(ValueType x)
+    { return FastMath::exp(x); }
+
+    static ValueType log(ValueType x)
+    { return FastMath::log(x); }
+
+    static ValueType log10(ValueType x)
+    { return FastMath::log(x)*static_cast<ValueType>(0.43429448190325182765); }
+
+    template <class ExpType>
+    static ValueType pow(ValueType base, const ExpType& exp)
+    { return FastMath::pow(base, static_cast<ValueType>(exp)); }
+};
+//! \endcond
+
 template <class ValueType, int numVars, unsigned staticSize>
 Evaluation<ValueType, numVars, staticSize> exp(const Evaluation<ValueType, numVars, staticSize>& x)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
     Evaluation<ValueType, numVars, staticSize> result(x);
 
     const ValueType& exp_x = ValueTypeToolbox::exp(x.value());
@@ -300,7 +352,7 @@ template <class ValueType, int numVars, unsigned staticSize, class ExpType>
 Evaluation<ValueType, numVars, staticSize> pow(const Evaluation<ValueType, numVars, staticSize>& base,
                                                const ExpType& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
     Evaluation<ValueType, numVars, staticSize> result(base);
 
     const ValueType& pow_x = ValueTypeToolbox::pow(base.value(), exp);
@@ -326,7 +378,7 @@ template <class BaseType, class ValueType, int numVars, unsigned staticSize>
 Evaluation<ValueType, numVars, staticSize> pow(const BaseType& base,
                                                const Evaluation<ValueType, numVars, staticSize>& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars, staticSize> result(exp);
 
@@ -354,7 +406,7 @@ template <class ValueType, int numVars, unsigned staticSize>
 Evaluation<ValueType, numVars, staticSize> pow(const Evaluation<ValueType, numVars, staticSize>& base,
                                                const Evaluation<ValueType, numVars, staticSize>& exp)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars, staticSize> result(base);
 
@@ -385,7 +437,7 @@ Evaluation<ValueType, numVars, staticSize> pow(const Evaluation<ValueType, numVa
 template <class ValueType, int numVars, unsigned staticSize>
 Evaluation<ValueType, numVars, staticSize> log(const Evaluation<ValueType, numVars, staticSize>& x)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars, staticSize> result(x);
 
@@ -403,20 +455,158 @@ Evaluation<ValueType, numVars, staticSize> log(const Evaluation<ValueType, numVa
 template <class ValueType, int numVars, unsigned staticSize>
 Evaluation<ValueType, numVars, staticSize> log10(const Evaluation<ValueType, numVars, staticSize>& x)
 {
-    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    typedef ValueMath_<ValueType> ValueTypeToolbox;
 
     Evaluation<ValueType, numVars, staticSize> result(x);
 
     result.setValue(ValueTypeToolbox::log10(x.value()));
 
     // derivatives use the chain rule
-    const ValueType& df_dx = 1/x.value() * ValueTypeToolbox::log10(ValueTypeToolbox::exp(1.0));
+    const ValueType& df_dx = 1/x.value() * MathToolbox<ValueType>::log10(MathToolbox<ValueType>::exp(1.0));
     for (int curVarIdx = 0; curVarIdx < result.size(); ++curVarIdx)
         result.setDerivative(curVarIdx, df_dx*x.derivative(curVarIdx));
 
     return result;
 }
 
+// evaluations of SIMD packs: the functions above which need to branch on the value of
+// their arguments are replaced by lane-wise blends
+template <class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+select(const SimdMask<width>& mask,
+       const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& a,
+       const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& b)
+{
+    Evaluation<SimdPack<Scalar, width>, numVars, staticSize> result(b);
+
+    result.setValue(Opm::select(mask, a.value(), b.value()));
+    for (int curVarIdx = 0; curVarIdx < result.size(); ++curVarIdx)
+        result.setDerivative(curVarIdx, Opm::select(mask, a.derivative(curVarIdx), b.derivative(curVarIdx)));
+
+    return result;
+}
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+abs(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x)
+{ return select(x.value() > 0.0, x, -x); }
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+min(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x1,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x2)
+{ return select(x1.value() < x2.value(), x1, x2); }
+
+template <class Arg1ValueType, class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+min(const Arg1ValueType& x1,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x2)
+{
+    Evaluation<SimdPack<Scalar, width>, numVars, staticSize> ret(x2);
+    ret = x1;
+    return select(ret.value() < x2.value(), ret, x2);
+}
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize, class Arg2ValueType>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+min(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x1,
+    const Arg2ValueType& x2)
+{ return min(x2, x1); }
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+max(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x1,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x2)
+{ return select(x1.value() > x2.value(), x1, x2); }
+
+template <class Arg1ValueType, class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+max(const Arg1ValueType& x1,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x2)
+{
+    Evaluation<SimdPack<Scalar, width>, numVars, staticSize> ret(x2);
+    ret = x1;
+    return select(ret.value() > x2.value(), ret, x2);
+}
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize, class Arg2ValueType>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+max(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& x1,
+    const Arg2ValueType& x2)
+{ return max(x2, x1); }
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize, class ExpType>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+pow(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& base,
+    const ExpType& exp)
+{
+    typedef SimdPack<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+    Evaluation<ValueType, numVars, staticSize> result(base);
+
+    const ValueType& pow_x = ValueTypeToolbox::pow(base.value(), exp);
+    result.setValue(pow_x);
+
+    // derivatives use the chain rule. the lanes where the base is zero get discarded
+    const ValueType& df_dx = pow_x/base.value()*exp;
+    for (int curVarIdx = 0; curVarIdx < result.size(); ++curVarIdx)
+        result.setDerivative(curVarIdx, df_dx*base.derivative(curVarIdx));
+
+    Evaluation<ValueType, numVars, staticSize> zero(base);
+    zero = 0.0;
+    return select(base.value() == 0.0, zero, result);
+}
+
+template <class BaseType, class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+pow(const BaseType& base,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& exp)
+{
+    typedef SimdPack<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    Evaluation<ValueType, numVars, staticSize> result(exp);
+
+    const ValueType& lnBase = ValueTypeToolbox::log(base);
+    result.setValue(ValueTypeToolbox::exp(lnBase*exp.value()));
+
+    // derivatives use the chain rule
+    const ValueType& df_dx = lnBase*result.value();
+    for (int curVarIdx = 0; curVarIdx < result.size(); ++curVarIdx)
+        result.setDerivative(curVarIdx, df_dx*exp.derivative(curVarIdx));
+
+    Evaluation<ValueType, numVars, staticSize> zero(exp);
+    zero = 0.0;
+    return select(ValueType(base) == 0.0, zero, result);
+}
+
+template <class Scalar, unsigned width, int numVars, unsigned staticSize>
+Evaluation<SimdPack<Scalar, width>, numVars, staticSize>
+pow(const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& base,
+    const Evaluation<SimdPack<Scalar, width>, numVars, staticSize>& exp)
+{
+    typedef SimdPack<Scalar, width> ValueType;
+    typedef MathToolbox<ValueType> ValueTypeToolbox;
+
+    Evaluation<ValueType, numVars, staticSize> result(base);
+
+    ValueType valuePow = ValueTypeToolbox::pow(base.value(), exp.value());
+    result.setValue(valuePow);
+
+    const ValueType& f = base.value();
+    const ValueType& g = exp.value();
+    const ValueType& logF = ValueTypeToolbox::log(f);
+    for (int curVarIdx = 0; curVarIdx < result.size(); ++curVarIdx) {
+        const ValueType& fPrime = base.derivative(curVarIdx);
+        const ValueType& gPrime = exp.derivative(curVarIdx);
+        result.setDerivative(curVarIdx, (g*fPrime/f + logF*gPrime) * valuePow);
+    }
+
+    Evaluation<ValueType, numVars, staticSize> zero(base);
+    zero = 0.0;
+    return select(base.value() == 0.0, zero, result);
+}
+
 } // namespace DenseAd
 
 // a kind of traits class for the automatic differentiation case. (The toolbox for the
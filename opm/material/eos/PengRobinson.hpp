@@ -35,7 +35,10 @@
 #include <opm/material/common/Unused.hpp>
 #include <opm/material/common/PolynomialUtils.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <csignal>
+#include <utility>
 
 namespace Opm {
 
@@ -152,6 +155,7 @@ public:
         Valgrind::CheckDefined(fs.pressure(phaseIdx));
 
         typedef typename FluidState::Scalar Evaluation;
+        typedef typename MathToolbox<Evaluation>::Scalar RawScalar;
 
         Evaluation Vm = 0;
         Valgrind::SetUndefined(Vm);
@@ -172,35 +176,38 @@ public:
         const Evaluation& Astar = a*p/(RT*RT);
         const Evaluation& Bstar = b*p/RT;
 
-        const Evaluation& a1 = 1.0;
+        // coefficients of the monic cubic polynomial for the compressibility factor
         const Evaluation& a2 = - (1 - Bstar);
         const Evaluation& a3 = Astar - Bstar*(3*Bstar + 2);
         const Evaluation& a4 = Bstar*(- Astar + Bstar*(1 + Bstar));
-
-        // ignore the first two results if the smallest
-        // compressibility factor is <= 0.0. (this means that if we
-        // would get negative molar volumes for the liquid phase, we
-        // consider the liquid phase non-existant.)
-        Evaluation Z[3] = {0.0,0.0,0.0};
-        Valgrind::CheckDefined(a1);
         Valgrind::CheckDefined(a2);
         Valgrind::CheckDefined(a3);
         Valgrind::CheckDefined(a4);
-        int numSol = invertCubicPolynomial(Z, a1, a2, a3, a4);
+
+        // the roots are determined using plain floating point values. the
+        // derivatives of the selected root are then recovered using the implicit
+        // function theorem. (this is much cheaper than solving the cubic using
+        // evaluations and it does not exhibit any singularities if two roots are
+        // close to each other.)
+        RawScalar Z[3] = {0.0, 0.0, 0.0};
+        int numSol = invertMonicCubicPolynomial(Z,
+                                                scalarValue(a2),
+                                                scalarValue(a3),
+                                                scalarValue(a4));
         if (numSol == 3) {
             // the EOS has three intersections with the pressure,
             // i.e. the molar volume of gas is the largest one and the
             // molar volume of liquid is the smallest one
             if (isGasPhase)
-                Vm = Z[2]*RT/p;
+                Vm = cubicRoot_(Z[2], a2, a3, a4)*RT/p;
             else
-                Vm = Z[0]*RT/p;
+                Vm = cubicRoot_(Z[0], a2, a3, a4)*RT/p;
         }
         else if (numSol == 1) {
             // the EOS only has one intersection with the pressure,
             // for the other phase, we take the extremum of the EOS
             // with the largest distance from the intersection.
-            Evaluation VmCubic = Z[0]*RT/p;
+            Evaluation VmCubic = cubicRoot_(Z[0], a2, a3, a4)*RT/p;
             Vm = VmCubic;
 
             // find the extrema (if they are present)
@@ -232,6 +239,36 @@ public:
         return Vm;
     }
 
+    /*!
+     * \brief Computes the compressibility factors for a batch of cells.
+     *
+     * This is a variant of computeMolarVolume() for plain floating point values:
+     * For each cell, the dimensionless "attractive" and "co-volume" parameters
+     * \f$A^* = a p/(RT)^2\f$ and \f$B^* = b p/(RT)\f$ must be specified. If the EOS
+     * exhibits three roots, the largest one is used for gas phases and the smallest
+     * one for liquids. Note that in contrast to computeMolarVolume(), the single root
+     * of the cubic is used as-is if the EOS only exhibits one intersection with the
+     * pressure.
+     */
+    template <class RawScalar>
+    static void computeCompressibilityFactors(RawScalar* Z,
+                                              const RawScalar* Astar,
+                                              const RawScalar* Bstar,
+                                              size_t numCells,
+                                              bool isGasPhase)
+    {
+        RawScalar roots[3];
+        for (size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const RawScalar A = Astar[cellIdx];
+            const RawScalar B = Bstar[cellIdx];
+            int numSol = invertMonicCubicPolynomial(roots,
+                                                    /*a2=*/- (1 - B),
+                                                    /*a3=*/A - B*(3*B + 2),
+                                                    /*a4=*/B*(- A + B*(1 + B)));
+            Z[cellIdx] = (isGasPhase)?roots[numSol - 1]:roots[0];
+        }
+    }
+
     /*!
      * \brief Returns the fugacity coefficient for a given pressure
      *        and molar volume.
@@ -302,6 +339,50 @@ protected:
             Vm = min(Vm, Vcrit);
     }
 
+    // returns a root of a monic cubic polynomial including its derivatives. The value of
+    // the root must already be known; the derivatives are obtained by the implicit
+    // function theorem, i.e., dZ = - dp/p'(Z). This is done by a single Newton step in
+    // the arithmetic of the evaluations.
+    template <class Evaluation, class RawScalar>
+    static Evaluation cubicRoot_(RawScalar Z,
+                                 const Evaluation& a2,
+                                 const Evaluation& a3,
+                                 const Evaluation& a4)
+    {
+        const Evaluation& f = a4 + Z*(a3 + Z*(a2 + Z));
+        const RawScalar fPrime = scalarValue(a3) + Z*(2*scalarValue(a2) + 3*Z);
+        if (fPrime == 0.0)
+            // double root: the derivatives are undefined
+            return f*0.0 + Z;
+
+        return Z - f/fPrime;
+    }
+
+    // the same for the roots of the quartic polynomial which determines the extrema of
+    // the EOS
+    template <class Evaluation, class RawScalar>
+    static Evaluation quarticRoot_(RawScalar V,
+                                   const Evaluation& a1,
+                                   const Evaluation& a2,
+                                   const Evaluation& a3,
+                                   const Evaluation& a4,
+                                   const Evaluation& a5)
+    {
+        const Evaluation& f = a5 + V*(a4 + V*(a3 + V*(a2 + V*a1)));
+        const RawScalar fPrime =
+            scalarValue(a4) + V*(2*scalarValue(a3) + V*(3*scalarValue(a2) + V*4*scalarValue(a1)));
+        if (fPrime == 0.0)
+            return f*0.0 + V;
+
+        return V - f/fPrime;
+    }
+
+    // the critical point of the Peng-Robinson EOS for given values of the "a" and "b"
+    // parameters. If "a" and "b" are fixed, the critical point can be calculated
+    // analytically: The first and the second derivatives of the pressure regarding
+    // molar volume vanish at the critical point. For the reduced molar volume v = V/b,
+    // this leads to v^3 - 3*v^2 - 3*v - 3 = 0, i.e., V_crit is about 3.95*b. The
+    // critical temperature follows from the first condition.
     template <class Evaluation>
     static void findCriticalPoint_(Evaluation& Tcrit,
                                    Evaluation& pcrit,
@@ -309,94 +390,19 @@ protected:
                                    const Evaluation& a,
                                    const Evaluation& b)
     {
-        Evaluation minVm(0);
-        Evaluation maxVm(1e30);
-
-        Evaluation minP(0);
-        Evaluation maxP(1e30);
-
-        // first, we need to find an isotherm where the EOS exhibits
-        // a maximum and a minimum
-        Evaluation Tmin = 250; // [K]
-        for (unsigned i = 0; i < 30; ++i) {
-            bool hasExtrema = findExtrema_(minVm, maxVm, minP, maxP, a, b, Tmin);
-            if (hasExtrema)
-                break;
-            Tmin /= 2;
-        };
-
-        Evaluation T = Tmin;
-
-        // Newton's method: Start at minimum temperature and minimize
-        // the "gap" between the extrema of the EOS
-        unsigned iMax = 100;
-        for (unsigned i = 0; i < iMax; ++i) {
-            // calculate function we would like to minimize
-            Evaluation f = maxVm - minVm;
-
-            // check if we're converged
-            if (f < 1e-10 || (i == iMax - 1 && f < 1e-8)) {
-                Tcrit = T;
-                pcrit = (minP + maxP)/2;
-                Vcrit = (maxVm + minVm)/2;
-                return;
-            }
+        typedef typename MathToolbox<Evaluation>::Scalar RawScalar;
 
-            // backward differences. Forward differences are not
-            // robust, since the isotherm could be critical if an
-            // epsilon was added to the temperature. (this is case
-            // rarely happens, though)
-            const Scalar eps = - 1e-11;
-            bool hasExtrema OPM_OPTIM_UNUSED = findExtrema_(minVm, maxVm, minP, maxP, a, b, T + eps);
-            assert(hasExtrema);
-            assert(std::isfinite(scalarValue(maxVm)));
-            Evaluation fStar = maxVm - minVm;
-
-            // derivative of the difference between the maximum's
-            // molar volume and the minimum's molar volume regarding
-            // temperature
-            Evaluation fPrime = (fStar - f)/eps;
-            if (std::abs(scalarValue(fPrime)) < 1e-40) {
-                Tcrit = T;
-                pcrit = (minP + maxP)/2;
-                Vcrit = (maxVm + minVm)/2;
-                return;
-            }
+        RawScalar v[3];
+        invertMonicCubicPolynomial(v, RawScalar(-3.0), RawScalar(-3.0), RawScalar(-3.0));
+        const RawScalar vCrit = v[0];
 
-            // update value for the current iteration
-            Evaluation delta = f/fPrime;
-            assert(std::isfinite(scalarValue(delta)));
-            if (delta > 0)
-                delta = -10;
-
-            // line search (we have to make sure that both extrema
-            // still exist after the update)
-            for (unsigned j = 0; ; ++j) {
-                if (j >= 20) {
-                    if (f < 1e-8) {
-                        Tcrit = T;
-                        pcrit = (minP + maxP)/2;
-                        Vcrit = (maxVm + minVm)/2;
-                        return;
-                    }
-
-                    std::ostringstream oss;
-                    oss << "Could not determine the critical point for a=" << a << ", b=" << b;
-                    throw NumericalIssue(oss.str());
-                }
+        // dp/dV = 0 yields R*T*b/a = (v - 1)^2*(2*v + 2)/(v^2 + 2*v - 1)^2
+        const RawScalar q = vCrit*vCrit + 2*vCrit - 1;
+        const RawScalar omegaT = (vCrit - 1)*(vCrit - 1)*(2*vCrit + 2)/(q*q);
 
-                if (findExtrema_(minVm, maxVm, minP, maxP, a, b, T - delta)) {
-                    // if the isotherm for T - delta exhibits two
-                    // extrema the update is finished
-                    T -= delta;
-                    break;
-                }
-                else
-                    delta /= 2;
-            };
-        }
-
-        assert(false);
+        Vcrit = vCrit*b;
+        Tcrit = omegaT*a/(R*b);
+        pcrit = R*Tcrit/(Vcrit - b) - a/(Vcrit*Vcrit + 2*b*Vcrit - b*b);
     }
 
     // find the two molar volumes where the EOS exhibits extrema and
@@ -429,23 +435,29 @@ protected:
         assert(std::isfinite(scalarValue(a4)));
         assert(std::isfinite(scalarValue(a5)));
 
-        // Newton method to find first root
-
-        // if the values which we got on Vmin and Vmax are usefull, we
-        // will reuse them as initial value, else we will start 10%
-        // above the covolume
-        Evaluation V = b*1.1;
-        Evaluation delta = 1.0;
-        for (unsigned i = 0; std::abs(scalarValue(delta)) > 1e-12; ++i) {
-            const Evaluation& f = a5 + V*(a4 + V*(a3 + V*(a2 + V*a1)));
-            const Evaluation& fPrime = a4 + V*(2*a3 + V*(3*a2 + V*4*a1));
-
-            if (std::abs(scalarValue(fPrime)) < 1e-20) {
+        // the roots are determined using plain floating point values, the
+        // derivatives of the extrema are recovered afterwards
+        typedef typename MathToolbox<Evaluation>::Scalar RawScalar;
+        const RawScalar a1s = scalarValue(a1);
+        const RawScalar a2s = scalarValue(a2);
+        const RawScalar a3s = scalarValue(a3);
+        const RawScalar a4s = scalarValue(a4);
+        const RawScalar a5s = scalarValue(a5);
+        const RawScalar bs = scalarValue(b);
+
+        // Newton method to find first root. we start 10% above the
+        // covolume
+        RawScalar V = bs*1.1;
+        RawScalar delta = 1.0;
+        for (unsigned i = 0; std::abs(delta) > 1e-12; ++i) {
+            const RawScalar f = a5s + V*(a4s + V*(a3s + V*(a2s + V*a1s)));
+            const RawScalar fPrime = a4s + V*(2*a3s + V*(3*a2s + V*4*a1s));
+
+            if (std::abs(fPrime) < 1e-20) {
                 // give up if the derivative is zero
                 return false;
             }
 
-
             delta = f/fPrime;
             V -= delta;
 
@@ -454,24 +466,30 @@ protected:
                 return false;
             }
         }
-        assert(std::isfinite(scalarValue(V)));
+        assert(std::isfinite(V));
 
         // polynomial division
-        Evaluation b1 = a1;
-        Evaluation b2 = a2 + V*b1;
-        Evaluation b3 = a3 + V*b2;
-        Evaluation b4 = a4 + V*b3;
+        const RawScalar b1 = a1s;
+        const RawScalar b2 = a2s + V*b1;
+        const RawScalar b3 = a3s + V*b2;
+        const RawScalar b4 = a4s + V*b3;
 
-        // invert resulting cubic polynomial analytically
-        Evaluation allV[4];
+        // invert resulting cubic polynomial
+        RawScalar allV[4];
         allV[0] = V;
-        int numSol = 1 + invertCubicPolynomial<Evaluation>(allV + 1, b1, b2, b3, b4);
+        int numCubicSol = invertMonicCubicPolynomial(allV + 1, b2/b1, b3/b1, b4/b1);
+        assert(0 <= numCubicSol && numCubicSol <= 3);
 
-        // sort all roots of the derivative
-        std::sort(allV + 0, allV + numSol);
+        // sort all roots of the derivative. this is done by hand for the at most four
+        // values because std::sort's code path for large ranges causes -Warray-bounds
+        // false positives at -O2.
+        int numSol = 1 + std::min(std::max(numCubicSol, 0), 3);
+        for (int i = 1; i < numSol; ++i)
+            for (int j = i; j > 0 && allV[j] < allV[j - 1]; --j)
+                std::swap(allV[j], allV[j - 1]);
 
         // check whether the result is physical
-        if (numSol != 4 || allV[numSol - 2] < b) {
+        if (numSol != 4 || allV[numSol - 2] < bs) {
             // the second largest extremum is smaller than the phase's
             // covolume which is physically impossible
             return false;
@@ -479,8 +497,8 @@ protected:
 
 
         // it seems that everything is okay...
-        Vmin = allV[numSol - 2];
-        Vmax = allV[numSol - 1];
+        Vmin = quarticRoot_(allV[numSol - 2], a1, a2, a3, a4, a5);
+        Vmax = quarticRoot_(allV[numSol - 1], a1, a2, a3, a4, a5);
         return true;
     }
 
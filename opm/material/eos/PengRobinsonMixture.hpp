@@ -110,20 +110,17 @@ public:
         LhsEval Astar = params.a(phaseIdx)*p/(RT*RT);
         LhsEval Bstar = params.b(phaseIdx)*p/(RT);
 
-        // calculate delta_i (see: Reid, p. 145)
+        // calculate delta_i (see: Reid, p. 145). the a_ij of the mixing rule are taken
+        // from the parameter object, but the sum is taken over the mole fractions of
+        // the fluid state to retain their derivatives.
         LhsEval sumMoleFractions = 0.0;
-        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
-            sumMoleFractions += fs.moleFraction(phaseIdx, compJIdx);
-        LhsEval deltai = 2*sqrt(params.aPure(phaseIdx, compIdx))/params.a(phaseIdx);
-        LhsEval tmp = 0;
+        LhsEval tmp = 0.0;
         for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
-            tmp +=
-                fs.moleFraction(phaseIdx, compJIdx)
-                / sumMoleFractions
-                * sqrt(params.aPure(phaseIdx, compJIdx))
-                * (1.0 - StaticParameters::interactionCoefficient(compIdx, compJIdx));
-        };
-        deltai *= tmp;
+            const LhsEval& xj = fs.moleFraction(phaseIdx, compJIdx);
+            sumMoleFractions += xj;
+            tmp += xj*params.aInteraction(phaseIdx, compIdx, compJIdx);
+        }
+        LhsEval deltai = 2*tmp/(params.a(phaseIdx)*sumMoleFractions);
 
         LhsEval base =
             (2*Z + Bstar*(u + std::sqrt(u*u - 4*w))) /
@@ -33,6 +33,9 @@
 #include <opm/material/Constants.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
 
 namespace Opm
 {
@@ -89,6 +92,11 @@ public:
         Valgrind::CheckDefined(temperature);
         Valgrind::CheckDefined(pressure);
 
+        // the parameters of the pure components only depend on temperature, so there
+        // is nothing to do if it did not change since the last call
+        if (pureUpToDate_ && temperature == pureTemperature_)
+            return;
+
         // Calculate the Peng-Robinson parameters of the pure
         // components
         //
@@ -123,9 +131,14 @@ public:
             this->pureParams_[i].setB(newB);
             Valgrind::CheckDefined(this->pureParams_[i].a());
             Valgrind::CheckDefined(this->pureParams_[i].b());
+
+            bPure_[i] = newB;
         }
 
         updateACache_();
+
+        pureTemperature_ = temperature;
+        pureUpToDate_ = true;
     }
 
     /*!
@@ -138,45 +151,14 @@ public:
     template <class FluidState>
     void updateMix(const FluidState& fs)
     {
-        Scalar sumx = 0.0;
-        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
-            sumx += fs.moleFraction(phaseIdx, compIdx);
-        sumx = std::max(Scalar(1e-10), sumx);
-
-        // Calculate the Peng-Robinson parameters of the mixture
-        //
-        // See: R. Reid, et al.: The Properties of Gases and Liquids,
-        // 4th edition, McGraw-Hill, 1987, p. 82
-        Scalar newA = 0;
-        Scalar newB = 0;
-        for (unsigned compIIdx = 0; compIIdx < numComponents; ++compIIdx) {
-            const Scalar moleFracI = fs.moleFraction(phaseIdx, compIIdx);
-            Scalar xi = max(0.0, min(1.0, moleFracI));
-            Valgrind::CheckDefined(xi);
-
-            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
-                const Scalar moleFracJ = fs.moleFraction(phaseIdx, compJIdx );
-                Scalar xj = max(0.0, min(1.0, moleFracJ));
-                Valgrind::CheckDefined(xj);
-
-                // mixing rule from Reid, page 82
-                newA +=  xi * xj * aCache_[compIIdx][compJIdx];
-
-                assert(std::isfinite(scalarValue(newA)));
-            }
-
-            // mixing rule from Reid, page 82
-            newB += max(0.0, xi) * this->pureParams_[compIIdx].b();
-            assert(std::isfinite(scalarValue(newB)));
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Scalar moleFrac = fs.moleFraction(phaseIdx, compIdx);
+            moleFrac_[compIdx] = max(0.0, min(1.0, moleFrac));
+            Valgrind::CheckDefined(moleFrac_[compIdx]);
         }
 
-        // assert(newB > 0);
-        this->setA(newA);
-        this->setB(newB);
-
-        Valgrind::CheckDefined(this->a());
-        Valgrind::CheckDefined(this->b());
-
+        updateASums_();
+        updateMixFromSums_();
     }
 
     /*!
@@ -184,16 +166,46 @@ public:
      *        the mixture provided that only a single mole fraction
      *        was changed.
      *
-     * The updatePure() method needs to be called _before_ calling
-     * this method!
+     * Since only a single mole fraction changed, the mixing rule can be
+     * updated with a cost which is linear in the number of components.
+     * Each incremental update adds a rounding error to the partial sums of
+     * the mixing rule. To keep it bounded, the sums are recomputed from
+     * scratch after numComponents incremental updates, i.e., the amortized
+     * cost stays linear and the partial sums never accumulate the errors of
+     * more than numComponents updates.
+     *
+     * The updatePure() and updateMix() methods need to be called _before_
+     * calling this method!
      */
     template <class FluidState>
     void updateSingleMoleFraction(const FluidState& fs,
-                                  unsigned /*compIdx*/)
+                                  unsigned compIdx)
     {
-        updateMix(fs);
+        const Scalar moleFrac = fs.moleFraction(phaseIdx, compIdx);
+        const Scalar xk = max(0.0, min(1.0, moleFrac));
+        Valgrind::CheckDefined(xk);
+
+        const Scalar deltaX = xk - moleFrac_[compIdx];
+        moleFrac_[compIdx] = xk;
+        if (++numIncrementalUpdates_ >= numComponents)
+            updateASums_();
+        else {
+            for (unsigned compIIdx = 0; compIIdx < numComponents; ++compIIdx)
+                aSum_[compIIdx] += deltaX * aCache_[compIIdx][compIdx];
+        }
+
+        updateMixFromSums_();
     }
 
+    /*!
+     * \brief Returns the attractive parameter \f$a_{ij}\f$ of the mixing rule for a
+     *        pair of components.
+     *
+     * It is only valid after updatePure() was called.
+     */
+    const Scalar& aInteraction(unsigned compIIdx, unsigned compJIdx) const
+    { return aCache_[compIIdx][compJIdx]; }
+
     /*!
      * \brief Return the Peng-Robinson parameters of a pure substance,
      */
@@ -228,6 +240,41 @@ protected:
     PureParams pureParams_[numComponents];
 
 private:
+    // calculate the partial sums \sum_j x_j a_ij of the mixing rule from scratch
+    //
+    // See: R. Reid, et al.: The Properties of Gases and Liquids,
+    // 4th edition, McGraw-Hill, 1987, p. 82
+    void updateASums_()
+    {
+        for (unsigned compIIdx = 0; compIIdx < numComponents; ++compIIdx) {
+            Scalar tmp = 0.0;
+            for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx)
+                tmp += moleFrac_[compJIdx] * aCache_[compIIdx][compJIdx];
+            aSum_[compIIdx] = tmp;
+        }
+        numIncrementalUpdates_ = 0;
+    }
+
+    void updateMixFromSums_()
+    {
+        Scalar newA = 0.0;
+        Scalar newB = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            // mixing rule from Reid, page 82
+            newA += moleFrac_[compIdx] * aSum_[compIdx];
+            newB += moleFrac_[compIdx] * bPure_[compIdx];
+        }
+        assert(std::isfinite(scalarValue(newA)));
+        assert(std::isfinite(scalarValue(newB)));
+
+        // assert(newB > 0);
+        this->setA(newA);
+        this->setB(newB);
+
+        Valgrind::CheckDefined(this->a());
+        Valgrind::CheckDefined(this->b());
+    }
+
     void updateACache_()
     {
         for (unsigned compIIdx = 0; compIIdx < numComponents; ++ compIIdx) {
@@ -244,6 +291,16 @@ private:
     }
 
     Scalar aCache_[numComponents][numComponents];
+
+    // the composition dependent quantities are stored as contiguous arrays to
+    // allow the compiler to vectorize the mixing rules
+    std::array<Scalar, numComponents> bPure_;
+    std::array<Scalar, numComponents> moleFrac_;
+    std::array<Scalar, numComponents> aSum_;
+    unsigned numIncrementalUpdates_ = 0;
+
+    Scalar pureTemperature_;
+    bool pureUpToDate_ = false;
 };
 
 template <class Scalar, class FluidSystem, unsigned phaseIdx, bool useSpe5Relations>
@@ -49,6 +49,7 @@
 #include <cassert>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Opm {
@@ -56,24 +57,16 @@ namespace Opm {
  * \brief Collects all grid properties which are relevant for end point scaling.
  *
  * This class is used for both, the drainage and the imbibition variants of the ECL
- * keywords.
+ * keywords. It does not copy any data: the properties are referenced in the storage
+ * of the FieldPropsManager, i.e., the EclipseState object must outlive the
+ * EclEpsGridProperties object. Keywords which are not specified by the deck are
+ * represented by null views; defaulted permeabilities are resolved when they are
+ * accessed.
  */
-
-namespace {
-
-std::vector<double> try_get(const FieldPropsManager& fp, const std::string& keyword) {
-    if (fp.has_double(keyword))
-        return fp.get_double(keyword);
-
-    return {};
-}
-
-}
-
-
-
 class EclEpsGridProperties
 {
+    typedef std::vector<double> DoubleArray_;
+    typedef std::vector<int> IntArray_;
 
 public:
 #if HAVE_ECL_INPUT
@@ -84,65 +77,69 @@ public:
         const std::string kwPrefix = useImbibition ? "I" : "";
 
         const auto& fp = eclState.fieldProps();
-
-        compressed_satnum = useImbibition
-            ? fp.get_int("IMBNUM") : fp.get_int("SATNUM");
-
-        this->compressed_swl = try_get( fp, kwPrefix+"SWL");
-        this->compressed_sgl = try_get( fp, kwPrefix+"SGL");
-        this->compressed_swcr = try_get( fp, kwPrefix+"SWCR");
-        this->compressed_sgcr = try_get( fp, kwPrefix+"SGCR");
-        this->compressed_sowcr = try_get( fp, kwPrefix+"SOWCR");
-        this->compressed_sogcr = try_get( fp, kwPrefix+"SOGCR");
-        this->compressed_swu = try_get( fp, kwPrefix+"SWU");
-        this->compressed_sgu = try_get( fp, kwPrefix+"SGU");
-        this->compressed_pcw = try_get( fp, kwPrefix+"PCW");
-        this->compressed_pcg = try_get( fp, kwPrefix+"PCG");
-        this->compressed_krw = try_get( fp, kwPrefix+"KRW");
-        this->compressed_krwr = try_get( fp, kwPrefix+"KRWR");
-        this->compressed_kro = try_get( fp, kwPrefix+"KRO");
-        this->compressed_krorg = try_get( fp, kwPrefix+"KRORG");
-        this->compressed_krorw = try_get( fp, kwPrefix+"KRORW");
-        this->compressed_krg = try_get( fp, kwPrefix+"KRG");
-        this->compressed_krgr = try_get( fp, kwPrefix+"KRGR");
+        static_assert(std::is_reference<decltype(fp.get_double(kwPrefix))>::value,
+                      "The field properties must be returned by reference to be viewable");
+
+        this->compressed_satnum = &(useImbibition
+                                    ? fp.get_int("IMBNUM") : fp.get_int("SATNUM"));
+
+        this->compressed_swl = view_( fp, kwPrefix+"SWL");
+        this->compressed_sgl = view_( fp, kwPrefix+"SGL");
+        this->compressed_swcr = view_( fp, kwPrefix+"SWCR");
+        this->compressed_sgcr = view_( fp, kwPrefix+"SGCR");
+        this->compressed_sowcr = view_( fp, kwPrefix+"SOWCR");
+        this->compressed_sogcr = view_( fp, kwPrefix+"SOGCR");
+        this->compressed_swu = view_( fp, kwPrefix+"SWU");
+        this->compressed_sgu = view_( fp, kwPrefix+"SGU");
+        this->compressed_pcw = view_( fp, kwPrefix+"PCW");
+        this->compressed_pcg = view_( fp, kwPrefix+"PCG");
+        this->compressed_krw = view_( fp, kwPrefix+"KRW");
+        this->compressed_krwr = view_( fp, kwPrefix+"KRWR");
+        this->compressed_kro = view_( fp, kwPrefix+"KRO");
+        this->compressed_krorg = view_( fp, kwPrefix+"KRORG");
+        this->compressed_krorw = view_( fp, kwPrefix+"KRORW");
+        this->compressed_krg = view_( fp, kwPrefix+"KRG");
+        this->compressed_krgr = view_( fp, kwPrefix+"KRGR");
 
         // _may_ be needed to calculate the Leverett capillary pressure scaling factor
-        if (fp.has_double("PORO"))
-            this->compressed_poro = fp.get_double("PORO");
-
-        this->compressed_permx = fp.has_double("PERMX")
-            ? fp.get_double("PERMX")
-            : std::vector<double>(this->compressed_satnum.size());
-
-        this->compressed_permy = fp.has_double("PERMY")
-            ? fp.get_double("PERMY") : this->compressed_permx;
-
-        this->compressed_permz = fp.has_double("PERMZ")
-            ? fp.get_double("PERMZ") : this->compressed_permx;
+        this->compressed_poro = view_(fp, "PORO");
+        this->compressed_permx = view_(fp, "PERMX");
+        this->compressed_permy = view_(fp, "PERMY");
+        this->compressed_permz = view_(fp, "PERMZ");
     }
 
 #endif
 
-
-
     unsigned satRegion(std::size_t active_index) const {
-        return this->compressed_satnum[active_index] - 1;
+        return (*this->compressed_satnum)[active_index] - 1;
     }
 
+    /*!
+     * \brief The permeability in x direction.
+     *
+     * If PERMX is not specified, the permeability is zero.
+     */
     double permx(std::size_t active_index) const {
-        return this->compressed_permx[active_index];
+        return this->compressed_permx ? (*this->compressed_permx)[active_index] : 0.0;
     }
 
+    /*!
+     * \brief The permeability in y direction. Defaults to the one in x direction.
+     */
     double permy(std::size_t active_index) const {
-        return this->compressed_permy[active_index];
+        return this->compressed_permy ? (*this->compressed_permy)[active_index] : this->permx(active_index);
     }
 
+    /*!
+     * \brief The permeability in z direction. Defaults to the one in x direction.
+     */
     double permz(std::size_t active_index) const {
-        return this->compressed_permz[active_index];
+        return this->compressed_permz ? (*this->compressed_permz)[active_index] : this->permx(active_index);
     }
 
     double poro(std::size_t active_index) const {
-        return this->compressed_poro[active_index];
+        assert(this->compressed_poro);
+        return (*this->compressed_poro)[active_index];
     }
 
     const double * swl(std::size_t active_index) const {
@@ -214,38 +211,48 @@ public:
     }
 
 private:
+#if HAVE_ECL_INPUT
+    // returns a view of a keyword or a null view if the deck does not specify it
+    static const DoubleArray_* view_(const FieldPropsManager& fp, const std::string& keyword)
+    {
+        if (fp.has_double(keyword))
+            return &fp.get_double(keyword);
+
+        return nullptr;
+    }
+#endif
+
     const double *
-    satfunc(const std::vector<double>& data,
-            const std::size_t          active_index) const
+    satfunc(const DoubleArray_* data,
+            const std::size_t   active_index) const
     {
-        return data.empty() ? nullptr : &data[active_index];
-    }
-
-
-    std::vector<int> compressed_satnum;
-    std::vector<double> compressed_swl;
-    std::vector<double> compressed_sgl;
-    std::vector<double> compressed_swcr;
-    std::vector<double> compressed_sgcr;
-    std::vector<double> compressed_sowcr;
-    std::vector<double> compressed_sogcr;
-    std::vector<double> compressed_swu;
-    std::vector<double> compressed_sgu;
-    std::vector<double> compressed_pcw;
-    std::vector<double> compressed_pcg;
-    std::vector<double> compressed_krw;
-    std::vector<double> compressed_krwr;
-    std::vector<double> compressed_kro;
-    std::vector<double> compressed_krorg;
-    std::vector<double> compressed_krorw;
-    std::vector<double> compressed_krg;
-    std::vector<double> compressed_krgr;
-
-    std::vector<double> compressed_permx;
-    std::vector<double> compressed_permy;
-    std::vector<double> compressed_permz;
-    std::vector<double> compressed_poro;
+        return data ? &(*data)[active_index] : nullptr;
+    }
+
+
+    const IntArray_* compressed_satnum = nullptr;
+    const DoubleArray_* compressed_swl = nullptr;
+    const DoubleArray_* compressed_sgl = nullptr;
+    const DoubleArray_* compressed_swcr = nullptr;
+    const DoubleArray_* compressed_sgcr = nullptr;
+    const DoubleArray_* compressed_sowcr = nullptr;
+    const DoubleArray_* compressed_sogcr = nullptr;
+    const DoubleArray_* compressed_swu = nullptr;
+    const DoubleArray_* compressed_sgu = nullptr;
+    const DoubleArray_* compressed_pcw = nullptr;
+    const DoubleArray_* compressed_pcg = nullptr;
+    const DoubleArray_* compressed_krw = nullptr;
+    const DoubleArray_* compressed_krwr = nullptr;
+    const DoubleArray_* compressed_kro = nullptr;
+    const DoubleArray_* compressed_krorg = nullptr;
+    const DoubleArray_* compressed_krorw = nullptr;
+    const DoubleArray_* compressed_krg = nullptr;
+    const DoubleArray_* compressed_krgr = nullptr;
+
+    const DoubleArray_* compressed_permx = nullptr;
+    const DoubleArray_* compressed_permy = nullptr;
+    const DoubleArray_* compressed_permz = nullptr;
+    const DoubleArray_* compressed_poro = nullptr;
 };
 }
 #endif
-
@@ -525,6 +525,95 @@ private:
     std::array<Scalar, 3> saturationKrnPoints_;
 };
 
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief The precomputed slopes of the piecewise linear mapping between the scaled and
+ *        the unscaled saturations of a two-phase curve.
+ *
+ * Only the slopes are stored because they are the only part of the mapping which
+ * requires a division. The knots and the offsets of the lines are the scaling points
+ * themselves, so they are passed to the evaluation functions instead of being copied
+ * into every mapping. For two-point scaling, the single line through the end points
+ * is used; for three-point scaling there is one line for each of the two segments
+ * between the points.
+ */
+template <class Scalar>
+class EclEpsSaturationMapping
+{
+public:
+    EclEpsSaturationMapping()
+    { slopes_.fill(1.0); }
+
+    /*!
+     * \brief The line through (from[0], to[0]) and (from[2], to[2]).
+     */
+    void setTwoPoint(const std::array<Scalar, 3>& from, const std::array<Scalar, 3>& to)
+    { slopes_.fill((to[2] - to[0])/(from[2] - from[0])); }
+
+    /*!
+     * \brief Linear interpolation between the three points (from[i], to[i]).
+     *
+     * A decreasing or empty segment is flat.
+     */
+    void setThreePoint(const std::array<Scalar, 3>& from, const std::array<Scalar, 3>& to)
+    {
+        for (unsigned segIdx = 0; segIdx < 2; ++segIdx) {
+            const Scalar dFrom = from[segIdx + 1] - from[segIdx];
+            const Scalar dTo = to[segIdx + 1] - to[segIdx];
+            if (dTo < 0.0 || !(dFrom > 0.0))
+                slopes_[segIdx] = 0.0;
+            else
+                slopes_[segIdx] = dTo/dFrom;
+        }
+    }
+
+    /*!
+     * \brief Map a saturation using two-point scaling.
+     *
+     * Saturations outside of [from[0], from[2]] are extrapolated. The points must be
+     * the ones passed to setTwoPoint().
+     */
+    template <class Evaluation>
+    Evaluation evalTwoPoint(const Evaluation& S,
+                            const std::array<Scalar, 3>& from,
+                            const std::array<Scalar, 3>& to) const
+    { return to[0] + (S - from[0])*slopes_[0]; }
+
+    /*!
+     * \brief Map a saturation using three-point scaling.
+     *
+     * Saturations outside of [from[0], from[2]] are clamped. A decreasing segment of
+     * the target points is flattened to the smaller value. If the middle point is not
+     * below the last one, the first segment ends at from[2] if \a truncateFirstSegment
+     * is true and at from[1] otherwise. (The ECL scaled-to-unscaled and
+     * unscaled-to-scaled conversions differ in this respect.) The points must be the
+     * ones passed to setThreePoint().
+     */
+    template <class Evaluation>
+    Evaluation evalThreePoint(const Evaluation& S,
+                              const std::array<Scalar, 3>& from,
+                              const std::array<Scalar, 3>& to,
+                              bool truncateFirstSegment) const
+    {
+        if (!(S > from[0]))
+            return to[0];
+
+        const Scalar knot1 = truncateFirstSegment ? std::min(from[1], from[2]) : from[1];
+        if (S < knot1)
+            return std::min(to[0], to[1]) + (S - from[0])*slopes_[0];
+
+        const Scalar knot2 = truncateFirstSegment ? from[2] : std::max(from[1], from[2]);
+        if (S < knot2)
+            return std::min(to[1], to[2]) + (S - from[1])*slopes_[1];
+
+        return to[2];
+    }
+
+private:
+    std::array<Scalar, 2> slopes_;
+};
+
 } // namespace Opm
 
 #endif
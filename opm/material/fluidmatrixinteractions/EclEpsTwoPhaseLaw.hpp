@@ -54,6 +54,7 @@ class EclEpsTwoPhaseLaw : public EffLawT::Traits
     typedef EffLawT EffLaw;
 
 public:
+    typedef EffLawT EffectiveLaw;
     typedef typename EffLaw::Traits Traits;
     typedef ParamsT Params;
     typedef typename EffLaw::Scalar Scalar;
@@ -274,9 +275,9 @@ public:
 
         // the saturations of capillary pressure are always scaled using two-point
         // scaling
-        return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                            params.unscaledPoints().saturationPcPoints(),
-                                            params.scaledPoints().saturationPcPoints());
+        return params.scaledToUnscaledSatPc().evalTwoPoint(SwScaled,
+                                                           params.scaledPoints().saturationPcPoints(),
+                                                           params.unscaledPoints().saturationPcPoints());
     }
 
     template <class Evaluation>
@@ -285,16 +286,17 @@ public:
         if (!params.config().enableSatScaling())
             return SwUnscaled;
 
-        // the saturations of capillary pressure are always scaled using two-point
-        // scaling
-        return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                            params.unscaledPoints().saturationPcPoints(),
-                                            params.scaledPoints().saturationPcPoints());
+        return params.unscaledToScaledSatPc().evalTwoPoint(SwUnscaled,
+                                                           params.unscaledPoints().saturationPcPoints(),
+                                                           params.scaledPoints().saturationPcPoints());
     }
 
     /*!
      * \brief Convert an absolute saturation to an effective one for the scaling of the
      *        relperm of the wetting phase.
+     *
+     * The slopes of the piecewise linear mapping are computed when the parameter
+     * object is finalized.
      */
     template <class Evaluation>
     static Evaluation scaledToUnscaledSatKrw(const Params& params, const Evaluation& SwScaled)
@@ -302,16 +304,9 @@ public:
         if (!params.config().enableSatScaling())
             return SwScaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return scaledToUnscaledSatThreePoint_(SwScaled,
-                                                  params.unscaledPoints().saturationKrwPoints(),
-                                                  params.scaledPoints().saturationKrwPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                                params.unscaledPoints().saturationKrwPoints(),
-                                                params.scaledPoints().saturationKrwPoints());
-        }
+        return scaledToUnscaledSat_(params, params.scaledToUnscaledSatKrw(), SwScaled,
+                                    params.unscaledPoints().saturationKrwPoints(),
+                                    params.scaledPoints().saturationKrwPoints());
     }
 
     template <class Evaluation>
@@ -320,16 +315,9 @@ public:
         if (!params.config().enableSatScaling())
             return SwUnscaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return unscaledToScaledSatThreePoint_(SwUnscaled,
-                                                  params.unscaledPoints().saturationKrwPoints(),
-                                                  params.scaledPoints().saturationKrwPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                                params.unscaledPoints().saturationKrwPoints(),
-                                                params.scaledPoints().saturationKrwPoints());
-        }
+        return unscaledToScaledSat_(params, params.unscaledToScaledSatKrw(), SwUnscaled,
+                                    params.unscaledPoints().saturationKrwPoints(),
+                                    params.scaledPoints().saturationKrwPoints());
     }
 
     /*!
@@ -342,14 +330,9 @@ public:
         if (!params.config().enableSatScaling())
             return SwScaled;
 
-        if (params.config().enableThreePointKrSatScaling())
-            return scaledToUnscaledSatThreePoint_(SwScaled,
-                                                  params.unscaledPoints().saturationKrnPoints(),
-                                                  params.scaledPoints().saturationKrnPoints());
-        else // two-point relperm saturation scaling
-            return scaledToUnscaledSatTwoPoint_(SwScaled,
-                                                params.unscaledPoints().saturationKrnPoints(),
-                                                params.scaledPoints().saturationKrnPoints());
+        return scaledToUnscaledSat_(params, params.scaledToUnscaledSatKrn(), SwScaled,
+                                    params.unscaledPoints().saturationKrnPoints(),
+                                    params.scaledPoints().saturationKrnPoints());
     }
 
 
@@ -359,116 +342,36 @@ public:
         if (!params.config().enableSatScaling())
             return SwUnscaled;
 
-        if (params.config().enableThreePointKrSatScaling()) {
-            return unscaledToScaledSatThreePoint_(SwUnscaled,
-                                                  params.unscaledPoints().saturationKrnPoints(),
-                                                  params.scaledPoints().saturationKrnPoints());
-        }
-        else { // two-point relperm saturation scaling
-            return unscaledToScaledSatTwoPoint_(SwUnscaled,
-                                                params.unscaledPoints().saturationKrnPoints(),
-                                                params.scaledPoints().saturationKrnPoints());
-        }
+        return unscaledToScaledSat_(params, params.unscaledToScaledSatKrn(), SwUnscaled,
+                                    params.unscaledPoints().saturationKrnPoints(),
+                                    params.scaledPoints().saturationKrnPoints());
     }
 
 private:
-    template <class Evaluation, class PointsContainer>
-    static Evaluation scaledToUnscaledSatTwoPoint_(const Evaluation& scaledSat,
-                                                   const PointsContainer& unscaledSats,
-                                                   const PointsContainer& scaledSats)
-    {
-        return
-            unscaledSats[0]
-            +
-            (scaledSat - scaledSats[0])*((unscaledSats[2] - unscaledSats[0])/(scaledSats[2] - scaledSats[0]));
-    }
-
-    template <class Evaluation, class PointsContainer>
-    static Evaluation unscaledToScaledSatTwoPoint_(const Evaluation& unscaledSat,
-                                                   const PointsContainer& unscaledSats,
-                                                   const PointsContainer& scaledSats)
-    {
-        return
-            scaledSats[0]
-            +
-            (unscaledSat - unscaledSats[0])*((scaledSats[2] - scaledSats[0])/(unscaledSats[2] - unscaledSats[0]));
-    }
-
-    template <class Evaluation, class PointsContainer>
-    static Evaluation scaledToUnscaledSatThreePoint_(const Evaluation& scaledSat,
-                                                     const PointsContainer& unscaledSats,
-                                                     const PointsContainer& scaledSats)
+    template <class Evaluation, class Mapping, class PointsContainer>
+    static Evaluation scaledToUnscaledSat_(const Params& params,
+                                           const Mapping& mapping,
+                                           const Evaluation& scaledSat,
+                                           const PointsContainer& unscaledSats,
+                                           const PointsContainer& scaledSats)
     {
-        using UnscaledSat = std::remove_cv_t<std::remove_reference_t<decltype(unscaledSats[0])>>;
-
-        auto map = [&scaledSat, &unscaledSats, &scaledSats](const std::size_t i)
-        {
-            const auto distance = (scaledSat         - scaledSats[i])
-                                / (scaledSats[i + 1] - scaledSats[i]);
-
-            const auto displacement =
-                std::max(unscaledSats[i + 1] - unscaledSats[i], UnscaledSat{ 0 });
-
-            return std::min(unscaledSats[i] + distance*displacement,
-                            Evaluation { unscaledSats[i + 1] });
-        };
-
-        if (! (scaledSat > scaledSats[0])) {
-            // s <= sL
-            return unscaledSats[0];
-        }
-        else if (scaledSat < std::min(scaledSats[1], scaledSats[2])) {
-            // Scaled saturation in interval [sL, sR).
-            // Map to tabulated saturation in [unscaledSats[0], unscaledSats[1]).
-            return map(0);
-        }
-        else if (scaledSat < scaledSats[2]) {
-            // Scaled saturation in interval [sR, sU); sR guaranteed to be less
-            // than sU from previous condition.  Map to tabulated saturation in
-            // [unscaledSats[1], unscaledSats[2]).
-            return map(1);
-        }
-        else {
-            // s >= sU
-            return unscaledSats[2];
-        }
+        if (params.config().enableThreePointKrSatScaling())
+            return mapping.evalThreePoint(scaledSat, scaledSats, unscaledSats, /*truncateFirstSegment=*/true);
+        else // two-point relperm saturation scaling
+            return mapping.evalTwoPoint(scaledSat, scaledSats, unscaledSats);
     }
 
-    template <class Evaluation, class PointsContainer>
-    static Evaluation unscaledToScaledSatThreePoint_(const Evaluation& unscaledSat,
-                                                     const PointsContainer& unscaledSats,
-                                                     const PointsContainer& scaledSats)
+    template <class Evaluation, class Mapping, class PointsContainer>
+    static Evaluation unscaledToScaledSat_(const Params& params,
+                                           const Mapping& mapping,
+                                           const Evaluation& unscaledSat,
+                                           const PointsContainer& unscaledSats,
+                                           const PointsContainer& scaledSats)
     {
-        using ScaledSat = std::remove_cv_t<std::remove_reference_t<decltype(scaledSats[0])>>;
-
-        auto map = [&unscaledSat, &unscaledSats, &scaledSats](const std::size_t i)
-        {
-            const auto distance = (unscaledSat         - unscaledSats[i])
-                                / (unscaledSats[i + 1] - unscaledSats[i]);
-
-            const auto displacement =
-                std::max(scaledSats[i + 1] - scaledSats[i], ScaledSat{ 0 });
-
-            return std::min(scaledSats[i] + distance*displacement,
-                            Evaluation { scaledSats[i + 1] });
-        };
-
-        if (! (unscaledSat > unscaledSats[0])) {
-            return scaledSats[0];
-        }
-        else if (unscaledSat < unscaledSats[1]) {
-            // Tabulated saturation in interval [unscaledSats[0], unscaledSats[1]).
-            // Map to scaled saturation in [sL, sR).
-            return map(0);
-        }
-        else if (unscaledSat < unscaledSats[2]) {
-            // Tabulated saturation in interval [unscaledSats[1], unscaledSats[2]).
-            // Map to scaled saturation in [sR, sU).
-            return map(1);
-        }
-        else {
-            return scaledSats[2];
-        }
+        if (params.config().enableThreePointKrSatScaling())
+            return mapping.evalThreePoint(unscaledSat, unscaledSats, scaledSats, /*truncateFirstSegment=*/false);
+        else // two-point relperm saturation scaling
+            return mapping.evalTwoPoint(unscaledSat, unscaledSats, scaledSats);
     }
 
     /*!
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <memory>
+#include <array>
 #include <cassert>
 #include <algorithm>
 
@@ -58,6 +59,7 @@ class EclEpsTwoPhaseLawParams : public EnsureFinalized
 public:
     typedef typename EffLawParams::Traits Traits;
     typedef EclEpsScalingPoints<Scalar> ScalingPoints;
+    typedef EclEpsSaturationMapping<Scalar> SaturationMapping;
 
     EclEpsTwoPhaseLawParams()
     {
@@ -76,6 +78,8 @@ public:
         }
         assert(effectiveLawParams_);
 #endif
+        updateSaturationMappings_();
+
         EnsureFinalized :: finalize();
     }
 
@@ -117,10 +121,56 @@ public:
 
     /*!
      * \brief Returns the scaling points which are seen by the physical model
+     *
+     * The saturation mappings are computed by finalize(), i.e., changing the
+     * saturation points after the parameters have been finalized has no effect on
+     * them. The vertical scaling points can be changed at any time.
      */
     ScalingPoints& scaledPoints()
     { return scaledPoints_; }
 
+    /*!
+     * \brief The slopes of the mapping from scaled to unscaled saturations for
+     *        capillary pressure.
+     */
+    const SaturationMapping& scaledToUnscaledSatPc() const
+    { return satMappings_[0]; }
+
+    /*!
+     * \brief The slopes of the mapping from unscaled to scaled saturations for
+     *        capillary pressure.
+     */
+    const SaturationMapping& unscaledToScaledSatPc() const
+    { return satMappings_[1]; }
+
+    /*!
+     * \brief The slopes of the mapping from scaled to unscaled saturations for the
+     *        wetting phase relative permeability.
+     */
+    const SaturationMapping& scaledToUnscaledSatKrw() const
+    { return satMappings_[2]; }
+
+    /*!
+     * \brief The slopes of the mapping from unscaled to scaled saturations for the
+     *        wetting phase relative permeability.
+     */
+    const SaturationMapping& unscaledToScaledSatKrw() const
+    { return satMappings_[3]; }
+
+    /*!
+     * \brief The slopes of the mapping from scaled to unscaled saturations for the
+     *        non-wetting phase relative permeability.
+     */
+    const SaturationMapping& scaledToUnscaledSatKrn() const
+    { return satMappings_[4]; }
+
+    /*!
+     * \brief The slopes of the mapping from unscaled to scaled saturations for the
+     *        non-wetting phase relative permeability.
+     */
+    const SaturationMapping& unscaledToScaledSatKrn() const
+    { return satMappings_[5]; }
+
     /*!
      * \brief Sets the parameter object for the effective/nested material law.
      */
@@ -134,11 +184,42 @@ public:
     { return *effectiveLawParams_; }
 
 private:
+    void updateSaturationMappings_()
+    {
+        if (!config_->enableSatScaling())
+            return;
+
+        const auto& unscaled = *unscaledPoints_;
+        const auto& scaled = scaledPoints_;
+
+        // the saturations of capillary pressure are always scaled using two-point
+        // scaling
+        satMappings_[0].setTwoPoint(scaled.saturationPcPoints(), unscaled.saturationPcPoints());
+        satMappings_[1].setTwoPoint(unscaled.saturationPcPoints(), scaled.saturationPcPoints());
+
+        if (config_->enableThreePointKrSatScaling()) {
+            satMappings_[2].setThreePoint(scaled.saturationKrwPoints(), unscaled.saturationKrwPoints());
+            satMappings_[3].setThreePoint(unscaled.saturationKrwPoints(), scaled.saturationKrwPoints());
+            satMappings_[4].setThreePoint(scaled.saturationKrnPoints(), unscaled.saturationKrnPoints());
+            satMappings_[5].setThreePoint(unscaled.saturationKrnPoints(), scaled.saturationKrnPoints());
+        }
+        else {
+            satMappings_[2].setTwoPoint(scaled.saturationKrwPoints(), unscaled.saturationKrwPoints());
+            satMappings_[3].setTwoPoint(unscaled.saturationKrwPoints(), scaled.saturationKrwPoints());
+            satMappings_[4].setTwoPoint(scaled.saturationKrnPoints(), unscaled.saturationKrnPoints());
+            satMappings_[5].setTwoPoint(unscaled.saturationKrnPoints(), scaled.saturationKrnPoints());
+        }
+    }
+
     std::shared_ptr<EffLawParams> effectiveLawParams_;
 
     std::shared_ptr<EclEpsConfig> config_;
     std::shared_ptr<ScalingPoints> unscaledPoints_;
     ScalingPoints scaledPoints_;
+
+    // scaled-to-unscaled and unscaled-to-scaled for pc, krw and krn. the knots of the
+    // mappings are the scaling points, so only their slopes are stored
+    std::array<SaturationMapping, 6> satMappings_;
 };
 
 } // namespace Opm
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <memory>
+#include <functional>
 #include <cassert>
 #include <algorithm>
 
@@ -58,6 +59,11 @@ class EclHysteresisTwoPhaseLawParams : public EnsureFinalized
 public:
     typedef typename EffLawParams::Traits Traits;
 
+    /*!
+     * \brief Callback which creates the parameters of the imbibition curve on demand.
+     */
+    typedef std::function<std::shared_ptr<EffLawParams>()> ImbibitionParamsFactory;
+
     EclHysteresisTwoPhaseLawParams()
     {
         // These are initialized to two (even though they represent saturations)
@@ -80,7 +86,14 @@ public:
         if (config().enableHysteresis()) {
             //C_ = 1.0/(Sncri_ - Sncrd_) + 1.0/(Snmaxd_ - Sncrd_);
 
-            updateDynamicParams_();
+            // the wetting phase relperm is always evaluated on the imbibition curve
+            // for relperm hysteresis model 1. otherwise, the imbibition curve is only
+            // required after the first reversal.
+            if (config().krHysteresisModel() == 1 || krnSwMdc_ < 2.0)
+                ensureImbibitionParams_();
+
+            if (imbibitionParams_)
+                updateDynamicParams_();
         }
 
         EnsureFinalized :: finalize();
@@ -125,7 +138,7 @@ public:
                              const EclEpsScalingPointsInfo<Scalar>& /* info */,
                              EclTwoPhaseSystemType /* twoPhaseSystem */)
     {
-        imbibitionParams_ = *value;
+        imbibitionParams_ = value;
 
 /*
         if (twoPhaseSystem == EclGasOilSystem) {
@@ -138,21 +151,49 @@ public:
 */
     }
 
+    /*!
+     * \brief Specify how the parameters of the imbibition curve are created once they
+     *        are needed.
+     *
+     * Most cells of a typical simulation never leave the main drainage curve, so the
+     * imbibition parameters are only materialized when the first reversal is seen by
+     * update(). Until then, no imbibition parameter object is allocated.
+     */
+    void setImbibitionParamsFactory(ImbibitionParamsFactory value)
+    { imbibitionParamsFactory_ = std::move(value); }
+
+    /*!
+     * \brief Returns true if the parameters of the imbibition curve are available.
+     */
+    bool hasImbibitionParams() const
+    { return static_cast<bool>(imbibitionParams_); }
+
     /*!
      * \brief Returns the parameters used for the imbibition curve
      */
     const EffLawParams& imbibitionParams() const
-    { return imbibitionParams_; }
+    {
+        assert(imbibitionParams_);
+        return *imbibitionParams_;
+    }
 
     EffLawParams& imbibitionParams()
-    { return imbibitionParams_; }
+    {
+        ensureImbibitionParams_();
+        assert(imbibitionParams_);
+        return *imbibitionParams_;
+    }
 
     /*!
      * \brief Set the saturation of the wetting phase where the last switch from the main
      *        drainage curve (MDC) to imbibition happend on the capillary pressure curve.
      */
     void setPcSwMdc(Scalar value)
-    { pcSwMdc_ = value; }
+    {
+        pcSwMdc_ = value;
+        if (pcSwMdc_ < 2.0)
+            ensureImbibitionParams_();
+    }
 
     /*!
      * \brief Get the saturation of the wetting phase where the last switch from the main
@@ -185,7 +226,11 @@ public:
      *        non-wetting phase.
      */
     void setKrnSwMdc(Scalar value)
-    { krnSwMdc_ = value; }
+    {
+        krnSwMdc_ = value;
+        if (krnSwMdc_ < 2.0)
+            ensureImbibitionParams_();
+    }
 
     /*!
      * \brief Get the saturation of the wetting phase where the last switch from the main
@@ -269,11 +314,23 @@ public:
             updateParams = true;
         }
 
-        if (updateParams)
-            updateDynamicParams_();
+        if (updateParams) {
+            ensureImbibitionParams_();
+            if (imbibitionParams_)
+                updateDynamicParams_();
+        }
     }
 
 private:
+    void ensureImbibitionParams_()
+    {
+        if (imbibitionParams_ || !imbibitionParamsFactory_)
+            return;
+
+        imbibitionParams_ = imbibitionParamsFactory_();
+        imbibitionParamsFactory_ = nullptr;
+    }
+
     void updateDynamicParams_()
     {
         // HACK: Eclipse seems to disable the wetting-phase relperm even though this is
@@ -308,7 +365,8 @@ private:
     }
 
     std::shared_ptr<EclHysteresisConfig> config_;
-    EffLawParams imbibitionParams_;
+    std::shared_ptr<EffLawParams> imbibitionParams_;
+    ImbibitionParamsFactory imbibitionParamsFactory_;
     EffLawParams drainageParams_;
 
     // largest wettinging phase saturation which is on the main-drainage curve. These are
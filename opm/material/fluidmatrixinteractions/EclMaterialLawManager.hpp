@@ -39,8 +39,12 @@
 #include <opm/material/fluidmatrixinteractions/EclEpsConfig.hpp>
 #include <opm/material/fluidmatrixinteractions/EclHysteresisConfig.hpp>
 #include <opm/material/fluidmatrixinteractions/EclMultiplexerMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/EclStaticMaterialLaw.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/fluidsystems/BlackOilDefaultIndexTraits.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
+#include <opm/material/common/SharedTables.hpp>
 
 #if HAVE_OPM_COMMON
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -52,8 +56,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace Opm {
@@ -109,6 +116,25 @@ public:
     typedef EclMultiplexerMaterial<Traits, GasOilTwoPhaseLaw, OilWaterTwoPhaseLaw, GasWaterTwoPhaseLaw> MaterialLaw;
     typedef typename MaterialLaw::Params MaterialLawParams;
 
+    /*!
+     * \brief The three-phase material law for a three-phase approach which is fixed at
+     *        compile time.
+     *
+     * Calling this law instead of MaterialLaw avoids the runtime dispatch of the
+     * multiplexer. Hysteresis and end-point scaling can be compiled out as well. The
+     * law may only be used if supportsStaticMaterialLaw() returns true for the same
+     * template arguments. Its parameter objects are provided by
+     * staticMaterialLawParams().
+     */
+    template <EclMultiplexerApproach approach, bool enableHysteresisV = true, bool enableEpsV = true>
+    using StaticMaterialLaw = typename EclStaticMaterialLaw<Traits,
+                                                            GasOilTwoPhaseLaw,
+                                                            OilWaterTwoPhaseLaw,
+                                                            GasWaterTwoPhaseLaw,
+                                                            approach,
+                                                            enableHysteresisV,
+                                                            enableEpsV>::type;
+
 private:
     // internal typedefs
     typedef std::vector<std::shared_ptr<GasOilEffectiveTwoPhaseParams> > GasOilEffectiveParamVector;
@@ -126,6 +152,33 @@ private:
     typedef std::vector<std::shared_ptr<GasWaterTwoPhaseHystParams> > GasWaterParamVector;
     typedef std::vector<std::shared_ptr<MaterialLawParams> > MaterialLawParamsVector;
 
+    // everything which is required to create the imbibition parameters of an element
+    // once it leaves the main drainage curve
+    struct ImbibitionContext_
+    {
+        explicit ImbibitionContext_(const EclipseState& state)
+            : eclState(state)
+            , epsGridProperties(state, /*useImbibition=*/true)
+        {}
+
+        const EclipseState& eclState;
+        EclEpsGridProperties epsGridProperties;
+        std::vector<int> imbnumRegionArray;
+        std::vector<EclEpsScalingPointsInfo<Scalar>> unscaledEpsInfo;
+
+        std::shared_ptr<EclEpsConfig> gasOilConfig;
+        std::shared_ptr<EclEpsConfig> oilWaterConfig;
+        std::shared_ptr<EclEpsConfig> gasWaterConfig;
+
+        GasOilScalingPointsVector gasOilUnscaledPointsVector;
+        OilWaterScalingPointsVector oilWaterUnscaledPointsVector;
+        GasWaterScalingPointsVector gasWaterUnscaledPointsVector;
+
+        GasOilEffectiveParamVector gasOilEffectiveParamVector;
+        OilWaterEffectiveParamVector oilWaterEffectiveParamVector;
+        GasWaterEffectiveParamVector gasWaterEffectiveParamVector;
+    };
+
 public:
     EclMaterialLawManager()
     {}
@@ -189,6 +242,16 @@ public:
         }
     }
 
+    /*!
+     * \brief Create the material law parameters of all elements.
+     *
+     * If hysteresis is enabled, the parameters of the imbibition curves are only created
+     * once an element leaves the main drainage curve, which may happen at any time of
+     * the simulation. They are read from the end point scaling properties of the
+     * EclipseState object, which are referenced without copying them. In this case, the
+     * EclipseState object must thus outlive the parameter objects of the elements,
+     * i.e., this object as well as all copies of it and of its parameter objects.
+     */
     void initParamsForElements(const EclipseState& eclState, size_t numCompressedElems)
     {
         // get the number of saturation regions
@@ -240,27 +303,12 @@ public:
         // element
         GasOilScalingInfoVector gasOilScaledInfoVector(numCompressedElems);
         oilWaterScaledEpsInfoDrainage_.resize(numCompressedElems);
-        GasOilScalingInfoVector gasOilScaledImbInfoVector;
-        OilWaterScalingInfoVector oilWaterScaledImbInfoVector;
-        
+
         GasOilScalingPointsVector gasOilScaledPointsVector(numCompressedElems);
         GasOilScalingPointsVector oilWaterScaledEpsPointsDrainage(numCompressedElems);
-        GasOilScalingPointsVector gasOilScaledImbPointsVector;
-        OilWaterScalingPointsVector oilWaterScaledImbPointsVector;
-        
+
         GasWaterScalingInfoVector gasWaterScaledInfoVector(numCompressedElems);
         GasWaterScalingPointsVector gasWaterScaledPointsVector(numCompressedElems);
-        GasWaterScalingInfoVector gasWaterScaledImbInfoVector;
-        GasWaterScalingPointsVector gasWaterScaledImbPointsVector;
-     
-        if (enableHysteresis()) {
-            gasOilScaledImbInfoVector.resize(numCompressedElems);
-            gasOilScaledImbPointsVector.resize(numCompressedElems);
-            oilWaterScaledImbInfoVector.resize(numCompressedElems);
-            oilWaterScaledImbPointsVector.resize(numCompressedElems);
-            gasWaterScaledImbInfoVector.resize(numCompressedElems);
-            gasWaterScaledImbPointsVector.resize(numCompressedElems);
-        }
 
         EclEpsGridProperties epsGridProperties(eclState, false);
 
@@ -288,30 +336,25 @@ public:
 
         }
 
+        // the parameters for the imbibition curves are only created once a cell leaves
+        // the main drainage curve. we thus only keep what is required to create them.
+        // the factories share the ownership of this data, so they stay valid if this
+        // object is copied, moved or destroyed.
+        std::shared_ptr<const ImbibitionContext_> imbibitionContext;
         if (enableHysteresis()) {
-            EclEpsGridProperties epsImbGridProperties(eclState, true);
-            for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
-                readGasOilScaledPoints_(gasOilScaledImbInfoVector,
-                                        gasOilScaledImbPointsVector,
-                                        gasOilConfig,
-                                        eclState,
-                                        epsImbGridProperties,
-                                        elemIdx);
-
-                readOilWaterScaledPoints_(oilWaterScaledImbInfoVector,
-                                          oilWaterScaledImbPointsVector,
-                                          oilWaterConfig,
-                                          eclState,
-                                          epsImbGridProperties,
-                                          elemIdx);
-                
-                readGasWaterScaledPoints_(gasWaterScaledImbInfoVector,
-                                          gasWaterScaledImbPointsVector,
-                                          gasWaterConfig,
-                                          eclState,
-                                          epsImbGridProperties,
-                                          elemIdx);
-            }
+            auto context = std::make_shared<ImbibitionContext_>(eclState);
+            context->imbnumRegionArray = imbnumRegionArray_;
+            context->unscaledEpsInfo = unscaledEpsInfo_;
+            context->gasOilConfig = gasOilConfig;
+            context->oilWaterConfig = oilWaterConfig;
+            context->gasWaterConfig = gasWaterConfig;
+            context->gasOilUnscaledPointsVector = gasOilUnscaledPointsVector_;
+            context->oilWaterUnscaledPointsVector = oilWaterUnscaledPointsVector_;
+            context->gasWaterUnscaledPointsVector = gasWaterUnscaledPointsVector_;
+            context->gasOilEffectiveParamVector = gasOilEffectiveParamVector_;
+            context->oilWaterEffectiveParamVector = oilWaterEffectiveParamVector_;
+            context->gasWaterEffectiveParamVector = gasWaterEffectiveParamVector_;
+            imbibitionContext = context;
         }
 
         // create the parameter objects for the two-phase laws
@@ -319,16 +362,6 @@ public:
         OilWaterParamVector oilWaterParams(numCompressedElems);
         GasWaterParamVector gasWaterParams(numCompressedElems);
 
-        GasOilParamVector gasOilImbParams;
-        OilWaterParamVector oilWaterImbParams;
-        GasWaterParamVector gasWaterImbParams;
-
-        if (enableHysteresis()) {
-            gasOilImbParams.resize(numCompressedElems);
-            oilWaterImbParams.resize(numCompressedElems);
-            gasWaterImbParams.resize(numCompressedElems);
-        }
-
         assert(numCompressedElems == satnumRegionArray_.size());
         assert(!enableHysteresis() || numCompressedElems == imbnumRegionArray_.size());
         for (unsigned elemIdx = 0; elemIdx < numCompressedElems; ++elemIdx) {
@@ -381,47 +414,37 @@ public:
             }
 
 
-            if (enableHysteresis()) {
-                unsigned imbRegionIdx = imbnumRegionArray_[elemIdx];
-
-                if (hasGas && hasOil) {
-                    auto gasOilImbParamsHyst = std::make_shared<GasOilEpsTwoPhaseParams>();
-                    gasOilImbParamsHyst->setConfig(gasOilConfig);
-                    gasOilImbParamsHyst->setUnscaledPoints(gasOilUnscaledPointsVector_[imbRegionIdx]);
-                    gasOilImbParamsHyst->setScaledPoints(gasOilScaledImbPointsVector[elemIdx]);
-                    gasOilImbParamsHyst->setEffectiveLawParams(gasOilEffectiveParamVector_[imbRegionIdx]);
-                    gasOilImbParamsHyst->finalize();
-
-                    gasOilParams[elemIdx]->setImbibitionParams(gasOilImbParamsHyst,
-                                                               *gasOilScaledImbInfoVector[elemIdx],
-                                                               EclGasOilSystem);
-                }
-
-                if (hasOil && hasWater) {
-                    auto oilWaterImbParamsHyst = std::make_shared<OilWaterEpsTwoPhaseParams>();
-                    oilWaterImbParamsHyst->setConfig(oilWaterConfig);
-                    oilWaterImbParamsHyst->setUnscaledPoints(oilWaterUnscaledPointsVector_[imbRegionIdx]);
-                    oilWaterImbParamsHyst->setScaledPoints(oilWaterScaledImbPointsVector[elemIdx]);
-                    oilWaterImbParamsHyst->setEffectiveLawParams(oilWaterEffectiveParamVector_[imbRegionIdx]);
-                    oilWaterImbParamsHyst->finalize();
-
-                    oilWaterParams[elemIdx]->setImbibitionParams(oilWaterImbParamsHyst,
-                                                                 *gasOilScaledImbInfoVector[elemIdx],
-                                                                 EclGasOilSystem);
-                }
-
-                if (hasGas && hasWater && !hasOil) {
-                    auto gasWaterImbParamsHyst = std::make_shared<GasWaterEpsTwoPhaseParams>();
-                    gasWaterImbParamsHyst->setConfig(gasWaterConfig);
-                    gasWaterImbParamsHyst->setUnscaledPoints(gasWaterUnscaledPointsVector_[imbRegionIdx]);
-                    gasWaterImbParamsHyst->setScaledPoints(gasWaterScaledImbPointsVector[elemIdx]);
-                    gasWaterImbParamsHyst->setEffectiveLawParams(gasWaterEffectiveParamVector_[imbRegionIdx]);
-                    gasWaterImbParamsHyst->finalize();
-
-                    gasWaterParams[elemIdx]->setImbibitionParams(gasWaterImbParamsHyst,
-                                                                 *gasWaterScaledImbInfoVector[elemIdx],
-                                                                 EclGasWaterSystem);
-                }
+            if (imbibitionContext) {
+                const auto& context = imbibitionContext;
+                if (hasGas && hasOil)
+                    gasOilParams[elemIdx]->setImbibitionParamsFactory([context, elemIdx]() {
+                        return createImbibitionParams_<GasOilEpsTwoPhaseParams>(*context,
+                                                                                elemIdx,
+                                                                                context->gasOilConfig,
+                                                                                context->gasOilUnscaledPointsVector,
+                                                                                context->gasOilEffectiveParamVector,
+                                                                                EclGasOilSystem);
+                    });
+
+                if (hasOil && hasWater)
+                    oilWaterParams[elemIdx]->setImbibitionParamsFactory([context, elemIdx]() {
+                        return createImbibitionParams_<OilWaterEpsTwoPhaseParams>(*context,
+                                                                                  elemIdx,
+                                                                                  context->oilWaterConfig,
+                                                                                  context->oilWaterUnscaledPointsVector,
+                                                                                  context->oilWaterEffectiveParamVector,
+                                                                                  EclOilWaterSystem);
+                    });
+
+                if (hasGas && hasWater && !hasOil)
+                    gasWaterParams[elemIdx]->setImbibitionParamsFactory([context, elemIdx]() {
+                        return createImbibitionParams_<GasWaterEpsTwoPhaseParams>(*context,
+                                                                                  elemIdx,
+                                                                                  context->gasWaterConfig,
+                                                                                  context->gasWaterUnscaledPointsVector,
+                                                                                  context->gasWaterEffectiveParamVector,
+                                                                                  EclGasWaterSystem);
+                    });
             }
 
             if (hasGas && hasOil)
@@ -527,6 +550,48 @@ public:
         return *materialLawParams_[elemIdx];
     }
 
+    /*!
+     * \brief The three-phase approach which has been selected by the deck.
+     */
+    EclMultiplexerApproach threePhaseApproach() const
+    { return threePhaseApproach_; }
+
+    /*!
+     * \brief Returns true if StaticMaterialLaw<approach, enableHysteresisV, enableEpsV>
+     *        produces the same results as MaterialLaw for the current deck.
+     */
+    template <EclMultiplexerApproach approach, bool enableHysteresisV = true, bool enableEpsV = true>
+    bool supportsStaticMaterialLaw() const
+    {
+        if (threePhaseApproach_ != approach)
+            return false;
+        if (!enableHysteresisV && enableHysteresis())
+            return false;
+        if (!enableEpsV) {
+            for (const auto& config : {gasOilConfig, oilWaterConfig, gasWaterConfig})
+                if (config && (config->enableSatScaling()
+                               || config->enablePcScaling()
+                               || config->enableLeverettScaling()
+                               || config->enableKrwScaling()
+                               || config->enableKrnScaling()))
+                    return false;
+        }
+        return true;
+    }
+
+    /*!
+     * \brief The parameter object of an element for StaticMaterialLaw<approach, ...>.
+     */
+    template <EclMultiplexerApproach approach>
+    auto staticMaterialLawParams(unsigned elemIdx)
+        -> decltype(std::declval<MaterialLawParams&>().template getRealParams<approach>())
+    { return materialLawParams(elemIdx).template getRealParams<approach>(); }
+
+    template <EclMultiplexerApproach approach>
+    auto staticMaterialLawParams(unsigned elemIdx) const
+        -> decltype(std::declval<const MaterialLawParams&>().template getRealParams<approach>())
+    { return materialLawParams(elemIdx).template getRealParams<approach>(); }
+
     /*!
      * \brief Returns a material parameter object for a given element and saturation region.
      *
@@ -619,6 +684,12 @@ public:
     int satnumRegionIdx(unsigned elemIdx) const
     { return satnumRegionArray_[elemIdx]; }
 
+    /*!
+     * \brief Returns the SATNUM region indices of all elements.
+     */
+    const std::vector<int>& satnumRegionArray() const
+    { return satnumRegionArray_; }
+
     int imbnumRegionIdx(unsigned elemIdx) const
     { return imbnumRegionArray_[elemIdx]; }
 
@@ -682,6 +753,175 @@ public:
         MaterialLaw::setGasOilHysteresisParams(pcSwMdc, krnSwMdc, params);
     }
 
+    /*!
+     * \brief The number of values which represent the hysteresis state of an element.
+     *
+     * These are pcSwMdc and krnSwMdc of the oil-water system followed by pcSwMdc and
+     * krnSwMdc of the gas-oil system, i.e., the same quantities which are returned by
+     * oilWaterHysteresisParams() and gasOilHysteresisParams().
+     */
+    static const unsigned numHysteresisValuesPerElement = 4;
+
+    /*!
+     * \brief Copy the hysteresis state of a range of elements into a flat array.
+     *
+     * The state of element elemIdx is stored at
+     * values[numHysteresisValuesPerElement*(elemIdx - beginElemIdx)]. The values of a
+     * two-phase system which is not active are set to 2.0, which means that no
+     * hysteresis has occured yet. All elements use the same three-phase law, so the
+     * approach is dispatched once per call instead of once per element. Disjoint
+     * ranges may be processed concurrently.
+     */
+    void exportHysteresisState(Scalar* values,
+                               unsigned beginElemIdx,
+                               unsigned endElemIdx) const
+    {
+        if (!enableHysteresis())
+            throw std::runtime_error("Cannot get hysteresis parameters if hysteresis not enabled.");
+
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        switch (threePhaseApproach_) {
+        case EclMultiplexerApproach::EclStone1Approach:
+            exportHysteresisState_<typename MaterialLaw::Stone1Material,
+                                   EclMultiplexerApproach::EclStone1Approach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclStone2Approach:
+            exportHysteresisState_<typename MaterialLaw::Stone2Material,
+                                   EclMultiplexerApproach::EclStone2Approach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclDefaultApproach:
+            exportHysteresisState_<typename MaterialLaw::DefaultMaterial,
+                                   EclMultiplexerApproach::EclDefaultApproach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclTwoPhaseApproach:
+            exportHysteresisState_<typename MaterialLaw::TwoPhaseMaterial,
+                                   EclMultiplexerApproach::EclTwoPhaseApproach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclOnePhaseApproach:
+            std::fill(values,
+                      values + numHysteresisValuesPerElement*(endElemIdx - beginElemIdx),
+                      Scalar(2.0));
+            break;
+        }
+    }
+
+    /*!
+     * \brief Set the hysteresis state of a range of elements from a flat array.
+     *
+     * The layout of the array is the one of exportHysteresisState(). Like
+     * setOilWaterHysteresisParams() and setGasOilHysteresisParams(), this only lowers
+     * the minimum saturations which have been seen so far. The values of inactive
+     * two-phase systems are ignored.
+     */
+    void importHysteresisState(const Scalar* values,
+                               unsigned beginElemIdx,
+                               unsigned endElemIdx)
+    {
+        if (!enableHysteresis())
+            throw std::runtime_error("Cannot set hysteresis parameters if hysteresis not enabled.");
+
+        assert(beginElemIdx <= endElemIdx && endElemIdx <= materialLawParams_.size());
+        switch (threePhaseApproach_) {
+        case EclMultiplexerApproach::EclStone1Approach:
+            importHysteresisState_<typename MaterialLaw::Stone1Material,
+                                   EclMultiplexerApproach::EclStone1Approach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclStone2Approach:
+            importHysteresisState_<typename MaterialLaw::Stone2Material,
+                                   EclMultiplexerApproach::EclStone2Approach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclDefaultApproach:
+            importHysteresisState_<typename MaterialLaw::DefaultMaterial,
+                                   EclMultiplexerApproach::EclDefaultApproach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclTwoPhaseApproach:
+            importHysteresisState_<typename MaterialLaw::TwoPhaseMaterial,
+                                   EclMultiplexerApproach::EclTwoPhaseApproach>(values, beginElemIdx, endElemIdx);
+            break;
+
+        case EclMultiplexerApproach::EclOnePhaseApproach:
+            break;
+        }
+    }
+
+    /*!
+     * \brief Returns the hysteresis state of all elements as a flat array.
+     */
+    std::vector<Scalar> exportHysteresisState() const
+    {
+        std::vector<Scalar> values(numHysteresisValuesPerElement*materialLawParams_.size());
+        exportHysteresisState(values.data(), 0, static_cast<unsigned>(materialLawParams_.size()));
+        return values;
+    }
+
+    /*!
+     * \brief Set the hysteresis state of all elements from a flat array.
+     */
+    void importHysteresisState(const std::vector<Scalar>& values)
+    {
+        if (values.size() != numHysteresisValuesPerElement*materialLawParams_.size())
+            throw std::invalid_argument("The size of the hysteresis state ("+std::to_string(values.size())
+                                        +") does not match the number of elements");
+        importHysteresisState(values.data(), 0, static_cast<unsigned>(materialLawParams_.size()));
+    }
+
+    /*!
+     * \brief Write the hysteresis state of all elements to or read it from a serializer.
+     *
+     * This can be used together with BinarySerializer to store the state in a
+     * checkpoint.
+     */
+    template <class Serializer>
+    void serializeHysteresisState(Serializer& serializer)
+    {
+        std::vector<Scalar> values;
+        if (!serializer.isReading())
+            values = exportHysteresisState();
+        serializer(values);
+        if (serializer.isReading())
+            importHysteresisState(values);
+    }
+
+    /*!
+     * \brief Replace the saturation function tables of all regions by views of tables
+     *        which are shared by all processes of a node.
+     *
+     * All processes must call this method with the same segment name after
+     * initParamsForElements(), i.e., their tables must be identical. The tables of the
+     * first process are copied into shared memory (see SharedTables) and the other
+     * processes release their private copies, so the tables of the SATNUM regions are
+     * only stored once per node. The shared memory is used as long as the manager lives.
+     *
+     * \param segmentName The name of the shared memory segment.
+     * \param layoutKey Identifies the input of the tables, e.g. a hash of the deck.
+     * \return true if the tables of the calling process were copied.
+     */
+    bool shareTables(const std::string& segmentName, std::uint64_t layoutKey = 0)
+    {
+        layoutKey = SharedMemoryRegion::hash(static_cast<std::uint64_t>(gasOilEffectiveParamVector_.size()),
+                                             layoutKey);
+        layoutKey = SharedMemoryRegion::hash(sizeof(Scalar), layoutKey);
+
+        auto tables =
+            std::make_shared<SharedTables>(segmentName,
+                                           layoutKey,
+                                           []() { /* the tables have already been read */ },
+                                           [this](BinarySerializer& serializer) {
+                                               serializeEffectiveParams_(serializer, gasOilEffectiveParamVector_);
+                                               serializeEffectiveParams_(serializer, oilWaterEffectiveParamVector_);
+                                               serializeEffectiveParams_(serializer, gasWaterEffectiveParamVector_);
+                                           });
+        sharedTables_ = tables;
+        return tables->isOwner();
+    }
+
     EclEpsScalingPoints<Scalar>& oilWaterScaledEpsPointsDrainage(unsigned elemIdx)
     {
         auto& materialParams = *materialLawParams_[elemIdx];
@@ -717,6 +957,43 @@ public:
     { return oilWaterScaledEpsInfoDrainage_[elemIdx]; }
 
 private:
+    template <class ThreePhaseLaw, EclMultiplexerApproach approach>
+    void exportHysteresisState_(Scalar* values,
+                                unsigned beginElemIdx,
+                                unsigned endElemIdx) const
+    {
+        const bool hasOilWater = hasOil && hasWater;
+        const bool hasGasOil = hasGas && hasOil;
+        for (unsigned elemIdx = beginElemIdx; elemIdx < endElemIdx; ++elemIdx) {
+            const auto& params = materialLawParams_[elemIdx]->template getRealParams<approach>();
+            Scalar* elemValues = values + numHysteresisValuesPerElement*(elemIdx - beginElemIdx);
+
+            elemValues[0] = elemValues[1] = elemValues[2] = elemValues[3] = 2.0;
+            if (hasOilWater)
+                ThreePhaseLaw::oilWaterHysteresisParams(elemValues[0], elemValues[1], params);
+            if (hasGasOil)
+                ThreePhaseLaw::gasOilHysteresisParams(elemValues[2], elemValues[3], params);
+        }
+    }
+
+    template <class ThreePhaseLaw, EclMultiplexerApproach approach>
+    void importHysteresisState_(const Scalar* values,
+                                unsigned beginElemIdx,
+                                unsigned endElemIdx)
+    {
+        const bool hasOilWater = hasOil && hasWater;
+        const bool hasGasOil = hasGas && hasOil;
+        for (unsigned elemIdx = beginElemIdx; elemIdx < endElemIdx; ++elemIdx) {
+            auto& params = materialLawParams_[elemIdx]->template getRealParams<approach>();
+            const Scalar* elemValues = values + numHysteresisValuesPerElement*(elemIdx - beginElemIdx);
+
+            if (hasOilWater)
+                ThreePhaseLaw::setOilWaterHysteresisParams(elemValues[0], elemValues[1], params);
+            if (hasGasOil)
+                ThreePhaseLaw::setGasOilHysteresisParams(elemValues[2], elemValues[3], params);
+        }
+    }
+
     void readGlobalEpsOptions_(const EclipseState& eclState)
     {
         oilWaterEclEpsConfig_ = std::make_shared<EclEpsConfig>();
@@ -1087,6 +1364,57 @@ private:
         destPoints[elemIdx]->init(*destInfo[elemIdx], *config, EclGasWaterSystem);
     }
 
+    // the parameter objects are deserialized in place because the parameters of the
+    // elements refer to them
+    template <class Serializer, class EffectiveParamVector>
+    static void serializeEffectiveParams_(Serializer& serializer, EffectiveParamVector& paramVector)
+    {
+        std::uint64_t numRegions = paramVector.size();
+        serializer(numRegions);
+        if (numRegions != paramVector.size())
+            throw std::runtime_error("The number of saturation regions of the shared tables does not match");
+
+        for (auto& params : paramVector) {
+            bool hasParams = static_cast<bool>(params);
+            serializer(hasParams);
+            if (hasParams != static_cast<bool>(params))
+                throw std::runtime_error("The saturation functions of the shared tables do not match");
+            if (params)
+                serializer(*params);
+        }
+    }
+
+    // create the parameters for the imbibition curve of a single element. this is
+    // called by the hysteresis parameter objects when the element leaves the main
+    // drainage curve for the first time.
+    template <class EpsTwoPhaseParams, class UnscaledPointsContainer, class EffectiveParamsContainer>
+    static std::shared_ptr<EpsTwoPhaseParams>
+    createImbibitionParams_(const ImbibitionContext_& context,
+                            unsigned elemIdx,
+                            std::shared_ptr<EclEpsConfig> config,
+                            const UnscaledPointsContainer& unscaledPointsVector,
+                            const EffectiveParamsContainer& effectiveParamVector,
+                            EclTwoPhaseSystemType twoPhaseSystem)
+    {
+        unsigned imbRegionIdx = static_cast<unsigned>(context.imbnumRegionArray[elemIdx]);
+        unsigned satRegionIdx = context.epsGridProperties.satRegion(elemIdx);
+
+        EclEpsScalingPointsInfo<Scalar> scaledInfo(context.unscaledEpsInfo[satRegionIdx]);
+        scaledInfo.extractScaled(context.eclState, context.epsGridProperties, elemIdx);
+
+        auto scaledPoints = std::make_shared<EclEpsScalingPoints<Scalar> >();
+        scaledPoints->init(scaledInfo, *config, twoPhaseSystem);
+
+        auto imbParams = std::make_shared<EpsTwoPhaseParams>();
+        imbParams->setConfig(config);
+        imbParams->setUnscaledPoints(unscaledPointsVector[imbRegionIdx]);
+        imbParams->setScaledPoints(scaledPoints);
+        imbParams->setEffectiveLawParams(effectiveParamVector[imbRegionIdx]);
+        imbParams->finalize();
+
+        return imbParams;
+    }
+
     void initThreePhaseParams_(const EclipseState& /* eclState */,
                                MaterialLawParams& materialParams,
                                unsigned satRegionIdx,
@@ -1179,6 +1507,7 @@ private:
     GasOilEffectiveParamVector gasOilEffectiveParamVector_;
     OilWaterEffectiveParamVector oilWaterEffectiveParamVector_;
     GasWaterEffectiveParamVector gasWaterEffectiveParamVector_;
+    std::shared_ptr<SharedTables> sharedTables_;
 
     EclMultiplexerApproach threePhaseApproach_ = EclMultiplexerApproach::EclDefaultApproach;
     // this attribute only makes sense for twophase simulations!
@@ -1188,6 +1517,7 @@ private:
 
     std::vector<int> satnumRegionArray_;
     std::vector<int> imbnumRegionArray_;
+
     std::vector<Scalar> stoneEtas;
 
     bool hasGas;
@@ -1198,6 +1528,14 @@ private:
     std::shared_ptr<EclEpsConfig> oilWaterConfig;
     std::shared_ptr<EclEpsConfig> gasWaterConfig;
 };
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+// the material law manager for the phase indices of the black-oil fluid system
+extern template class EclMaterialLawManager<ThreePhaseMaterialTraits<double,
+                                                                     BlackOilDefaultIndexTraits::waterPhaseIdx,
+                                                                     BlackOilDefaultIndexTraits::oilPhaseIdx,
+                                                                     BlackOilDefaultIndexTraits::gasPhaseIdx> >;
+#endif
 } // namespace Opm
 
 #endif
@@ -35,6 +35,7 @@
 
 #include <opm/material/common/Valgrind.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Instrumentation.hpp>
 
 #include <algorithm>
 
@@ -136,6 +137,9 @@ public:
                                    const Params& params,
                                    const FluidState& fluidState)
     {
+        // the instrumentation counters are kept separately for each approach
+        OPM_INSTRUMENT_SCOPE("EclMultiplexerMaterial", "capillaryPressures", static_cast<unsigned>(params.approach()));
+
         switch (params.approach()) {
         case EclMultiplexerApproach::EclStone1Approach:
             Stone1Material::capillaryPressures(values,
@@ -408,6 +412,8 @@ public:
                                        const Params& params,
                                        const FluidState& fluidState)
     {
+        OPM_INSTRUMENT_SCOPE("EclMultiplexerMaterial", "relativePermeabilities", static_cast<unsigned>(params.approach()));
+
         switch (params.approach()) {
         case EclMultiplexerApproach::EclStone1Approach:
             Stone1Material::relativePermeabilities(values,
@@ -544,6 +550,8 @@ public:
     template <class FluidState>
     static void updateHysteresis(Params& params, const FluidState& fluidState)
     {
+        OPM_INSTRUMENT_SCOPE("EclMultiplexerMaterial", "updateHysteresis", static_cast<unsigned>(params.approach()));
+
         switch (params.approach()) {
         case EclMultiplexerApproach::EclStone1Approach:
             Stone1Material::updateHysteresis(params.template getRealParams<EclMultiplexerApproach::EclStone1Approach>(),
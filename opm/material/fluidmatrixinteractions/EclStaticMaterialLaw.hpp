@@ -0,0 +1,226 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::EclStaticTwoPhaseLaw
+ */
+#ifndef OPM_ECL_STATIC_MATERIAL_LAW_HPP
+#define OPM_ECL_STATIC_MATERIAL_LAW_HPP
+
+#include "EclMultiplexerMaterialParams.hpp"
+#include "EclStone1Material.hpp"
+#include "EclStone2Material.hpp"
+#include "EclDefaultMaterial.hpp"
+#include "EclTwoPhaseMaterial.hpp"
+
+#include <type_traits>
+
+namespace Opm {
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Strips the hysteresis and end-point scaling layers from a two-phase ECL law
+ *        at compile time.
+ *
+ * The law operates on the parameter objects of the full
+ * EclHysteresisTwoPhaseLaw<EclEpsTwoPhaseLaw<EffLaw> > stack, so it can be plugged
+ * into the three-phase laws without converting their parameters. If hysteresis is
+ * disabled, the drainage curve is used unconditionally; if end-point scaling is
+ * disabled as well, the effective law is called directly. The caller is responsible
+ * for using the law only if the parameters have been set up accordingly, i.e.,
+ * without hysteresis and without any saturation, capillary pressure or relative
+ * permeability scaling.
+ */
+template <class HystLawT, bool enableHysteresisV = true, bool enableEpsV = true>
+class EclStaticTwoPhaseLaw : public HystLawT::Traits
+{
+    typedef typename HystLawT::EffectiveLaw EpsLaw_;
+    typedef typename EpsLaw_::EffectiveLaw EffLaw_;
+
+    static_assert(enableEpsV || !enableHysteresisV,
+                  "Hysteresis without end-point scaling is not supported by the ECL material laws");
+
+    // 2: full hysteresis law, 1: drainage curve with end-point scaling, 0: unscaled
+    // drainage curve
+    typedef std::integral_constant<int, enableHysteresisV ? 2 : (enableEpsV ? 1 : 0)> Level_;
+
+public:
+    typedef HystLawT HysteresisLaw;
+    typedef typename HystLawT::Traits Traits;
+    typedef typename HystLawT::Params Params;
+    typedef typename HystLawT::Scalar Scalar;
+
+    static const bool enableHysteresis = enableHysteresisV;
+    static const bool enableEps = enableEpsV;
+
+    //! The number of fluid phases
+    static const int numPhases = HystLawT::numPhases;
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API
+    static const bool implementsTwoPhaseApi = HystLawT::implementsTwoPhaseApi;
+
+    //! Specify whether this material law implements the two-phase
+    //! convenience API which only depends on the phase saturations
+    static const bool implementsTwoPhaseSatApi = HystLawT::implementsTwoPhaseSatApi;
+
+    //! Specify whether the quantities defined by this material law
+    //! are saturation dependent
+    static const bool isSaturationDependent = HystLawT::isSaturationDependent;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the absolute pressure
+    static const bool isPressureDependent = HystLawT::isPressureDependent;
+
+    //! Specify whether the quantities defined by this material law
+    //! are temperature dependent
+    static const bool isTemperatureDependent = HystLawT::isTemperatureDependent;
+
+    //! Specify whether the quantities defined by this material law
+    //! are dependent on the phase composition
+    static const bool isCompositionDependent = HystLawT::isCompositionDependent;
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatPcnw(const Params& params, const Evaluation& Sw)
+    { return pcnw_(params, Sw, Level_()); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrw(const Params& params, const Evaluation& Sw)
+    { return krw_(params, Sw, Level_()); }
+
+    template <class Evaluation>
+    static Evaluation twoPhaseSatKrn(const Params& params, const Evaluation& Sw)
+    { return krn_(params, Sw, Level_()); }
+
+private:
+    typedef std::integral_constant<int, 2> Hysteresis_;
+    typedef std::integral_constant<int, 1> Eps_;
+    typedef std::integral_constant<int, 0> Unscaled_;
+
+    template <class Evaluation>
+    static Evaluation pcnw_(const Params& params, const Evaluation& Sw, Hysteresis_)
+    { return HystLawT::twoPhaseSatPcnw(params, Sw); }
+
+    template <class Evaluation>
+    static Evaluation pcnw_(const Params& params, const Evaluation& Sw, Eps_)
+    { return EpsLaw_::twoPhaseSatPcnw(params.drainageParams(), Sw); }
+
+    template <class Evaluation>
+    static Evaluation pcnw_(const Params& params, const Evaluation& Sw, Unscaled_)
+    { return EffLaw_::twoPhaseSatPcnw(params.drainageParams().effectiveLawParams(), Sw); }
+
+    template <class Evaluation>
+    static Evaluation krw_(const Params& params, const Evaluation& Sw, Hysteresis_)
+    { return HystLawT::twoPhaseSatKrw(params, Sw); }
+
+    template <class Evaluation>
+    static Evaluation krw_(const Params& params, const Evaluation& Sw, Eps_)
+    { return EpsLaw_::twoPhaseSatKrw(params.drainageParams(), Sw); }
+
+    template <class Evaluation>
+    static Evaluation krw_(const Params& params, const Evaluation& Sw, Unscaled_)
+    { return EffLaw_::twoPhaseSatKrw(params.drainageParams().effectiveLawParams(), Sw); }
+
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params, const Evaluation& Sw, Hysteresis_)
+    { return HystLawT::twoPhaseSatKrn(params, Sw); }
+
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params, const Evaluation& Sw, Eps_)
+    { return EpsLaw_::twoPhaseSatKrn(params.drainageParams(), Sw); }
+
+    template <class Evaluation>
+    static Evaluation krn_(const Params& params, const Evaluation& Sw, Unscaled_)
+    { return EffLaw_::twoPhaseSatKrn(params.drainageParams().effectiveLawParams(), Sw); }
+};
+
+/*!
+ * \ingroup FluidMatrixInteractions
+ *
+ * \brief Selects the three-phase ECL material law at compile time.
+ *
+ * The member type is the law which EclMultiplexerMaterial dispatches to for a given
+ * approach, but with the two-phase laws replaced by EclStaticTwoPhaseLaw. Its
+ * parameter type is identical to the one which is stored by the multiplexer, i.e.,
+ * the object returned by EclMultiplexerMaterialParams::getRealParams<approach>() can
+ * be passed to it directly.
+ */
+template <class TraitsT,
+          class GasOilMaterialLawT,
+          class OilWaterMaterialLawT,
+          class GasWaterMaterialLawT,
+          EclMultiplexerApproach approach,
+          bool enableHysteresisV = true,
+          bool enableEpsV = true>
+struct EclStaticMaterialLaw;
+
+template <class TraitsT, class GasOilLawT, class OilWaterLawT, class GasWaterLawT, bool enableHysteresisV, bool enableEpsV>
+struct EclStaticMaterialLaw<TraitsT, GasOilLawT, OilWaterLawT, GasWaterLawT,
+                            EclMultiplexerApproach::EclStone1Approach, enableHysteresisV, enableEpsV>
+{
+    typedef typename EclStone1Material<TraitsT, GasOilLawT, OilWaterLawT>::Params Params;
+    typedef EclStone1Material<TraitsT,
+                              EclStaticTwoPhaseLaw<GasOilLawT, enableHysteresisV, enableEpsV>,
+                              EclStaticTwoPhaseLaw<OilWaterLawT, enableHysteresisV, enableEpsV>,
+                              Params> type;
+};
+
+template <class TraitsT, class GasOilLawT, class OilWaterLawT, class GasWaterLawT, bool enableHysteresisV, bool enableEpsV>
+struct EclStaticMaterialLaw<TraitsT, GasOilLawT, OilWaterLawT, GasWaterLawT,
+                            EclMultiplexerApproach::EclStone2Approach, enableHysteresisV, enableEpsV>
+{
+    typedef typename EclStone2Material<TraitsT, GasOilLawT, OilWaterLawT>::Params Params;
+    typedef EclStone2Material<TraitsT,
+                              EclStaticTwoPhaseLaw<GasOilLawT, enableHysteresisV, enableEpsV>,
+                              EclStaticTwoPhaseLaw<OilWaterLawT, enableHysteresisV, enableEpsV>,
+                              Params> type;
+};
+
+template <class TraitsT, class GasOilLawT, class OilWaterLawT, class GasWaterLawT, bool enableHysteresisV, bool enableEpsV>
+struct EclStaticMaterialLaw<TraitsT, GasOilLawT, OilWaterLawT, GasWaterLawT,
+                            EclMultiplexerApproach::EclDefaultApproach, enableHysteresisV, enableEpsV>
+{
+    typedef typename EclDefaultMaterial<TraitsT, GasOilLawT, OilWaterLawT>::Params Params;
+    typedef EclDefaultMaterial<TraitsT,
+                               EclStaticTwoPhaseLaw<GasOilLawT, enableHysteresisV, enableEpsV>,
+                               EclStaticTwoPhaseLaw<OilWaterLawT, enableHysteresisV, enableEpsV>,
+                               Params> type;
+};
+
+// the two-phase law still selects the active phase pair at runtime
+template <class TraitsT, class GasOilLawT, class OilWaterLawT, class GasWaterLawT, bool enableHysteresisV, bool enableEpsV>
+struct EclStaticMaterialLaw<TraitsT, GasOilLawT, OilWaterLawT, GasWaterLawT,
+                            EclMultiplexerApproach::EclTwoPhaseApproach, enableHysteresisV, enableEpsV>
+{
+    typedef typename EclTwoPhaseMaterial<TraitsT, GasOilLawT, OilWaterLawT, GasWaterLawT>::Params Params;
+    typedef EclTwoPhaseMaterial<TraitsT,
+                                EclStaticTwoPhaseLaw<GasOilLawT, enableHysteresisV, enableEpsV>,
+                                EclStaticTwoPhaseLaw<OilWaterLawT, enableHysteresisV, enableEpsV>,
+                                EclStaticTwoPhaseLaw<GasWaterLawT, enableHysteresisV, enableEpsV>,
+                                Params> type;
+};
+
+} // namespace Opm
+
+#endif
@@ -32,6 +32,7 @@
 #include <cstddef>
 
 #include <opm/material/common/EnsureFinalized.hpp>
+#include <opm/material/common/TableArray.hpp>
 
 namespace Opm {
 /*!
@@ -39,6 +40,9 @@ namespace Opm {
  *
  * \brief Specification of the material parameters for a two-phase material law which
  *        uses a table and piecewise constant interpolation.
+ *
+ * The sampling points are stored in table arrays, so the parameters of the saturation
+ * regions can be placed in shared memory, see SharedTables.
  */
 template<class TraitsT>
 class PiecewiseLinearTwoPhaseMaterialParams : public EnsureFinalized
@@ -46,7 +50,7 @@ class PiecewiseLinearTwoPhaseMaterialParams : public EnsureFinalized
     typedef typename TraitsT::Scalar Scalar;
 
 public:
-    typedef std::vector<Scalar> ValueVector;
+    typedef TableArray<Scalar> ValueVector;
 
     typedef TraitsT Traits;
 
@@ -176,6 +180,20 @@ public:
         std::copy(values.begin(), values.end(), krnSamples_.begin());
     }
 
+    /*!
+     * \brief Serialize or deserialize the sampling points of the parameter object.
+     */
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(SwPcwnSamples_);
+        serializer(SwKrwSamples_);
+        serializer(SwKrnSamples_);
+        serializer(pcwnSamples_);
+        serializer(krwSamples_);
+        serializer(krnSamples_);
+    }
+
 private:
     void swapOrder_(ValueVector& swValues, ValueVector& values) const
     {
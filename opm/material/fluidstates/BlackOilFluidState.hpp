@@ -87,6 +87,180 @@ auto getSaltConcentration_(typename std::enable_if<!HasMember_saltConcentration<
                                                     const FluidState&>::type fluidState OPM_UNUSED)
 { return 0.0; }
 
+/*!
+ * \brief The quantities of a black-oil fluid state which are computed "on the fly".
+ *
+ * The implementation must provide the pressure(), density(), Rs(), Rv() and
+ * pvtRegionIndex() methods.
+ */
+template <class Scalar, class FluidSystem, class Implementation>
+class BlackOilFluidStateDerivedModule
+{
+    enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+    enum { oilPhaseIdx = FluidSystem::oilPhaseIdx };
+
+    enum { waterCompIdx = FluidSystem::waterCompIdx };
+    enum { gasCompIdx = FluidSystem::gasCompIdx };
+    enum { oilCompIdx = FluidSystem::oilCompIdx };
+
+    enum { numComponents = FluidSystem::numComponents };
+
+public:
+    /*!
+     * \brief Return the molar density of a fluid phase [mol/m^3].
+     */
+    Scalar molarDensity(unsigned phaseIdx) const
+    {
+        unsigned regionIdx = asImp_().pvtRegionIndex();
+        const auto& rho = asImp_().density(phaseIdx);
+
+        if (phaseIdx == waterPhaseIdx)
+            return rho/FluidSystem::molarMass(waterCompIdx, regionIdx);
+
+        return
+            rho*(moleFraction(phaseIdx, gasCompIdx)/FluidSystem::molarMass(gasCompIdx, regionIdx)
+                 + moleFraction(phaseIdx, oilCompIdx)/FluidSystem::molarMass(oilCompIdx, regionIdx));
+
+    }
+
+    /*!
+     * \brief Return the molar volume of a fluid phase [m^3/mol].
+     *
+     * This is equivalent to the inverse of the molar density.
+     */
+    Scalar molarVolume(unsigned phaseIdx) const
+    { return 1.0/molarDensity(phaseIdx); }
+
+    /*!
+     * \brief Return the dynamic viscosity of a fluid phase [Pa s].
+     */
+    Scalar viscosity(unsigned phaseIdx) const
+    { return FluidSystem::viscosity(asImp_(), phaseIdx, asImp_().pvtRegionIndex()); }
+
+    /*!
+     * \brief Return the mass fraction of a component in a fluid phase [-].
+     */
+    Scalar massFraction(unsigned phaseIdx, unsigned compIdx) const
+    {
+        unsigned regionIdx = asImp_().pvtRegionIndex();
+
+        switch (phaseIdx) {
+        case waterPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 1.0;
+            return 0.0;
+
+        case oilPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 0.0;
+            else if (compIdx == oilCompIdx)
+                return 1.0 - FluidSystem::convertRsToXoG(asImp_().Rs(), regionIdx);
+            else {
+                assert(compIdx == gasCompIdx);
+                return FluidSystem::convertRsToXoG(asImp_().Rs(), regionIdx);
+            }
+            break;
+
+        case gasPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 0.0;
+            else if (compIdx == oilCompIdx)
+                return FluidSystem::convertRvToXgO(asImp_().Rv(), regionIdx);
+            else {
+                assert(compIdx == gasCompIdx);
+                return 1.0 - FluidSystem::convertRvToXgO(asImp_().Rv(), regionIdx);
+            }
+            break;
+        }
+
+        throw std::logic_error("Invalid phase or component index!");
+    }
+
+    /*!
+     * \brief Return the mole fraction of a component in a fluid phase [-].
+     */
+    Scalar moleFraction(unsigned phaseIdx, unsigned compIdx) const
+    {
+        unsigned regionIdx = asImp_().pvtRegionIndex();
+
+        switch (phaseIdx) {
+        case waterPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 1.0;
+            return 0.0;
+
+        case oilPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 0.0;
+            else if (compIdx == oilCompIdx)
+                return 1.0 - FluidSystem::convertXoGToxoG(FluidSystem::convertRsToXoG(asImp_().Rs(), regionIdx),
+                                                          regionIdx);
+            else {
+                assert(compIdx == gasCompIdx);
+                return FluidSystem::convertXoGToxoG(FluidSystem::convertRsToXoG(asImp_().Rs(), regionIdx),
+                                                    regionIdx);
+            }
+            break;
+
+        case gasPhaseIdx:
+            if (compIdx == waterCompIdx)
+                return 0.0;
+            else if (compIdx == oilCompIdx)
+                return FluidSystem::convertXgOToxgO(FluidSystem::convertRvToXgO(asImp_().Rv(), regionIdx),
+                                                    regionIdx);
+            else {
+                assert(compIdx == gasCompIdx);
+                return 1.0 - FluidSystem::convertXgOToxgO(FluidSystem::convertRvToXgO(asImp_().Rv(), regionIdx),
+                                                          regionIdx);
+            }
+            break;
+        }
+
+        throw std::logic_error("Invalid phase or component index!");
+    }
+
+    /*!
+     * \brief Return the partial molar density of a component in a fluid phase [mol / m^3].
+     */
+    Scalar molarity(unsigned phaseIdx, unsigned compIdx) const
+    { return moleFraction(phaseIdx, compIdx)*molarDensity(phaseIdx); }
+
+    /*!
+     * \brief Return the partial molar density of a fluid phase [kg / mol].
+     */
+    Scalar averageMolarMass(unsigned phaseIdx) const
+    {
+        unsigned regionIdx = asImp_().pvtRegionIndex();
+
+        Scalar result(0.0);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
+            result += FluidSystem::molarMass(compIdx, regionIdx)*moleFraction(phaseIdx, compIdx);
+        return result;
+    }
+
+    /*!
+     * \brief Return the fugacity coefficient of a component in a fluid phase [-].
+     */
+    Scalar fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
+    { return FluidSystem::fugacityCoefficient(asImp_(), phaseIdx, compIdx, asImp_().pvtRegionIndex()); }
+
+    /*!
+     * \brief Return the fugacity of a component in a fluid phase [Pa].
+     */
+    Scalar fugacity(unsigned phaseIdx, unsigned compIdx) const
+    {
+        return
+            fugacityCoefficient(phaseIdx, compIdx)
+            *moleFraction(phaseIdx, compIdx)
+            *asImp_().pressure(phaseIdx);
+    }
+
+protected:
+    const Implementation& asImp_() const
+    { return *static_cast<const Implementation*>(this); }
+};
+
 /*!
  * \brief Implements a "tailor-made" fluid state class for the black-oil model.
  *
@@ -102,6 +276,15 @@ template <class ScalarT,
           bool enableBrine = false,
           unsigned numStoragePhases = FluidSystem::numPhases>
 class BlackOilFluidState
+    : public BlackOilFluidStateDerivedModule<ScalarT,
+                                             FluidSystem,
+                                             BlackOilFluidState<ScalarT,
+                                                                FluidSystem,
+                                                                enableTemperature,
+                                                                enableEnergy,
+                                                                enableDissolution,
+                                                                enableBrine,
+                                                                numStoragePhases> >
 {
     enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
     enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
@@ -412,152 +595,6 @@ public:
     Scalar internalEnergy(unsigned phaseIdx OPM_UNUSED) const
     { return (*enthalpy_)[canonicalToStoragePhaseIndex_(phaseIdx)] - pressure(phaseIdx)/density(phaseIdx); }
 
-    //////
-    // slow methods
-    //////
-
-    /*!
-     * \brief Return the molar density of a fluid phase [mol/m^3].
-     */
-    Scalar molarDensity(unsigned phaseIdx) const
-    {
-        const auto& rho = density(phaseIdx);
-
-        if (phaseIdx == waterPhaseIdx)
-            return rho/FluidSystem::molarMass(waterCompIdx, pvtRegionIdx_);
-
-        return
-            rho*(moleFraction(phaseIdx, gasCompIdx)/FluidSystem::molarMass(gasCompIdx, pvtRegionIdx_)
-                 + moleFraction(phaseIdx, oilCompIdx)/FluidSystem::molarMass(oilCompIdx, pvtRegionIdx_));
-
-    }
-
-    /*!
-     * \brief Return the molar volume of a fluid phase [m^3/mol].
-     *
-     * This is equivalent to the inverse of the molar density.
-     */
-    Scalar molarVolume(unsigned phaseIdx) const
-    { return 1.0/molarDensity(phaseIdx); }
-
-    /*!
-     * \brief Return the dynamic viscosity of a fluid phase [Pa s].
-     */
-    Scalar viscosity(unsigned phaseIdx) const
-    { return FluidSystem::viscosity(*this, phaseIdx, pvtRegionIdx_); }
-
-    /*!
-     * \brief Return the mass fraction of a component in a fluid phase [-].
-     */
-    Scalar massFraction(unsigned phaseIdx, unsigned compIdx) const
-    {
-        switch (phaseIdx) {
-        case waterPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 1.0;
-            return 0.0;
-
-        case oilPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 0.0;
-            else if (compIdx == oilCompIdx)
-                return 1.0 - FluidSystem::convertRsToXoG(Rs(), pvtRegionIdx_);
-            else {
-                assert(compIdx == gasCompIdx);
-                return FluidSystem::convertRsToXoG(Rs(), pvtRegionIdx_);
-            }
-            break;
-
-        case gasPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 0.0;
-            else if (compIdx == oilCompIdx)
-                return FluidSystem::convertRvToXgO(Rv(), pvtRegionIdx_);
-            else {
-                assert(compIdx == gasCompIdx);
-                return 1.0 - FluidSystem::convertRvToXgO(Rv(), pvtRegionIdx_);
-            }
-            break;
-        }
-
-        throw std::logic_error("Invalid phase or component index!");
-    }
-
-    /*!
-     * \brief Return the mole fraction of a component in a fluid phase [-].
-     */
-    Scalar moleFraction(unsigned phaseIdx, unsigned compIdx) const
-    {
-        switch (phaseIdx) {
-        case waterPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 1.0;
-            return 0.0;
-
-        case oilPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 0.0;
-            else if (compIdx == oilCompIdx)
-                return 1.0 - FluidSystem::convertXoGToxoG(FluidSystem::convertRsToXoG(Rs(), pvtRegionIdx_),
-                                                          pvtRegionIdx_);
-            else {
-                assert(compIdx == gasCompIdx);
-                return FluidSystem::convertXoGToxoG(FluidSystem::convertRsToXoG(Rs(), pvtRegionIdx_),
-                                                    pvtRegionIdx_);
-            }
-            break;
-
-        case gasPhaseIdx:
-            if (compIdx == waterCompIdx)
-                return 0.0;
-            else if (compIdx == oilCompIdx)
-                return FluidSystem::convertXgOToxgO(FluidSystem::convertRvToXgO(Rv(), pvtRegionIdx_),
-                                                    pvtRegionIdx_);
-            else {
-                assert(compIdx == gasCompIdx);
-                return 1.0 - FluidSystem::convertXgOToxgO(FluidSystem::convertRvToXgO(Rv(), pvtRegionIdx_),
-                                                          pvtRegionIdx_);
-            }
-            break;
-        }
-
-        throw std::logic_error("Invalid phase or component index!");
-    }
-
-    /*!
-     * \brief Return the partial molar density of a component in a fluid phase [mol / m^3].
-     */
-    Scalar molarity(unsigned phaseIdx, unsigned compIdx) const
-    { return moleFraction(phaseIdx, compIdx)*molarDensity(phaseIdx); }
-
-    /*!
-     * \brief Return the partial molar density of a fluid phase [kg / mol].
-     */
-    Scalar averageMolarMass(unsigned phaseIdx) const
-    {
-        Scalar result(0.0);
-        for (unsigned compIdx = 0; compIdx < numComponents; ++ compIdx)
-            result += FluidSystem::molarMass(compIdx, pvtRegionIdx_)*moleFraction(phaseIdx, compIdx);
-        return result;
-    }
-
-    /*!
-     * \brief Return the fugacity coefficient of a component in a fluid phase [-].
-     */
-    Scalar fugacityCoefficient(unsigned phaseIdx, unsigned compIdx) const
-    { return FluidSystem::fugacityCoefficient(*this, phaseIdx, compIdx, pvtRegionIdx_); }
-
-    /*!
-     * \brief Return the fugacity of a component in a fluid phase [Pa].
-     */
-    Scalar fugacity(unsigned phaseIdx, unsigned compIdx) const
-    {
-        return
-            fugacityCoefficient(phaseIdx, compIdx)
-            *moleFraction(phaseIdx, compIdx)
-            *pressure(phaseIdx);
-    }
-
 private:
     static unsigned storageToCanonicalPhaseIndex_(unsigned storagePhaseIdx)
     {
@@ -0,0 +1,516 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Opm::BlackOilFluidStateArray
+ */
+#ifndef OPM_BLACK_OIL_FLUID_STATE_ARRAY_HPP
+#define OPM_BLACK_OIL_FLUID_STATE_ARRAY_HPP
+
+#include <opm/material/fluidstates/BlackOilFluidState.hpp>
+
+#include <opm/material/common/Valgrind.hpp>
+#include <opm/material/common/Unused.hpp>
+#include <opm/material/common/ConditionalStorage.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \brief A reference to a single cell of a BlackOilFluidStateArray.
+ *
+ * The object satisfies the fluid state API, i.e., it can be passed to the fluid systems
+ * and material laws instead of a BlackOilFluidState. All quantities are read from and
+ * written to the storage of the array. Copying the object yields another reference to
+ * the same cell; use assign() to copy the values of a fluid state.
+ *
+ * If the template argument is a const array, the setters are not available.
+ */
+template <class FluidStateArray>
+class BlackOilFluidStateArrayCell
+    : public BlackOilFluidStateDerivedModule<typename FluidStateArray::Scalar,
+                                             typename FluidStateArray::FluidSystem,
+                                             BlackOilFluidStateArrayCell<FluidStateArray> >
+{
+    typedef typename FluidStateArray::FluidSystem FluidSystem;
+
+public:
+    typedef typename FluidStateArray::Scalar Scalar;
+    enum { numPhases = FluidSystem::numPhases };
+    enum { numComponents = FluidSystem::numComponents };
+
+    BlackOilFluidStateArrayCell(FluidStateArray& array, std::size_t cellIdx)
+        : array_(&array)
+        , cellIdx_(cellIdx)
+    { assert(cellIdx < array.numCells()); }
+
+    /*!
+     * \brief Return the index of the referenced cell.
+     */
+    std::size_t cellIndex() const
+    { return cellIdx_; }
+
+    /*!
+     * \brief Make sure that all attributes are defined.
+     *
+     * This method does not do anything if the program is not run
+     * under valgrind. If it is, then valgrind will print an error
+     * message if some attributes of the object have not been properly
+     * defined.
+     */
+    void checkDefined() const
+    {
+#ifndef NDEBUG
+        Valgrind::CheckDefined(pvtRegionIndex());
+
+        for (unsigned storagePhaseIdx = 0; storagePhaseIdx < FluidStateArray::numStoragePhases; ++ storagePhaseIdx) {
+            unsigned phaseIdx = FluidStateArray::storageToCanonicalPhaseIndex(storagePhaseIdx);
+            Valgrind::CheckDefined(saturation(phaseIdx));
+            Valgrind::CheckDefined(pressure(phaseIdx));
+            Valgrind::CheckDefined(density(phaseIdx));
+            Valgrind::CheckDefined(invB(phaseIdx));
+
+            if (FluidStateArray::enableEnergy)
+                Valgrind::CheckDefined(enthalpy(phaseIdx));
+        }
+
+        if (FluidStateArray::enableDissolution) {
+            Valgrind::CheckDefined(Rs());
+            Valgrind::CheckDefined(Rv());
+        }
+
+        if (FluidStateArray::enableBrine)
+            Valgrind::CheckDefined(saltConcentration());
+
+        if (FluidStateArray::enableTemperature || FluidStateArray::enableEnergy)
+            Valgrind::CheckDefined(temperature(/*phaseIdx=*/0));
+#endif // NDEBUG
+    }
+
+    /*!
+     * \brief Retrieve all parameters from an arbitrary fluid
+     *        state.
+     */
+    template <class FluidState>
+    void assign(const FluidState& fs)
+    {
+        if (FluidStateArray::enableTemperature || FluidStateArray::enableEnergy)
+            setTemperature(fs.temperature(/*phaseIdx=*/0));
+
+        unsigned pvtRegionIdx = getPvtRegionIndex_<FluidState>(fs);
+        setPvtRegionIndex(pvtRegionIdx);
+
+        if (FluidStateArray::enableDissolution) {
+            setRs(BlackOil::getRs_<FluidSystem, FluidState, Scalar>(fs, pvtRegionIdx));
+            setRv(BlackOil::getRv_<FluidSystem, FluidState, Scalar>(fs, pvtRegionIdx));
+        }
+
+        if (FluidStateArray::enableBrine)
+            setSaltConcentration(BlackOil::getSaltConcentration_<FluidSystem, FluidState, Scalar>(fs, pvtRegionIdx));
+
+        for (unsigned storagePhaseIdx = 0; storagePhaseIdx < FluidStateArray::numStoragePhases; ++storagePhaseIdx) {
+            unsigned phaseIdx = FluidStateArray::storageToCanonicalPhaseIndex(storagePhaseIdx);
+            setSaturation(phaseIdx, fs.saturation(phaseIdx));
+            setPressure(phaseIdx, fs.pressure(phaseIdx));
+            setDensity(phaseIdx, fs.density(phaseIdx));
+
+            if (FluidStateArray::enableEnergy)
+                setEnthalpy(phaseIdx, fs.enthalpy(phaseIdx));
+
+            setInvB(phaseIdx, getInvB_<FluidSystem, FluidState, Scalar>(fs, phaseIdx, pvtRegionIdx));
+        }
+    }
+
+    void setPvtRegionIndex(unsigned newPvtRegionIdx)
+    { array_->pvtRegionIndexArray()[cellIdx_] = static_cast<unsigned short>(newPvtRegionIdx); }
+
+    void setPressure(unsigned phaseIdx, const Scalar& p)
+    { array_->pressureArray(phaseIdx)[cellIdx_] = p; }
+
+    void setSaturation(unsigned phaseIdx, const Scalar& S)
+    { array_->saturationArray(phaseIdx)[cellIdx_] = S; }
+
+    void setPc(unsigned phaseIdx, const Scalar& pc)
+    { array_->pcArray(phaseIdx)[cellIdx_] = pc; }
+
+    void setTotalSaturation(const Scalar& value)
+    { array_->totalSaturationArray()[cellIdx_] = value; }
+
+    void setTemperature(const Scalar& value)
+    { array_->temperatureArray()[cellIdx_] = value; }
+
+    void setEnthalpy(unsigned phaseIdx, const Scalar& value)
+    { array_->enthalpyArray(phaseIdx)[cellIdx_] = value; }
+
+    void setInvB(unsigned phaseIdx, const Scalar& b)
+    { array_->invBArray(phaseIdx)[cellIdx_] = b; }
+
+    void setDensity(unsigned phaseIdx, const Scalar& rho)
+    { array_->densityArray(phaseIdx)[cellIdx_] = rho; }
+
+    void setRs(const Scalar& newRs)
+    { array_->RsArray()[cellIdx_] = newRs; }
+
+    void setRv(const Scalar& newRv)
+    { array_->RvArray()[cellIdx_] = newRv; }
+
+    void setSaltConcentration(const Scalar& newSaltConcentration)
+    { array_->saltConcentrationArray()[cellIdx_] = newSaltConcentration; }
+
+    const Scalar& pressure(unsigned phaseIdx) const
+    { return array_->pressureArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& saturation(unsigned phaseIdx) const
+    { return array_->saturationArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& pc(unsigned phaseIdx) const
+    { return array_->pcArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& totalSaturation() const
+    { return array_->totalSaturationArray()[cellIdx_]; }
+
+    /*!
+     * \brief Return the temperature [K]
+     *
+     * If temperature is not stored by the array, this is the reservoir temperature.
+     */
+    const Scalar& temperature(unsigned phaseIdx OPM_UNUSED) const
+    {
+        if (!FluidStateArray::enableTemperature && !FluidStateArray::enableEnergy) {
+            static Scalar tmp(FluidSystem::reservoirTemperature(pvtRegionIndex()));
+            return tmp;
+        }
+
+        return array_->temperatureArray()[cellIdx_];
+    }
+
+    const Scalar& invB(unsigned phaseIdx) const
+    { return array_->invBArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& Rs() const
+    {
+        if (!FluidStateArray::enableDissolution) {
+            static Scalar null = 0.0;
+            return null;
+        }
+
+        return array_->RsArray()[cellIdx_];
+    }
+
+    const Scalar& Rv() const
+    {
+        if (!FluidStateArray::enableDissolution) {
+            static Scalar null = 0.0;
+            return null;
+        }
+
+        return array_->RvArray()[cellIdx_];
+    }
+
+    const Scalar& saltConcentration() const
+    {
+        if (!FluidStateArray::enableBrine) {
+            static Scalar null = 0.0;
+            return null;
+        }
+
+        return array_->saltConcentrationArray()[cellIdx_];
+    }
+
+    unsigned short pvtRegionIndex() const
+    { return array_->pvtRegionIndexArray()[cellIdx_]; }
+
+    Scalar density(unsigned phaseIdx) const
+    { return array_->densityArray(phaseIdx)[cellIdx_]; }
+
+    const Scalar& enthalpy(unsigned phaseIdx) const
+    { return array_->enthalpyArray(phaseIdx)[cellIdx_]; }
+
+    Scalar internalEnergy(unsigned phaseIdx) const
+    { return enthalpy(phaseIdx) - pressure(phaseIdx)/density(phaseIdx); }
+
+private:
+    FluidStateArray* array_;
+    std::size_t cellIdx_;
+};
+
+/*!
+ * \brief Stores the black-oil fluid states of a block of cells as a structure of
+ *        arrays.
+ *
+ * This container holds the same quantities as a vector of BlackOilFluidState objects,
+ * but each quantity of each phase is stored contiguously for all cells. Loops which
+ * only touch a few quantities, e.g., batched PVT kernels, thus get unit-stride access
+ * via the *Array() methods instead of striding over complete fluid states. The
+ * arrays are indexed by the cell, the per-phase ones are selected by the canonical
+ * phase index.
+ *
+ * operator[] returns a BlackOilFluidStateArrayCell object for a cell, which can be
+ * used wherever a fluid state is expected:
+ *
+ * \code
+ * BlackOilFluidStateArray<Evaluation, FluidSystem> fluidStates(numCells);
+ * ...
+ * for (std::size_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+ *     auto fs = fluidStates[cellIdx];
+ *     fs.setInvB(oilPhaseIdx, FluidSystem::inverseFormationVolumeFactor(fs, oilPhaseIdx, fs.pvtRegionIndex()));
+ * }
+ * \endcode
+ *
+ * The template parameters have the same meaning as for BlackOilFluidState. The arrays
+ * of quantities which are disabled are not allocated.
+ */
+template <class ScalarT,
+          class FluidSystemT,
+          bool enableTemperatureV = false,
+          bool enableEnergyV = false,
+          bool enableDissolutionV = true,
+          bool enableBrineV = false,
+          unsigned numStoragePhasesV = FluidSystemT::numPhases>
+class BlackOilFluidStateArray
+{
+    typedef BlackOilFluidStateArray<ScalarT,
+                                    FluidSystemT,
+                                    enableTemperatureV,
+                                    enableEnergyV,
+                                    enableDissolutionV,
+                                    enableBrineV,
+                                    numStoragePhasesV> ThisType;
+
+    typedef std::array<std::vector<ScalarT>, numStoragePhasesV> PhaseArrays;
+
+public:
+    typedef ScalarT Scalar;
+    typedef FluidSystemT FluidSystem;
+
+    static const bool enableTemperature = enableTemperatureV;
+    static const bool enableEnergy = enableEnergyV;
+    static const bool enableDissolution = enableDissolutionV;
+    static const bool enableBrine = enableBrineV;
+    static const unsigned numStoragePhases = numStoragePhasesV;
+
+    //! The fluid state type of which the values of a cell can be stored
+    typedef BlackOilFluidState<Scalar,
+                               FluidSystem,
+                               enableTemperature,
+                               enableEnergy,
+                               enableDissolution,
+                               enableBrine,
+                               numStoragePhases> FluidState;
+
+    typedef BlackOilFluidStateArrayCell<ThisType> Cell;
+    typedef BlackOilFluidStateArrayCell<const ThisType> ConstCell;
+
+    explicit BlackOilFluidStateArray(std::size_t numCells = 0)
+    { resize(numCells); }
+
+    /*!
+     * \brief Set the number of cells.
+     *
+     * The values of the cells which are already present are kept.
+     */
+    void resize(std::size_t numCells)
+    {
+        numCells_ = numCells;
+        for (unsigned storagePhaseIdx = 0; storagePhaseIdx < numStoragePhases; ++storagePhaseIdx) {
+            pressure_[storagePhaseIdx].resize(numCells);
+            pc_[storagePhaseIdx].resize(numCells);
+            saturation_[storagePhaseIdx].resize(numCells);
+            invB_[storagePhaseIdx].resize(numCells);
+            density_[storagePhaseIdx].resize(numCells);
+            if (enableEnergy)
+                (*enthalpy_)[storagePhaseIdx].resize(numCells);
+        }
+
+        totalSaturation_.resize(numCells);
+        pvtRegionIdx_.resize(numCells);
+        if (enableTemperature || enableEnergy)
+            temperature_->resize(numCells);
+        if (enableDissolution) {
+            Rs_->resize(numCells);
+            Rv_->resize(numCells);
+        }
+        if (enableBrine)
+            saltConcentration_->resize(numCells);
+    }
+
+    std::size_t numCells() const
+    { return numCells_; }
+
+    std::size_t size() const
+    { return numCells_; }
+
+    /*!
+     * \brief Return a fluid state object which refers to a cell.
+     */
+    Cell operator[](std::size_t cellIdx)
+    { return Cell(*this, cellIdx); }
+
+    ConstCell operator[](std::size_t cellIdx) const
+    { return ConstCell(*this, cellIdx); }
+
+    /*!
+     * \brief Copy the values of an arbitrary fluid state into a cell.
+     */
+    template <class FluidState>
+    void assign(std::size_t cellIdx, const FluidState& fs)
+    { (*this)[cellIdx].assign(fs); }
+
+    /*!
+     * \brief Return a copy of the values of a cell as a BlackOilFluidState.
+     *
+     * Unlike BlackOilFluidState::assign(), this also copies the capillary pressures and
+     * the total saturation.
+     */
+    FluidState fluidState(std::size_t cellIdx) const
+    {
+        FluidState fs;
+        fs.assign((*this)[cellIdx]);
+        fs.setTotalSaturation(totalSaturation_[cellIdx]);
+        for (unsigned storagePhaseIdx = 0; storagePhaseIdx < numStoragePhases; ++storagePhaseIdx) {
+            unsigned phaseIdx = storageToCanonicalPhaseIndex(storagePhaseIdx);
+            fs.setPc(phaseIdx, pc_[storagePhaseIdx][cellIdx]);
+        }
+        return fs;
+    }
+
+    /*!
+     * \brief The contiguous arrays of the quantities for all cells.
+     *
+     * The arrays of the per-phase quantities are selected by the canonical phase
+     * index. The ones of the quantities which are disabled by the template parameters
+     * must not be accessed.
+     */
+    Scalar* pressureArray(unsigned phaseIdx)
+    { return pressure_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* pressureArray(unsigned phaseIdx) const
+    { return pressure_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* saturationArray(unsigned phaseIdx)
+    { return saturation_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* saturationArray(unsigned phaseIdx) const
+    { return saturation_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* pcArray(unsigned phaseIdx)
+    { return pc_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* pcArray(unsigned phaseIdx) const
+    { return pc_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* invBArray(unsigned phaseIdx)
+    { return invB_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* invBArray(unsigned phaseIdx) const
+    { return invB_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* densityArray(unsigned phaseIdx)
+    { return density_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* densityArray(unsigned phaseIdx) const
+    { return density_[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* enthalpyArray(unsigned phaseIdx)
+    { return (*enthalpy_)[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    const Scalar* enthalpyArray(unsigned phaseIdx) const
+    { return (*enthalpy_)[canonicalToStoragePhaseIndex(phaseIdx)].data(); }
+
+    Scalar* totalSaturationArray()
+    { return totalSaturation_.data(); }
+
+    const Scalar* totalSaturationArray() const
+    { return totalSaturation_.data(); }
+
+    Scalar* temperatureArray()
+    { return temperature_->data(); }
+
+    const Scalar* temperatureArray() const
+    { return temperature_->data(); }
+
+    Scalar* RsArray()
+    { return Rs_->data(); }
+
+    const Scalar* RsArray() const
+    { return Rs_->data(); }
+
+    Scalar* RvArray()
+    { return Rv_->data(); }
+
+    const Scalar* RvArray() const
+    { return Rv_->data(); }
+
+    Scalar* saltConcentrationArray()
+    { return saltConcentration_->data(); }
+
+    const Scalar* saltConcentrationArray() const
+    { return saltConcentration_->data(); }
+
+    unsigned short* pvtRegionIndexArray()
+    { return pvtRegionIdx_.data(); }
+
+    const unsigned short* pvtRegionIndexArray() const
+    { return pvtRegionIdx_.data(); }
+
+    static unsigned storageToCanonicalPhaseIndex(unsigned storagePhaseIdx)
+    {
+        if (numStoragePhases == 3)
+            return storagePhaseIdx;
+
+        return FluidSystem::activeToCanonicalPhaseIdx(storagePhaseIdx);
+    }
+
+    static unsigned canonicalToStoragePhaseIndex(unsigned canonicalPhaseIdx)
+    {
+        if (numStoragePhases == 3)
+            return canonicalPhaseIdx;
+
+        return FluidSystem::canonicalToActivePhaseIdx(canonicalPhaseIdx);
+    }
+
+private:
+    std::size_t numCells_;
+    ConditionalStorage<enableTemperature || enableEnergy, std::vector<Scalar> > temperature_;
+    ConditionalStorage<enableEnergy, PhaseArrays> enthalpy_;
+    std::vector<Scalar> totalSaturation_;
+    PhaseArrays pressure_;
+    PhaseArrays pc_;
+    PhaseArrays saturation_;
+    PhaseArrays invB_;
+    PhaseArrays density_;
+    ConditionalStorage<enableDissolution, std::vector<Scalar> > Rs_;
+    ConditionalStorage<enableDissolution, std::vector<Scalar> > Rv_;
+    ConditionalStorage<enableBrine, std::vector<Scalar> > saltConcentration_;
+    std::vector<unsigned short> pvtRegionIdx_;
+};
+
+} // namespace Opm
+
+#endif
@@ -40,6 +40,9 @@
 #include <opm/material/common/Valgrind.hpp>
 #include <opm/material/common/HasMemberGeneratorMacros.hpp>
 #include <opm/material/common/Exceptions.hpp>
+#include <opm/material/common/BinarySerializer.hpp>
+#include <opm/material/common/SharedTables.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -47,7 +50,11 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 #endif
 
+#include <cstdint>
+#include <istream>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 #include <array>
 
@@ -252,7 +259,14 @@ public:
         // brine
         if (eclState.runspec().co2Storage()) {
             for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
-                molarMass_[regionIdx][oilCompIdx] = BrineCo2Pvt<Scalar>::Brine::molarMass();
+                if (oilPvt_ && oilPvt_->approach() == OilPvtApproach::BrineCo2Pvt) {
+                    // the brine PVT may use fewer regions than the fluid system
+                    const auto& brinePvt = oilPvt_->template getRealPvt<OilPvtApproach::BrineCo2Pvt>();
+                    unsigned pvtRegionIdx = regionIdx < brinePvt.numRegions() ? regionIdx : 0;
+                    molarMass_[regionIdx][oilCompIdx] = brinePvt.brineMolarMass(pvtRegionIdx);
+                }
+                else
+                    molarMass_[regionIdx][oilCompIdx] = BrineCo2Pvt<Scalar>::Brine::molarMass();
                 molarMass_[regionIdx][gasCompIdx] = BrineCo2Pvt<Scalar>::CO2::molarMass();
             }
         }
@@ -283,6 +297,148 @@ public:
     }
 #endif // HAVE_ECL_INPUT
 
+    /*!
+     * \brief Write the state of the initialized fluid system to a binary stream.
+     *
+     * The snapshot contains the PVT relations of all phases, the reference densities,
+     * the molar masses and the diffusion coefficients, i.e., readSnapshot() restores
+     * the fluid system without having to process the deck again. Snapshots are tied
+     * to the format version, the scalar type and the index traits of the fluid system
+     * as well as to the byte order of the host.
+     */
+    static void writeSnapshot(std::ostream& os)
+    {
+        if (!isInitialized_)
+            throw std::logic_error("Only initialized fluid systems can be written to a snapshot");
+
+        BinarySerializer payload;
+        serializeOp(payload);
+
+        BinarySerializer header;
+        SnapshotHeader_ hdr = snapshotHeader_();
+        hdr.payloadSize = payload.buffer().size();
+        header(hdr);
+
+        os.write(header.buffer().data(), static_cast<std::streamsize>(header.buffer().size()));
+        os.write(payload.buffer().data(), static_cast<std::streamsize>(payload.buffer().size()));
+        if (!os)
+            throw std::runtime_error("Could not write the snapshot of the fluid system");
+    }
+
+    /*!
+     * \brief Initialize the fluid system from a snapshot created by writeSnapshot().
+     *
+     * This replaces any previous initialization of the fluid system.
+     */
+    static void readSnapshot(std::istream& is)
+    {
+        BinarySerializer writtenHeader;
+        SnapshotHeader_ hdr = snapshotHeader_();
+        writtenHeader(hdr);
+
+        std::vector<char> headerBuffer(writtenHeader.buffer().size());
+        is.read(headerBuffer.data(), static_cast<std::streamsize>(headerBuffer.size()));
+        if (!is)
+            throw std::runtime_error("Could not read the header of the fluid system snapshot");
+
+        BinarySerializer header(std::move(headerBuffer));
+        header(hdr);
+        const SnapshotHeader_ expected = snapshotHeader_();
+        if (hdr.magic != expected.magic)
+            throw std::runtime_error("The stream does not contain a snapshot of a black-oil fluid system");
+        if (hdr.version != expected.version)
+            throw std::runtime_error("Unsupported version "+std::to_string(hdr.version)
+                                     +" of the fluid system snapshot (expected "
+                                     +std::to_string(expected.version)+")");
+        if (hdr.scalarSize != expected.scalarSize || hdr.indices != expected.indices)
+            throw std::runtime_error("The fluid system snapshot was written for a different "
+                                     "scalar type or index traits");
+
+        std::vector<char> payloadBuffer(hdr.payloadSize);
+        is.read(payloadBuffer.data(), static_cast<std::streamsize>(payloadBuffer.size()));
+        if (!is)
+            throw std::runtime_error("The fluid system snapshot is truncated");
+
+        isInitialized_ = false;
+        BinarySerializer payload(std::move(payloadBuffer));
+        serializeOp(payload);
+        if (payload.remaining() != 0)
+            throw std::runtime_error("The fluid system snapshot contains unexpected data");
+        isInitialized_ = true;
+    }
+
+    /*!
+     * \brief Initialize the fluid system once per node and share its tables.
+     *
+     * All processes of a node call this method with the same segment name. Only the
+     * first one calls init(), which must fully initialize the fluid system, e.g. via
+     * initFromState() or initBegin() ... initEnd(). The tables of the PVT relations are
+     * then placed in shared memory (see SharedTables) and all processes initialize the
+     * fluid system from there, so they do not need to process the deck at all and the
+     * tables are only stored once per node. The shared memory is released when the
+     * fluid system is initialized from shared tables again or the process exits.
+     *
+     * \param segmentName The name of the shared memory segment.
+     * \param init Initializes the fluid system. Only called by one process.
+     * \param layoutKey Identifies the input of init(), e.g. a hash of the deck. It is
+     *                  combined with the format of the fluid system.
+     * \return true if the calling process called init().
+     */
+    template <class InitFn>
+    static bool initShared(const std::string& segmentName,
+                           InitFn init,
+                           std::uint64_t layoutKey = 0)
+    {
+        SnapshotHeader_ hdr = snapshotHeader_();
+        layoutKey = SharedMemoryRegion::hash(hdr.magic, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(hdr.version, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(hdr.scalarSize, layoutKey);
+        layoutKey = SharedMemoryRegion::hash(hdr.indices, layoutKey);
+
+        auto tables =
+            std::make_shared<SharedTables>(segmentName,
+                                           layoutKey,
+                                           [&init]() {
+                                               init();
+                                               if (!isInitialized_)
+                                                   throw std::logic_error("The fluid system was not initialized");
+                                           },
+                                           [](BinarySerializer& serializer) {
+                                               if (serializer.isReading())
+                                                   isInitialized_ = false;
+                                               serializeOp(serializer);
+                                           });
+        isInitialized_ = true;
+
+        // the previous tables can only be released once the fluid system refers to the new ones
+        sharedTables_ = tables;
+        return tables->isOwner();
+    }
+
+    /*!
+     * \brief Write the state of the fluid system to or read it from a serializer.
+     */
+    template <class Serializer>
+    static void serializeOp(Serializer& serializer)
+    {
+        serializer(numActivePhases_);
+        serializer(phaseIsActive_);
+        serializer(surfaceTemperature);
+        serializer(surfacePressure);
+        serializer(reservoirTemperature_);
+        serializer(enableDissolvedGas_);
+        serializer(enableVaporizedOil_);
+        serializer(enableDiffusion_);
+        serializePvt_(serializer, gasPvt_);
+        serializePvt_(serializer, oilPvt_);
+        serializePvt_(serializer, waterPvt_);
+        serializer(referenceDensity_);
+        serializer(molarMass_);
+        serializer(diffusionCoefficients_);
+        serializer(activeToCanonicalPhaseIdx_);
+        serializer(canonicalToActivePhaseIdx_);
+    }
+
     /*!
      * \brief Begin the initialization of the black oil fluid system.
      *
@@ -376,6 +532,22 @@ public:
     }
 
 
+    /*!
+     * \brief Replace the PVT tables of the oil and gas phases by monotonicity preserving
+     *        splines through a subset of their sampling points.
+     *
+     * This is optional and must be called after initEnd(). The splines deviate from
+     * none of the original sampling points by more than the tolerance times the largest
+     * absolute value of the respective table, see Tabulated1DFunction::compress().
+     */
+    static void compressTables(Scalar tolerance)
+    {
+        if (oilPvt_)
+            oilPvt_->compressTables(tolerance);
+        if (gasPvt_)
+            gasPvt_->compressTables(tolerance);
+    }
+
     /*!
      * \brief Finish initializing the black oil fluid system.
      */
@@ -1373,6 +1545,49 @@ private:
         referenceDensity_.resize(numRegions);
     }
 
+    struct SnapshotHeader_
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t scalarSize;
+        std::array<std::uint32_t, 6> indices;
+        std::uint64_t payloadSize;
+
+        template <class Serializer>
+        void serializeOp(Serializer& serializer)
+        {
+            serializer(magic);
+            serializer(version);
+            serializer(scalarSize);
+            serializer(indices);
+            serializer(payloadSize);
+        }
+    };
+
+    // increment the version whenever the layout of the serialized data changes
+    static SnapshotHeader_ snapshotHeader_()
+    {
+        SnapshotHeader_ hdr;
+        hdr.magic = 0x534f424f; // "OBOS"
+        hdr.version = 2;
+        hdr.scalarSize = sizeof(Scalar);
+        hdr.indices = {{waterPhaseIdx, oilPhaseIdx, gasPhaseIdx,
+                        waterCompIdx, oilCompIdx, gasCompIdx}};
+        hdr.payloadSize = 0;
+        return hdr;
+    }
+
+    template <class Serializer, class Pvt>
+    static void serializePvt_(Serializer& serializer, std::shared_ptr<Pvt>& pvt)
+    {
+        bool hasPvt = static_cast<bool>(pvt);
+        serializer(hasPvt);
+        if (serializer.isReading())
+            pvt = hasPvt ? std::make_shared<Pvt>() : nullptr;
+        if (pvt)
+            serializer(*pvt);
+    }
+
     static Scalar reservoirTemperature_;
 
     static std::shared_ptr<GasPvt> gasPvt_;
@@ -1394,6 +1609,8 @@ private:
     static std::array<short, numPhases> canonicalToActivePhaseIdx_;
 
     static bool isInitialized_;
+
+    static std::shared_ptr<SharedTables> sharedTables_;
 };
 
 template <class Scalar, class IndexTraits>
@@ -1456,6 +1673,14 @@ BlackOilFluidSystem<Scalar, IndexTraits>::diffusionCoefficients_;
 template <class Scalar, class IndexTraits>
 bool BlackOilFluidSystem<Scalar, IndexTraits>::isInitialized_ = false;
 
+template <class Scalar, class IndexTraits>
+std::shared_ptr<SharedTables>
+BlackOilFluidSystem<Scalar, IndexTraits>::sharedTables_;
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class BlackOilFluidSystem<double, BlackOilDefaultIndexTraits>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -175,6 +175,26 @@ public:
         };
     }
 
+    /*!
+     * \brief The attractive parameter \f$a_{ij}\f$ of the mixing rule of a phase for a
+     *        pair of components.
+     *
+     * \param phaseIdx The fluid phase of interest
+     * \param compIIdx The first component of interest
+     * \param compJIdx The second component of interest
+     */
+    Scalar aInteraction(unsigned phaseIdx, unsigned compIIdx, unsigned compJIdx) const
+    {
+        switch (phaseIdx)
+        {
+        case oilPhaseIdx: return oilPhaseParams_.aInteraction(compIIdx, compJIdx);
+        case gasPhaseIdx: return gasPhaseParams_.aInteraction(compIIdx, compJIdx);
+        default:
+            throw std::logic_error("The a() parameter is only defined for "
+                                   "oil and gas phases");
+        };
+    }
+
     /*!
      * \brief Returns the molar volume of a phase [m^3/mol]
      *
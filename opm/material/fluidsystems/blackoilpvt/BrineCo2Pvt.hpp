@@ -37,7 +37,8 @@
 #include <opm/material/components/TabulatedComponent.hpp>
 #include <opm/material/binarycoefficients/H2O_CO2.hpp>
 #include <opm/material/binarycoefficients/Brine_CO2.hpp>
-#include <opm/material/components/co2tables.inc>
+#include <opm/material/components/CO2Tables.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 
 #if HAVE_ECL_INPUT
@@ -52,6 +53,10 @@ namespace Opm {
 /*!
  * \brief This class represents the Pressure-Volume-Temperature relations of the liquid phase
  * for a CO2-Brine system
+ *
+ * Each PVT region has its own salinity. The properties of the brine are computed from
+ * precomputed per-region terms, i.e., the global salinity of the brine component is
+ * neither used nor modified.
  */
 template <class Scalar>
 class BrineCo2Pvt
@@ -71,6 +76,7 @@ public:
     typedef SimpleHuDuanH2O<Scalar> H2O;
     typedef ::Opm::Brine<Scalar, H2O> Brine;
     typedef ::Opm::CO2<Scalar, CO2Tables> CO2;
+    typedef typename Brine::SalinityTerms SalinityTerms;
 
     typedef Tabulated1DFunction<Scalar> TabulatedOneDFunction;
 
@@ -85,6 +91,7 @@ public:
           co2ReferenceDensity_(co2ReferenceDensity),
           salinity_(salinity)
     {
+        updateSalinityTerms_();
     }
 #if HAVE_ECL_INPUT
     /*!
@@ -111,13 +118,12 @@ public:
         const Scalar molality = eclState.getTableManager().salinity(); // mol/kg
         const Scalar MmNaCl = 58e-3; // molar mass of NaCl [kg/mol]
         // convert to mass fraction
-        Brine::salinity = 1 / ( 1 + 1 / (molality*MmNaCl)); //
-        salinity_[regionIdx] = Brine::salinity;
+        setSalinity(regionIdx, 1 / ( 1 + 1 / (molality*MmNaCl)));
         // set the surface conditions using the STCOND keyword
         Scalar T_ref = eclState.getTableManager().stCond().temperature;
         Scalar P_ref = eclState.getTableManager().stCond().pressure;
 
-        brineReferenceDensity_[regionIdx] = Brine::liquidDensity(T_ref, P_ref);
+        brineReferenceDensity_[regionIdx] = Brine::liquidDensity(T_ref, P_ref, salinityTerms_[regionIdx]);
         co2ReferenceDensity_[regionIdx] = CO2::gasDensity(T_ref, P_ref);
     }
 #endif
@@ -127,6 +133,16 @@ public:
         brineReferenceDensity_.resize(numRegions);
         co2ReferenceDensity_.resize(numRegions);
         salinity_.resize(numRegions);
+        updateSalinityTerms_();
+    }
+
+    /*!
+     * \brief Set the mass fraction of salt in the brine of a PVT region.
+     */
+    void setSalinity(unsigned regionIdx, Scalar salinity)
+    {
+        salinity_[regionIdx] = salinity;
+        salinityTerms_[regionIdx].setSalinity(salinity);
     }
 
 
@@ -167,10 +183,10 @@ public:
                         const Evaluation& Rs) const
     {
 
-        const Evaluation xlCO2 = convertXoGToxoG_(convertRsToXoG_(Rs,regionIdx));
+        const Evaluation xlCO2 = convertXoGToxoG_(convertRsToXoG_(Rs,regionIdx), regionIdx);
         return (liquidEnthalpyBrineCO2_(temperature,
                                        pressure,
-                                       salinity_[regionIdx],
+                                       salinityTerms_[regionIdx],
                                        xlCO2)
         - pressure / density_(regionIdx, temperature, pressure, Rs));
     }
@@ -192,11 +208,11 @@ public:
      * \brief Returns the dynamic viscosity [Pa s] of oil saturated gas at given pressure.
      */
     template <class Evaluation>
-    Evaluation saturatedViscosity(unsigned /*regionIdx*/,
+    Evaluation saturatedViscosity(unsigned regionIdx,
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
     {
-        return Brine::liquidViscosity(temperature, pressure);
+        return Brine::liquidViscosity(temperature, pressure, salinityTerms_[regionIdx]);
     }
 
     /*!
@@ -271,14 +287,45 @@ public:
     const Scalar salinity(unsigned regionIdx) const
     { return salinity_[regionIdx]; }
 
+    /*!
+     * \brief Returns the molar mass [kg/mol] of the brine of a PVT region.
+     */
+    Scalar brineMolarMass(unsigned regionIdx) const
+    { return salinityTerms_[regionIdx].molarMass(); }
+
     bool operator==(const BrineCo2Pvt<Scalar>& data) const
     {
         return co2ReferenceDensity_ == data.co2ReferenceDensity_ &&
-                brineReferenceDensity_ == data.brineReferenceDensity_;
+                brineReferenceDensity_ == data.brineReferenceDensity_ &&
+                salinity_ == data.salinity_;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(brineReferenceDensity_);
+        serializer(co2ReferenceDensity_);
+        serializer(salinity_);
+
+        if (serializer.isReading())
+            updateSalinityTerms_();
+    }
+
+    /*!
+     * \brief The diffusion coefficient of CO2 in the brine of the first PVT region.
+     */
     template <class Evaluation>
     Evaluation diffusionCoefficient(const Evaluation& temperature,
+                                    const Evaluation& pressure,
+                                    unsigned compIdx) const
+    { return diffusionCoefficient(/*regionIdx=*/0, temperature, pressure, compIdx); }
+
+    /*!
+     * \brief The diffusion coefficient of CO2 in the brine of a given PVT region.
+     */
+    template <class Evaluation>
+    Evaluation diffusionCoefficient(unsigned regionIdx,
+                                    const Evaluation& temperature,
                                     const Evaluation& pressure,
                                     unsigned /*compIdx*/) const
     {
@@ -287,7 +334,7 @@ public:
 
         //Diffusion coefficient of CO2 in the brine phase modified following (Ratcliff and Holdcroft,1963 and Al-Rawajfeh, 2004)
         const Evaluation& mu_H20 = H2O::liquidViscosity(temperature, pressure); // Water viscosity
-        const Evaluation& mu_Brine = Brine::liquidViscosity(temperature, pressure); // Brine viscosity
+        const Evaluation& mu_Brine = Brine::liquidViscosity(temperature, pressure, salinityTerms_[regionIdx]); // Brine viscosity
         const Evaluation log_D_Brine = log_D_H20 - 0.87*log10(mu_Brine / mu_H20);
 
         return pow(Evaluation(10), log_D_Brine) * 1e-4; // convert from cm2/s to m2/s
@@ -297,6 +344,14 @@ private:
     std::vector<Scalar> brineReferenceDensity_;
     std::vector<Scalar> co2ReferenceDensity_;
     std::vector<Scalar> salinity_;
+    std::vector<SalinityTerms> salinityTerms_;
+
+    void updateSalinityTerms_()
+    {
+        salinityTerms_.clear();
+        for (Scalar S : salinity_)
+            salinityTerms_.emplace_back(S);
+    }
 
     template <class LhsEval>
     LhsEval density_(unsigned regionIdx,
@@ -304,8 +359,9 @@ private:
                      const LhsEval& pressure,
                      const LhsEval& Rs) const
     {
-        LhsEval xlCO2 = convertXoGToxoG_(convertRsToXoG_(Rs,regionIdx));
-        LhsEval result = liquidDensity_(temperature,
+        LhsEval xlCO2 = convertXoGToxoG_(convertRsToXoG_(Rs,regionIdx), regionIdx);
+        LhsEval result = liquidDensity_(regionIdx,
+                                        temperature,
                                         pressure,
                                         xlCO2);
 
@@ -315,7 +371,8 @@ private:
 
 
     template <class LhsEval>
-    LhsEval liquidDensity_(const LhsEval& T,
+    LhsEval liquidDensity_(unsigned regionIdx,
+                           const LhsEval& T,
                            const LhsEval& pl,
                            const LhsEval& xlCO2) const
     {
@@ -336,7 +393,7 @@ private:
             throw NumericalIssue(oss.str());
         }
 
-        const LhsEval& rho_brine = Brine::liquidDensity(T, pl);
+        const LhsEval& rho_brine = Brine::liquidDensity(T, pl, salinityTerms_[regionIdx]);
         const LhsEval& rho_pure = H2O::liquidDensity(T, pl);
         const LhsEval& rho_lCO2 = liquidDensityWaterCO2_(T, pl, xlCO2);
         const LhsEval& contribCO2 = rho_lCO2 - rho_pure;
@@ -386,10 +443,10 @@ private:
      * \brief Convert a gas mass fraction in the oil phase the corresponding mole fraction.
      */
     template <class LhsEval>
-    LhsEval convertXoGToxoG_(const LhsEval& XoG) const
+    LhsEval convertXoGToxoG_(const LhsEval& XoG, unsigned regionIdx) const
     {
         Scalar M_CO2 = CO2::molarMass();
-        Scalar M_Brine = Brine::molarMass();
+        Scalar M_Brine = Brine::molarMass(salinityTerms_[regionIdx]);
         return XoG*M_Brine / (M_CO2*(1 - XoG) + XoG*M_Brine);
     }
 
@@ -398,10 +455,10 @@ private:
      * \brief Convert a gas mole fraction in the oil phase the corresponding mass fraction.
      */
     template <class LhsEval>
-    LhsEval convertxoGToXoG(const LhsEval& xoG) const
+    LhsEval convertxoGToXoG(const LhsEval& xoG, unsigned regionIdx) const
     {
         Scalar M_CO2 = CO2::molarMass();
-        Scalar M_Brine = Brine::molarMass();
+        Scalar M_Brine = Brine::molarMass(salinityTerms_[regionIdx]);
 
         return xoG*M_CO2 / (xoG*(M_CO2 - M_Brine) + M_Brine);
     }
@@ -440,13 +497,13 @@ private:
         // normalize the phase compositions
         xlCO2 = max(0.0, min(1.0, xlCO2));
 
-        return convertXoGToRs(convertxoGToXoG(xlCO2), regionIdx);
+        return convertXoGToRs(convertxoGToXoG(xlCO2, regionIdx), regionIdx);
     }
 
     template <class LhsEval>
     static LhsEval liquidEnthalpyBrineCO2_(const LhsEval& T,
                                            const LhsEval& p,
-                                           Scalar S, // salinity
+                                           const SalinityTerms& salinityTerms,
                                            const LhsEval& X_CO2_w)
     {
         /* X_CO2_w : mass fraction of CO2 in brine */
@@ -454,12 +511,12 @@ private:
         /* same function as enthalpy_brine, only extended by CO2 content */
 
         /*Numerical coefficents from PALLISER*/
-        static Scalar f[] = {
+        static const Scalar f[] = {
             2.63500E-1, 7.48368E-6, 1.44611E-6, -3.80860E-10
         };
 
         /*Numerical coefficents from MICHAELIDES for the enthalpy of brine*/
-        static Scalar a[4][3] = {
+        static const Scalar a[4][3] = {
             { 9633.6, -4080.0, +286.49 },
             { +166.58, +68.577, -4.6856 },
             { -0.90963, -0.36524, +0.249667E-1 },
@@ -474,10 +531,14 @@ private:
         theta = T - 273.15;
 
         // Regularization
+        Scalar S = salinityTerms.salinity();
+        Scalar m = salinityTerms.molality();
         Scalar scalarTheta = scalarValue(theta);
         Scalar S_lSAT = f[0] + scalarTheta*(f[1] + scalarTheta*(f[2] + scalarTheta*f[3]));
-        if (S > S_lSAT)
+        if (S > S_lSAT) {
             S = S_lSAT;
+            m = 1E3/58.44 * S/(1-S);
+        }
 
         hw = H2O::liquidEnthalpy(T, p) /1E3; /* kJ/kg */
 
@@ -485,16 +546,11 @@ private:
         /*U=*/h_NaCl = (3.6710E4*T + 0.5*(6.2770E1)*T*T - ((6.6670E-2)/3)*T*T*T
                         +((2.8000E-5)/4)*(T*T*T*T))/(58.44E3)- 2.045698e+02; /* kJ/kg */
 
-        Scalar m = 1E3/58.44 * S/(1-S);
-        int i = 0;
-        int j = 0;
-        d_h = 0;
-
-        for (i = 0; i<=3; i++) {
-            for (j=0; j<=2; j++) {
-                d_h = d_h + a[i][j] * pow(theta, static_cast<Scalar>(i)) * std::pow(m, j);
-            }
-        }
+        // the coefficients of the polynomial in theta only depend on the salinity
+        Scalar c[4];
+        for (int i = 0; i<=3; i++)
+            c[i] = a[i][0] + m*(a[i][1] + m*a[i][2]);
+        d_h = c[0] + theta*(c[1] + theta*(c[2] + theta*c[3]));
         /* heat of dissolution for halite according to Michaelides 1971 */
         delta_h = (4.184/(1E3 + (58.44 * m)))*d_h;
 
@@ -515,6 +571,10 @@ private:
 
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class BrineCo2Pvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
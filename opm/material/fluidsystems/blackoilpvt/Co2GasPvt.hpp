@@ -34,7 +34,8 @@
 #include <opm/material/components/SimpleHuDuanH2O.hpp>
 #include <opm/material/common/UniformTabulated2DFunction.hpp>
 #include <opm/material/binarycoefficients/Brine_CO2.hpp>
-#include <opm/material/components/co2tables.inc>
+#include <opm/material/components/CO2Tables.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -227,10 +228,20 @@ public:
         return gasReferenceDensity_ == data.gasReferenceDensity_;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(gasReferenceDensity_);
+    }
+
 private:
     std::vector<Scalar> gasReferenceDensity_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class Co2GasPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
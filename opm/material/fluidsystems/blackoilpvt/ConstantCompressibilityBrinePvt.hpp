@@ -28,6 +28,7 @@
 #define OPM_CONSTANT_COMPRESSIBILITY_BRINE_PVT_HPP
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -222,7 +223,7 @@ public:
 
     bool operator==(const ConstantCompressibilityBrinePvt<Scalar>& data) const
     {
-        return this->waterReferenceDensity() == data.waterReferenceDensity() &&
+        return this->waterReferenceDensity_ == data.waterReferenceDensity_ &&
                this->referencePressure() == data.referencePressure() &&
                this->formationVolumeTables() == data.formationVolumeTables() &&
                this->compressibilityTables() == data.compressibilityTables() &&
@@ -230,6 +231,17 @@ public:
                this->viscosibilityTables() == data.viscosibilityTables();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(waterReferenceDensity_);
+        serializer(referencePressure_);
+        serializer(formationVolumeTables_);
+        serializer(compressibilityTables_);
+        serializer(viscosityTables_);
+        serializer(viscosibilityTables_);
+    }
+
 private:
     std::vector<Scalar> waterReferenceDensity_;
     std::vector<Scalar> referencePressure_;
@@ -240,6 +252,10 @@ private:
 
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class ConstantCompressibilityBrinePvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
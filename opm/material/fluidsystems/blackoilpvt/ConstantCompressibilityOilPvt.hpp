@@ -31,6 +31,7 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -297,14 +298,25 @@ public:
 
     bool operator==(const ConstantCompressibilityOilPvt<Scalar>& data) const
     {
-        return this->oilReferenceDensity() == data.oilReferenceDensity() &&
-               this->oilReferencePressure() == data.oilReferencePressure() &&
+        return this->oilReferenceDensity_ == data.oilReferenceDensity_ &&
+               this->oilReferencePressure_ == data.oilReferencePressure_ &&
                this->oilReferenceFormationVolumeFactor() == data.oilReferenceFormationVolumeFactor() &&
                this->oilCompressibility() == data.oilCompressibility() &&
                this->oilViscosity() == data.oilViscosity() &&
                this->oilViscosibility() == data.oilViscosibility();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(oilReferenceDensity_);
+        serializer(oilReferencePressure_);
+        serializer(oilReferenceFormationVolumeFactor_);
+        serializer(oilCompressibility_);
+        serializer(oilViscosity_);
+        serializer(oilViscosibility_);
+    }
+
 private:
     std::vector<Scalar> oilReferenceDensity_;
     std::vector<Scalar> oilReferencePressure_;
@@ -314,6 +326,10 @@ private:
     std::vector<Scalar> oilViscosibility_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class ConstantCompressibilityOilPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
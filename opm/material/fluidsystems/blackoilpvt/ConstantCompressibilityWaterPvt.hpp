@@ -28,6 +28,7 @@
 #define OPM_CONSTANT_COMPRESSIBILITY_WATER_PVT_HPP
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -230,7 +231,7 @@ public:
 
     bool operator==(const ConstantCompressibilityWaterPvt<Scalar>& data) const
     {
-        return this->waterReferenceDensity() == data.waterReferenceDensity() &&
+        return this->waterReferenceDensity_ == data.waterReferenceDensity_ &&
                this->waterReferencePressure() == data.waterReferencePressure() &&
                this->waterReferenceFormationVolumeFactor() == data.waterReferenceFormationVolumeFactor() &&
                this->waterCompressibility() == data.waterCompressibility() &&
@@ -238,6 +239,17 @@ public:
                this->waterViscosibility() == data.waterViscosibility();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(waterReferenceDensity_);
+        serializer(waterReferencePressure_);
+        serializer(waterReferenceFormationVolumeFactor_);
+        serializer(waterCompressibility_);
+        serializer(waterViscosity_);
+        serializer(waterViscosibility_);
+    }
+
 private:
     std::vector<Scalar> waterReferenceDensity_;
     std::vector<Scalar> waterReferencePressure_;
@@ -247,6 +259,10 @@ private:
     std::vector<Scalar> waterViscosibility_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class ConstantCompressibilityWaterPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -30,6 +30,7 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -171,6 +172,22 @@ public:
         }
     }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd().
+     */
+    void compressTables(Scalar tolerance)
+    {
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            inverseOilB_[regionIdx].compress(tolerance);
+            oilMu_[regionIdx].compress(tolerance);
+            inverseOilBMu_[regionIdx].compress(tolerance);
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -300,12 +317,21 @@ public:
 
     bool operator==(const DeadOilPvt<Scalar>& data) const
     {
-        return this->oilReferenceDensity() == data.oilReferenceDensity() &&
+        return this->oilReferenceDensity_ == data.oilReferenceDensity_ &&
                this->inverseOilB() == data.inverseOilB() &&
                this->oilMu() == data.oilMu() &&
                this->inverseOilBMu() == data.inverseOilBMu();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(oilReferenceDensity_);
+        serializer(inverseOilB_);
+        serializer(oilMu_);
+        serializer(inverseOilBMu_);
+    }
+
 private:
     std::vector<Scalar> oilReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseOilB_;
@@ -313,6 +339,10 @@ private:
     std::vector<TabulatedOneDFunction> inverseOilBMu_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class DeadOilPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -30,6 +30,7 @@
 #include <opm/material/Constants.hpp>
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -195,6 +196,22 @@ public:
         }
     }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd().
+     */
+    void compressTables(Scalar tolerance)
+    {
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            inverseGasB_[regionIdx].compress(tolerance);
+            gasMu_[regionIdx].compress(tolerance);
+            inverseGasBMu_[regionIdx].compress(tolerance);
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -316,6 +333,15 @@ public:
                inverseGasBMu_ == data.inverseGasBMu_;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(gasReferenceDensity_);
+        serializer(inverseGasB_);
+        serializer(gasMu_);
+        serializer(inverseGasBMu_);
+    }
+
 private:
     std::vector<Scalar> gasReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseGasB_;
@@ -323,6 +349,10 @@ private:
     std::vector<TabulatedOneDFunction> inverseGasBMu_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class DryGasPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -32,6 +32,15 @@
 #include "GasPvtThermal.hpp"
 #include "Co2GasPvt.hpp"
 
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+#include <opm/material/densead/Evaluation.hpp>
+#endif
+
+#include <utility>
+
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #endif
@@ -177,6 +186,31 @@ public:
     void initEnd()
     { OPM_GAS_PVT_MULTIPLEXER_CALL(pvtImpl.initEnd()); }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd(). Approaches which are not based on tables are not
+     * affected.
+     */
+    void compressTables(Scalar tolerance)
+    {
+        switch (gasPvtApproach_) {
+        case GasPvtApproach::DryGasPvt:
+            getRealPvt<GasPvtApproach::DryGasPvt>().compressTables(tolerance);
+            break;
+        case GasPvtApproach::WetGasPvt:
+            getRealPvt<GasPvtApproach::WetGasPvt>().compressTables(tolerance);
+            break;
+        case GasPvtApproach::ThermalGasPvt:
+            getRealPvt<GasPvtApproach::ThermalGasPvt>().compressTables(tolerance);
+            break;
+        default:
+            break;
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -197,7 +231,11 @@ public:
                         const Evaluation& temperature,
                         const Evaluation& pressure,
                         const Evaluation& Rv) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure, Rv)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "internalEnergy", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure, Rv));
+        return 0;
+    }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
@@ -207,7 +245,11 @@ public:
                          const Evaluation& temperature,
                          const Evaluation& pressure,
                          const Evaluation& Rv) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.viscosity(regionIdx, temperature, pressure, Rv)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "viscosity", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.viscosity(regionIdx, temperature, pressure, Rv));
+        return 0;
+    }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of oil saturated gas given a set of parameters.
@@ -216,7 +258,11 @@ public:
     Evaluation saturatedViscosity(unsigned regionIdx,
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedViscosity(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "saturatedViscosity", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedViscosity(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the formation volume factor [-] of the fluid phase.
@@ -226,7 +272,11 @@ public:
                                             const Evaluation& temperature,
                                             const Evaluation& pressure,
                                             const Evaluation& Rv) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rv)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "inverseFormationVolumeFactor", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rv));
+        return 0;
+    }
 
     /*!
      * \brief Returns the formation volume factor [-] of oil saturated gas given a set of parameters.
@@ -235,7 +285,11 @@ public:
     Evaluation saturatedInverseFormationVolumeFactor(unsigned regionIdx,
                                                      const Evaluation& temperature,
                                                      const Evaluation& pressure) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "saturatedInverseFormationVolumeFactor", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of oil saturated gas.
@@ -244,7 +298,11 @@ public:
     Evaluation saturatedOilVaporizationFactor(unsigned regionIdx,
                                               const Evaluation& temperature,
                                               const Evaluation& pressure) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedOilVaporizationFactor(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "saturatedOilVaporizationFactor", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedOilVaporizationFactor(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the oil vaporization factor \f$R_v\f$ [m^3/m^3] of oil saturated gas.
@@ -255,7 +313,11 @@ public:
                                               const Evaluation& pressure,
                                               const Evaluation& oilSaturation,
                                               const Evaluation& maxOilSaturation) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedOilVaporizationFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "saturatedOilVaporizationFactor", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedOilVaporizationFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation));
+        return 0;
+    }
 
     /*!
      * \brief Returns the saturation pressure of the gas phase [Pa]
@@ -267,7 +329,11 @@ public:
     Evaluation saturationPressure(unsigned regionIdx,
                                   const Evaluation& temperature,
                                   const Evaluation& Rv) const
-    { OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturationPressure(regionIdx, temperature, Rv)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("GasPvtMultiplexer", "saturationPressure", regionIdx);
+        OPM_GAS_PVT_MULTIPLEXER_CALL(return pvtImpl.saturationPressure(regionIdx, temperature, Rv));
+        return 0;
+    }
 
     /*!
      * \copydoc BaseFluidSystem::diffusionCoefficient
@@ -395,6 +461,30 @@ public:
         return *this;
     }
 
+    /*!
+     * \brief Write the parameters of the PVT relations to or read them from a serializer.
+     *
+     * When reading, the concrete PVT object is replaced by one for the stored approach.
+     */
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        GasPvtApproach appr = gasPvtApproach_;
+        serializer(appr);
+        if (serializer.isReading()) {
+            // let a temporary object dispose of the current PVT object
+            GasPvtMultiplexer<Scalar,enableThermal> tmp;
+            if (appr != GasPvtApproach::NoGasPvt)
+                tmp.setApproach(appr);
+            std::swap(gasPvtApproach_, tmp.gasPvtApproach_);
+            std::swap(realGasPvt_, tmp.realGasPvt_);
+        }
+
+        if (gasPvtApproach_ != GasPvtApproach::NoGasPvt) {
+            OPM_GAS_PVT_MULTIPLEXER_CALL(serializer(pvtImpl));
+        }
+    }
+
 private:
     GasPvtApproach gasPvtApproach_;
     void* realGasPvt_;
@@ -402,6 +492,35 @@ private:
 
 #undef OPM_GAS_PVT_MULTIPLEXER_CALL
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+// instantiate the evaluation functions for one of the value types which are compiled
+// into the opm-material library. PREFIX is either empty or 'extern'.
+#define OPM_GAS_PVT_MULTIPLEXER_INSTANTIATE(PREFIX, Eval)                                  \
+    PREFIX template Eval GasPvtMultiplexer<double>::internalEnergy(                        \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval GasPvtMultiplexer<double>::viscosity(                             \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval GasPvtMultiplexer<double>::saturatedViscosity(                    \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval GasPvtMultiplexer<double>::inverseFormationVolumeFactor(          \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval GasPvtMultiplexer<double>::saturatedInverseFormationVolumeFactor( \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval GasPvtMultiplexer<double>::saturatedOilVaporizationFactor(        \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval GasPvtMultiplexer<double>::saturatedOilVaporizationFactor(        \
+        unsigned, const Eval&, const Eval&, const Eval&, const Eval&) const;               \
+    PREFIX template Eval GasPvtMultiplexer<double>::saturationPressure(                    \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval GasPvtMultiplexer<double>::diffusionCoefficient(                  \
+        const Eval&, const Eval&, unsigned) const;
+
+#define OPM_GAS_PVT_MULTIPLEXER_EXTERN(Eval) OPM_GAS_PVT_MULTIPLEXER_INSTANTIATE(extern, Eval)
+extern template class GasPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_EVALUATION(OPM_GAS_PVT_MULTIPLEXER_EXTERN)
+#undef OPM_GAS_PVT_MULTIPLEXER_EXTERN
+#endif
+
 } // namespace Opm
 
 #endif
@@ -33,6 +33,7 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -201,6 +202,14 @@ public:
     void initEnd()
     { }
 
+    /*!
+     * \brief Compress the tables of the isothermal PVT relations.
+     *
+     * See GasPvtMultiplexer::compressTables().
+     */
+    void compressTables(Scalar tolerance)
+    { isothermalPvt_->compressTables(tolerance); }
+
     size_t numRegions() const
     { return gasvisctCurves_.size(); }
 
@@ -435,6 +444,28 @@ public:
         return *this;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        bool hasIsothermalPvt = isothermalPvt_ != nullptr;
+        serializer(hasIsothermalPvt);
+        if (serializer.isReading()) {
+            delete isothermalPvt_;
+            isothermalPvt_ = hasIsothermalPvt ? new IsothermalPvt : nullptr;
+        }
+        if (isothermalPvt_)
+            serializer(*isothermalPvt_);
+
+        serializer(gasvisctCurves_);
+        serializer(gasdentRefTemp_);
+        serializer(gasdentCT1_);
+        serializer(gasdentCT2_);
+        serializer(internalEnergyCurves_);
+        serializer(enableThermalDensity_);
+        serializer(enableThermalViscosity_);
+        serializer(enableInternalEnergy_);
+    }
+
 private:
     IsothermalPvt* isothermalPvt_;
 
@@ -454,6 +485,10 @@ private:
     bool enableInternalEnergy_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class GasPvtThermal<double>;
+#endif
+
 } // namespace Opm
 
 #endif
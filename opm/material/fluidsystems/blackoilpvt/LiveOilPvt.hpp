@@ -30,8 +30,10 @@
 #include <opm/material/Constants.hpp>
 #include <opm/material/common/OpmFinal.hpp>
 #include <opm/material/common/MathToolbox.hpp>
+#include <opm/material/common/Instrumentation.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -430,6 +432,27 @@ public:
         }
     }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd().
+     */
+    void compressTables(Scalar tolerance)
+    {
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            inverseOilBTable_[regionIdx].compress(tolerance);
+            oilMuTable_[regionIdx].compress(tolerance);
+            inverseOilBMuTable_[regionIdx].compress(tolerance);
+            saturatedOilMuTable_[regionIdx].compress(tolerance);
+            inverseSaturatedOilBTable_[regionIdx].compress(tolerance);
+            inverseSaturatedOilBMuTable_[regionIdx].compress(tolerance);
+            saturatedGasDissolutionFactorTable_[regionIdx].compress(tolerance);
+            saturationPressure_[regionIdx].compress(tolerance);
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -553,6 +576,8 @@ public:
                                   const Evaluation& temperature OPM_UNUSED,
                                   const Evaluation& Rs) const
     {
+        OPM_INSTRUMENT_SCOPE("LiveOilPvt", "saturationPressure", regionIdx);
+
         typedef MathToolbox<Evaluation> Toolbox;
 
         const auto& RsTable = saturatedGasDissolutionFactorTable_[regionIdx];
@@ -566,6 +591,8 @@ public:
         // iterations...
         bool onProbation = false;
         for (int i = 0; i < 20; ++i) {
+            OPM_INSTRUMENT_ITERATION();
+
             const Evaluation& f = RsTable.eval(pSat, /*extrapolate=*/true) - Rs;
             const Evaluation& fPrime = RsTable.evalDerivative(pSat, /*extrapolate=*/true);
 
@@ -645,8 +672,8 @@ public:
 
     bool operator==(const LiveOilPvt<Scalar>& data) const
     {
-        return this->gasReferenceDensity() == data.gasReferenceDensity() &&
-               this->oilReferenceDensity() == data.oilReferenceDensity() &&
+        return this->gasReferenceDensity_ == data.gasReferenceDensity_ &&
+               this->oilReferenceDensity_ == data.oilReferenceDensity_ &&
                this->inverseOilBTable() == data.inverseOilBTable() &&
                this->oilMuTable() == data.oilMuTable() &&
                this->inverseOilBMuTable() == data.inverseOilBMuTable() &&
@@ -657,6 +684,22 @@ public:
                this->vapPar2() == data.vapPar2();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(gasReferenceDensity_);
+        serializer(oilReferenceDensity_);
+        serializer(inverseOilBTable_);
+        serializer(oilMuTable_);
+        serializer(inverseOilBMuTable_);
+        serializer(saturatedOilMuTable_);
+        serializer(inverseSaturatedOilBTable_);
+        serializer(inverseSaturatedOilBMuTable_);
+        serializer(saturatedGasDissolutionFactorTable_);
+        serializer(saturationPressure_);
+        serializer(vapPar2_);
+    }
+
 private:
     void updateSaturationPressure_(unsigned regionIdx)
     {
@@ -702,6 +745,10 @@ private:
     Scalar vapPar2_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class LiveOilPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -33,6 +33,15 @@
 #include "OilPvtThermal.hpp"
 #include "BrineCo2Pvt.hpp"
 
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+#include <opm/material/densead/Evaluation.hpp>
+#endif
+
+#include <utility>
+
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
@@ -171,6 +180,31 @@ public:
     void initEnd()
     { OPM_OIL_PVT_MULTIPLEXER_CALL(pvtImpl.initEnd()); }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd(). Approaches which are not based on tables are not
+     * affected.
+     */
+    void compressTables(Scalar tolerance)
+    {
+        switch (approach_) {
+        case OilPvtApproach::LiveOilPvt:
+            getRealPvt<OilPvtApproach::LiveOilPvt>().compressTables(tolerance);
+            break;
+        case OilPvtApproach::DeadOilPvt:
+            getRealPvt<OilPvtApproach::DeadOilPvt>().compressTables(tolerance);
+            break;
+        case OilPvtApproach::ThermalOilPvt:
+            getRealPvt<OilPvtApproach::ThermalOilPvt>().compressTables(tolerance);
+            break;
+        default:
+            break;
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -191,7 +225,11 @@ public:
                         const Evaluation& temperature,
                         const Evaluation& pressure,
                         const Evaluation& Rs) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure, Rs)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "internalEnergy", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure, Rs));
+        return 0;
+    }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
@@ -201,7 +239,11 @@ public:
                          const Evaluation& temperature,
                          const Evaluation& pressure,
                          const Evaluation& Rs) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.viscosity(regionIdx, temperature, pressure, Rs)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "viscosity", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.viscosity(regionIdx, temperature, pressure, Rs));
+        return 0;
+    }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
@@ -210,7 +252,11 @@ public:
     Evaluation saturatedViscosity(unsigned regionIdx,
                                   const Evaluation& temperature,
                                   const Evaluation& pressure) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedViscosity(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "saturatedViscosity", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedViscosity(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the formation volume factor [-] of the fluid phase.
@@ -220,7 +266,11 @@ public:
                                             const Evaluation& temperature,
                                             const Evaluation& pressure,
                                             const Evaluation& Rs) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rs)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "inverseFormationVolumeFactor", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rs));
+        return 0;
+    }
 
     /*!
      * \brief Returns the formation volume factor [-] of the fluid phase.
@@ -229,7 +279,11 @@ public:
     Evaluation saturatedInverseFormationVolumeFactor(unsigned regionIdx,
                                                      const Evaluation& temperature,
                                                      const Evaluation& pressure) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "saturatedInverseFormationVolumeFactor", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedInverseFormationVolumeFactor(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of saturated oil.
@@ -238,7 +292,11 @@ public:
     Evaluation saturatedGasDissolutionFactor(unsigned regionIdx,
                                              const Evaluation& temperature,
                                              const Evaluation& pressure) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedGasDissolutionFactor(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "saturatedGasDissolutionFactor", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedGasDissolutionFactor(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the gas dissolution factor \f$R_s\f$ [m^3/m^3] of saturated oil.
@@ -249,7 +307,11 @@ public:
                                              const Evaluation& pressure,
                                              const Evaluation& oilSaturation,
                                              const Evaluation& maxOilSaturation) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedGasDissolutionFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "saturatedGasDissolutionFactor", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturatedGasDissolutionFactor(regionIdx, temperature, pressure, oilSaturation, maxOilSaturation));
+        return 0;
+    }
 
     /*!
      * \brief Returns the saturation pressure [Pa] of oil given the mass fraction of the
@@ -262,7 +324,11 @@ public:
     Evaluation saturationPressure(unsigned regionIdx,
                                   const Evaluation& temperature,
                                   const Evaluation& Rs) const
-    { OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturationPressure(regionIdx, temperature, Rs)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("OilPvtMultiplexer", "saturationPressure", regionIdx);
+        OPM_OIL_PVT_MULTIPLEXER_CALL(return pvtImpl.saturationPressure(regionIdx, temperature, Rs));
+        return 0;
+    }
 
     /*!
      * \copydoc BaseFluidSystem::diffusionCoefficient
@@ -438,6 +504,30 @@ public:
         return *this;
     }
 
+    /*!
+     * \brief Write the parameters of the PVT relations to or read them from a serializer.
+     *
+     * When reading, the concrete PVT object is replaced by one for the stored approach.
+     */
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        OilPvtApproach appr = approach_;
+        serializer(appr);
+        if (serializer.isReading()) {
+            // let a temporary object dispose of the current PVT object
+            OilPvtMultiplexer<Scalar,enableThermal> tmp;
+            if (appr != OilPvtApproach::NoOilPvt)
+                tmp.setApproach(appr);
+            std::swap(approach_, tmp.approach_);
+            std::swap(realOilPvt_, tmp.realOilPvt_);
+        }
+
+        if (approach_ != OilPvtApproach::NoOilPvt) {
+            OPM_OIL_PVT_MULTIPLEXER_CALL(serializer(pvtImpl));
+        }
+    }
+
 private:
     OilPvtApproach approach_;
     void* realOilPvt_;
@@ -445,6 +535,35 @@ private:
 
 #undef OPM_OIL_PVT_MULTIPLEXER_CALL
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+// instantiate the evaluation functions for one of the value types which are compiled
+// into the opm-material library. PREFIX is either empty or 'extern'.
+#define OPM_OIL_PVT_MULTIPLEXER_INSTANTIATE(PREFIX, Eval)                                  \
+    PREFIX template Eval OilPvtMultiplexer<double>::internalEnergy(                        \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval OilPvtMultiplexer<double>::viscosity(                             \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval OilPvtMultiplexer<double>::saturatedViscosity(                    \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval OilPvtMultiplexer<double>::inverseFormationVolumeFactor(          \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                            \
+    PREFIX template Eval OilPvtMultiplexer<double>::saturatedInverseFormationVolumeFactor( \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval OilPvtMultiplexer<double>::saturatedGasDissolutionFactor(         \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval OilPvtMultiplexer<double>::saturatedGasDissolutionFactor(         \
+        unsigned, const Eval&, const Eval&, const Eval&, const Eval&) const;               \
+    PREFIX template Eval OilPvtMultiplexer<double>::saturationPressure(                    \
+        unsigned, const Eval&, const Eval&) const;                                         \
+    PREFIX template Eval OilPvtMultiplexer<double>::diffusionCoefficient(                  \
+        const Eval&, const Eval&, unsigned) const;
+
+#define OPM_OIL_PVT_MULTIPLEXER_EXTERN(Eval) OPM_OIL_PVT_MULTIPLEXER_INSTANTIATE(extern, Eval)
+extern template class OilPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_EVALUATION(OPM_OIL_PVT_MULTIPLEXER_EXTERN)
+#undef OPM_OIL_PVT_MULTIPLEXER_EXTERN
+#endif
+
 } // namespace Opm
 
 #endif
@@ -33,6 +33,7 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -218,6 +219,14 @@ public:
     void initEnd()
     { }
 
+    /*!
+     * \brief Compress the tables of the isothermal PVT relations.
+     *
+     * See OilPvtMultiplexer::compressTables().
+     */
+    void compressTables(Scalar tolerance)
+    { isothermalPvt_->compressTables(tolerance); }
+
     /*!
      * \brief Returns true iff the density of the oil phase is temperature dependent.
      */
@@ -461,6 +470,31 @@ public:
         return *this;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        bool hasIsothermalPvt = isothermalPvt_ != nullptr;
+        serializer(hasIsothermalPvt);
+        if (serializer.isReading()) {
+            delete isothermalPvt_;
+            isothermalPvt_ = hasIsothermalPvt ? new IsothermalPvt : nullptr;
+        }
+        if (isothermalPvt_)
+            serializer(*isothermalPvt_);
+
+        serializer(oilvisctCurves_);
+        serializer(viscrefPress_);
+        serializer(viscrefRs_);
+        serializer(viscRef_);
+        serializer(oildentRefTemp_);
+        serializer(oildentCT1_);
+        serializer(oildentCT2_);
+        serializer(internalEnergyCurves_);
+        serializer(enableThermalDensity_);
+        serializer(enableThermalViscosity_);
+        serializer(enableInternalEnergy_);
+    }
+
 private:
     IsothermalPvt* isothermalPvt_;
 
@@ -484,6 +518,10 @@ private:
     bool enableInternalEnergy_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class OilPvtThermal<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -30,6 +30,7 @@
 #include <opm/material/Constants.hpp>
 
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -232,6 +233,15 @@ public:
                inverseSolventBMu_ == data.inverseSolventBMu_;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(solventReferenceDensity_);
+        serializer(inverseSolventB_);
+        serializer(solventMu_);
+        serializer(inverseSolventBMu_);
+    }
+
 private:
     std::vector<Scalar> solventReferenceDensity_;
     std::vector<TabulatedOneDFunction> inverseSolventB_;
@@ -239,6 +249,10 @@ private:
     std::vector<TabulatedOneDFunction> inverseSolventBMu_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class SolventPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
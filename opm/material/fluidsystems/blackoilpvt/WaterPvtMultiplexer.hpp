@@ -31,6 +31,15 @@
 #include "ConstantCompressibilityBrinePvt.hpp"
 #include "WaterPvtThermal.hpp"
 
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
+
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+#include <opm/material/densead/Evaluation.hpp>
+#endif
+
+#include <utility>
+
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
@@ -154,7 +163,11 @@ public:
     Evaluation internalEnergy(unsigned regionIdx,
                         const Evaluation& temperature,
                         const Evaluation& pressure) const
-    { OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure)); return 0; }
+    {
+        OPM_INSTRUMENT_SCOPE("WaterPvtMultiplexer", "internalEnergy", regionIdx);
+        OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.internalEnergy(regionIdx, temperature, pressure));
+        return 0;
+    }
 
     /*!
      * \brief Returns the dynamic viscosity [Pa s] of the fluid phase given a set of parameters.
@@ -165,6 +178,7 @@ public:
                          const Evaluation& pressure,
                          const Evaluation& saltconcentration) const
     {
+        OPM_INSTRUMENT_SCOPE("WaterPvtMultiplexer", "viscosity", regionIdx);
         OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.viscosity(regionIdx, temperature, pressure, saltconcentration));
         return 0;
     }
@@ -177,7 +191,9 @@ public:
                                             const Evaluation& temperature,
                                             const Evaluation& pressure,
                                             const Evaluation& saltconcentration) const
-    {   OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, saltconcentration));
+    {
+        OPM_INSTRUMENT_SCOPE("WaterPvtMultiplexer", "inverseFormationVolumeFactor", regionIdx);
+        OPM_WATER_PVT_MULTIPLEXER_CALL(return pvtImpl.inverseFormationVolumeFactor(regionIdx, temperature, pressure, saltconcentration));
         return 0;
     }
 
@@ -296,6 +312,30 @@ public:
         return *this;
     }
 
+    /*!
+     * \brief Write the parameters of the PVT relations to or read them from a serializer.
+     *
+     * When reading, the concrete PVT object is replaced by one for the stored approach.
+     */
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        WaterPvtApproach appr = approach_;
+        serializer(appr);
+        if (serializer.isReading()) {
+            // let a temporary object dispose of the current PVT object
+            WaterPvtMultiplexer<Scalar,enableThermal,enableBrine> tmp;
+            if (appr != WaterPvtApproach::NoWaterPvt)
+                tmp.setApproach(appr);
+            std::swap(approach_, tmp.approach_);
+            std::swap(realWaterPvt_, tmp.realWaterPvt_);
+        }
+
+        if (approach_ != WaterPvtApproach::NoWaterPvt) {
+            OPM_WATER_PVT_MULTIPLEXER_CALL(serializer(pvtImpl));
+        }
+    }
+
 private:
     WaterPvtApproach approach_;
     void* realWaterPvt_;
@@ -303,6 +343,23 @@ private:
 
 #undef OPM_WATER_PVT_MULTIPLEXER_CALL
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+// instantiate the evaluation functions for one of the value types which are compiled
+// into the opm-material library. PREFIX is either empty or 'extern'.
+#define OPM_WATER_PVT_MULTIPLEXER_INSTANTIATE(PREFIX, Eval)                         \
+    PREFIX template Eval WaterPvtMultiplexer<double>::internalEnergy(               \
+        unsigned, const Eval&, const Eval&) const;                                  \
+    PREFIX template Eval WaterPvtMultiplexer<double>::viscosity(                    \
+        unsigned, const Eval&, const Eval&, const Eval&) const;                     \
+    PREFIX template Eval WaterPvtMultiplexer<double>::inverseFormationVolumeFactor( \
+        unsigned, const Eval&, const Eval&, const Eval&) const;
+
+#define OPM_WATER_PVT_MULTIPLEXER_EXTERN(Eval) OPM_WATER_PVT_MULTIPLEXER_INSTANTIATE(extern, Eval)
+extern template class WaterPvtMultiplexer<double>;
+OPM_MATERIAL_FOR_EACH_EVALUATION(OPM_WATER_PVT_MULTIPLEXER_EXTERN)
+#undef OPM_WATER_PVT_MULTIPLEXER_EXTERN
+#endif
+
 } // namespace Opm
 
 #endif
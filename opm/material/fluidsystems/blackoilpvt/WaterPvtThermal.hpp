@@ -33,6 +33,7 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
 #include <opm/material/common/Spline.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -393,6 +394,34 @@ public:
         return *this;
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        bool hasIsothermalPvt = isothermalPvt_ != nullptr;
+        serializer(hasIsothermalPvt);
+        if (serializer.isReading()) {
+            delete isothermalPvt_;
+            isothermalPvt_ = hasIsothermalPvt ? new IsothermalPvt : nullptr;
+        }
+        if (isothermalPvt_)
+            serializer(*isothermalPvt_);
+
+        serializer(viscrefPress_);
+        serializer(watdentRefTemp_);
+        serializer(watdentCT1_);
+        serializer(watdentCT2_);
+        serializer(pvtwRefPress_);
+        serializer(pvtwRefB_);
+        serializer(pvtwCompressibility_);
+        serializer(pvtwViscosity_);
+        serializer(pvtwViscosibility_);
+        serializer(watvisctCurves_);
+        serializer(internalEnergyCurves_);
+        serializer(enableThermalDensity_);
+        serializer(enableThermalViscosity_);
+        serializer(enableInternalEnergy_);
+    }
+
 private:
     IsothermalPvt* isothermalPvt_;
 
@@ -420,6 +449,10 @@ private:
     bool enableInternalEnergy_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class WaterPvtThermal<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -30,8 +30,10 @@
 #include <opm/material/Constants.hpp>
 #include <opm/material/common/MathToolbox.hpp>
 #include <opm/material/common/OpmFinal.hpp>
+#include <opm/material/common/Instrumentation.hpp>
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/ExplicitInstantiation.hpp>
 
 #if HAVE_ECL_INPUT
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -458,6 +460,26 @@ public:
         }
     }
 
+    /*!
+     * \brief Replace the tables by monotonicity preserving splines through a subset of
+     *        their sampling points.
+     *
+     * See Tabulated1DFunction::compress() for the meaning of the tolerance. This must
+     * be called after initEnd().
+     */
+    void compressTables(Scalar tolerance)
+    {
+        for (unsigned regionIdx = 0; regionIdx < numRegions(); ++regionIdx) {
+            inverseGasB_[regionIdx].compress(tolerance);
+            inverseSaturatedGasB_[regionIdx].compress(tolerance);
+            gasMu_[regionIdx].compress(tolerance);
+            inverseGasBMu_[regionIdx].compress(tolerance);
+            inverseSaturatedGasBMu_[regionIdx].compress(tolerance);
+            saturatedOilVaporizationFactorTable_[regionIdx].compress(tolerance);
+            saturationPressure_[regionIdx].compress(tolerance);
+        }
+    }
+
     /*!
      * \brief Return the number of PVT regions which are considered by this PVT-object.
      */
@@ -579,6 +601,8 @@ public:
                                   const Evaluation& temperature OPM_UNUSED,
                                   const Evaluation& Rv) const
     {
+        OPM_INSTRUMENT_SCOPE("WetGasPvt", "saturationPressure", regionIdx);
+
         typedef MathToolbox<Evaluation> Toolbox;
 
         const auto& RvTable = saturatedOilVaporizationFactorTable_[regionIdx];
@@ -592,6 +616,8 @@ public:
         // iterations...
         bool onProbation = false;
         for (unsigned i = 0; i < 20; ++i) {
+            OPM_INSTRUMENT_ITERATION();
+
             const Evaluation& f = RvTable.eval(pSat, /*extrapolate=*/true) - Rv;
             const Evaluation& fPrime = RvTable.evalDerivative(pSat, /*extrapolate=*/true);
 
@@ -677,8 +703,8 @@ public:
 
     bool operator==(const WetGasPvt<Scalar>& data) const
     {
-        return this->gasReferenceDensity() == data.gasReferenceDensity() &&
-               this->oilReferenceDensity() == data.oilReferenceDensity() &&
+        return this->gasReferenceDensity_ == data.gasReferenceDensity_ &&
+               this->oilReferenceDensity_ == data.oilReferenceDensity_ &&
                this->inverseGasB() == data.inverseGasB() &&
                this->inverseSaturatedGasB() == data.inverseSaturatedGasB() &&
                this->gasMu() == data.gasMu() &&
@@ -689,6 +715,21 @@ public:
                this->vapPar1() == data.vapPar1();
     }
 
+    template <class Serializer>
+    void serializeOp(Serializer& serializer)
+    {
+        serializer(gasReferenceDensity_);
+        serializer(oilReferenceDensity_);
+        serializer(inverseGasB_);
+        serializer(inverseSaturatedGasB_);
+        serializer(gasMu_);
+        serializer(inverseGasBMu_);
+        serializer(inverseSaturatedGasBMu_);
+        serializer(saturatedOilVaporizationFactorTable_);
+        serializer(saturationPressure_);
+        serializer(vapPar1_);
+    }
+
 private:
     void updateSaturationPressure_(unsigned regionIdx)
     {
@@ -731,6 +772,10 @@ private:
     Scalar vapPar1_;
 };
 
+#if OPM_MATERIAL_EXPLICIT_INSTANTIATION
+extern template class WetGasPvt<double>;
+#endif
+
 } // namespace Opm
 
 #endif
@@ -0,0 +1,197 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReverseAd::Evaluation
+ */
+#ifndef OPM_REVERSE_AD_EVALUATION_HPP
+#define OPM_REVERSE_AD_EVALUATION_HPP
+
+#include "Tape.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Opm {
+namespace ReverseAd {
+
+/*!
+ * \brief Represents a function evaluation whose derivatives are computed in reverse
+ *        mode.
+ *
+ * In contrast to DenseAd::Evaluation, objects of this class only store the value and
+ * the index of the node on the active tape which computed it. They can thus be used
+ * where the number of parameters is large, e.g., to compute the sensitivities of a
+ * result with regard to all entries of a table by using this class as the scalar
+ * type of the table.
+ *
+ * Evaluations which are not recorded on a tape represent constants. Operations on
+ * constants are not recorded, i.e., tables which do not depend on any independent
+ * variable do not cause any overhead on the tape.
+ */
+template <class ScalarT>
+class Evaluation
+{
+public:
+    typedef ScalarT ValueType;
+    typedef ScalarT Scalar;
+    typedef ReverseAd::Tape<ScalarT> Tape;
+
+    Evaluation()
+        : value_(0.0)
+        , index_(0)
+    {}
+
+    // create a constant
+    Evaluation(Scalar value)
+        : value_(value)
+        , index_(0)
+    {}
+
+    Evaluation(const Evaluation& other) = default;
+    Evaluation& operator=(const Evaluation& other) = default;
+
+    /*!
+     * \brief Create an independent variable on the active tape.
+     */
+    static Evaluation createVariable(Scalar value)
+    {
+        Tape* tape = activeTape_();
+        Evaluation result(value);
+        result.index_ = tape->pushNode(0, 0.0, 0, 0.0);
+        return result;
+    }
+
+    static Evaluation createConstant(Scalar value)
+    { return Evaluation(value); }
+
+    /*!
+     * \brief Record the result of an operation with up to two arguments.
+     *
+     * The arguments are given by the indices of their nodes and the partial
+     * derivatives of the result with regard to them.
+     */
+    static Evaluation record(Scalar value,
+                             unsigned arg0, Scalar partial0,
+                             unsigned arg1 = 0, Scalar partial1 = 0.0)
+    {
+        Evaluation result(value);
+        if (arg0 != 0 || arg1 != 0)
+            result.index_ = activeTape_()->pushNode(arg0, partial0, arg1, partial1);
+        return result;
+    }
+
+    const Scalar& value() const
+    { return value_; }
+
+    //! The index of the node on the tape, 0 for constants
+    unsigned index() const
+    { return index_; }
+
+    //! Returns true if the evaluation does not depend on any recorded variable
+    bool isConstant() const
+    { return index_ == 0; }
+
+    //! Return the derivative of the last backward sweep of the active tape
+    Scalar adjoint() const
+    { return activeTape_()->adjoint(*this); }
+
+    Evaluation operator+() const
+    { return *this; }
+
+    Evaluation operator-() const
+    { return record(-value_, index_, -1.0); }
+
+    Evaluation& operator+=(const Evaluation& other)
+    { return *this = *this + other; }
+
+    Evaluation& operator-=(const Evaluation& other)
+    { return *this = *this - other; }
+
+    Evaluation& operator*=(const Evaluation& other)
+    { return *this = *this * other; }
+
+    Evaluation& operator/=(const Evaluation& other)
+    { return *this = *this / other; }
+
+    // the binary operators are friends so that scalars get converted implicitly
+    friend Evaluation operator+(const Evaluation& a, const Evaluation& b)
+    { return record(a.value_ + b.value_, a.index_, 1.0, b.index_, 1.0); }
+
+    friend Evaluation operator-(const Evaluation& a, const Evaluation& b)
+    { return record(a.value_ - b.value_, a.index_, 1.0, b.index_, -1.0); }
+
+    friend Evaluation operator*(const Evaluation& a, const Evaluation& b)
+    { return record(a.value_*b.value_, a.index_, b.value_, b.index_, a.value_); }
+
+    friend Evaluation operator/(const Evaluation& a, const Evaluation& b)
+    {
+        const Scalar inv = 1.0/b.value_;
+        const Scalar result = a.value_*inv;
+        return record(result, a.index_, inv, b.index_, -result*inv);
+    }
+
+    friend bool operator==(const Evaluation& a, const Evaluation& b)
+    { return a.value_ == b.value_; }
+
+    friend bool operator!=(const Evaluation& a, const Evaluation& b)
+    { return a.value_ != b.value_; }
+
+    friend bool operator<(const Evaluation& a, const Evaluation& b)
+    { return a.value_ < b.value_; }
+
+    friend bool operator>(const Evaluation& a, const Evaluation& b)
+    { return a.value_ > b.value_; }
+
+    friend bool operator<=(const Evaluation& a, const Evaluation& b)
+    { return a.value_ <= b.value_; }
+
+    friend bool operator>=(const Evaluation& a, const Evaluation& b)
+    { return a.value_ >= b.value_; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Evaluation& eval)
+    {
+        os << eval.value_;
+        return os;
+    }
+
+private:
+    static Tape* activeTape_()
+    {
+        Tape* tape = Tape::active();
+        if (!tape)
+            throw std::logic_error("Reverse-mode AD evaluations require an active tape");
+        return tape;
+    }
+
+    Scalar value_;
+    unsigned index_;
+};
+
+} // namespace ReverseAd
+} // namespace Opm
+
+#include "Math.hpp"
+
+#endif
@@ -0,0 +1,235 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The algebraic functions and the MathToolbox for reverse-mode automatic
+ *        differentiation.
+ */
+#ifndef OPM_REVERSE_AD_MATH_HPP
+#define OPM_REVERSE_AD_MATH_HPP
+
+#include "Evaluation.hpp"
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <cmath>
+
+namespace Opm {
+namespace ReverseAd {
+
+template <class Scalar>
+Evaluation<Scalar> abs(const Evaluation<Scalar>& x)
+{ return (x > 0.0)?x:-x; }
+
+template <class Scalar>
+Evaluation<Scalar> min(const Evaluation<Scalar>& x1, const Evaluation<Scalar>& x2)
+{ return (x1 < x2)?x1:x2; }
+
+template <class Scalar>
+Evaluation<Scalar> max(const Evaluation<Scalar>& x1, const Evaluation<Scalar>& x2)
+{ return (x1 > x2)?x1:x2; }
+
+template <class Scalar>
+Evaluation<Scalar> tan(const Evaluation<Scalar>& x)
+{
+    const Scalar tmp = std::tan(x.value());
+    return Evaluation<Scalar>::record(tmp, x.index(), 1 + tmp*tmp);
+}
+
+template <class Scalar>
+Evaluation<Scalar> atan(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::atan(x.value()), x.index(), 1/(1 + x.value()*x.value())); }
+
+template <class Scalar>
+Evaluation<Scalar> atan2(const Evaluation<Scalar>& x, const Evaluation<Scalar>& y)
+{
+    const Scalar denom = x.value()*x.value() + y.value()*y.value();
+    return Evaluation<Scalar>::record(std::atan2(x.value(), y.value()),
+                                      x.index(), y.value()/denom,
+                                      y.index(), -x.value()/denom);
+}
+
+template <class Scalar>
+Evaluation<Scalar> sin(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::sin(x.value()), x.index(), std::cos(x.value())); }
+
+template <class Scalar>
+Evaluation<Scalar> asin(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::asin(x.value()), x.index(), 1/std::sqrt(1 - x.value()*x.value())); }
+
+template <class Scalar>
+Evaluation<Scalar> cos(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::cos(x.value()), x.index(), -std::sin(x.value())); }
+
+template <class Scalar>
+Evaluation<Scalar> acos(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::acos(x.value()), x.index(), -1/std::sqrt(1 - x.value()*x.value())); }
+
+template <class Scalar>
+Evaluation<Scalar> sqrt(const Evaluation<Scalar>& x)
+{
+    const Scalar sqrt_x = std::sqrt(x.value());
+    return Evaluation<Scalar>::record(sqrt_x, x.index(), 0.5/sqrt_x);
+}
+
+template <class Scalar>
+Evaluation<Scalar> exp(const Evaluation<Scalar>& x)
+{
+    const Scalar exp_x = std::exp(x.value());
+    return Evaluation<Scalar>::record(exp_x, x.index(), exp_x);
+}
+
+template <class Scalar>
+Evaluation<Scalar> log(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::log(x.value()), x.index(), 1/x.value()); }
+
+template <class Scalar>
+Evaluation<Scalar> log10(const Evaluation<Scalar>& x)
+{ return Evaluation<Scalar>::record(std::log10(x.value()), x.index(), 1/(x.value()*std::log(10.0))); }
+
+template <class Scalar>
+Evaluation<Scalar> pow(const Evaluation<Scalar>& base, const Evaluation<Scalar>& exp)
+{
+    // we special case the base 0 case because 0.0 is in the valid range of the base
+    // but the generic code leads to NaNs.
+    if (base.value() == 0.0)
+        return 0.0;
+
+    const Scalar f = base.value();
+    const Scalar g = exp.value();
+    const Scalar valuePow = std::pow(f, g);
+    return Evaluation<Scalar>::record(valuePow,
+                                      base.index(), g/f*valuePow,
+                                      exp.index(), std::log(f)*valuePow);
+}
+
+} // namespace ReverseAd
+
+template <class ScalarT>
+struct MathToolbox<ReverseAd::Evaluation<ScalarT> >
+{
+public:
+    typedef ScalarT ValueType;
+    typedef MathToolbox<ValueType> InnerToolbox;
+    typedef typename InnerToolbox::Scalar Scalar;
+    typedef ReverseAd::Evaluation<ScalarT> Evaluation;
+
+    static ValueType value(const Evaluation& eval)
+    { return eval.value(); }
+
+    static Scalar scalarValue(const Evaluation& eval)
+    { return eval.value(); }
+
+    static Evaluation createBlank(const Evaluation& x OPM_UNUSED)
+    { return Evaluation(); }
+
+    static Evaluation createConstant(ValueType value)
+    { return Evaluation::createConstant(value); }
+
+    static Evaluation createConstant(unsigned numDeriv OPM_UNUSED, const ValueType value)
+    { return Evaluation::createConstant(value); }
+
+    static Evaluation createConstant(const Evaluation& x OPM_UNUSED, const ValueType value)
+    { return Evaluation::createConstant(value); }
+
+    // in reverse mode, variables are not identified by an index but by their node on
+    // the tape
+    static Evaluation createVariable(ValueType value OPM_UNUSED, int varIdx OPM_UNUSED)
+    { throw std::logic_error("Reverse-mode AD variables must be created using Evaluation::createVariable(value)"); }
+
+    static Evaluation createVariable(const Evaluation& x OPM_UNUSED, ValueType value OPM_UNUSED, int varIdx OPM_UNUSED)
+    { throw std::logic_error("Reverse-mode AD variables must be created using Evaluation::createVariable(value)"); }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_same<Evaluation, LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval; }
+
+    template <class LhsEval>
+    static typename std::enable_if<std::is_floating_point<LhsEval>::value,
+                                   LhsEval>::type
+    decay(const Evaluation& eval)
+    { return eval.value(); }
+
+    // comparison
+    static bool isSame(const Evaluation& a, const Evaluation& b, Scalar tolerance)
+    { return InnerToolbox::isSame(a.value(), b.value(), tolerance); }
+
+    // arithmetic functions
+    static Evaluation max(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::max(arg1, arg2); }
+
+    static Evaluation min(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::min(arg1, arg2); }
+
+    static Evaluation abs(const Evaluation& arg)
+    { return ReverseAd::abs(arg); }
+
+    static Evaluation tan(const Evaluation& arg)
+    { return ReverseAd::tan(arg); }
+
+    static Evaluation atan(const Evaluation& arg)
+    { return ReverseAd::atan(arg); }
+
+    static Evaluation atan2(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::atan2(arg1, arg2); }
+
+    static Evaluation sin(const Evaluation& arg)
+    { return ReverseAd::sin(arg); }
+
+    static Evaluation asin(const Evaluation& arg)
+    { return ReverseAd::asin(arg); }
+
+    static Evaluation cos(const Evaluation& arg)
+    { return ReverseAd::cos(arg); }
+
+    static Evaluation acos(const Evaluation& arg)
+    { return ReverseAd::acos(arg); }
+
+    static Evaluation sqrt(const Evaluation& arg)
+    { return ReverseAd::sqrt(arg); }
+
+    static Evaluation exp(const Evaluation& arg)
+    { return ReverseAd::exp(arg); }
+
+    static Evaluation log(const Evaluation& arg)
+    { return ReverseAd::log(arg); }
+
+    static Evaluation log10(const Evaluation& arg)
+    { return ReverseAd::log10(arg); }
+
+    static Evaluation pow(const Evaluation& arg1, const Evaluation& arg2)
+    { return ReverseAd::pow(arg1, arg2); }
+
+    static bool isfinite(const Evaluation& arg)
+    { return std::isfinite(arg.value()); }
+
+    static bool isnan(const Evaluation& arg)
+    { return std::isnan(arg.value()); }
+};
+
+} // namespace Opm
+
+#endif
@@ -0,0 +1,231 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ * \copydoc Opm::ReverseAd::Tape
+ */
+#ifndef OPM_REVERSE_AD_TAPE_HPP
+#define OPM_REVERSE_AD_TAPE_HPP
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm {
+namespace ReverseAd {
+
+template <class ScalarT>
+class Evaluation;
+
+/*!
+ * \brief Records the operations on reverse-mode AD evaluations.
+ *
+ * Every operation which involves at least one recorded evaluation appends a node to
+ * the tape which stores the indices of (at most) two arguments together with the
+ * partial derivatives of the result with regard to them. A single backward sweep over
+ * the tape then yields the derivatives of one result with regard to all independent
+ * variables, i.e., the cost of the gradient does not depend on the number of
+ * parameters.
+ *
+ * The nodes are allocated in chunks of fixed size, so recording never moves nodes
+ * which have already been recorded. Node 0 is a sink for the adjoints of constants:
+ * constants have index 0 and contributions to them are simply ignored.
+ *
+ * Operations are recorded on the tape which is active for the calling thread.
+ */
+template <class ScalarT>
+class Tape
+{
+    struct Node_
+    {
+        unsigned args[2];
+        ScalarT partials[2];
+    };
+
+public:
+    typedef ScalarT Scalar;
+
+    /*!
+     * \brief Create an empty tape.
+     *
+     * \param log2ChunkSize The binary logarithm of the number of nodes which are
+     *                      allocated at once.
+     */
+    explicit Tape(unsigned log2ChunkSize = 16)
+        : log2ChunkSize_(log2ChunkSize)
+        , numNodes_(0)
+    {
+        // the sink for the adjoints of constants
+        pushNode(0, 0.0, 0, 0.0);
+    }
+
+    Tape(const Tape&) = delete;
+    Tape& operator=(const Tape&) = delete;
+
+    ~Tape()
+    {
+        if (activeTape_() == this)
+            activeTape_() = nullptr;
+    }
+
+    /*!
+     * \brief Returns the tape which records the operations of the calling thread.
+     *
+     * If no tape is active, this method returns nullptr.
+     */
+    static Tape* active()
+    { return activeTape_(); }
+
+    /*!
+     * \brief Record all subsequent operations of the calling thread on this tape.
+     */
+    void activate()
+    { activeTape_() = this; }
+
+    /*!
+     * \brief Stop recording the operations of the calling thread.
+     */
+    void deactivate()
+    {
+        if (activeTape_() == this)
+            activeTape_() = nullptr;
+    }
+
+    /*!
+     * \brief The number of nodes which have been recorded so far.
+     *
+     * This can be passed to reset() to discard everything recorded afterwards.
+     */
+    unsigned position() const
+    { return numNodes_; }
+
+    /*!
+     * \brief Discard all nodes after a given position.
+     *
+     * Evaluations which have been recorded after this position must not be used
+     * anymore. The memory of the tape is retained.
+     */
+    void reset(unsigned pos = 1)
+    {
+        assert(1 <= pos && pos <= numNodes_);
+        numNodes_ = pos;
+        adjoints_.clear();
+    }
+
+    /*!
+     * \brief Append a node to the tape and return its index.
+     */
+    unsigned pushNode(unsigned arg0, Scalar partial0, unsigned arg1, Scalar partial1)
+    {
+        assert(arg0 < numNodes_ || numNodes_ == 0);
+        assert(arg1 < numNodes_ || numNodes_ == 0);
+
+        if (numNodes_ == (chunks_.size() << log2ChunkSize_)) {
+            if (numNodes_ + (1u << log2ChunkSize_) < numNodes_)
+                throw std::overflow_error("Too many nodes on the reverse-mode AD tape");
+            chunks_.emplace_back(new Node_[1u << log2ChunkSize_]);
+        }
+
+        Node_& node = node_(numNodes_);
+        node.args[0] = arg0;
+        node.args[1] = arg1;
+        node.partials[0] = partial0;
+        node.partials[1] = partial1;
+        return numNodes_++;
+    }
+
+    /*!
+     * \brief Compute the derivatives of a recorded quantity with regard to everything
+     *        recorded before it.
+     *
+     * This is the backward sweep. Afterwards, the derivatives can be retrieved using
+     * adjoint().
+     */
+    void computeAdjoints(const Evaluation<Scalar>& output, Scalar seed = 1.0)
+    {
+        unsigned outputIdx = output.index();
+        assert(outputIdx < numNodes_);
+
+        adjoints_.assign(numNodes_, 0.0);
+        adjoints_[outputIdx] = seed;
+        for (unsigned nodeIdx = outputIdx; nodeIdx > 0; --nodeIdx) {
+            const Scalar a = adjoints_[nodeIdx];
+            if (a == 0.0)
+                continue;
+
+            const Node_& node = node_(nodeIdx);
+            adjoints_[node.args[0]] += node.partials[0]*a;
+            adjoints_[node.args[1]] += node.partials[1]*a;
+        }
+    }
+
+    /*!
+     * \brief Return the derivative of the output of the last backward sweep with
+     *        regard to a given evaluation.
+     */
+    Scalar adjoint(const Evaluation<Scalar>& x) const
+    {
+        unsigned idx = x.index();
+        if (idx == 0 || idx >= adjoints_.size())
+            return 0.0;
+        return adjoints_[idx];
+    }
+
+    /*!
+     * \brief Return the derivatives of the output of the last backward sweep with
+     *        regard to a sequence of evaluations.
+     */
+    template <class EvalContainer>
+    std::vector<Scalar> adjoints(const EvalContainer& x) const
+    {
+        std::vector<Scalar> result;
+        result.reserve(x.size());
+        for (const auto& xi : x)
+            result.push_back(adjoint(xi));
+        return result;
+    }
+
+private:
+    static Tape*& activeTape_()
+    {
+        static thread_local Tape* tape = nullptr;
+        return tape;
+    }
+
+    Node_& node_(unsigned idx)
+    { return chunks_[idx >> log2ChunkSize_][idx & ((1u << log2ChunkSize_) - 1)]; }
+
+    const Node_& node_(unsigned idx) const
+    { return chunks_[idx >> log2ChunkSize_][idx & ((1u << log2ChunkSize_) - 1)]; }
+
+    unsigned log2ChunkSize_;
+    unsigned numNodes_;
+    std::vector<std::unique_ptr<Node_[]> > chunks_;
+    std::vector<Scalar> adjoints_;
+};
+
+} // namespace ReverseAd
+} // namespace Opm
+
+#endif
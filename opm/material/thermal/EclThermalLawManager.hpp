@@ -37,17 +37,60 @@
 #include "EclThermalConductionLawMultiplexer.hpp"
 #include "EclThermalConductionLawMultiplexerParams.hpp"
 
+#include <opm/material/common/Unused.hpp>
+
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
 namespace Opm {
 
+namespace Detail {
+// the subset of the fluid state API which is required by the thermal laws. this
+// allows to evaluate the per-element laws of EclThermalLawManager for a range of
+// elements.
+template <class EvaluationT, class FluidSystem>
+class EclThermalBulkFluidState
+{
+public:
+    typedef EvaluationT Scalar;
+
+    EclThermalBulkFluidState(const Scalar* temperature, const Scalar* gasSaturation)
+        : temperature_(temperature)
+        , gasSaturation_(gasSaturation)
+    {}
+
+    const Scalar& temperature(unsigned /*phaseIdx*/) const
+    { assert(temperature_); return *temperature_; }
+
+    const Scalar& saturation(unsigned phaseIdx OPM_OPTIM_UNUSED) const
+    {
+        assert(phaseIdx == FluidSystem::gasPhaseIdx && gasSaturation_);
+        return *gasSaturation_;
+    }
+
+private:
+    const Scalar* temperature_;
+    const Scalar* gasSaturation_;
+};
+} // namespace Detail
+
 /*!
  * \ingroup fluidmatrixinteractions
  *
  * \brief Provides an simple way to create and manage the thermal law objects
  *        for a complete ECL deck.
+ *
+ * By default, one parameter object is created for each element if the thermal laws
+ * are specified element-wise (HEATCR, THCONR and THC*). If compact storage is enabled,
+ * the coefficients of these laws are stored in contiguous arrays instead, i.e.,
+ * solidEnergyLawParams() and thermalConductionLawParams() can then only be used for
+ * the region-wise and the null approaches. solidInternalEnergy(),
+ * thermalConductivity() and their bulk variants work in both modes.
  */
 template <class Scalar, class FluidSystem>
 class EclThermalLawManager
@@ -65,8 +108,23 @@ public:
     {
         solidEnergyApproach_ = SolidEnergyLawParams::undefinedApproach;
         thermalConductivityApproach_ = ThermalConductionLawParams::undefinedApproach;
+        enableCompactStorage_ = false;
     }
 
+    /*!
+     * \brief Specify whether the per-element parameter objects should be omitted.
+     *
+     * This must be called before initParamsForElements().
+     */
+    void setEnableCompactStorage(bool yesno)
+    { enableCompactStorage_ = yesno; }
+
+    /*!
+     * \brief Returns whether the per-element parameter objects are omitted.
+     */
+    bool enableCompactStorage() const
+    { return enableCompactStorage_; }
+
     void initParamsForElements(const EclipseState& eclState, size_t numElems)
     {
         const auto& fp = eclState.fieldProps();
@@ -94,6 +152,9 @@ public:
     {
         switch (solidEnergyApproach_) {
         case SolidEnergyLawParams::heatcrApproach:
+            if (enableCompactStorage_)
+                throw std::logic_error("Per-element solid energy parameters are not available "
+                                       "if compact storage is enabled");
             assert(0 <= elemIdx && elemIdx <  solidEnergyLawParams_.size());
             return solidEnergyLawParams_[elemIdx];
 
@@ -119,6 +180,9 @@ public:
         switch (thermalConductivityApproach_) {
         case ThermalConductionLawParams::thconrApproach:
         case ThermalConductionLawParams::thcApproach:
+            if (enableCompactStorage_)
+                throw std::logic_error("Per-element thermal conduction parameters are not available "
+                                       "if compact storage is enabled");
             assert(0 <= elemIdx && elemIdx <  thermalConductionLawParams_.size());
             return thermalConductionLawParams_[elemIdx];
 
@@ -131,6 +195,168 @@ public:
         }
     }
 
+    /*!
+     * \brief Compute the volumetric internal energy of the rock [W/m^3] of an element.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    Evaluation solidInternalEnergy(unsigned elemIdx, const FluidState& fluidState) const
+    {
+        if (enableCompactStorage_ && solidEnergyApproach_ == SolidEnergyLawParams::heatcrApproach) {
+            assert(elemIdx < rockHeatCapacity_.size());
+            const Evaluation& deltaT =
+                fluidState.temperature(/*phaseIdx=*/0) - HeatcrLawParams::referenceTemperature();
+            return deltaT*(rockHeatCapacity_[elemIdx] + deltaT*dRockHeatCapacity_dT_[elemIdx] / 2.0);
+        }
+
+        return SolidEnergyLaw::solidInternalEnergy(solidEnergyLawParams(elemIdx), fluidState);
+    }
+
+    /*!
+     * \brief Compute the volumetric internal energy of the rock [W/m^3] of a range of
+     *        elements.
+     *
+     * \param energies Array of size endElemIdx - beginElemIdx which receives the results
+     * \param temperatures The temperatures of the elements in the range
+     * \param beginElemIdx The index of the first element of the range
+     * \param endElemIdx The index of the element after the last element of the range
+     */
+    template <class Evaluation>
+    void solidInternalEnergies(Evaluation* energies,
+                               const Evaluation* temperatures,
+                               unsigned beginElemIdx,
+                               unsigned endElemIdx) const
+    {
+        const unsigned n = endElemIdx - beginElemIdx;
+        switch (solidEnergyApproach_) {
+        case SolidEnergyLawParams::heatcrApproach: {
+            if (!enableCompactStorage_) {
+                for (unsigned i = 0; i < n; ++i) {
+                    Detail::EclThermalBulkFluidState<Evaluation, FluidSystem> fluidState(temperatures + i, nullptr);
+                    energies[i] =
+                        SolidEnergyLaw::solidInternalEnergy(solidEnergyLawParams(beginElemIdx + i), fluidState);
+                }
+                break;
+            }
+
+            assert(endElemIdx <= rockHeatCapacity_.size());
+            const Scalar Tref = HeatcrLawParams::referenceTemperature();
+            const Scalar* C0 = rockHeatCapacity_.data() + beginElemIdx;
+            const Scalar* C1 = dRockHeatCapacity_dT_.data() + beginElemIdx;
+            for (unsigned i = 0; i < n; ++i) {
+                const Evaluation& deltaT = temperatures[i] - Tref;
+                energies[i] = deltaT*(C0[i] + deltaT*C1[i] / 2.0);
+            }
+            break;
+        }
+
+        case SolidEnergyLawParams::nullApproach:
+            for (unsigned i = 0; i < n; ++i)
+                energies[i] = 0.0;
+            break;
+
+        case SolidEnergyLawParams::specrockApproach:
+            // see EclSpecrockLaw::solidInternalEnergy()
+            for (unsigned i = 0; i < n; ++i) {
+                const auto& specrockParams =
+                    solidEnergyLawParams(beginElemIdx + i).template getRealParams<SolidEnergyLawParams::specrockApproach>();
+                energies[i] = specrockParams.internalEnergyFunction().eval(temperatures[i], /*extrapolate=*/true);
+            }
+            break;
+
+        default:
+            throw std::runtime_error("Attempting to compute solid energies without "
+                                     "a known approach being defined by the deck.");
+        }
+    }
+
+    /*!
+     * \brief Compute the total thermal conductivity [W/m^2 / (K/m)] of an element.
+     */
+    template <class FluidState, class Evaluation = typename FluidState::Scalar>
+    Evaluation thermalConductivity(unsigned elemIdx, const FluidState& fluidState) const
+    {
+        if (!enableCompactStorage_)
+            return ThermalConductionLaw::thermalConductivity(thermalConductionLawParams(elemIdx), fluidState);
+
+        switch (thermalConductivityApproach_) {
+        case ThermalConductionLawParams::thconrApproach:
+            assert(elemIdx < referenceThermalConductivity_.size());
+            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                const Evaluation& Sg = decay<Evaluation>(fluidState.saturation(FluidSystem::gasPhaseIdx));
+                return referenceThermalConductivity_[elemIdx]*(1.0 - dThermalConductivity_dSg_[elemIdx]*Sg);
+            }
+            return referenceThermalConductivity_[elemIdx];
+
+        case ThermalConductionLawParams::thcApproach:
+            assert(elemIdx < referenceThermalConductivity_.size());
+            return referenceThermalConductivity_[elemIdx];
+
+        default:
+            return ThermalConductionLaw::thermalConductivity(thermalConductionLawParams(elemIdx), fluidState);
+        }
+    }
+
+    /*!
+     * \brief Compute the total thermal conductivity [W/m^2 / (K/m)] of a range of elements.
+     *
+     * \param conductivities Array of size endElemIdx - beginElemIdx which receives the results
+     * \param gasSaturations The gas saturations of the elements in the range. This may
+     *                       be a null pointer if the gas phase is inactive.
+     * \param beginElemIdx The index of the first element of the range
+     * \param endElemIdx The index of the element after the last element of the range
+     */
+    template <class Evaluation>
+    void thermalConductivities(Evaluation* conductivities,
+                               const Evaluation* gasSaturations,
+                               unsigned beginElemIdx,
+                               unsigned endElemIdx) const
+    {
+        const unsigned n = endElemIdx - beginElemIdx;
+        if (!enableCompactStorage_) {
+            for (unsigned i = 0; i < n; ++i) {
+                Detail::EclThermalBulkFluidState<Evaluation, FluidSystem> fluidState(nullptr, gasSaturations ? gasSaturations + i : nullptr);
+                conductivities[i] =
+                    ThermalConductionLaw::thermalConductivity(thermalConductionLawParams(beginElemIdx + i), fluidState);
+            }
+            return;
+        }
+
+        switch (thermalConductivityApproach_) {
+        case ThermalConductionLawParams::thconrApproach: {
+            assert(endElemIdx <= referenceThermalConductivity_.size());
+            const Scalar* lambdaRef = referenceThermalConductivity_.data() + beginElemIdx;
+            const Scalar* alpha = dThermalConductivity_dSg_.data() + beginElemIdx;
+            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                assert(gasSaturations);
+                for (unsigned i = 0; i < n; ++i)
+                    conductivities[i] = lambdaRef[i]*(1.0 - alpha[i]*gasSaturations[i]);
+            }
+            else {
+                for (unsigned i = 0; i < n; ++i)
+                    conductivities[i] = lambdaRef[i];
+            }
+            break;
+        }
+
+        case ThermalConductionLawParams::thcApproach: {
+            assert(endElemIdx <= referenceThermalConductivity_.size());
+            const Scalar* lambdaRef = referenceThermalConductivity_.data() + beginElemIdx;
+            for (unsigned i = 0; i < n; ++i)
+                conductivities[i] = lambdaRef[i];
+            break;
+        }
+
+        case ThermalConductionLawParams::nullApproach:
+            for (unsigned i = 0; i < n; ++i)
+                conductivities[i] = 0.0;
+            break;
+
+        default:
+            throw std::runtime_error("Attempting to compute thermal conductivities without "
+                                     "a known approach being defined by the deck.");
+        }
+    }
+
 private:
     /*!
      * \brief Initialize the parameters for the solid energy law using using HEATCR and friends.
@@ -146,6 +372,12 @@ private:
         const auto& fp = eclState.fieldProps();
         const std::vector<double>& heatcrData  = fp.get_double("HEATCR");
         const std::vector<double>& heatcrtData = fp.get_double("HEATCRT");
+        if (enableCompactStorage_) {
+            rockHeatCapacity_.assign(heatcrData.begin(), heatcrData.begin() + numElems);
+            dRockHeatCapacity_dT_.assign(heatcrtData.begin(), heatcrtData.begin() + numElems);
+            return;
+        }
+
         solidEnergyLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParam = solidEnergyLawParams_[elemIdx];
@@ -205,6 +437,7 @@ private:
         solidEnergyApproach_ = SolidEnergyLawParams::nullApproach;
 
         solidEnergyLawParams_.resize(1);
+        solidEnergyLawParams_[0].setSolidEnergyApproach(SolidEnergyLawParams::nullApproach);
         solidEnergyLawParams_[0].finalize();
     }
 
@@ -225,6 +458,16 @@ private:
         if (fp.has_double("THCONSF"))
             thconsfData = fp.get_double("THCONSF");
 
+        if (enableCompactStorage_) {
+            referenceThermalConductivity_.resize(numElems);
+            dThermalConductivity_dSg_.resize(numElems);
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                referenceThermalConductivity_[elemIdx] = thconrData.empty() ? 0.0 : thconrData[elemIdx];
+                dThermalConductivity_dSg_[elemIdx] = thconsfData.empty() ? 0.0 : thconsfData[elemIdx];
+            }
+            return;
+        }
+
         thermalConductionLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParams = thermalConductionLawParams_[elemIdx];
@@ -269,6 +512,26 @@ private:
 
         const std::vector<double>& poroData = fp.get_double("PORO");
 
+        // the THC* conductivity does not depend on the solution, so it is stored
+        // directly. this mirrors EclThcLaw::thermalConductivity().
+        if (enableCompactStorage_) {
+            referenceThermalConductivity_.resize(numElems);
+            dThermalConductivity_dSg_.clear();
+            for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                Scalar poro = poroData[elemIdx];
+                Scalar thcrock = thcrockData.empty()    ? 0.0 : thcrockData[elemIdx];
+                Scalar thcoil = thcoilData.empty()      ? 0.0 : thcoilData[elemIdx];
+                Scalar thcgas = thcgasData.empty()      ? 0.0 : thcgasData[elemIdx];
+                Scalar thcwater = thcwaterData.empty()  ? 0.0 : thcwaterData[elemIdx];
+
+                Scalar numPhases = 3.0;
+                referenceThermalConductivity_[elemIdx] =
+                    poro*(thcoil + thcgas + thcwater) / numPhases
+                    + (1.0 - poro)*thcrock;
+            }
+            return;
+        }
+
         thermalConductionLawParams_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             auto& elemParams = thermalConductionLawParams_[elemIdx];
@@ -298,10 +561,13 @@ private:
         thermalConductivityApproach_ = ThermalConductionLawParams::nullApproach;
 
         thermalConductionLawParams_.resize(1);
+        thermalConductionLawParams_[0].setThermalConductionApproach(ThermalConductionLawParams::nullApproach);
         thermalConductionLawParams_[0].finalize();
     }
 
 private:
+    bool enableCompactStorage_;
+
     typename ThermalConductionLawParams::ThermalConductionApproach thermalConductivityApproach_;
     typename SolidEnergyLawParams::SolidEnergyApproach solidEnergyApproach_;
 
@@ -309,6 +575,15 @@ private:
 
     std::vector<SolidEnergyLawParams> solidEnergyLawParams_;
     std::vector<ThermalConductionLawParams> thermalConductionLawParams_;
+
+    // element-wise coefficients of the HEATCR approach
+    std::vector<Scalar> rockHeatCapacity_;
+    std::vector<Scalar> dRockHeatCapacity_dT_;
+
+    // element-wise coefficients of the THCONR approach. for the THC* approach, the
+    // first array holds the total thermal conductivity.
+    std::vector<Scalar> referenceThermalConductivity_;
+    std::vector<Scalar> dThermalConductivity_dSg_;
 };
 } // namespace Opm
 
@@ -32,6 +32,9 @@
 #include <opm/material/common/UniformXTabulated2DFunction.hpp>
 #include <opm/material/common/UniformTabulated2DFunction.hpp>
 #include <opm/material/common/IntervalTabulated2DFunction.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/DynamicEvaluation.hpp>
+#include <opm/material/densead/Math.hpp>
 
 #include <dune/common/parallel/mpihelper.hh>
 
@@ -53,17 +56,21 @@ struct Test
     static Scalar testFn3(Scalar x, Scalar y)
     { return x*y; }
 
+    static Scalar testFn4(Scalar x, Scalar y)
+    { return std::exp(x/2)*std::sqrt(1 + y); }
+
+    static Scalar testFn5(Scalar x, Scalar y)
+    { return (x + y > 0.5) ? 1.0 : 0.0; }
+
     template <class Fn>
     std::shared_ptr<Opm::UniformTabulated2DFunction<Scalar> >
-    createUniformTabulatedFunction(Fn& f)
+    createUniformTabulatedFunction(Fn& f, unsigned m = 50, unsigned n = 40)
     {
         Scalar xMin = -2.0;
         Scalar xMax = 3.0;
-        unsigned m = 50;
 
         Scalar yMin = -1/2.0;
         Scalar yMax = 1/3.0;
-        unsigned n = 40;
 
         auto tab = std::make_shared<Opm::UniformTabulated2DFunction<Scalar>>(
             xMin, xMax, m,
@@ -135,7 +142,7 @@ struct Test
 
     template <class Fn>
     std::shared_ptr<Opm::IntervalTabulated2DFunction<Scalar> >
-    createIntervalTabulated2DFunction(Fn& f)
+    createIntervalTabulated2DFunction(Fn& f, bool uniform = true)
     {
         const Scalar xMin = -2.0;
         const Scalar xMax = 3.0;
@@ -150,7 +157,8 @@ struct Test
         std::vector<std::vector<Scalar>> data(m, std::vector<Scalar>(n));
 
         for (unsigned i = 0; i < m; ++i) {
-            xSamples[i] = xMin + Scalar(i)/(m - 1) * (xMax - xMin);
+            Scalar t = Scalar(i)/(m - 1);
+            xSamples[i] = xMin + (uniform ? t : t*t) * (xMax - xMin);
 
             for (unsigned j = 0; j < n; ++j) {
                 ySamples[j] = yMin + Scalar(j)/(n -1) * (yMax - yMin);
@@ -221,6 +229,167 @@ struct Test
         return true;
     }
 
+    // the bi-linear interpolation of x*y is exact, so the gradient must be (y, x) even
+    // if the table is extrapolated
+    template <class Table>
+    bool checkIntervalTabulatedGradient(const Table& table, Scalar tolerance)
+    {
+        typedef Opm::DenseAd::Evaluation<Scalar, 2> Eval;
+        typedef Opm::DenseAd::DynamicEvaluation<Scalar> DynEval;
+
+        for (unsigned i = 0; i <= 60; ++i) {
+            Scalar x = -4.0 + Scalar(i)/60*12.0;
+
+            for (unsigned j = 0; j <= 45; ++j) {
+                Scalar y = -1.0 + Scalar(j)/45*2.0;
+                Scalar dfdx;
+                Scalar dfdy;
+                Scalar f = table->evalWithGradient(x, y, dfdx, dfdy);
+                if (std::abs(f - x*y) > tolerance
+                    || std::abs(dfdx - y) > tolerance
+                    || std::abs(dfdy - x) > tolerance)
+                {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": wrong value or gradient at (" << x << "," << y << "): "
+                              << f << " (" << dfdx << ", " << dfdy << ")\n";
+                    return false;
+                }
+
+                Eval fEval = table->eval(Eval::createVariable(x, 0), Eval::createVariable(y, 1));
+                if (fEval.value() != f || fEval.derivative(0) != dfdx || fEval.derivative(1) != dfdy) {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": eval() is inconsistent with evalWithGradient() at ("
+                              << x << "," << y << ")\n";
+                    return false;
+                }
+
+                // evaluations with a run-time number of derivatives cannot be created
+                // from a scalar without specifying the number of derivatives
+                DynEval fDynEval = table->eval(DynEval::createVariable(2, x, 0), DynEval::createVariable(2, y, 1));
+                if (fDynEval.size() != 2 || fDynEval.value() != f
+                    || fDynEval.derivative(0) != dfdx || fDynEval.derivative(1) != dfdy)
+                {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": eval() of a dynamic evaluation is inconsistent with evalWithGradient() at ("
+                              << x << "," << y << ")\n";
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // returns the maximum deviation of a table from a function between the sampling points
+    template <class Table, class Fn>
+    Scalar maxError(const Table& table, Fn& f)
+    {
+        Scalar result = 0.0;
+        for (unsigned i = 0; i < 3*table->numX(); ++i) {
+            Scalar x = table->xMin() + (i + 0.5)/(3*table->numX())*(table->xMax() - table->xMin());
+            for (unsigned j = 0; j < 3*table->numY(); ++j) {
+                Scalar y = table->yMin() + (j + 0.5)/(3*table->numY())*(table->yMax() - table->yMin());
+                result = std::max(result, std::abs(table->eval(x, y) - f(x, y)));
+            }
+        }
+        return result;
+    }
+
+    bool checkBicubic(Scalar tolerance)
+    {
+        typedef Opm::UniformTabulated2DFunction<Scalar> Table;
+        typedef typename Table::InterpolationType InterpolationType;
+        typedef Opm::DenseAd::Evaluation<Scalar, 2> Eval;
+
+        // bi-linear functions are reproduced exactly
+        auto tab = createUniformTabulatedFunction(testFn3, 10, 8);
+        tab->setInterpolationType(InterpolationType::Bicubic);
+        if (maxError(tab, testFn3) > tolerance) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation of x*y is not exact\n";
+            return false;
+        }
+
+        // for smooth monotonic functions the bi-cubic interpolation is much more
+        // accurate. it is also C1 continuous
+        auto coarseTab = createUniformTabulatedFunction(testFn4, 20, 10);
+        Scalar errBilinear = maxError(coarseTab, testFn4);
+        coarseTab->setInterpolationType(InterpolationType::Bicubic);
+        Scalar errBicubic = maxError(coarseTab, testFn4);
+        if (errBicubic > 0.25*errBilinear) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation is not more accurate than bi-linear: "
+                      << errBicubic << " vs " << errBilinear << "\n";
+            return false;
+        }
+
+        for (unsigned i = 1; i < coarseTab->numX() - 1; ++i) {
+            for (unsigned j = 1; j < coarseTab->numY() - 1; ++j) {
+                Scalar x = coarseTab->iToX(i);
+                Scalar y = coarseTab->jToY(j);
+                Scalar eps = 1e-3*(coarseTab->xMax() - coarseTab->xMin())/coarseTab->numX();
+                Eval left = coarseTab->eval(Eval::createVariable(x - eps, 0), Eval::createVariable(y - eps, 1));
+                Eval right = coarseTab->eval(Eval::createVariable(x + eps, 0), Eval::createVariable(y + eps, 1));
+                if (std::abs(left.derivative(0) - right.derivative(0)) > 1e-2
+                    || std::abs(left.derivative(1) - right.derivative(1)) > 1e-2)
+                {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation is not C1 continuous at ("
+                              << x << "," << y << ")\n";
+                    return false;
+                }
+            }
+        }
+
+        // evaluations with a run-time number of derivatives give the same results for both
+        // kinds of interpolation
+        typedef Opm::DenseAd::DynamicEvaluation<Scalar> DynEval;
+        for (int bicubic = 0; bicubic < 2; ++bicubic) {
+            coarseTab->setInterpolationType(bicubic ? InterpolationType::Bicubic : InterpolationType::Bilinear);
+            for (unsigned i = 0; i < 30; ++i) {
+                Scalar x = coarseTab->xMin() + (i + 0.5)/30*(coarseTab->xMax() - coarseTab->xMin());
+                Scalar y = coarseTab->yMin() + (i + 0.25)/30*(coarseTab->yMax() - coarseTab->yMin());
+                Eval f = coarseTab->eval(Eval::createVariable(x, 0), Eval::createVariable(y, 1));
+                DynEval fDyn = coarseTab->eval(DynEval::createVariable(2, x, 0), DynEval::createVariable(2, y, 1));
+                if (fDyn.size() != 2
+                    || std::abs(fDyn.value() - f.value()) > tolerance
+                    || std::abs(fDyn.derivative(0) - f.derivative(0)) > tolerance
+                    || std::abs(fDyn.derivative(1) - f.derivative(1)) > tolerance)
+                {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": eval() of a dynamic evaluation is inconsistent at ("
+                              << x << "," << y << ")\n";
+                    return false;
+                }
+            }
+        }
+
+        // a coarse bi-cubic table resampled from a fine bi-linear one is as accurate
+        auto fineTab = createUniformTabulatedFunction(testFn4, 200, 100);
+        Table resampledTab = fineTab->resampled(50, 25);
+        if (resampledTab.interpolationType() != InterpolationType::Bicubic
+            || resampledTab.numX() != 50 || resampledTab.numY() != 25)
+            return false;
+        Scalar errFine = maxError(fineTab, testFn4);
+        Scalar errResampled = maxError(&resampledTab, testFn4);
+        if (errResampled > 2*errFine) {
+            std::cerr << __FILE__ << ":" << __LINE__ << ": resampled table is less accurate than the original one: "
+                      << errResampled << " vs " << errFine << "\n";
+            return false;
+        }
+
+        // the interpolation of discontinuous data does not overshoot
+        auto stepTab = createUniformTabulatedFunction(testFn5, 20, 10);
+        stepTab->setInterpolationType(InterpolationType::Bicubic);
+        for (unsigned i = 0; i < 100; ++i) {
+            Scalar x = stepTab->xMin() + (i + 0.5)/100*(stepTab->xMax() - stepTab->xMin());
+            for (unsigned j = 0; j < 50; ++j) {
+                Scalar y = stepTab->yMin() + (j + 0.5)/50*(stepTab->yMax() - stepTab->yMin());
+                Scalar v = stepTab->eval(x, y);
+                if (v < -tolerance || v > 1.0 + tolerance) {
+                    std::cerr << __FILE__ << ":" << __LINE__ << ": bi-cubic interpolation overshoots at ("
+                              << x << "," << y << "): " << v << "\n";
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
     template <class UniformTablePtr, class UniformXTablePtr, class Fn>
     bool compareTables(const UniformTablePtr uTable,
                        const UniformXTablePtr uXTable,
@@ -409,6 +578,9 @@ inline int testAll(const typename TestType::Scalar tolerance = 1e-6)
     if (!test.compareTables(uniformTab, uniformXTab, TestType::testFn3, /*tolerance=*/1e-2))
         return 1;
 
+    if (!test.checkBicubic(100*tolerance))
+        return 1;
+
     uniformXTab = test.createUniformXTabulatedFunction2(TestType::testFn3);
     if (!test.compareTableWithAnalyticFn(uniformXTab,
                                          -2.0, 3.0, 100,
@@ -444,6 +616,17 @@ inline int testAll(const typename TestType::Scalar tolerance = 1e-6)
 
         if (!test.compareTableWithAnalyticFn2(xytab, xMin, xMax, m, yMin, yMax, n, TestType::testFn3, tmpTolerance))
             return 1;
+
+        if (!xytab->xUniform() || !xytab->yUniform())
+            return 1;
+        if (!test.checkIntervalTabulatedGradient(xytab, 10*tmpTolerance))
+            return 1;
+
+        xytab = test.createIntervalTabulated2DFunction(TestType::testFn3, /*uniform=*/false);
+        if (xytab->xUniform() || !xytab->yUniform())
+            return 1;
+        if (!test.checkIntervalTabulatedGradient(xytab, 10*tmpTolerance))
+            return 1;
     }
 
     // CSV output for debugging
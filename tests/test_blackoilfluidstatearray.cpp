@@ -0,0 +1,223 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the structure-of-arrays container of black-oil
+ *        fluid states.
+ *
+ * The per-cell objects of the container must conform to the fluid state API and the
+ * fluid system must compute the same quantities for them as for the corresponding
+ * BlackOilFluidState objects.
+ */
+#include "config.h"
+
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/fluidstates/BlackOilFluidState.hpp>
+#include <opm/material/fluidstates/BlackOilFluidStateArray.hpp>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/checkFluidSystem.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+template <class FluidSystem>
+void initFluidSystem(unsigned numRegions)
+{
+    typedef typename FluidSystem::Scalar Scalar;
+    typedef typename FluidSystem::OilPvt OilPvt;
+    typedef typename FluidSystem::GasPvt GasPvt;
+    typedef typename FluidSystem::WaterPvt WaterPvt;
+    typedef Opm::Tabulated1DFunction<Scalar> TabulatedFunction;
+
+    FluidSystem::initBegin(numRegions);
+    FluidSystem::setEnableDissolvedGas(false);
+    FluidSystem::setEnableVaporizedOil(false);
+
+    auto oilPvt = std::make_shared<OilPvt>();
+    oilPvt->setApproach(Opm::OilPvtApproach::DeadOilPvt);
+    auto& deadOil = oilPvt->template getRealPvt<Opm::OilPvtApproach::DeadOilPvt>();
+    deadOil.setNumRegions(numRegions);
+
+    auto gasPvt = std::make_shared<GasPvt>();
+    gasPvt->setApproach(Opm::GasPvtApproach::DryGasPvt);
+    auto& dryGas = gasPvt->template getRealPvt<Opm::GasPvtApproach::DryGasPvt>();
+    dryGas.setNumRegions(numRegions);
+
+    auto waterPvt = std::make_shared<WaterPvt>();
+    waterPvt->setApproach(Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt);
+    auto& water = waterPvt->template getRealPvt<Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt>();
+    water.setNumRegions(numRegions);
+
+    std::vector<Scalar> p = {1e5, 1e6, 1e7, 1e8};
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        Scalar rhoOil = 850.0 + 10*regionIdx;
+        deadOil.setReferenceDensities(regionIdx, rhoOil, 1.0, 1000.0);
+        deadOil.setInverseOilFormationVolumeFactor(regionIdx,
+                                                   TabulatedFunction(p, std::vector<Scalar>{0.90, 0.91, 0.92, 0.95}));
+        deadOil.setOilViscosity(regionIdx,
+                                TabulatedFunction(p, std::vector<Scalar>{1e-3, 1.1e-3, 1.2e-3, 1.5e-3}));
+
+        dryGas.setReferenceDensities(regionIdx, rhoOil, 1.0 + 0.1*regionIdx, 1000.0);
+        dryGas.setGasFormationVolumeFactor(regionIdx, {{1e5, 1.0}, {1e6, 0.1}, {1e7, 0.01}, {1e8, 0.005}});
+        dryGas.setGasViscosity(regionIdx,
+                               TabulatedFunction(p, std::vector<Scalar>{1e-5, 1.1e-5, 1.5e-5, 2e-5}));
+
+        water.setReferenceDensities(regionIdx, rhoOil, 1.0, 1000.0 + regionIdx);
+        water.setReferencePressure(regionIdx, 1e5);
+        water.setReferenceFormationVolumeFactor(regionIdx, 1.01);
+        water.setCompressibility(regionIdx, 4e-10);
+        water.setViscosity(regionIdx, 0.5e-3);
+
+        FluidSystem::setReferenceDensities(rhoOil, 1000.0 + regionIdx, 1.0 + 0.1*regionIdx, regionIdx);
+    }
+
+    oilPvt->initEnd();
+    gasPvt->initEnd();
+    waterPvt->initEnd();
+
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    FluidSystem::initEnd();
+}
+
+template <class Scalar, class Evaluation>
+void testApi()
+{
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Opm::BlackOilFluidStateArray<Evaluation, FluidSystem> FluidStateArray;
+
+    FluidStateArray fluidStates(10);
+    typename FluidStateArray::Cell fs = fluidStates[3];
+    checkFluidState<Evaluation>(fs);
+
+    const FluidStateArray& constFluidStates = fluidStates;
+    typename FluidStateArray::ConstCell constFs = constFluidStates[3];
+    checkFluidState<Evaluation>(constFs);
+}
+
+template <class Scalar>
+void testCells()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Opm::BlackOilFluidStateArray<Evaluation, FluidSystem, /*enableTemperature=*/true> FluidStateArray;
+    typedef typename FluidStateArray::FluidState FluidState;
+
+    enum { numPhases = FluidSystem::numPhases };
+
+    initFluidSystem<FluidSystem>(/*numRegions=*/3);
+
+    const unsigned numCells = 100;
+    FluidStateArray fluidStates(numCells);
+    std::vector<FluidState> reference(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        FluidState& refFs = reference[cellIdx];
+        refFs.setPvtRegionIndex(cellIdx % 3);
+        refFs.setTemperature(300.0 + cellIdx);
+        refFs.setRs(0.0);
+        refFs.setRv(0.0);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            refFs.setPressure(phaseIdx, Evaluation::createVariable(1e6 + 1e5*cellIdx + phaseIdx, 0));
+            refFs.setSaturation(phaseIdx, Evaluation::createVariable(1.0/numPhases, 1));
+            refFs.setDensity(phaseIdx, 0.0);
+            refFs.setInvB(phaseIdx, 0.0);
+        }
+        fluidStates.assign(cellIdx, refFs);
+    }
+
+    // let the fluid system work on the cells of the container and on the fluid states
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        auto fs = fluidStates[cellIdx];
+        FluidState& refFs = reference[cellIdx];
+        unsigned regionIdx = fs.pvtRegionIndex();
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fs.setInvB(phaseIdx, FluidSystem::template inverseFormationVolumeFactor<decltype(fs), Evaluation>(fs, phaseIdx, regionIdx));
+            fs.setDensity(phaseIdx, FluidSystem::template density<decltype(fs), Evaluation>(fs, phaseIdx, regionIdx));
+            refFs.setInvB(phaseIdx, FluidSystem::template inverseFormationVolumeFactor<FluidState, Evaluation>(refFs, phaseIdx, regionIdx));
+            refFs.setDensity(phaseIdx, FluidSystem::template density<FluidState, Evaluation>(refFs, phaseIdx, regionIdx));
+        }
+    }
+
+    const FluidStateArray& constFluidStates = fluidStates;
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        auto fs = constFluidStates[cellIdx];
+        const FluidState& refFs = reference[cellIdx];
+        check(fs.pvtRegionIndex() == refFs.pvtRegionIndex(), "PVT region index");
+        check(fs.temperature(0) == refFs.temperature(0), "Temperature");
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            check(fs.pressure(phaseIdx) == refFs.pressure(phaseIdx), "Pressure");
+            check(fs.saturation(phaseIdx) == refFs.saturation(phaseIdx), "Saturation");
+            check(fs.invB(phaseIdx) == refFs.invB(phaseIdx), "Inverse formation volume factor");
+            check(fs.density(phaseIdx) == refFs.density(phaseIdx), "Density");
+            check(fs.viscosity(phaseIdx) == refFs.viscosity(phaseIdx), "Viscosity");
+            check(fs.molarDensity(phaseIdx) == refFs.molarDensity(phaseIdx), "Molar density");
+            for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+                check(fs.moleFraction(phaseIdx, compIdx) == refFs.moleFraction(phaseIdx, compIdx), "Mole fraction");
+        }
+
+        // the unit-stride arrays must see the same values
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            check(constFluidStates.invBArray(phaseIdx)[cellIdx] == refFs.invB(phaseIdx), "Array of inverse formation volume factors");
+
+        // converting back to a fluid state must not lose anything
+        FluidState fs2 = constFluidStates.fluidState(cellIdx);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            check(fs2.density(phaseIdx) == refFs.density(phaseIdx), "Density after conversion");
+    }
+
+    // a copy of a cell object refers to the same cell
+    auto fs = fluidStates[5];
+    auto fsCopy = fs;
+    fsCopy.setPressure(FluidSystem::oilPhaseIdx, 42.0);
+    check(fluidStates.pressureArray(FluidSystem::oilPhaseIdx)[5] == 42.0, "Copies must refer to the same cell");
+
+    // resizing must keep the existing values
+    fluidStates.resize(2*numCells);
+    check(fluidStates.numCells() == 2*numCells, "Number of cells after resizing");
+    check(fluidStates[7].density(FluidSystem::waterPhaseIdx) == reference[7].density(FluidSystem::waterPhaseIdx),
+          "Values must be kept when resizing");
+}
+
+int main()
+{
+    testApi<double, double>();
+    testApi<float, float>();
+    testApi<float, Opm::DenseAd::Evaluation<float, 2> >();
+
+    testCells<double>();
+    testCells<float>();
+
+    return 0;
+}
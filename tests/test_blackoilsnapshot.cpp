@@ -0,0 +1,312 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the binary snapshots of the black-oil fluid system.
+ *
+ * The fluid system is set up programmatically, written to a snapshot, reinitialized
+ * differently and then restored from the snapshot. The restored PVT objects must
+ * compare equal to the original ones. This is done for piecewise linear as well as for
+ * compressed PVT tables, see BlackOilFluidSystem::compressTables().
+ */
+#include "config.h"
+
+#include <opm/material/common/BinarySerializer.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidstates/BlackOilFluidState.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+template <class Exception, class Fn>
+bool throws(Fn fn)
+{
+    try {
+        fn();
+    }
+    catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+void testSerializer()
+{
+    int i = 42;
+    double d = 3.5;
+    bool b = true;
+    std::string s = "opm";
+    std::vector<double> v = {1.0, 2.0, 3.0};
+    std::vector<bool> vb = {true, false, true};
+    std::array<short, 3> a = {{1, -2, 3}};
+    std::vector<std::tuple<float, double, int> > vt = {std::make_tuple(1.0f, 2.0, 3)};
+    Opm::Tabulated1DFunction<double> f(std::vector<double>{0.0, 1.0, 2.0},
+                                       std::vector<double>{1.0, 4.0, 9.0},
+                                       /*sortInputs=*/false);
+
+    Opm::BinarySerializer out;
+    out(i);
+    out(d);
+    out(b);
+    out(s);
+    out(v);
+    out(vb);
+    out(a);
+    out(vt);
+    out(f);
+
+    int i2 = 0;
+    double d2 = 0.0;
+    bool b2 = false;
+    std::string s2;
+    std::vector<double> v2;
+    std::vector<bool> vb2;
+    std::array<short, 3> a2 = {{0, 0, 0}};
+    std::vector<std::tuple<float, double, int> > vt2;
+    Opm::Tabulated1DFunction<double> f2;
+
+    Opm::BinarySerializer in(out.buffer());
+    in(i2);
+    in(d2);
+    in(b2);
+    in(s2);
+    in(v2);
+    in(vb2);
+    in(a2);
+    in(vt2);
+    in(f2);
+
+    if (i2 != i || d2 != d || b2 != b || s2 != s || v2 != v || vb2 != vb
+        || a2 != a || vt2 != vt || !(f2 == f))
+        throw std::logic_error("Round trip of the serializer failed");
+    if (in.remaining() != 0)
+        throw std::logic_error("The serializer did not consume all data");
+
+    // reading past the end of the data must be detected
+    std::vector<char> truncated(out.buffer().begin(), out.buffer().end() - 1);
+    if (!throws<std::runtime_error>([&truncated]() {
+                Opm::BinarySerializer in2(truncated);
+                int i3;
+                double d3;
+                bool b3;
+                std::string s3;
+                std::vector<double> v3;
+                std::vector<bool> vb3;
+                std::array<short, 3> a3;
+                std::vector<std::tuple<float, double, int> > vt3;
+                Opm::Tabulated1DFunction<double> f3;
+                in2(i3); in2(d3); in2(b3); in2(s3); in2(v3); in2(vb3); in2(a3); in2(vt3); in2(f3);
+            }))
+        throw std::logic_error("Reading truncated data must fail");
+}
+
+template <class FluidSystem>
+void initFluidSystem(unsigned numRegions, typename FluidSystem::Scalar rhoOil)
+{
+    typedef typename FluidSystem::Scalar Scalar;
+    typedef typename FluidSystem::OilPvt OilPvt;
+    typedef typename FluidSystem::GasPvt GasPvt;
+    typedef typename FluidSystem::WaterPvt WaterPvt;
+    typedef Opm::Tabulated1DFunction<Scalar> TabulatedFunction;
+
+    FluidSystem::initBegin(numRegions);
+    FluidSystem::setEnableDissolvedGas(false);
+    FluidSystem::setEnableVaporizedOil(false);
+
+    auto oilPvt = std::make_shared<OilPvt>();
+    oilPvt->setApproach(Opm::OilPvtApproach::DeadOilPvt);
+    auto& deadOil = oilPvt->template getRealPvt<Opm::OilPvtApproach::DeadOilPvt>();
+    deadOil.setNumRegions(numRegions);
+
+    auto gasPvt = std::make_shared<GasPvt>();
+    gasPvt->setApproach(Opm::GasPvtApproach::DryGasPvt);
+    auto& dryGas = gasPvt->template getRealPvt<Opm::GasPvtApproach::DryGasPvt>();
+    dryGas.setNumRegions(numRegions);
+
+    auto waterPvt = std::make_shared<WaterPvt>();
+    waterPvt->setApproach(Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt);
+    auto& water = waterPvt->template getRealPvt<Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt>();
+    water.setNumRegions(numRegions);
+
+    std::vector<Scalar> p = {1e5, 1e6, 1e7, 1e8};
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        Scalar rhoRegion = rhoOil + 10*regionIdx;
+        deadOil.setReferenceDensities(regionIdx, rhoRegion, 1.0, 1000.0);
+        deadOil.setInverseOilFormationVolumeFactor(regionIdx,
+                                                   TabulatedFunction(p, std::vector<Scalar>{0.90, 0.91, 0.92, 0.95}));
+        deadOil.setOilViscosity(regionIdx,
+                                TabulatedFunction(p, std::vector<Scalar>{1e-3, 1.1e-3, 1.2e-3, 1.5e-3}));
+
+        dryGas.setReferenceDensities(regionIdx, rhoRegion, 1.0 + 0.1*regionIdx, 1000.0);
+        dryGas.setGasFormationVolumeFactor(regionIdx, {{1e5, 1.0}, {1e6, 0.1}, {1e7, 0.01}, {1e8, 0.005}});
+        dryGas.setGasViscosity(regionIdx,
+                               TabulatedFunction(p, std::vector<Scalar>{1e-5, 1.1e-5, 1.5e-5, 2e-5}));
+
+        water.setReferenceDensities(regionIdx, rhoRegion, 1.0, 1000.0 + regionIdx);
+        water.setReferencePressure(regionIdx, 1e5);
+        water.setReferenceFormationVolumeFactor(regionIdx, 1.01);
+        water.setCompressibility(regionIdx, 4e-10);
+        water.setViscosity(regionIdx, 0.5e-3);
+
+        FluidSystem::setReferenceDensities(rhoRegion,
+                                           1000.0 + regionIdx,
+                                           1.0 + 0.1*regionIdx,
+                                           regionIdx);
+    }
+
+    oilPvt->initEnd();
+    gasPvt->initEnd();
+    waterPvt->initEnd();
+
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    FluidSystem::initEnd();
+}
+
+template <class Scalar>
+void testSnapshot(bool compressTables)
+{
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef typename FluidSystem::OilPvt OilPvt;
+    typedef typename FluidSystem::GasPvt GasPvt;
+    typedef typename FluidSystem::WaterPvt WaterPvt;
+
+    initFluidSystem<FluidSystem>(/*numRegions=*/3, /*rhoOil=*/850.0);
+    FluidSystem::setEnableDiffusion(true);
+    FluidSystem::setReservoirTemperature(350.0);
+    if (compressTables) {
+        // the slopes of the splines must be part of the snapshot
+        FluidSystem::compressTables(1e-3);
+        const auto& deadOil = FluidSystem::oilPvt().template getRealPvt<Opm::OilPvtApproach::DeadOilPvt>();
+        const auto& dryGas = FluidSystem::gasPvt().template getRealPvt<Opm::GasPvtApproach::DryGasPvt>();
+        for (unsigned regionIdx = 0; regionIdx < FluidSystem::numRegions(); ++regionIdx)
+            if (!deadOil.inverseOilB()[regionIdx].isCompressed()
+                || !deadOil.oilMu()[regionIdx].isCompressed()
+                || !dryGas.inverseGasB()[regionIdx].isCompressed()
+                || !dryGas.gasMu()[regionIdx].isCompressed())
+                throw std::logic_error("The tables of the fluid system must be compressed");
+    }
+
+    // keep copies of the original state
+    OilPvt oilPvt(FluidSystem::oilPvt());
+    GasPvt gasPvt(FluidSystem::gasPvt());
+    WaterPvt waterPvt(FluidSystem::waterPvt());
+    std::vector<Scalar> referenceDensities;
+    std::vector<Scalar> molarMasses;
+    for (unsigned regionIdx = 0; regionIdx < FluidSystem::numRegions(); ++regionIdx) {
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            referenceDensities.push_back(FluidSystem::referenceDensity(phaseIdx, regionIdx));
+        for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+            molarMasses.push_back(FluidSystem::molarMass(compIdx, regionIdx));
+    }
+
+    Opm::BlackOilFluidState<Scalar, FluidSystem, /*enableTemperature=*/true> fluidState;
+    fluidState.setPvtRegionIndex(2);
+    fluidState.setTemperature(350.0);
+    fluidState.setRs(0.0);
+    fluidState.setRv(0.0);
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        fluidState.setPressure(phaseIdx, 2e7);
+    std::vector<Scalar> densities;
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        densities.push_back(FluidSystem::density(fluidState, phaseIdx, /*regionIdx=*/2));
+
+    std::stringstream snapshot;
+    FluidSystem::writeSnapshot(snapshot);
+    const std::string data = snapshot.str();
+
+    // change everything which is stored in the snapshot
+    initFluidSystem<FluidSystem>(/*numRegions=*/1, /*rhoOil=*/700.0);
+    FluidSystem::setEnableDissolvedGas(true);
+
+    std::stringstream is(data);
+    FluidSystem::readSnapshot(is);
+
+    if (!FluidSystem::isInitialized())
+        throw std::logic_error("The fluid system must be initialized after reading a snapshot");
+    if (FluidSystem::numRegions() != 3)
+        throw std::logic_error("Wrong number of PVT regions after reading a snapshot");
+    if (FluidSystem::enableDissolvedGas() || !FluidSystem::enableDiffusion())
+        throw std::logic_error("Wrong flags after reading a snapshot");
+    if (FluidSystem::reservoirTemperature() != 350.0)
+        throw std::logic_error("Wrong reservoir temperature after reading a snapshot");
+    if (!(FluidSystem::oilPvt() == oilPvt)
+        || !(FluidSystem::gasPvt() == gasPvt)
+        || !(FluidSystem::waterPvt() == waterPvt))
+        throw std::logic_error("The PVT objects differ after reading a snapshot");
+
+    unsigned i = 0;
+    unsigned j = 0;
+    for (unsigned regionIdx = 0; regionIdx < FluidSystem::numRegions(); ++regionIdx) {
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            if (FluidSystem::referenceDensity(phaseIdx, regionIdx) != referenceDensities[i++])
+                throw std::logic_error("The reference densities differ after reading a snapshot");
+        for (unsigned compIdx = 0; compIdx < FluidSystem::numComponents; ++compIdx)
+            if (FluidSystem::molarMass(compIdx, regionIdx) != molarMasses[j++])
+                throw std::logic_error("The molar masses differ after reading a snapshot");
+    }
+
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        if (FluidSystem::density(fluidState, phaseIdx, /*regionIdx=*/2) != densities[phaseIdx])
+            throw std::logic_error("The densities differ after reading a snapshot");
+
+    // snapshots written with another version, scalar type or truncated ones must be
+    // rejected
+    std::string wrongVersion(data);
+    wrongVersion[4] ^= 0x7f;
+    std::stringstream is2(wrongVersion);
+    if (!throws<std::runtime_error>([&is2]() { FluidSystem::readSnapshot(is2); }))
+        throw std::logic_error("Reading a snapshot with a different version must fail");
+
+    std::stringstream is3(data.substr(0, data.size() - 1));
+    if (!throws<std::runtime_error>([&is3]() { FluidSystem::readSnapshot(is3); }))
+        throw std::logic_error("Reading a truncated snapshot must fail");
+
+    typedef Opm::BlackOilFluidSystem<typename std::conditional<std::is_same<Scalar, double>::value, float, double>::type> OtherFluidSystem;
+    std::stringstream is4(data);
+    if (!throws<std::runtime_error>([&is4]() { OtherFluidSystem::readSnapshot(is4); }))
+        throw std::logic_error("Reading a snapshot for a different scalar type must fail");
+}
+
+int main()
+{
+    testSerializer();
+    testSnapshot<double>(/*compressTables=*/false);
+    testSnapshot<float>(/*compressTables=*/false);
+    testSnapshot<double>(/*compressTables=*/true);
+    testSnapshot<float>(/*compressTables=*/true);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the memoization of per-cell properties.
+ */
+#include "config.h"
+
+#include <opm/material/common/CellPropertyCache.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef Opm::DenseAd::Evaluation<double, 2> Evaluation;
+typedef Opm::CellPropertyCache<Evaluation, 2, 2, /*enableStatistics=*/true> Cache;
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+int main()
+{
+    const unsigned numCells = 10;
+    std::vector<double> x = { 0.0, 1e5, 2e5, 5e5 };
+    std::vector<double> y = { 1.0, 0.9, 0.85, 0.8 };
+    Opm::Tabulated1DFunction<double> table(x, y);
+
+    std::vector<Evaluation> p(numCells);
+    std::vector<Evaluation> S(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        p[cellIdx] = Evaluation::createVariable(1e5 + 1e4*cellIdx, 0);
+        S[cellIdx] = Evaluation::createVariable(0.1*cellIdx, 1);
+    }
+
+    unsigned numComputations = 0;
+    auto compute = [&](unsigned cellIdx) {
+        return [&, cellIdx](Cache::Outputs& result) {
+            ++numComputations;
+            result[0] = table.eval(p[cellIdx]);
+            result[1] = result[0]*S[cellIdx]*S[cellIdx];
+        };
+    };
+
+    Cache cache(numCells);
+    auto updateAll = [&](unsigned regionIdx, bool exact = true) {
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const auto& out = cache.get(cellIdx, regionIdx, {{p[cellIdx], S[cellIdx]}}, compute(cellIdx));
+            const Evaluation expected = table.eval(p[cellIdx])*S[cellIdx]*S[cellIdx];
+            check(!exact || out[1] == expected, "The cached outputs must be identical to the computed ones");
+        }
+    };
+
+    // the first update computes everything, the second one nothing
+    updateAll(0);
+    check(numComputations == numCells && cache.numMisses() == numCells, "First update");
+    updateAll(0);
+    check(numComputations == numCells && cache.numHits() == numCells, "Second update");
+    check(cache.hitRate() == 0.5, "Hit rate");
+
+    // changing the value or the derivatives of an input causes a recomputation
+    p[3] += 1.0;
+    S[4] = Evaluation::createVariable(S[4].value(), 0);
+    updateAll(0);
+    check(numComputations == numCells + 2, "Changed inputs must be recomputed");
+
+    // ... as does changing the region
+    updateAll(1);
+    check(numComputations == 2*numCells + 2, "Changed regions must be recomputed");
+
+    cache.invalidate(7);
+    updateAll(1);
+    check(numComputations == 2*numCells + 3, "Invalidated cells must be recomputed");
+
+    // small changes are ignored if a tolerance is given
+    cache.setTolerance(1e-6);
+    p[5] += 1e-8;
+    updateAll(1, /*exact=*/false);
+    check(numComputations == 2*numCells + 3, "Changes below the tolerance must not be recomputed");
+    cache.setTolerance(0.0);
+
+    cache.invalidateAll();
+    cache.resetStatistics();
+    updateAll(1);
+    check(cache.numHits() == 0 && cache.numMisses() == numCells, "All cells must be recomputed");
+
+    // without statistics, the cache must not carry any counters
+    typedef Opm::CellPropertyCache<Evaluation, 2, 2> PlainCache;
+    static_assert(sizeof(PlainCache) < sizeof(Cache), "Disabled statistics must be compiled out");
+    PlainCache plainCache(numCells);
+    numComputations = 0;
+    for (unsigned i = 0; i < 2; ++i)
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+            plainCache.get(cellIdx, 0, {{p[cellIdx], S[cellIdx]}}, compute(cellIdx));
+    check(numComputations == numCells, "The cache without statistics must skip unchanged cells");
+
+    return 0;
+}
@@ -34,7 +34,7 @@
 #endif
 
 //#include <opm/material/fluidsystems/blackoilpvt/Co2GasPvt.hpp>
-//#include <opm/material/fluidsystems/blackoilpvt/BrineCo2Pvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/BrineCo2Pvt.hpp>
 
 #include <opm/material/fluidsystems/blackoilpvt/GasPvtMultiplexer.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/OilPvtMultiplexer.hpp>
@@ -163,6 +163,50 @@ void ensurePvtApi(const BrinePvt& brinePvt, const Co2Pvt& co2Pvt)
     }
 }
 
+// each PVT region must behave like a single region PVT object of the same salinity,
+// independently of the global salinity of the brine component
+template <class Scalar>
+void testSalinityRegions()
+{
+    typedef Opm::BrineCo2Pvt<Scalar> BrinePvt;
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+
+    BrinePvt multiRegionPvt({1000.0, 1000.0}, {1.8, 1.8}, {0.05, 0.2});
+    std::vector<BrinePvt> singleRegionPvts = {
+        BrinePvt({1000.0}, {1.8}, {0.05}),
+        BrinePvt({1000.0}, {1.8}, {0.2})
+    };
+
+    const Scalar oldSalinity = BrinePvt::Brine::salinity;
+    BrinePvt::Brine::salinity = 0.0;
+    for (unsigned regionIdx = 0; regionIdx < 2; ++regionIdx) {
+        const auto& pvt = singleRegionPvts[regionIdx];
+        for (Scalar T = 300.0; T < 380.0; T += 20.0) {
+            for (Scalar p = 1e6; p < 3e7; p *= 2) {
+                Evaluation temperature = Evaluation::createVariable(T, 0);
+                Evaluation pressure = Evaluation::createVariable(p, 1);
+                Evaluation Rs = 10.0;
+                if (multiRegionPvt.inverseFormationVolumeFactor(regionIdx, temperature, pressure, Rs)
+                    != pvt.inverseFormationVolumeFactor(0, temperature, pressure, Rs)
+                    || multiRegionPvt.viscosity(regionIdx, temperature, pressure, Rs)
+                    != pvt.viscosity(0, temperature, pressure, Rs)
+                    || multiRegionPvt.internalEnergy(regionIdx, temperature, pressure, Rs)
+                    != pvt.internalEnergy(0, temperature, pressure, Rs)
+                    || multiRegionPvt.saturatedGasDissolutionFactor(regionIdx, temperature, pressure)
+                    != pvt.saturatedGasDissolutionFactor(0, temperature, pressure))
+                    throw std::logic_error("The PVT properties of a region depend on the salinity of other regions");
+            }
+        }
+    }
+
+    if (multiRegionPvt.inverseFormationVolumeFactor(0, Scalar(350.0), Scalar(1e7), Scalar(10.0))
+        == multiRegionPvt.inverseFormationVolumeFactor(1, Scalar(350.0), Scalar(1e7), Scalar(10.0)))
+        throw std::logic_error("The salinity of a region is not considered");
+    if (BrinePvt::Brine::salinity != 0.0)
+        throw std::logic_error("The global salinity of brine must not be modified");
+    BrinePvt::Brine::salinity = oldSalinity;
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -182,6 +226,8 @@ inline void testAll()
     typedef Opm::DenseAd::Evaluation<Scalar, 1> FooEval;
     ensurePvtApi<Scalar>(brinePvt, co2Pvt);
     ensurePvtApi<FooEval>(brinePvt, co2Pvt);
+
+    testSalinityRegions<Scalar>();
 }
 
 
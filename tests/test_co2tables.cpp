@@ -0,0 +1,234 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the tabulated viscosity and heat capacity of CO2.
+ *
+ * The tables are compared to the correlation of Fenghour and Vesovic and to the
+ * temperature derivative of the enthalpy table. Away from the cells which contain the
+ * phase boundary of CO2, 99 percent of the tabulated viscosities must be within a
+ * relative tolerance of 2e-4 of the correlation and all of them within 1e-2.
+ */
+#include "config.h"
+
+#include <opm/material/components/CO2.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+namespace Opm {
+namespace CO2TablesTest {
+#include <opm/material/components/co2tables.inc>
+}}
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+typedef Opm::UniformTabulated2DFunction<double> Table;
+
+// the CO2 tables resampled to a bi-cubically interpolated coarse grid
+struct CoarseCO2Tables
+{
+    static const Table tabulatedEnthalpy;
+    static const Table tabulatedDensity;
+    static constexpr double brineSalinity = Opm::CO2TablesTest::CO2Tables::brineSalinity;
+};
+
+const Table CoarseCO2Tables::tabulatedEnthalpy =
+    Opm::CO2TablesTest::CO2Tables::tabulatedEnthalpy.resampled(50, 125);
+const Table CoarseCO2Tables::tabulatedDensity =
+    Opm::CO2TablesTest::CO2Tables::tabulatedDensity.resampled(50, 125);
+
+// tables which reach below the temperature at which the viscosity correlation is
+// regularized. the density is the one of an ideal gas
+Table makeIdealGasDensity()
+{
+    Table density(250.0, 400.0, 31, 1e5, 1e7, 21);
+    for (unsigned i = 0; i < density.numX(); ++i)
+        for (unsigned j = 0; j < density.numY(); ++j)
+            density.setSamplePoint(i, j, density.jToY(j)*44e-3/(8.314*density.iToX(i)));
+    return density;
+}
+
+struct ColdCO2Tables
+{
+    static const Table tabulatedEnthalpy;
+    static const Table tabulatedDensity;
+    static constexpr double brineSalinity = Opm::CO2TablesTest::CO2Tables::brineSalinity;
+};
+
+const Table ColdCO2Tables::tabulatedEnthalpy = Opm::CO2TablesTest::CO2Tables::tabulatedEnthalpy;
+const Table ColdCO2Tables::tabulatedDensity = makeIdealGasDensity();
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+// returns true if the density changes a lot in the vicinity of a table cell, i.e., if
+// the cell is close to the phase boundary
+bool nearPhaseBoundary(const Table& density, unsigned i, unsigned j)
+{
+    unsigned iLow = i > 0 ? i - 1 : 0;
+    unsigned iHigh = std::min(i + 2, density.numX() - 1);
+    double rhoMin = 1e100;
+    double rhoMax = 0.0;
+    for (unsigned k = iLow; k <= iHigh; ++k) {
+        for (unsigned l = j; l <= j + 1; ++l) {
+            rhoMin = std::min(rhoMin, density.getSamplePoint(k, l));
+            rhoMax = std::max(rhoMax, density.getSamplePoint(k, l));
+        }
+    }
+    return rhoMax > 1.5*rhoMin;
+}
+
+template <class Scalar, class CO2Tables>
+void testSamplingPoints()
+{
+    typedef Opm::CO2<Scalar, CO2Tables> CO2;
+    const auto& density = CO2Tables::tabulatedDensity;
+    const auto& viscosity = CO2::tabulatedGasViscosity();
+    const auto& heatCapacity = CO2::tabulatedGasHeatCapacity();
+
+    check(viscosity.numX() == density.numX() && viscosity.numY() == density.numY(),
+          "The viscosity must be tabulated on the grid of the density");
+    check((viscosity.interpolationType() == Opm::UniformTabulated2DFunction<Scalar>::InterpolationType::Bicubic)
+          == (density.interpolationType() == Table::InterpolationType::Bicubic),
+          "The viscosity must be interpolated like the density");
+    check((heatCapacity.interpolationType() == Opm::UniformTabulated2DFunction<Scalar>::InterpolationType::Bicubic)
+          == (density.interpolationType() == Table::InterpolationType::Bicubic),
+          "The heat capacity must be interpolated like the enthalpy");
+
+    // the tables are exact at the interior sampling points
+    for (unsigned i = 1; i + 1 < density.numX(); i += 3) {
+        Scalar T = density.iToX(i);
+        for (unsigned j = 1; j + 1 < density.numY(); j += 7) {
+            Scalar p = density.jToY(j);
+            Scalar mu = viscosity.getSamplePoint(i, j);
+            Scalar muRef = CO2::gasViscosityCorrelation(T, p);
+            check(std::abs(mu - muRef) <= 1e-5*muRef,
+                  "The tabulated viscosity must be exact at the sampling points");
+
+            Scalar cp = heatCapacity.getSamplePoint(i, j);
+            Scalar cpRef = CO2::gasHeatCapacityFromEnthalpy(T, p);
+            // for bi-cubic enthalpy tables, the derivative of the interpolation at the
+            // sampling points is not the central difference
+            if (std::is_same<Scalar, double>::value
+                && density.interpolationType() == Table::InterpolationType::Bilinear)
+                check(std::abs(cp - cpRef) <= 1e-5*std::abs(cpRef),
+                      "The tabulated heat capacity must be exact at the sampling points");
+        }
+    }
+}
+
+template <class CO2Tables>
+void testAccuracy()
+{
+    typedef Opm::CO2<double, CO2Tables> CO2;
+    const auto& density = CO2Tables::tabulatedDensity;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> TDist(density.xMin(), density.xMax());
+    std::uniform_real_distribution<double> pDist(density.yMin(), density.yMax());
+    std::vector<double> errors;
+    for (unsigned k = 0; k < 20000; ++k) {
+        double T = TDist(rng);
+        double p = pDist(rng);
+        unsigned i = std::min(static_cast<unsigned>(density.xToI(T)), density.numX() - 2);
+        unsigned j = std::min(static_cast<unsigned>(density.yToJ(p)), density.numY() - 2);
+        if (nearPhaseBoundary(density, i, j))
+            continue;
+
+        double mu = CO2::gasViscosity(T, p);
+        double muRef = CO2::gasViscosityCorrelation(T, p);
+        errors.push_back(std::abs(mu - muRef)/muRef);
+    }
+    std::sort(errors.begin(), errors.end());
+
+    double p99 = errors[errors.size()*99/100];
+    std::cout << "relative error of the tabulated CO2 viscosity: 99th percentile " << p99
+              << ", max " << errors.back() << "\n";
+    check(p99 <= 2e-4, "99 percent of the tabulated viscosities must be within the tolerance");
+    check(errors.back() <= 1e-2, "All tabulated viscosities must be within the tolerance");
+}
+
+void testEvaluations()
+{
+    typedef Opm::CO2<double, Opm::CO2TablesTest::CO2Tables> CO2;
+    typedef Opm::DenseAd::Evaluation<double, 2> Eval;
+
+    // the derivatives are the ones of the interpolation
+    double T0 = 330.3;
+    double p0 = 2.3e7;
+    Eval T = Eval::createVariable(T0, 0);
+    Eval p = Eval::createVariable(p0, 1);
+    const Eval& mu = CO2::gasViscosity(T, p);
+    const Eval& cp = CO2::gasHeatCapacity(T, p);
+    check(mu.value() == CO2::gasViscosity(T0, p0) && cp.value() == CO2::gasHeatCapacity(T0, p0),
+          "The values of Evaluations must be the ones of scalars");
+
+    double dT = 1e-3;
+    double dp = 1.0;
+    double dmudT = (CO2::gasViscosity(T0 + dT, p0) - CO2::gasViscosity(T0 - dT, p0))/(2*dT);
+    double dmudp = (CO2::gasViscosity(T0, p0 + dp) - CO2::gasViscosity(T0, p0 - dp))/(2*dp);
+    double dcpdT = (CO2::gasHeatCapacity(T0 + dT, p0) - CO2::gasHeatCapacity(T0 - dT, p0))/(2*dT);
+    check(std::abs(mu.derivative(0) - dmudT) <= 1e-5*std::abs(dmudT), "Temperature derivative of the viscosity");
+    check(std::abs(mu.derivative(1) - dmudp) <= 1e-5*std::abs(dmudp), "Pressure derivative of the viscosity");
+    check(std::abs(cp.derivative(0) - dcpdT) <= 1e-5*std::abs(dcpdT), "Temperature derivative of the heat capacity");
+
+    // the viscosity is close to the one of the correlation, including its derivatives
+    const Eval& muRef = CO2::gasViscosityCorrelation(T, p);
+    check(std::abs(mu.value() - muRef.value()) <= 1e-3*muRef.value(), "Value of the viscosity");
+    check(std::abs(mu.derivative(1) - muRef.derivative(1)) <= 1e-2*std::abs(muRef.derivative(1)),
+          "Pressure derivative of the viscosity compared to the correlation");
+
+    // below 275 K, the correlation is evaluated at 275 K, including the density
+    typedef Opm::CO2<double, ColdCO2Tables> ColdCO2;
+    Eval TCold = Eval::createVariable(260.0, 0);
+    Eval pCold = Eval::createVariable(5e6, 1);
+    const Eval& muCold = ColdCO2::gasViscosityCorrelation(TCold, pCold);
+    const Eval& muClamped = ColdCO2::gasViscosityCorrelation(Eval(275.0), pCold);
+    check(muCold.value() == muClamped.value() && muCold.derivative(0) == 0.0
+          && muCold.derivative(1) == muClamped.derivative(1),
+          "The viscosity correlation must be regularized below 275 K");
+    check(std::abs(ColdCO2::gasViscosity(260.0, 5e6) - muClamped.value()) <= 1e-3*muClamped.value(),
+          "The viscosity table must be regularized below 275 K");
+}
+
+int main()
+{
+    testSamplingPoints<double, Opm::CO2TablesTest::CO2Tables>();
+    testSamplingPoints<float, Opm::CO2TablesTest::CO2Tables>();
+    testSamplingPoints<double, CoarseCO2Tables>();
+    testAccuracy<Opm::CO2TablesTest::CO2Tables>();
+    testEvaluations();
+
+    return 0;
+}
@@ -93,6 +93,43 @@ void testSimpleH2O()
     }
 }
 
+// the properties of brine must be the same if the salinity is specified explicitly or
+// via the global salinity, and the explicit variant must not depend on the latter
+template <class Scalar, class Evaluation>
+void testBrineSalinity()
+{
+    typedef Opm::SimpleHuDuanH2O<Scalar> H2O;
+    typedef Opm::Brine<Scalar, H2O> Brine;
+    typedef typename Brine::SalinityTerms SalinityTerms;
+    typedef Opm::MathToolbox<Evaluation> EvalToolbox;
+
+    const Scalar oldSalinity = Brine::salinity;
+    for (Scalar S : {0.0, 0.05, 0.2}) {
+        const SalinityTerms terms(S);
+        Brine::salinity = S;
+        for (int iT = 0; iT < 10; ++iT) {
+            Evaluation T = 290.0 + 15*iT;
+            for (int iP = 0; iP < 10; ++iP) {
+                Evaluation p = 1e5 + 5e6*iP;
+                if (!EvalToolbox::isSame(Brine::liquidDensity(T, p), Brine::liquidDensity(T, p, terms), 1e-10)
+                    || !EvalToolbox::isSame(Brine::liquidEnthalpy(T, p), Brine::liquidEnthalpy(T, p, terms), 1e-10)
+                    || !EvalToolbox::isSame(Brine::liquidViscosity(T, p), Brine::liquidViscosity(T, p, terms), 1e-10))
+                    throw std::logic_error("oops: the brine properties for an explicit salinity differ from the global ones");
+            }
+        }
+        if (Brine::molarMass() != Brine::molarMass(terms))
+            throw std::logic_error("oops: the molar mass of brine for an explicit salinity differs from the global one");
+    }
+
+    Brine::salinity = 0.1;
+    const SalinityTerms terms(0.2);
+    Evaluation rho = Brine::liquidDensity(Evaluation(300.0), Evaluation(1e7), terms);
+    Brine::salinity = 0.0;
+    if (Brine::liquidDensity(Evaluation(300.0), Evaluation(1e7), terms) != rho)
+        throw std::logic_error("oops: the brine density for an explicit salinity depends on the global salinity");
+    Brine::salinity = oldSalinity;
+}
+
 template <class Scalar, class Evaluation>
 void testAllComponents()
 {
@@ -123,6 +160,8 @@ inline void testAll()
     testAllComponents<Scalar, Scalar>();
     testAllComponents<Scalar, Evaluation>();
     testSimpleH2O<Scalar, Evaluation>();
+    testBrineSalinity<Scalar, Scalar>();
+    testBrineSalinity<Scalar, Evaluation>();
 
 }
 
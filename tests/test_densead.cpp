@@ -36,6 +36,7 @@
 
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/material/densead/Math.hpp>
+#include <opm/material/common/FastMath.hpp>
 
 #include <opm/material/common/Unused.hpp>
 
@@ -54,6 +55,17 @@ struct TestEnvBase
     const Implementation& asImp_() const
     { return *static_cast<const Implementation*>(this); }
 
+    // the maximum deviation of the value of a function from the one of the standard
+    // library. the fast math approximations are only accurate to a few ulp, so they
+    // are checked by a relative tolerance.
+    static Scalar valueTolerance_(Scalar y)
+    {
+        Scalar tol = std::numeric_limits<Scalar>::epsilon()*1e2;
+        if (OPM_DENSEAD_FAST_MATH)
+            tol *= std::max<Scalar>(1.0, std::abs(y));
+        return tol;
+    }
+
     void testOperators(const Scalar tolerance)
     {
         // test the constructors of the Opm::DenseAd::Evaluation class
@@ -275,7 +287,7 @@ struct TestEnvBase
             Scalar yStar2 = classicFn(x + eps);
             Scalar yPrime = (yStar2 - yStar1)/(2*eps);
 
-            if (std::abs(y-yEval.value()) > std::numeric_limits<Scalar>::epsilon()*1e2)
+            if (std::abs(y-yEval.value()) > valueTolerance_(y))
                 throw std::logic_error("oops: value");
 
             Scalar deltaAbs = std::abs(yPrime - yEval.derivative(0));
@@ -684,10 +696,64 @@ private:
     int numDerivs_;
 };
 
+// returns the deviation of a value from a reference in units of the last place
+template <class Scalar>
+long double ulpError(Scalar value, long double reference)
+{
+    Scalar r = static_cast<Scalar>(reference);
+    long double ulp = std::nextafter(std::abs(r), std::numeric_limits<Scalar>::infinity()) - std::abs(r);
+    return std::abs(value - reference)/ulp;
+}
+
+// check the polynomial approximations against the error bounds stated in FastMath.hpp
+template <class Scalar>
+void testFastMath()
+{
+    const Scalar maxExpArg = std::log(std::numeric_limits<Scalar>::max()) - 1;
+    const int n = 100*1000;
+    for (int i = 0; i < n; ++i) {
+        Scalar x = (2*Scalar(i)/(n - 1) - 1)*maxExpArg;
+        if (ulpError(Opm::FastMath::exp(x), std::exp(static_cast<long double>(x))) > 1.5)
+            throw std::logic_error("oops: FastMath::exp("+std::to_string(x)+")");
+
+        Scalar y = std::exp(x);
+        if (ulpError(Opm::FastMath::log(y), std::log(static_cast<long double>(y))) > 1.5)
+            throw std::logic_error("oops: FastMath::log("+std::to_string(y)+")");
+
+        Scalar base = std::exp(Scalar(i)/(n - 1)*4 - 2);
+        int k = i%33 - 16;
+        if (ulpError(Opm::FastMath::pow(base, Scalar(k)),
+                     std::pow(static_cast<long double>(base), k)) > std::max(1, std::abs(k)))
+            throw std::logic_error("oops: FastMath::pow("+std::to_string(base)+", "+std::to_string(k)+")");
+        if (ulpError(Opm::FastMath::pow(base, Scalar(k + 0.5)),
+                     std::pow(static_cast<long double>(base), k + 0.5L)) > 3*(std::abs(k) + 1))
+            throw std::logic_error("oops: FastMath::pow("+std::to_string(base)+", "+std::to_string(k + 0.5)+")");
+
+        Scalar e = Scalar(i)/(n - 1)*20 - 10 + Scalar(0.1);
+        Scalar bound = Scalar(1.5)*(2 + std::abs(e*std::log(base)));
+        if (ulpError(Opm::FastMath::pow(base, e),
+                     std::pow(static_cast<long double>(base), static_cast<long double>(e))) > bound)
+            throw std::logic_error("oops: FastMath::pow("+std::to_string(base)+", "+std::to_string(e)+")");
+    }
+
+    // special arguments and results which over- or underflow
+    const Scalar inf = std::numeric_limits<Scalar>::infinity();
+    if (Opm::FastMath::exp(Scalar(-1000.0)) != 0 || Opm::FastMath::exp(inf) != inf)
+        throw std::logic_error("oops: FastMath::exp() for special arguments");
+    if (Opm::FastMath::log(Scalar(0.0)) != -inf || !std::isnan(Opm::FastMath::log(Scalar(-1.0))))
+        throw std::logic_error("oops: FastMath::log() for special arguments");
+    if (Opm::FastMath::pow(Scalar(-2.0), Scalar(3.0)) != -8 || Opm::FastMath::pow(Scalar(0.0), Scalar(0.0)) != 1)
+        throw std::logic_error("oops: FastMath::pow() for special arguments");
+}
+
 int main(int argc, char **argv)
 {
     Dune::MPIHelper::instance(argc, argv);
 
+    std::cout << "Testing the fast math approximations\n";
+    testFastMath<double>();
+    testFastMath<float>();
+
     std::cout << "Testing statically sized evaluations\n";
     std::cout << " -> Scalar == double, n = 15\n";
     StaticTestEnv<double, 15>().testAll();
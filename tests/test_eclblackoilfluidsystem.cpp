@@ -49,6 +49,7 @@
 
 #include <type_traits>
 #include <cmath>
+#include <sstream>
 
 // values of strings based on the SPE1 and NORNE cases of opm-data.
 static const char* deckString1 =
@@ -638,6 +639,26 @@ inline void testAll()
 
     FluidSystem::initFromState(eclState, schedule);
 
+    // restore the fluid system from a snapshot: the remaining checks are then done
+    // using the restored PVT objects
+    {
+        typename FluidSystem::OilPvt oilPvt(FluidSystem::oilPvt());
+        typename FluidSystem::GasPvt gasPvt(FluidSystem::gasPvt());
+        typename FluidSystem::WaterPvt waterPvt(FluidSystem::waterPvt());
+
+        std::stringstream snapshot;
+        FluidSystem::writeSnapshot(snapshot);
+        FluidSystem::initBegin(/*numPvtRegions=*/1);
+        FluidSystem::readSnapshot(snapshot);
+
+        if (!(FluidSystem::oilPvt() == oilPvt))
+            std::abort();
+        if (!(FluidSystem::gasPvt() == gasPvt))
+            std::abort();
+        if (!(FluidSystem::waterPvt() == waterPvt))
+            std::abort();
+    }
+
     // create a parameter cache
     typedef typename FluidSystem::template ParameterCache<Scalar> ParamCache;
     ParamCache paramCache(/*maxOilSat=*/0.5, /*regionIdx=*/1);
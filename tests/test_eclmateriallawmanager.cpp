@@ -36,6 +36,7 @@
 
 #include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+#include <opm/material/common/BinarySerializer.hpp>
 
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -44,6 +45,8 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <memory>
+
 // values of strings taken from the SPE1 test case1 of opm-data
 static const char* fam1DeckString =
     "RUNSPEC\n"
@@ -485,7 +488,59 @@ inline void testAll()
             if (hysterMaterialLawManager.enableHysteresis() != true)
                 throw std::logic_error("Discrepancy between the deck and the EclMaterialLawManager");
 
-
+            // the imbibition parameters are only created on the first reversal. the
+            // factories must not depend on the manager which created them, so trigger
+            // the creation on a copy whose original has already been destroyed.
+            {
+                typedef Opm::EclMultiplexerApproach Approach;
+                auto lazyMaterialLawManager =
+                    std::make_unique<Opm::EclMaterialLawManager<MaterialTraits>>();
+                lazyMaterialLawManager->initFromState(hysterEclState);
+                lazyMaterialLawManager->initParamsForElements(hysterEclState, n);
+                Opm::EclMaterialLawManager<MaterialTraits> copiedMaterialLawManager(*lazyMaterialLawManager);
+                lazyMaterialLawManager.reset();
+
+                for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                    auto& params =
+                        copiedMaterialLawManager.materialLawParams(elemIdx)
+                        .template getRealParams<Approach::EclDefaultApproach>();
+                    if (params.oilWaterParams().hasImbibitionParams()
+                        || params.gasOilParams().hasImbibitionParams())
+                        throw std::logic_error("Imbibition parameters were created before the first reversal");
+
+                    params.gasOilParams().setPcSwMdc(0.5);
+                    if (!params.gasOilParams().hasImbibitionParams())
+                        throw std::logic_error("Setting pcSwMdc did not create the imbibition parameters");
+
+                    copiedMaterialLawManager.setOilWaterHysteresisParams(2.0, 0.5, elemIdx);
+                    if (!params.oilWaterParams().hasImbibitionParams())
+                        throw std::logic_error("A reversal of krn did not create the imbibition parameters");
+
+                    // the lazily created curves must match the ones of a manager which
+                    // is still alive
+                    copiedMaterialLawManager.setGasOilHysteresisParams(0.4, 0.5, elemIdx);
+                    hysterMaterialLawManager.setOilWaterHysteresisParams(2.0, 0.5, elemIdx);
+                    hysterMaterialLawManager.setGasOilHysteresisParams(0.4, 0.5, elemIdx);
+                    for (int i = 0; i <= 100; ++ i) {
+                        FluidState fs;
+                        fs.setSaturation(waterPhaseIdx, Scalar(i)/200);
+                        fs.setSaturation(gasPhaseIdx, Scalar(100 - i)/200);
+                        fs.setSaturation(oilPhaseIdx, 0.5);
+
+                        Scalar krLazy[numPhases] = { 0.0, 0.0, 0.0 };
+                        Scalar krRef[numPhases] = { 0.0, 0.0, 0.0 };
+                        MaterialLaw::relativePermeabilities(krLazy,
+                                                            copiedMaterialLawManager.materialLawParams(elemIdx),
+                                                            fs);
+                        MaterialLaw::relativePermeabilities(krRef,
+                                                            hysterMaterialLawManager.materialLawParams(elemIdx),
+                                                            fs);
+                        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx)
+                            if (std::abs(krLazy[phaseIdx] - krRef[phaseIdx]) > 1e-10)
+                                throw std::logic_error("Lazily created imbibition curves differ from the reference ones");
+                    }
+                }
+            }
 
             // make sure that the saturation functions for both keyword families are
             // identical, and that setting and getting the hysteresis parameters works
@@ -561,6 +616,91 @@ inline void testAll()
                     }
                 }
             }
+
+            // bulk export and import of the hysteresis state must be consistent with
+            // the per-element accessors
+            const unsigned numValues = MaterialLawManager::numHysteresisValuesPerElement;
+            std::vector<Scalar> hysteresisState = hysterMaterialLawManager.exportHysteresisState();
+            if (hysteresisState.size() != numValues*n)
+                throw std::logic_error("Wrong size of the exported hysteresis state");
+
+            Opm::EclMaterialLawManager<MaterialTraits> restartMaterialLawManager;
+            restartMaterialLawManager.initFromState(hysterEclState);
+            restartMaterialLawManager.initParamsForElements(hysterEclState, n);
+            restartMaterialLawManager.importHysteresisState(hysteresisState);
+
+            Opm::BinarySerializer hysteresisWriter;
+            hysterMaterialLawManager.serializeHysteresisState(hysteresisWriter);
+            Opm::BinarySerializer hysteresisReader(hysteresisWriter.buffer());
+            Opm::EclMaterialLawManager<MaterialTraits> blobMaterialLawManager;
+            blobMaterialLawManager.initFromState(hysterEclState);
+            blobMaterialLawManager.initParamsForElements(hysterEclState, n);
+            blobMaterialLawManager.serializeHysteresisState(hysteresisReader);
+
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                Scalar expected[4];
+                hysterMaterialLawManager.oilWaterHysteresisParams(expected[0], expected[1], elemIdx);
+                hysterMaterialLawManager.gasOilHysteresisParams(expected[2], expected[3], elemIdx);
+
+                Scalar restarted[4];
+                restartMaterialLawManager.oilWaterHysteresisParams(restarted[0], restarted[1], elemIdx);
+                restartMaterialLawManager.gasOilHysteresisParams(restarted[2], restarted[3], elemIdx);
+
+                Scalar fromBlob[4];
+                blobMaterialLawManager.oilWaterHysteresisParams(fromBlob[0], fromBlob[1], elemIdx);
+                blobMaterialLawManager.gasOilHysteresisParams(fromBlob[2], fromBlob[3], elemIdx);
+
+                for (unsigned i = 0; i < numValues; ++ i) {
+                    if (hysteresisState[numValues*elemIdx + i] != expected[i])
+                        throw std::logic_error("Exported hysteresis state does not match the per-element values");
+                    if (std::abs(restarted[i] - expected[i]) > 1e-12)
+                        throw std::logic_error("Imported hysteresis state does not match the exported one");
+                    if (std::abs(fromBlob[i] - expected[i]) > 1e-12)
+                        throw std::logic_error("Deserialized hysteresis state does not match the serialized one");
+                }
+            }
+        }
+
+        // the material law selected at compile time must reproduce the multiplexed one
+        {
+            constexpr auto approach = Opm::EclMultiplexerApproach::EclDefaultApproach;
+            typedef typename MaterialLawManager::template StaticMaterialLaw<approach> StaticLaw;
+            typedef typename MaterialLawManager::template StaticMaterialLaw<approach, false, false> UnscaledStaticLaw;
+
+            if (!materialLawManager.template supportsStaticMaterialLaw<approach, false, false>())
+                throw std::logic_error("The static material law must be usable without hysteresis and end-point scaling");
+            if (materialLawManager.template supportsStaticMaterialLaw<Opm::EclMultiplexerApproach::EclStone1Approach>())
+                throw std::logic_error("The static material law must not be usable for a different three-phase approach");
+
+            for (unsigned elemIdx = 0; elemIdx < n; ++ elemIdx) {
+                const auto& params = materialLawManager.materialLawParams(elemIdx);
+                const auto& staticParams = materialLawManager.template staticMaterialLawParams<approach>(elemIdx);
+                for (int i = 0; i <= 100; i += 5) {
+                    for (int j = 0; j <= 100 - i; j += 5) {
+                        FluidState fs;
+                        fs.setSaturation(waterPhaseIdx, Scalar(i)/100);
+                        fs.setSaturation(oilPhaseIdx, Scalar(j)/100);
+                        fs.setSaturation(gasPhaseIdx, 1 - Scalar(i)/100 - Scalar(j)/100);
+
+                        Scalar pc[numPhases], pcStatic[numPhases], pcUnscaled[numPhases];
+                        MaterialLaw::capillaryPressures(pc, params, fs);
+                        StaticLaw::capillaryPressures(pcStatic, staticParams, fs);
+                        UnscaledStaticLaw::capillaryPressures(pcUnscaled, staticParams, fs);
+
+                        Scalar kr[numPhases], krStatic[numPhases], krUnscaled[numPhases];
+                        MaterialLaw::relativePermeabilities(kr, params, fs);
+                        StaticLaw::relativePermeabilities(krStatic, staticParams, fs);
+                        UnscaledStaticLaw::relativePermeabilities(krUnscaled, staticParams, fs);
+
+                        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+                            if (pcStatic[phaseIdx] != pc[phaseIdx] || pcUnscaled[phaseIdx] != pc[phaseIdx])
+                                throw std::logic_error("Discrepancy between the capillary pressures of the static and the multiplexed material law");
+                            if (krStatic[phaseIdx] != kr[phaseIdx] || krUnscaled[phaseIdx] != kr[phaseIdx])
+                                throw std::logic_error("Discrepancy between the relative permeabilities of the static and the multiplexed material law");
+                        }
+                    }
+                }
+            }
         }
 
         // Gas oil
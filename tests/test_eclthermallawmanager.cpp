@@ -0,0 +1,264 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the class which manages the parameters of the ECL
+ *        thermal laws.
+ *
+ * The results of the element-wise and the bulk methods of the manager must match the
+ * ones of the per-element EclHeatcrLaw, EclThconrLaw and EclThcLaw objects, with and
+ * without compact storage. This test requires the presence of opm-common.
+ */
+#include "config.h"
+
+#if !HAVE_ECL_INPUT
+#error "The test for EclThermalLawManager requires eclipse input support in opm-common"
+#endif
+
+#include <opm/material/thermal/EclThermalLawManager.hpp>
+#include <opm/material/thermal/EclHeatcrLaw.hpp>
+#include <opm/material/thermal/EclThconrLaw.hpp>
+#include <opm/material/thermal/EclThcLaw.hpp>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+#include <opm/material/fluidstates/SimpleModularFluidState.hpp>
+
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static const char* gridString =
+    "RUNSPEC\n"
+    "\n"
+    "DIMENS\n"
+    "   2 2 1 /\n"
+    "\n"
+    "TABDIMS\n"
+    "/\n"
+    "\n"
+    "OIL\n"
+    "GAS\n"
+    "WATER\n"
+    "\n"
+    "THERMAL\n"
+    "\n"
+    "METRIC\n"
+    "\n"
+    "GRID\n"
+    "\n"
+    "DX\n"
+    "   4*100 /\n"
+    "DY\n"
+    "   4*100 /\n"
+    "DZ\n"
+    "   4*10 /\n"
+    "\n"
+    "TOPS\n"
+    "   4*2000 /\n"
+    "\n"
+    "PORO\n"
+    "   0.1 0.2 0.25 0.3 /\n"
+    "\n";
+
+// the HEATCR and THCONR approaches
+static const char* heatcrDeckString =
+    "HEATCR\n"
+    "   1.1e3 1.2e3 1.3e3 1.4e3 /\n"
+    "\n"
+    "HEATCRT\n"
+    "   2.0 3.0 4.0 5.0 /\n"
+    "\n"
+    "THCONR\n"
+    "   150 160 170 180 /\n"
+    "\n"
+    "THCONSF\n"
+    "   0.1 0.2 0.3 0.4 /\n"
+    "\n";
+
+// the THC* approach
+static const char* thcDeckString =
+    "THCROCK\n"
+    "   200 210 220 230 /\n"
+    "\n"
+    "THCOIL\n"
+    "   10 11 12 13 /\n"
+    "\n"
+    "THCGAS\n"
+    "   1 2 3 4 /\n"
+    "\n"
+    "THCWATER\n"
+    "   50 51 52 53 /\n"
+    "\n";
+
+template <class Scalar>
+void checkClose(Scalar value, Scalar reference, const std::string& what, unsigned elemIdx)
+{
+    if (std::abs(value - reference) > 100*std::numeric_limits<Scalar>::epsilon()*std::max<Scalar>(1.0, std::abs(reference)))
+        throw std::logic_error(what+" of element "+std::to_string(elemIdx)+" is "
+                               +std::to_string(value)+" instead of "+std::to_string(reference));
+}
+
+template <class Scalar>
+void testDeck(const std::string& deckString, bool isHeatcr)
+{
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Opm::EclThermalLawManager<Scalar, FluidSystem> ThermalLawManager;
+    typedef typename ThermalLawManager::SolidEnergyLawParams SolidEnergyLawParams;
+    typedef typename ThermalLawManager::ThermalConductionLawParams ThermalConductionLawParams;
+    typedef Opm::EclHeatcrLaw<Scalar, FluidSystem> HeatcrLaw;
+    typedef Opm::EclThconrLaw<Scalar, FluidSystem> ThconrLaw;
+    typedef Opm::EclThcLaw<Scalar> ThcLaw;
+    typedef Opm::SimpleModularFluidState<Scalar,
+                                         /*numPhases=*/3,
+                                         /*numComponents=*/3,
+                                         FluidSystem,
+                                         /*storePressure=*/false,
+                                         /*storeTemperature=*/true,
+                                         /*storeComposition=*/false,
+                                         /*storeFugacity=*/false,
+                                         /*storeSaturation=*/true,
+                                         /*storeDensity=*/false,
+                                         /*storeViscosity=*/false,
+                                         /*storeEnthalpy=*/false> FluidState;
+
+    Opm::Parser parser;
+    const auto deck = parser.parseString(deckString);
+    const Opm::EclipseState eclState(deck);
+    const unsigned numElems = 4;
+
+    ThermalLawManager elementManager;
+    elementManager.initParamsForElements(eclState, numElems);
+
+    ThermalLawManager compactManager;
+    compactManager.setEnableCompactStorage(true);
+    compactManager.initParamsForElements(eclState, numElems);
+
+    std::vector<Scalar> temperatures(numElems);
+    std::vector<Scalar> gasSaturations(numElems);
+    std::vector<FluidState> fluidStates(numElems);
+    for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+        temperatures[elemIdx] = 300.0 + 10.0*elemIdx;
+        gasSaturations[elemIdx] = 0.1 + 0.2*elemIdx;
+
+        fluidStates[elemIdx].setTemperature(temperatures[elemIdx]);
+        fluidStates[elemIdx].setSaturation(FluidSystem::waterPhaseIdx, 0.2);
+        fluidStates[elemIdx].setSaturation(FluidSystem::gasPhaseIdx, gasSaturations[elemIdx]);
+        fluidStates[elemIdx].setSaturation(FluidSystem::oilPhaseIdx, 0.8 - gasSaturations[elemIdx]);
+    }
+
+    // the reference values of the laws which are specified for each element
+    std::vector<Scalar> energyRef(numElems, 0.0);
+    std::vector<Scalar> conductivityRef(numElems);
+    for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+        const auto& energyParams = elementManager.solidEnergyLawParams(elemIdx);
+        const auto& conductionParams = elementManager.thermalConductionLawParams(elemIdx);
+        if (isHeatcr) {
+            if (energyParams.solidEnergyApproach() != SolidEnergyLawParams::heatcrApproach
+                || conductionParams.thermalConductionApproach() != ThermalConductionLawParams::thconrApproach)
+                throw std::logic_error("The HEATCR/THCONR approaches were not selected");
+
+            energyRef[elemIdx] =
+                HeatcrLaw::solidInternalEnergy(energyParams.template getRealParams<SolidEnergyLawParams::heatcrApproach>(),
+                                               fluidStates[elemIdx]);
+            conductivityRef[elemIdx] =
+                ThconrLaw::thermalConductivity(conductionParams.template getRealParams<ThermalConductionLawParams::thconrApproach>(),
+                                               fluidStates[elemIdx]);
+        }
+        else {
+            if (conductionParams.thermalConductionApproach() != ThermalConductionLawParams::thcApproach)
+                throw std::logic_error("The THC* approach was not selected");
+
+            conductivityRef[elemIdx] =
+                ThcLaw::thermalConductivity(conductionParams.template getRealParams<ThermalConductionLawParams::thcApproach>(),
+                                            fluidStates[elemIdx]);
+        }
+    }
+
+    for (const ThermalLawManager* manager : { &elementManager, &compactManager }) {
+        const std::string mode = manager->enableCompactStorage() ? "compact: " : "per-element: ";
+
+        std::vector<Scalar> energies(numElems);
+        std::vector<Scalar> conductivities(numElems);
+        manager->solidInternalEnergies(energies.data(), temperatures.data(), 0, numElems);
+        manager->thermalConductivities(conductivities.data(), gasSaturations.data(), 0, numElems);
+
+        for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+            checkClose(energies[elemIdx], energyRef[elemIdx],
+                       mode+"bulk solid internal energy", elemIdx);
+            checkClose(conductivities[elemIdx], conductivityRef[elemIdx],
+                       mode+"bulk thermal conductivity", elemIdx);
+            checkClose<Scalar>(manager->solidInternalEnergy(elemIdx, fluidStates[elemIdx]), energyRef[elemIdx],
+                               mode+"solid internal energy", elemIdx);
+            checkClose<Scalar>(manager->thermalConductivity(elemIdx, fluidStates[elemIdx]), conductivityRef[elemIdx],
+                               mode+"thermal conductivity", elemIdx);
+        }
+
+        // a sub-range must give the results of the corresponding elements
+        std::vector<Scalar> subConductivities(2);
+        manager->thermalConductivities(subConductivities.data(), gasSaturations.data() + 1, 1, 3);
+        for (unsigned i = 0; i < 2; ++i)
+            checkClose(subConductivities[i], conductivityRef[1 + i],
+                       mode+"bulk thermal conductivity of a sub-range", 1 + i);
+    }
+
+    // the per-element objects are omitted in compact mode
+    if (isHeatcr) {
+        bool caught = false;
+        try {
+            compactManager.solidEnergyLawParams(0);
+        }
+        catch (const std::logic_error&) {
+            caught = true;
+        }
+        if (!caught)
+            throw std::logic_error("Per-element parameter objects are available in compact mode");
+    }
+}
+
+template <class Scalar>
+void testAll()
+{
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    FluidSystem::initBegin(/*numPvtRegions=*/1);
+
+    testDeck<Scalar>(std::string(gridString) + heatcrDeckString, /*isHeatcr=*/true);
+    testDeck<Scalar>(std::string(gridString) + thcDeckString, /*isHeatcr=*/false);
+}
+
+int main(int argc, char **argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+
+    testAll<double>();
+    testAll<float>();
+
+    return 0;
+}
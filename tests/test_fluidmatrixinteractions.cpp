@@ -71,6 +71,15 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 // this function makes sure that a capillary pressure law adheres to
 // the generic programming interface for such laws. This API _must_ be
 // implemented by all capillary pressure laws. If there are no _very_
@@ -257,6 +266,122 @@ void testThreePhaseSatApi()
 {
 }
 
+// the saturation scaling of EclEpsTwoPhaseLaw as it was done before the slopes of the
+// mappings were precomputed by the parameter object
+template <class Scalar>
+Scalar referenceSatTwoPoint(Scalar S,
+                            const std::array<Scalar, 3>& from,
+                            const std::array<Scalar, 3>& to)
+{ return to[0] + (S - from[0])*((to[2] - to[0])/(from[2] - from[0])); }
+
+template <class Scalar>
+Scalar referenceSatThreePoint(Scalar S,
+                              const std::array<Scalar, 3>& from,
+                              const std::array<Scalar, 3>& to,
+                              bool scaledToUnscaled)
+{
+    auto map = [&](unsigned i) {
+        const Scalar distance = (S - from[i])/(from[i + 1] - from[i]);
+        const Scalar displacement = std::max(to[i + 1] - to[i], Scalar(0.0));
+        return std::min(to[i] + distance*displacement, to[i + 1]);
+    };
+
+    if (!(S > from[0]))
+        return to[0];
+    else if (S < (scaledToUnscaled ? std::min(from[1], from[2]) : from[1]))
+        return map(0);
+    else if (S < from[2])
+        return map(1);
+    else
+        return to[2];
+}
+
+template <class Scalar>
+void testEclEpsSaturationScaling()
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, /*wettingPhaseIdx=*/0, /*nonWettingPhaseIdx=*/1> Traits;
+    typedef Opm::BrooksCorey<Traits> RawMaterialLaw;
+    typedef Opm::EclEpsTwoPhaseLaw<RawMaterialLaw> MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+    typedef typename Params::ScalingPoints ScalingPoints;
+    typedef std::array<Scalar, 3> Points;
+
+    // the mappings must only hold their slopes
+    static_assert(sizeof(typename Params::SaturationMapping) == 2*sizeof(Scalar),
+                  "The saturation mappings must be compact");
+
+    // pairs of (unscaled, scaled) saturation points. the last ones exercise the flat
+    // segments of the three-point scaling and a displacement point beyond the
+    // maximum saturation
+    const std::vector<std::pair<Points, Points> > pointSets = {
+        { {{0.1, 0.5, 0.9}}, {{0.2, 0.45, 0.8}} },
+        { {{0.0, 0.3, 1.0}}, {{0.15, 0.6, 0.85}} },
+        { {{0.2, 0.6, 0.7}}, {{0.1, 0.5, 0.4}} },
+        { {{0.2, 0.8, 0.7}}, {{0.1, 0.3, 0.9}} },
+    };
+
+    const Scalar tolerance = 100*std::numeric_limits<Scalar>::epsilon();
+    auto check = [&](Scalar value, Scalar reference, bool exact, const std::string& what) {
+        if (exact ? value != reference : std::abs(value - reference) > tolerance)
+            throw std::logic_error("Precomputed saturation mapping differs from the reference for "+what);
+    };
+
+    for (bool threePoint : { false, true }) {
+        for (const auto& pointSet : pointSets) {
+            auto config = std::make_shared<Opm::EclEpsConfig>();
+            config->setEnableSatScaling(true);
+            config->setEnableThreePointKrSatScaling(threePoint);
+
+            auto unscaledPoints = std::make_shared<ScalingPoints>();
+            auto scaledPoints = std::make_shared<ScalingPoints>();
+            for (unsigned i = 0; i < 3; ++i) {
+                unscaledPoints->setSaturationPcPoint(i, pointSet.first[i]);
+                unscaledPoints->setSaturationKrwPoint(i, pointSet.first[i]);
+                unscaledPoints->setSaturationKrnPoint(i, pointSet.first[i]);
+                scaledPoints->setSaturationPcPoint(i, pointSet.second[i]);
+                scaledPoints->setSaturationKrwPoint(i, pointSet.second[i]);
+                scaledPoints->setSaturationKrnPoint(i, pointSet.second[i]);
+            }
+
+            Params params;
+            params.setConfig(config);
+            params.setUnscaledPoints(unscaledPoints);
+            params.setScaledPoints(scaledPoints);
+            params.setEffectiveLawParams(std::make_shared<typename RawMaterialLaw::Params>());
+            params.finalize();
+
+            const Points& unscaled = pointSet.first;
+            const Points& scaled = pointSet.second;
+            for (int i = -2; i <= 12; ++i) {
+                // includes the scaling points themselves
+                std::vector<Scalar> sats = { Scalar(0.1*i) };
+                sats.insert(sats.end(), unscaled.begin(), unscaled.end());
+                sats.insert(sats.end(), scaled.begin(), scaled.end());
+
+                for (Scalar S : sats) {
+                    check(MaterialLaw::scaledToUnscaledSatPc(params, S),
+                          referenceSatTwoPoint(S, scaled, unscaled), true, "Pc");
+                    check(MaterialLaw::unscaledToScaledSatPc(params, S),
+                          referenceSatTwoPoint(S, unscaled, scaled), true, "Pc");
+
+                    const Scalar refToUnscaled =
+                        threePoint
+                        ? referenceSatThreePoint(S, scaled, unscaled, /*scaledToUnscaled=*/true)
+                        : referenceSatTwoPoint(S, scaled, unscaled);
+                    const Scalar refToScaled =
+                        threePoint
+                        ? referenceSatThreePoint(S, unscaled, scaled, /*scaledToUnscaled=*/false)
+                        : referenceSatTwoPoint(S, unscaled, scaled);
+                    check(MaterialLaw::scaledToUnscaledSatKrw(params, S), refToUnscaled, !threePoint, "Krw");
+                    check(MaterialLaw::unscaledToScaledSatKrw(params, S), refToScaled, !threePoint, "Krw");
+                    check(MaterialLaw::scaledToUnscaledSatKrn(params, S), refToUnscaled, !threePoint, "Krn");
+                    check(MaterialLaw::unscaledToScaledSatKrn(params, S), refToScaled, !threePoint, "Krn");
+                }
+            }
+        }
+    }
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -418,6 +543,8 @@ inline void testAll()
         testGenericApi<MaterialLaw, TwoPhaseFluidState>();
         testTwoPhaseApi<MaterialLaw, TwoPhaseFluidState>();
         testTwoPhaseSatApi<MaterialLaw, TwoPhaseFluidState>();
+
+        testEclEpsSaturationScaling<Scalar>();
     }
     {
         typedef Opm::BrooksCorey<TwoPhaseTraits> RawMaterialLaw;
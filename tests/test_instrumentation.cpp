@@ -0,0 +1,134 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the optional instrumentation of the material and
+ *        PVT code.
+ */
+#include "config.h"
+
+// this test is only meaningful with the instrumentation compiled in
+#undef OPM_MATERIAL_INSTRUMENTATION
+#define OPM_MATERIAL_INSTRUMENTATION 1
+
+#include <opm/material/common/Instrumentation.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef Opm::Tabulated1DFunction<double> Table;
+
+template <class Evaluation>
+Evaluation lookUp(const Table& table, const Evaluation& x, unsigned regionIdx)
+{
+    OPM_INSTRUMENT_SCOPE("TestCategory", "lookUp", regionIdx);
+    return table.eval(x, /*extrapolate=*/true);
+}
+
+double solve(const Table& table, double y, unsigned regionIdx)
+{
+    OPM_INSTRUMENT_SCOPE("TestCategory", "solve", regionIdx);
+
+    // a few Newton iterations for table(x) = y, starting outside of the table
+    double x = -1.0;
+    for (unsigned i = 0; i < 10; ++i) {
+        OPM_INSTRUMENT_ITERATION();
+        double delta = (table.eval(x, /*extrapolate=*/true) - y)/table.evalDerivative(x, /*extrapolate=*/true);
+        x -= delta;
+        if (std::abs(delta) < 1e-12)
+            break;
+    }
+    return x;
+}
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+int main()
+{
+    static_assert(Opm::Instrumentation::enabled(), "The instrumentation must be enabled for this test");
+
+    std::vector<double> x = { 0.0, 1.0, 2.0, 3.0 };
+    std::vector<double> y = { 0.0, 2.0, 3.0, 5.0 };
+    Table table(x, y);
+
+    Opm::Instrumentation::setSamplingInterval(1);
+    Opm::Instrumentation::reset();
+
+    // calls are counted per region, the instantiations for different types are
+    // reported together
+    lookUp(table, 0.5, /*regionIdx=*/0);
+    lookUp(table, 4.0, /*regionIdx=*/0);
+    lookUp(table, Opm::DenseAd::Evaluation<double, 2>(-1.0), /*regionIdx=*/0);
+    lookUp(table, 1.5, /*regionIdx=*/3);
+
+    auto r0 = Opm::Instrumentation::query("TestCategory", "lookUp", 0);
+    check(r0.calls == 3, "expected 3 calls in region 0, got " + std::to_string(r0.calls));
+    check(r0.extrapolations == 2, "expected 2 extrapolations in region 0, got " + std::to_string(r0.extrapolations));
+    check(r0.timedCalls == 3, "all calls must be timed with a sampling interval of 1");
+
+    auto r3 = Opm::Instrumentation::query("TestCategory", "lookUp", 3);
+    check(r3.calls == 1 && r3.extrapolations == 0, "wrong counters for region 3");
+
+    auto rAll = Opm::Instrumentation::queryAllRegions("TestCategory", "lookUp");
+    check(rAll.calls == 4, "expected 4 calls in all regions");
+
+    auto tableRecord = Opm::Instrumentation::query("Tabulated1DFunction", "eval");
+    check(tableRecord.calls == 4, "expected 4 table lookups, got " + std::to_string(tableRecord.calls));
+    check(tableRecord.extrapolations == 2, "expected 2 extrapolated lookups");
+
+    // iterations and nested extrapolations are attributed to the innermost scope
+    double xSol = solve(table, 1.0, /*regionIdx=*/1);
+    check(std::abs(xSol - 0.5) < 1e-10, "wrong solution");
+    auto rSolve = Opm::Instrumentation::query("TestCategory", "solve", 1);
+    check(rSolve.calls == 1, "expected one call of solve()");
+    check(rSolve.iterations >= 2, "expected at least two iterations");
+    check(rSolve.extrapolations == 2, "expected that the first iteration is extrapolated, got "
+          + std::to_string(rSolve.extrapolations));
+
+    // sampled timings
+    Opm::Instrumentation::setSamplingInterval(100);
+    for (unsigned j = 0; j < 1000; ++j)
+        lookUp(table, 1.0, /*regionIdx=*/2);
+    auto r2 = Opm::Instrumentation::query("TestCategory", "lookUp", 2);
+    check(r2.calls == 1000, "expected 1000 calls, got " + std::to_string(r2.calls));
+    check(r2.timedCalls == 10, "expected 10 timed calls, got " + std::to_string(r2.timedCalls));
+
+    std::ostringstream oss;
+    Opm::Instrumentation::dump(oss);
+    check(oss.str().find("lookUp") != std::string::npos, "the dump must contain all records");
+
+    Opm::Instrumentation::reset();
+    check(Opm::Instrumentation::records().empty(), "no records are expected after a reset");
+
+    return 0;
+}
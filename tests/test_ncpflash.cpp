@@ -33,6 +33,7 @@
 #include "config.h"
 
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
+#include <opm/material/constraintsolvers/ConstraintSolverStatistics.hpp>
 #include <opm/material/constraintsolvers/MiscibleMultiPhaseComposition.hpp>
 #include <opm/material/constraintsolvers/ComputeFromReferencePhase.hpp>
 
@@ -128,6 +129,42 @@ void checkNcpFlash(const FluidState& fsRef,
 
     // compare the "flashed" fluid state with the reference one
     checkSame<Scalar>(fsRef, fsFlash);
+
+    // the variant which reports statistics must give the same result
+    FluidState fsCold;
+    fsCold.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    paramCache.updateAll(fsCold);
+    NcpFlash::guessInitial(fsCold, globalMolarities);
+
+    Opm::ConstraintSolverStatistics<Scalar> coldStats;
+    NcpFlash::template solve<MaterialLaw>(fsCold, matParams, paramCache, globalMolarities, coldStats);
+    checkSame<Scalar>(fsRef, fsCold);
+    if (!coldStats.converged || coldStats.fallbackTaken || coldStats.numIterations == 0)
+        throw std::runtime_error("inconsistent statistics for the NCP flash");
+
+    // the statistics object is reset by every call, i.e., it can be reused
+    FluidState fsCold2;
+    fsCold2.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+    paramCache.updateAll(fsCold2);
+    NcpFlash::guessInitial(fsCold2, globalMolarities);
+    const unsigned coldIterations = coldStats.numIterations;
+    NcpFlash::template solve<MaterialLaw>(fsCold2, matParams, paramCache, globalMolarities, coldStats);
+    if (!coldStats.converged || coldStats.numIterations != coldIterations)
+        throw std::runtime_error("the statistics of the NCP flash accumulate across calls");
+
+    // re-run the flash using the converged fluid state as the initial guess. this
+    // must give the same result and it must take less iterations.
+    FluidState fsWarm;
+    fsWarm.setTemperature(fsRef.temperature(/*phaseIdx=*/0));
+
+    Opm::ConstraintSolverStatistics<Scalar> warmStats;
+    NcpFlash::template solveFromInitial<MaterialLaw>(fsWarm, fsFlash, matParams, paramCache,
+                                                     globalMolarities, warmStats);
+    checkSame<Scalar>(fsRef, fsWarm);
+    if (warmStats.fallbackTaken || warmStats.numIterations > coldStats.numIterations)
+        throw std::runtime_error("NCP flash does not profit from a converged initial guess: "
+                                 + std::to_string(warmStats.numIterations) + " vs. "
+                                 + std::to_string(coldStats.numIterations) + " iterations");
 }
 
 
@@ -29,7 +29,12 @@
 #include "config.h"
 
 #include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/Constants.hpp>
+#include <opm/material/common/PolynomialUtils.hpp>
+#include <opm/material/eos/PengRobinson.hpp>
+#include <opm/material/constraintsolvers/CompositionFromFugacities.hpp>
 #include <opm/material/constraintsolvers/ComputeFromReferencePhase.hpp>
+#include <opm/material/constraintsolvers/ConstraintSolverStatistics.hpp>
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 #include <opm/material/fluidsystems/Spe5FluidSystem.hpp>
@@ -289,6 +294,388 @@ void printResult(const RawTable& rawTable,
     std::cout << "};\n";
 }
 
+// the fugacity coefficients must carry the derivatives with respect to the mole
+// fractions of the fluid state even if the parameter cache only uses scalars
+template <class Scalar>
+void testFugacityDerivatives()
+{
+    typedef Opm::Spe5FluidSystem<Scalar> FluidSystem;
+    enum { numComponents = FluidSystem::numComponents };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+    typedef Opm::DenseAd::Evaluation<Scalar, numComponents> Evaluation;
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef Opm::CompositionalFluidState<Evaluation, FluidSystem> EvalFluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+
+    FluidState fs;
+    createSurfaceGasFluidSystem<FluidSystem>(fs);
+    ParameterCache paramCache;
+    paramCache.updatePhase(fs, gasPhaseIdx);
+
+    EvalFluidState evalFs;
+    evalFs.setTemperature(fs.temperature(gasPhaseIdx));
+    evalFs.setPressure(gasPhaseIdx, fs.pressure(gasPhaseIdx));
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        evalFs.setMoleFraction(gasPhaseIdx, compIdx,
+                               Evaluation::createVariable(fs.moleFraction(gasPhaseIdx, compIdx), compIdx));
+
+    const Scalar eps = 1e-7;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        const Evaluation& phi = FluidSystem::fugacityCoefficient(evalFs, paramCache, gasPhaseIdx, compIdx);
+        for (unsigned compJIdx = 0; compJIdx < numComponents; ++compJIdx) {
+            FluidState fsPlus(fs);
+            FluidState fsMinus(fs);
+            Scalar x = fs.moleFraction(gasPhaseIdx, compJIdx);
+            fsPlus.setMoleFraction(gasPhaseIdx, compJIdx, x + eps);
+            fsMinus.setMoleFraction(gasPhaseIdx, compJIdx, x - eps);
+            Scalar phiPlus = FluidSystem::fugacityCoefficient(fsPlus, paramCache, gasPhaseIdx, compIdx);
+            Scalar phiMinus = FluidSystem::fugacityCoefficient(fsMinus, paramCache, gasPhaseIdx, compIdx);
+            Scalar dPhiRef = (phiPlus - phiMinus)/(2*eps);
+            if (std::abs(phi.derivative(compJIdx) - dPhiRef) > 1e-5*std::abs(phi.value()))
+                throw std::logic_error("The derivative of the fugacity coefficient of component "
+                                       +std::to_string(compIdx)+" with respect to the mole fraction of component "
+                                       +std::to_string(compJIdx)+" is wrong");
+        }
+    }
+
+    // many incremental updates of the mixing rule must give the same result as a
+    // complete one
+    FluidState fs2(fs);
+    ParameterCache paramCache2;
+    paramCache2.updatePhase(fs2, gasPhaseIdx);
+    for (unsigned i = 0; i < 1000; ++i) {
+        unsigned compIdx = i % numComponents;
+        fs2.setMoleFraction(gasPhaseIdx, compIdx, 0.5*(1.0 + std::sin(0.1*i)));
+        paramCache2.updateSingleMoleFraction(fs2, gasPhaseIdx, compIdx);
+    }
+    ParameterCache paramCache3;
+    paramCache3.updatePhase(fs2, gasPhaseIdx);
+    if (std::abs(paramCache2.a(gasPhaseIdx) - paramCache3.a(gasPhaseIdx)) > 1e-12*std::abs(paramCache3.a(gasPhaseIdx)))
+        throw std::logic_error("The incremental updates of the mixing rule accumulate rounding errors");
+}
+
+// the composition of a non-ideal phase must be recovered from its fugacities, with and
+// without successive substitution steps before the Newton method
+template <class Scalar>
+void testCompositionFromFugacities()
+{
+    typedef Opm::Spe5FluidSystem<Scalar> FluidSystem;
+    enum { numComponents = FluidSystem::numComponents };
+    enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
+    enum { waterPhaseIdx = FluidSystem::waterPhaseIdx };
+    typedef Opm::CompositionalFluidState<Scalar, FluidSystem> FluidState;
+    typedef typename FluidSystem::template ParameterCache<Scalar> ParameterCache;
+    typedef Opm::CompositionFromFugacities<Scalar, FluidSystem> CompositionFromFugacities;
+    typedef typename CompositionFromFugacities::ComponentVector ComponentVector;
+    typedef Opm::ConstraintSolverStatistics<Scalar> Statistics;
+
+    FluidState fsRef;
+    createSurfaceGasFluidSystem<FluidSystem>(fsRef);
+    fsRef.setPressure(gasPhaseIdx, 50e5);
+    fsRef.setMoleFraction(gasPhaseIdx, FluidSystem::C1Idx, 0.90);
+    fsRef.setMoleFraction(gasPhaseIdx, FluidSystem::C3Idx, 0.07);
+    fsRef.setMoleFraction(gasPhaseIdx, FluidSystem::C6Idx, 0.03);
+
+    ParameterCache paramCache;
+    paramCache.updatePhase(fsRef, gasPhaseIdx);
+    ComponentVector targetFug;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        Scalar phi = FluidSystem::fugacityCoefficient(fsRef, paramCache, gasPhaseIdx, compIdx);
+        targetFug[compIdx] = fsRef.moleFraction(gasPhaseIdx, compIdx)*phi*fsRef.pressure(gasPhaseIdx);
+    }
+
+    Statistics newtonStats;
+    Statistics substitutionStats;
+    for (unsigned maxSubstitutionIterations : { 0u, 10u }) {
+        Statistics& stats = maxSubstitutionIterations == 0 ? newtonStats : substitutionStats;
+
+        // start at a composition which is away from the solution
+        FluidState fs(fsRef);
+        fs.setMoleFraction(gasPhaseIdx, FluidSystem::C1Idx, 0.80);
+        fs.setMoleFraction(gasPhaseIdx, FluidSystem::C3Idx, 0.15);
+        fs.setMoleFraction(gasPhaseIdx, FluidSystem::C6Idx, 0.05);
+        ParameterCache solveParamCache;
+        solveParamCache.updatePhase(fs, gasPhaseIdx);
+
+        CompositionFromFugacities::solve(fs, solveParamCache, gasPhaseIdx, targetFug,
+                                         stats, maxSubstitutionIterations);
+
+        if (!stats.converged || stats.fallbackTaken || stats.numIterations == 0)
+            throw std::logic_error("Inconsistent statistics for the composition from the fugacities");
+        if (stats.numSubstitutionIterations > maxSubstitutionIterations
+            || (maxSubstitutionIterations > 0 && stats.numSubstitutionIterations == 0))
+            throw std::logic_error("Wrong number of successive substitution steps: "
+                                   +std::to_string(stats.numSubstitutionIterations));
+
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            Scalar x = fs.moleFraction(gasPhaseIdx, compIdx);
+            Scalar xRef = fsRef.moleFraction(gasPhaseIdx, compIdx);
+            if (std::abs(x - xRef) > 1e3*std::numeric_limits<Scalar>::epsilon())
+                throw std::logic_error("The composition computed from the fugacities is wrong for component "
+                                       +std::to_string(compIdx)+": "+std::to_string(x)+" vs. "
+                                       +std::to_string(xRef));
+        }
+    }
+
+    // the substitution steps get close to the solution, so Newton needs less
+    // iterations afterwards
+    if (substitutionStats.numIterations > newtonStats.numIterations)
+        throw std::logic_error("Successive substitution does not reduce the number of Newton iterations: "
+                               +std::to_string(substitutionStats.numIterations)+" vs. "
+                               +std::to_string(newtonStats.numIterations));
+
+    // ideal mixtures are solved directly
+    FluidState fsWater(fsRef);
+    fsWater.setPressure(waterPhaseIdx, 50e5);
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+        fsWater.setMoleFraction(waterPhaseIdx, compIdx, compIdx == FluidSystem::H2OIdx ? 1.0 : 0.0);
+    ParameterCache waterParamCache;
+    waterParamCache.updatePhase(fsWater, waterPhaseIdx);
+    ComponentVector waterFug;
+    for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+        Scalar phi = FluidSystem::fugacityCoefficient(fsWater, waterParamCache, waterPhaseIdx, compIdx);
+        waterFug[compIdx] = fsWater.moleFraction(waterPhaseIdx, compIdx)*phi*fsWater.pressure(waterPhaseIdx);
+    }
+    Statistics waterStats;
+    CompositionFromFugacities::solve(fsWater, waterParamCache, waterPhaseIdx, waterFug, waterStats, 10);
+    if (!waterStats.converged || waterStats.numIterations != 0 || waterStats.numSubstitutionIterations != 0)
+        throw std::logic_error("Inconsistent statistics for an ideal mixture");
+}
+
+// makes the protected helpers of the Peng-Robinson EOS accessible to the tests
+template <class Scalar>
+struct PengRobinsonTester : public Opm::PengRobinson<Scalar>
+{
+    typedef Opm::PengRobinson<Scalar> ParentType;
+
+    using ParentType::cubicRoot_;
+    using ParentType::findCriticalPoint_;
+    using ParentType::findExtrema_;
+};
+
+// checks that a root of a monic cubic polynomial has a residual in the order of the
+// rounding errors when evaluating the polynomial
+template <class Scalar>
+void checkCubicResidual(Scalar x, Scalar b, Scalar c, Scalar d, const std::string& msg)
+{
+    Scalar f = d + x*(c + x*(b + x));
+    Scalar scale = std::abs(d) + std::abs(c*x) + std::abs(b*x*x) + std::abs(x*x*x);
+    if (std::abs(f) > 1e2*std::numeric_limits<Scalar>::epsilon()*scale)
+        throw std::logic_error(msg+": the residual of the root "+std::to_string(x)+" is too large");
+}
+
+// the roots of monic cubic polynomials which are constructed from their roots
+template <class Scalar>
+void testCubicSolver()
+{
+    // the roots of each polynomial and the tolerance for the roots. if two roots are
+    // almost identical, the roots are only determined up to about the square root of
+    // the machine precision
+    const Scalar cases[][4] = {
+        { 1.0, 2.0, 3.0, 1e-12 },
+        { -5.0, 0.001, 7.5, 1e-12 },
+        { 0.002, 0.05, 0.9, 1e-12 },
+        { 1.0, 1.0, 3.0, 1e-7 },
+        { 2.83240690796, 2.83240690896, 3.2564240824, 1e-6 },
+        { 0.1, 3.2564240824, 3.2564241824, 1e-6 },
+        { 2.5138637963955031, 2.5138638649787675, 3.0126768772643899, 1e-6 },
+        { 0.96133970982387473, 3.3932463909063686, 3.3932464798933148, 1e-6 },
+        { 1e-5, 5e-4, 1.2, 1e-12 },
+        { -5.0, 0.001, 0.0010001, 1e-6 },
+    };
+
+    for (const auto& roots : cases) {
+        const Scalar b = -(roots[0] + roots[1] + roots[2]);
+        const Scalar c = roots[0]*roots[1] + roots[0]*roots[2] + roots[1]*roots[2];
+        const Scalar d = -roots[0]*roots[1]*roots[2];
+        const std::string msg =
+            "cubic with roots "+std::to_string(roots[0])+", "+std::to_string(roots[1])+", "+std::to_string(roots[2]);
+
+        Scalar sol[3];
+        unsigned numSol = Opm::invertMonicCubicPolynomial(sol, b, c, d);
+        if (numSol != 3)
+            throw std::logic_error(msg+": three roots expected");
+        for (unsigned i = 0; i < 3; ++i) {
+            checkCubicResidual(sol[i], b, c, d, msg);
+            if (std::abs(sol[i] - roots[i]) > roots[3]*std::max<Scalar>(1.0, std::abs(roots[i])))
+                throw std::logic_error(msg+": root "+std::to_string(i)+" is "+std::to_string(sol[i]));
+        }
+    }
+
+    // a single real root
+    Scalar sol[3];
+    unsigned numSol = Opm::invertMonicCubicPolynomial(sol, Scalar(-1.0), Scalar(1.0), Scalar(-1.0));
+    if (numSol != 1 || std::abs(sol[0] - 1.0) > 1e-12)
+        throw std::logic_error("The single real root of x^3 - x^2 + x - 1 is wrong");
+}
+
+// the compressibility factors and their derivatives with respect to A* and B*, also
+// close to the conditions where two of the roots merge
+template <class Scalar>
+void testCompressibilityFactors()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 2> Evaluation;
+    typedef PengRobinsonTester<Scalar> PR;
+
+    // returns all roots of the Peng-Robinson cubic for given A* and B*
+    const auto allRoots = [](Scalar* Z, Scalar A, Scalar B) {
+        return Opm::invertMonicCubicPolynomial(Z, - (1 - B), A - B*(3*B + 2), B*(- A + B*(1 + B)));
+    };
+
+    // for B* = 0.05, three positive roots exist between about A* = 0.31 and A* = 0.37.
+    // find both ends of this interval by bisection
+    const Scalar B = 0.05;
+    Scalar Z[3];
+    Scalar ALow[2] = { 0.2, 0.34 };
+    Scalar AHigh[2] = { 0.34, 0.5 };
+    for (unsigned endIdx = 0; endIdx < 2; ++endIdx) {
+        for (unsigned i = 0; i < 100; ++i) {
+            Scalar A = (ALow[endIdx] + AHigh[endIdx])/2;
+            bool threeRoots = allRoots(Z, A, B) == 3;
+            if (threeRoots == (endIdx == 0))
+                AHigh[endIdx] = A;
+            else
+                ALow[endIdx] = A;
+        }
+    }
+    if (allRoots(Z, AHigh[0], B) != 3 || allRoots(Z, ALow[1], B) != 3)
+        throw std::logic_error("The cubic of the Peng-Robinson EOS should exhibit three roots");
+
+    // well separated roots, the liquid and the middle root close to each other and the
+    // middle and the gas root close to each other
+    const Scalar AValues[] = { 0.32, 0.34, 0.36, AHigh[0] + 1e-6, ALow[1] - 1e-6 };
+    for (Scalar A : AValues) {
+        const std::string msg = "Peng-Robinson cubic at A*="+std::to_string(A)+", B*="+std::to_string(B);
+        const Scalar a2 = - (1 - B);
+        const Scalar a3 = A - B*(3*B + 2);
+        const Scalar a4 = B*(- A + B*(1 + B));
+        if (allRoots(Z, A, B) != 3)
+            throw std::logic_error(msg+": three roots expected");
+        for (unsigned i = 0; i < 3; ++i)
+            checkCubicResidual(Z[i], a2, a3, a4, msg);
+        if (!(Z[0] <= Z[1] && Z[1] <= Z[2]))
+            throw std::logic_error(msg+": the roots are not sorted");
+
+        // the batch variant selects the outer roots
+        Scalar As[2] = { A, A };
+        Scalar Bs[2] = { B, B };
+        Scalar ZLiquid[2];
+        Scalar ZGas[2];
+        PR::computeCompressibilityFactors(ZLiquid, As, Bs, 2, /*isGasPhase=*/false);
+        PR::computeCompressibilityFactors(ZGas, As, Bs, 2, /*isGasPhase=*/true);
+        if (ZLiquid[1] != Z[0] || ZGas[1] != Z[2])
+            throw std::logic_error(msg+": the batch variant selects the wrong roots");
+
+        // the derivatives of the roots obtained using the implicit function theorem must
+        // match finite differences. the closer two roots are, the smaller the step must
+        // be because the second derivative of the roots grows quickly
+        const Evaluation AEval = Evaluation::createVariable(A, 0);
+        const Evaluation BEval = Evaluation::createVariable(B, 1);
+        const Evaluation a2Eval = - (1 - BEval);
+        const Evaluation a3Eval = AEval - BEval*(3*BEval + 2);
+        const Evaluation a4Eval = BEval*(- AEval + BEval*(1 + BEval));
+        Scalar minDist = std::min(Z[1] - Z[0], Z[2] - Z[1]);
+        Scalar eps = std::min<Scalar>(1e-7, 1e-3*minDist*minDist);
+        Scalar ZAPlus[3], ZAMinus[3], ZBPlus[3], ZBMinus[3];
+        if (allRoots(ZAPlus, A + eps, B) != 3 || allRoots(ZAMinus, A - eps, B) != 3
+            || allRoots(ZBPlus, A, B + eps) != 3 || allRoots(ZBMinus, A, B - eps) != 3)
+            throw std::logic_error(msg+": the finite difference steps are too large");
+        for (unsigned i = 0; i < 3; ++i) {
+            const Evaluation& ZEval = PR::cubicRoot_(Z[i], a2Eval, a3Eval, a4Eval);
+            Scalar dZdA = (ZAPlus[i] - ZAMinus[i])/(2*eps);
+            Scalar dZdB = (ZBPlus[i] - ZBMinus[i])/(2*eps);
+            Scalar tol = 1e-4*(std::abs(dZdA) + std::abs(dZdB));
+            if (std::abs(ZEval.value() - Z[i]) > 1e-10*Z[i]
+                || std::abs(ZEval.derivative(0) - dZdA) > tol
+                || std::abs(ZEval.derivative(1) - dZdB) > tol)
+                throw std::logic_error(msg+": the derivatives of root "+std::to_string(i)+" are wrong");
+        }
+    }
+}
+
+// the critical point and the extrema of the Peng-Robinson EOS including their
+// derivatives with respect to the "a" and "b" parameters and the temperature
+template <class Scalar>
+void testCriticalPointAndExtrema()
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 3> Evaluation;
+    typedef PengRobinsonTester<Scalar> PR;
+    const Scalar R = Opm::Constants<Scalar>::R;
+
+    // roughly the parameters of methane
+    const Scalar a = 0.25;
+    const Scalar b = 2.7e-5;
+
+    // the pressure of the EOS and its first two derivatives with respect to the molar
+    // volume
+    const auto pressure = [R](Scalar T, Scalar V, Scalar aa, Scalar bb, Scalar& dpdV, Scalar& d2pdV2) {
+        Scalar q = V*V + 2*bb*V - bb*bb;
+        dpdV = -R*T/((V - bb)*(V - bb)) + aa*(2*V + 2*bb)/(q*q);
+        d2pdV2 = 2*R*T/((V - bb)*(V - bb)*(V - bb))
+            + aa*(2*q - 2*(2*V + 2*bb)*(2*V + 2*bb))/(q*q*q);
+        return R*T/(V - bb) - aa/q;
+    };
+
+    const Evaluation aEval = Evaluation::createVariable(a, 0);
+    const Evaluation bEval = Evaluation::createVariable(b, 1);
+    Evaluation Tcrit, pcrit, Vcrit;
+    PR::findCriticalPoint_(Tcrit, pcrit, Vcrit, aEval, bEval);
+
+    Scalar dpdV, d2pdV2;
+    Scalar p = pressure(Tcrit.value(), Vcrit.value(), a, b, dpdV, d2pdV2);
+    if (std::abs(p - pcrit.value()) > 1e-10*pcrit.value()
+        || std::abs(dpdV)*Vcrit.value() > 1e-8*pcrit.value()
+        || std::abs(d2pdV2)*Vcrit.value()*Vcrit.value() > 1e-8*pcrit.value())
+        throw std::logic_error("The critical point of the Peng-Robinson EOS is wrong");
+    if (std::abs(pcrit.value()*Vcrit.value()/(R*Tcrit.value()) - 0.307401) > 1e-6)
+        throw std::logic_error("The critical compressibility factor of the Peng-Robinson EOS is wrong");
+
+    const Scalar eps = 1e-7;
+    for (unsigned varIdx = 0; varIdx < 2; ++varIdx) {
+        Evaluation TcPlus, pcPlus, VcPlus, TcMinus, pcMinus, VcMinus;
+        Scalar h = eps*((varIdx == 0)?a:b);
+        PR::findCriticalPoint_(TcPlus, pcPlus, VcPlus,
+                               Evaluation(a + ((varIdx == 0)?h:0.0)), Evaluation(b + ((varIdx == 1)?h:0.0)));
+        PR::findCriticalPoint_(TcMinus, pcMinus, VcMinus,
+                               Evaluation(a - ((varIdx == 0)?h:0.0)), Evaluation(b - ((varIdx == 1)?h:0.0)));
+        if (std::abs(Tcrit.derivative(varIdx) - (TcPlus.value() - TcMinus.value())/(2*h)) > 1e-6*std::abs(Tcrit.derivative(varIdx))
+            || std::abs(pcrit.derivative(varIdx) - (pcPlus.value() - pcMinus.value())/(2*h)) > 1e-6*std::abs(pcrit.derivative(varIdx))
+            || std::abs(Vcrit.derivative(varIdx) - (VcPlus.value() - VcMinus.value())/(2*h)) > 1e-6*std::abs(Vcrit.derivative(varIdx)) + 1e-12)
+            throw std::logic_error("The derivatives of the critical point of the Peng-Robinson EOS are wrong");
+    }
+
+    // below the critical temperature, the EOS exhibits a local minimum and a local
+    // maximum. close to the critical temperature, they are close to each other
+    const Scalar TValues[] = { 0.7*Tcrit.value(), 0.95*Tcrit.value(), 0.9999*Tcrit.value() };
+    for (Scalar T : TValues) {
+        const std::string msg = "Extrema of the Peng-Robinson EOS at T="+std::to_string(T);
+        const Evaluation TEval = Evaluation::createVariable(T, 2);
+        Evaluation Vmin, Vmax, pmin, pmax;
+        if (!PR::findExtrema_(Vmin, Vmax, pmin, pmax, aEval, bEval, TEval))
+            throw std::logic_error(msg+": not found");
+        if (!(b < Vmin.value() && Vmin.value() < Vcrit.value() && Vcrit.value() < Vmax.value()))
+            throw std::logic_error(msg+": the extrema are not on both sides of the critical volume");
+
+        for (const Evaluation& V : { Vmin, Vmax }) {
+            p = pressure(T, V.value(), a, b, dpdV, d2pdV2);
+            if (std::abs(dpdV)*V.value() > 1e-6*pcrit.value())
+                throw std::logic_error(msg+": the derivative of the pressure does not vanish");
+        }
+
+        // the derivatives of the extrema with respect to the temperature
+        Evaluation VminPlus, VmaxPlus, VminMinus, VmaxMinus;
+        Scalar h = 1e-7*T;
+        if (!PR::findExtrema_(VminPlus, VmaxPlus, pmin, pmax, Evaluation(a), Evaluation(b), Evaluation(T + h))
+            || !PR::findExtrema_(VminMinus, VmaxMinus, pmin, pmax, Evaluation(a), Evaluation(b), Evaluation(T - h)))
+            throw std::logic_error(msg+": not found");
+        Scalar dVmindT = (VminPlus.value() - VminMinus.value())/(2*h);
+        Scalar dVmaxdT = (VmaxPlus.value() - VmaxMinus.value())/(2*h);
+        if (std::abs(Vmin.derivative(2) - dVmindT) > 1e-4*std::abs(dVmindT)
+            || std::abs(Vmax.derivative(2) - dVmaxdT) > 1e-4*std::abs(dVmaxdT))
+            throw std::logic_error(msg+": the derivatives with respect to the temperature are wrong");
+    }
+}
+
 template <class Scalar>
 inline void testAll()
 {
@@ -330,6 +717,12 @@ inline void testAll()
                       /*minPressure=*/1.0e4,
                       /*maxTemperature=*/40.0e6);
 
+    testCubicSolver<Scalar>();
+    testCompressibilityFactors<Scalar>();
+    testCriticalPointAndExtrema<Scalar>();
+    testFugacityDerivatives<Scalar>();
+    testCompositionFromFugacities<Scalar>();
+
     // set the parameters for the capillary pressure law
     MaterialLawParams matParams;
     for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
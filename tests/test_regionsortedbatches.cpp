@@ -0,0 +1,115 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for grouping cells by their regions.
+ */
+#include "config.h"
+
+#include <opm/material/common/RegionSortedBatches.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+int main()
+{
+    const unsigned numCells = 1000;
+    std::vector<int> pvtnum(numCells);
+    std::vector<int> satnum(numCells);
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+        pvtnum[cellIdx] = (cellIdx*7) % 5;
+        satnum[cellIdx] = (cellIdx*13) % 11;
+    }
+
+    Opm::RegionSortedBatches batches(pvtnum, satnum);
+    check(batches.numCells() == numCells, "Number of cells");
+    check(batches.batches().size() == 55, "Each combination of regions must be a batch");
+
+    // the batches must cover all cells exactly once, in region and then cell order
+    std::vector<unsigned> numVisits(numCells, 0);
+    unsigned prevPvt = 0;
+    unsigned prevSat = 0;
+    unsigned prevBatchEnd = 0;
+    batches.forEachBatch([&](const Opm::RegionSortedBatches::Batch& batch, const unsigned* cells) {
+        check(batch.begin == prevBatchEnd, "The batches must be contiguous");
+        prevBatchEnd = batch.end;
+        check(batch.pvtRegionIdx > prevPvt
+              || (batch.pvtRegionIdx == prevPvt && batch.satRegionIdx >= prevSat),
+              "The batches must be sorted by region");
+        prevPvt = batch.pvtRegionIdx;
+        prevSat = batch.satRegionIdx;
+
+        for (unsigned i = 0; i < batch.size(); ++i) {
+            const unsigned cellIdx = cells[i];
+            check(i == 0 || cells[i - 1] < cellIdx, "The permutation must be stable");
+            check(unsigned(pvtnum[cellIdx]) == batch.pvtRegionIdx
+                  && unsigned(satnum[cellIdx]) == batch.satRegionIdx,
+                  "All cells of a batch must belong to its regions");
+            ++numVisits[cellIdx];
+        }
+    });
+    check(prevBatchEnd == numCells, "The batches must cover all cells");
+    for (unsigned n : numVisits)
+        check(n == 1, "Each cell must be visited exactly once");
+
+    // results written in region order end up at the right cells
+    std::vector<double> result(numCells, 0.0);
+    batches.forEachCell([&](unsigned cellIdx, unsigned pvtRegionIdx, unsigned satRegionIdx) {
+        result[cellIdx] = 100.0*pvtRegionIdx + satRegionIdx;
+    });
+    for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx)
+        check(result[cellIdx] == 100.0*pvtnum[cellIdx] + satnum[cellIdx], "forEachCell");
+
+    std::vector<double> sorted;
+    std::vector<double> roundTrip;
+    batches.gather(result, sorted);
+    for (unsigned i = 1; i < numCells; ++i)
+        check(sorted[i - 1] <= sorted[i], "gather");
+    batches.scatter(sorted, roundTrip);
+    check(roundTrip == result, "scatter");
+
+    // a missing region array means that all cells belong to region 0
+    Opm::RegionSortedBatches pvtOnly(pvtnum, std::vector<int>());
+    check(pvtOnly.batches().size() == 5, "PVT regions only");
+    for (const auto& batch : pvtOnly.batches())
+        check(batch.satRegionIdx == 0 && batch.size() == numCells/5, "PVT regions only");
+
+    bool caught = false;
+    try {
+        Opm::RegionSortedBatches invalid(pvtnum, std::vector<int>(numCells - 1));
+    }
+    catch (const std::invalid_argument&) {
+        caught = true;
+    }
+    check(caught, "Region arrays of different sizes must be rejected");
+
+    return 0;
+}
@@ -0,0 +1,305 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for reverse-mode automatic differentiation.
+ *
+ * The gradients with regard to the entries of tables, the sampling points of
+ * piecewise linear material laws and the end-point scaling parameters are computed
+ * using a single backward sweep and compared to finite differences.
+ */
+#include "config.h"
+
+#include <opm/material/reversead/Evaluation.hpp>
+#include <opm/material/reversead/Math.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+#include <opm/material/fluidmatrixinteractions/PiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/fluidmatrixinteractions/EclEpsTwoPhaseLaw.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef Opm::ReverseAd::Tape<double> Tape;
+typedef Opm::ReverseAd::Evaluation<double> Eval;
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+// compare the gradient of a model obtained by a single backward sweep with central
+// differences
+template <class Model>
+void checkGradient(const Model& model, const std::vector<double>& params, const std::string& name)
+{
+    Tape tape;
+    tape.activate();
+
+    std::vector<Eval> x;
+    for (double p : params)
+        x.push_back(Eval::createVariable(p));
+
+    const Eval y = model(x);
+    check(std::abs(y.value() - model(params)) < 1e-12*std::max(1.0, std::abs(y.value())),
+          name+": the value must not depend on the type of the scalars");
+
+    tape.computeAdjoints(y);
+    const std::vector<double> gradient = tape.adjoints(x);
+
+    for (unsigned i = 0; i < params.size(); ++i) {
+        std::vector<double> p(params);
+        const double h = 1e-6*std::max(1.0, std::abs(p[i]));
+        p[i] = params[i] + h;
+        const double yPlus = model(p);
+        p[i] = params[i] - h;
+        const double yMinus = model(p);
+
+        const double fd = (yPlus - yMinus)/(2*h);
+        if (std::abs(fd - gradient[i]) > 1e-5*std::max(1.0, std::abs(fd)))
+            throw std::logic_error(name+": derivative "+std::to_string(i)+" is "
+                                   +std::to_string(gradient[i])+" instead of "+std::to_string(fd));
+    }
+
+    tape.deactivate();
+}
+
+void testElementary()
+{
+    auto model = [](const auto& x) {
+        typedef typename std::decay<decltype(x[0])>::type Scalar;
+        const Scalar& a = x[0];
+        const Scalar& b = x[1];
+        Scalar result = a*b + Opm::sin(a)/b - Opm::exp(a)*Opm::log(b);
+        result += Opm::pow(b, a) + Opm::sqrt(b) - 2.0/(1.0 + a*a);
+        result += Opm::atan2(a, b) + Opm::max(a, b) + Opm::abs(a - 3.0);
+        result -= a;
+        return result;
+    };
+    checkGradient(model, {0.7, 1.3}, "elementary functions");
+
+    // operations on constants are not recorded
+    Tape tape;
+    tape.activate();
+    unsigned pos = tape.position();
+    Eval c = Opm::exp(Eval(1.0))*2.0 + 3.0;
+    check(c.isConstant() && tape.position() == pos, "Constants must not be recorded");
+
+    Eval v = Eval::createVariable(2.0);
+    Eval w = v*v;
+    check(tape.position() == pos + 2, "Each operation must record a single node");
+    tape.computeAdjoints(w);
+    check(v.adjoint() == 4.0 && tape.adjoint(c) == 0.0, "derivative of x^2");
+
+    tape.reset(pos);
+    check(tape.position() == pos, "reset");
+    tape.deactivate();
+
+    bool caught = false;
+    try {
+        Eval::createVariable(1.0);
+    }
+    catch (const std::logic_error&) {
+        caught = true;
+    }
+    check(caught, "Variables cannot be created without an active tape");
+}
+
+void testTabulated1D()
+{
+    // the derivatives with regard to many table entries are obtained by a single sweep
+    const unsigned numSamples = 200;
+    std::vector<double> params(numSamples);
+    for (unsigned i = 0; i < numSamples; ++i)
+        params[i] = std::sin(0.1*i) + 0.01*i;
+
+    auto model = [numSamples](const auto& yValues) {
+        typedef typename std::decay<decltype(yValues[0])>::type Scalar;
+        std::vector<Scalar> xValues(numSamples);
+        for (unsigned i = 0; i < numSamples; ++i)
+            xValues[i] = i*i/double(numSamples);
+        Opm::Tabulated1DFunction<Scalar> table(xValues, yValues, /*sortInputs=*/false);
+
+        Scalar result = 0.0;
+        for (unsigned k = 0; k < 57; ++k) {
+            Scalar x = 0.33 + 3.47*k;
+            Scalar y = table.eval(x);
+            result += y*y;
+        }
+        return result;
+    };
+    checkGradient(model, params, "Tabulated1DFunction");
+}
+
+void testUniformXTabulated2D()
+{
+    const unsigned numX = 4;
+    const unsigned numY = 5;
+    std::vector<double> params(numX*numY);
+    for (unsigned i = 0; i < params.size(); ++i)
+        params[i] = 1.0 + 0.1*i + 0.05*(i % 3);
+
+    auto model = [](const auto& values) {
+        typedef typename std::decay<decltype(values[0])>::type Scalar;
+        Opm::UniformXTabulated2DFunction<Scalar> table;
+        for (unsigned i = 0; i < numX; ++i) {
+            table.appendXPos(1.0*i);
+            for (unsigned j = 0; j < numY; ++j)
+                table.appendSamplePoint(i, 2.0*j, values[i*numY + j]);
+        }
+
+        Scalar result = 0.0;
+        for (unsigned k = 0; k < 10; ++k) {
+            Scalar x = 0.13 + 0.27*k;
+            Scalar y = 0.41 + 0.73*k;
+            result += table.eval(x, y)*(1.0 + 0.1*k);
+        }
+        return result;
+    };
+    checkGradient(model, params, "UniformXTabulated2DFunction");
+}
+
+template <class Scalar>
+std::shared_ptr<Opm::PiecewiseLinearTwoPhaseMaterialParams<Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> > >
+makePiecewiseLinearParams(const std::vector<Scalar>& krValues)
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+    auto params = std::make_shared<Opm::PiecewiseLinearTwoPhaseMaterialParams<Traits> >();
+
+    const unsigned n = krValues.size()/2;
+    std::vector<Scalar> Sw(n);
+    std::vector<Scalar> krw(n);
+    std::vector<Scalar> krn(n);
+    std::vector<Scalar> pcnw(n);
+    for (unsigned i = 0; i < n; ++i) {
+        Sw[i] = 0.1 + 0.8*i/(n - 1);
+        krw[i] = krValues[i];
+        krn[i] = krValues[n + i];
+        pcnw[i] = 1e5*(1.0 - Sw[i]);
+    }
+    params->setKrwSamples(Sw, krw);
+    params->setKrnSamples(Sw, krn);
+    params->setPcnwSamples(Sw, pcnw);
+    params->finalize();
+    return params;
+}
+
+std::vector<double> krParams(unsigned n)
+{
+    std::vector<double> params(2*n);
+    for (unsigned i = 0; i < n; ++i) {
+        double s = double(i)/(n - 1);
+        params[i] = s*s;
+        params[n + i] = (1 - s)*(1 - s)*(1 - s);
+    }
+    return params;
+}
+
+void testPiecewiseLinear()
+{
+    auto model = [](const auto& krValues) {
+        typedef typename std::decay<decltype(krValues[0])>::type Scalar;
+        typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+        typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+        auto params = makePiecewiseLinearParams(krValues);
+
+        Scalar result = 0.0;
+        for (unsigned k = 0; k < 20; ++k) {
+            Scalar Sw = 0.005 + 0.0499*k;
+            result += MaterialLaw::twoPhaseSatKrw(*params, Sw)
+                + 2.0*MaterialLaw::twoPhaseSatKrn(*params, Sw);
+        }
+        return result;
+    };
+    checkGradient(model, krParams(11), "PiecewiseLinearTwoPhaseMaterial");
+}
+
+void testEclEpsTwoPhaseLaw()
+{
+    const unsigned numKr = 11;
+
+    // the first three parameters are the scaled saturation end points of the wetting
+    // phase, the remaining ones are the relperm tables
+    std::vector<double> params = { 0.15, 0.25, 0.95 };
+    for (double kr : krParams(numKr))
+        params.push_back(kr);
+
+    auto model = [numKr](const auto& x) {
+        typedef typename std::decay<decltype(x[0])>::type Scalar;
+        typedef Opm::TwoPhaseMaterialTraits<Scalar, 0, 1> Traits;
+        typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> EffLaw;
+        typedef Opm::EclEpsTwoPhaseLaw<EffLaw> MaterialLaw;
+        typedef typename MaterialLaw::Params Params;
+        typedef Opm::EclEpsScalingPoints<Scalar> ScalingPoints;
+
+        std::vector<Scalar> krValues(x.begin() + 3, x.begin() + 3 + 2*numKr);
+
+        auto config = std::make_shared<Opm::EclEpsConfig>();
+        config->setEnableSatScaling(true);
+        config->setEnableThreePointKrSatScaling(false);
+
+        auto unscaledPoints = std::make_shared<ScalingPoints>();
+        auto scaledPoints = std::make_shared<ScalingPoints>();
+        for (unsigned pointIdx = 0; pointIdx < 3; ++pointIdx) {
+            Scalar unscaled = 0.1 + 0.4*pointIdx;
+            unscaledPoints->setSaturationKrwPoint(pointIdx, unscaled);
+            unscaledPoints->setSaturationKrnPoint(pointIdx, unscaled);
+            unscaledPoints->setSaturationPcPoint(pointIdx, unscaled);
+            scaledPoints->setSaturationKrwPoint(pointIdx, x[pointIdx]);
+            scaledPoints->setSaturationKrnPoint(pointIdx, unscaled);
+            scaledPoints->setSaturationPcPoint(pointIdx, unscaled);
+        }
+
+        Params params;
+        params.setConfig(config);
+        params.setUnscaledPoints(unscaledPoints);
+        params.setScaledPoints(scaledPoints);
+        params.setEffectiveLawParams(makePiecewiseLinearParams(krValues));
+        params.finalize();
+
+        Scalar result = 0.0;
+        for (unsigned k = 0; k < 20; ++k) {
+            Scalar Sw = 0.005 + 0.0499*k;
+            result += MaterialLaw::twoPhaseSatKrw(params, Sw);
+        }
+        return result;
+    };
+    checkGradient(model, params, "EclEpsTwoPhaseLaw");
+}
+
+int main()
+{
+    testElementary();
+    testTabulated1D();
+    testUniformXTabulated2D();
+    testPiecewiseLinear();
+    testEclEpsTwoPhaseLaw();
+
+    return 0;
+}
@@ -0,0 +1,441 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is a program to test tables which are shared between the processes of a
+ *        node via POSIX shared memory.
+ *
+ * Several local processes are forked which initialize the same tabulated component or
+ * black-oil fluid system concurrently. Exactly one of them must compute the tables, all
+ * of them must see the same values.
+ */
+#include "config.h"
+
+#include <opm/material/common/SharedMemoryRegion.hpp>
+#include <opm/material/common/SharedTables.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/components/H2O.hpp>
+#include <opm/material/components/TabulatedComponent.hpp>
+#include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
+#include <opm/material/fluidmatrixinteractions/PiecewiseLinearTwoPhaseMaterial.hpp>
+#include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void testRegion()
+{
+    const std::string name = "/opm-material-test-region-" + std::to_string(getpid());
+    Opm::SharedMemoryRegion::unlink(name);
+
+    Opm::SharedMemoryRegion owner(name, 10*sizeof(double));
+    if (!owner.isOwner())
+        throw std::logic_error("The first region object must own the segment");
+
+    double* values = static_cast<double*>(owner.data());
+    for (unsigned i = 0; i < 10; ++i)
+        values[i] = i*i;
+    owner.markReady();
+
+    Opm::SharedMemoryRegion attached(name, 10*sizeof(double));
+    if (attached.isOwner())
+        throw std::logic_error("The second region object must not own the segment");
+
+    const double* attachedValues = static_cast<const double*>(attached.data());
+    for (unsigned i = 0; i < 10; ++i)
+        if (attachedValues[i] != i*i)
+            throw std::logic_error("The attached segment does not contain the values of the owner");
+
+    bool caught = false;
+    try {
+        Opm::SharedMemoryRegion wrongSize(name, 11*sizeof(double), /*layoutKey=*/0, /*timeout=*/1.0);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught)
+        throw std::logic_error("Attaching to a segment of a different size must fail");
+
+    caught = false;
+    try {
+        Opm::SharedMemoryRegion wrongKey(name, 10*sizeof(double), /*layoutKey=*/1, /*timeout=*/1.0);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught)
+        throw std::logic_error("Attaching to a segment with a different layout key must fail");
+}
+
+// a process which dies while it fills the segment must not block the others
+void testDeadOwner()
+{
+    const std::string name = "/opm-material-test-dead-owner-" + std::to_string(getpid());
+    Opm::SharedMemoryRegion::unlink(name);
+
+    pid_t pid = fork();
+    if (pid < 0)
+        throw std::runtime_error("Could not fork");
+    if (pid == 0) {
+        Opm::SharedMemoryRegion owner(name, 10*sizeof(double), /*layoutKey=*/42);
+        // leave without marking the segment as ready or removing its name
+        _exit(owner.isOwner() ? 0 : 1);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw std::logic_error("The child process did not create the segment");
+
+    Opm::SharedMemoryRegion region(name, 10*sizeof(double), /*layoutKey=*/42, /*timeout=*/5.0);
+    if (!region.isOwner())
+        throw std::logic_error("The segment of a dead owner must be taken over");
+    region.markReady();
+}
+
+// returns 0 if the tables are wrong, 1 if they were attached to and 2 if they were
+// computed by the calling process
+template <class Scalar>
+int initAndCheckTables(const std::string& segmentName)
+{
+    typedef Opm::H2O<Scalar> IapwsH2O;
+    typedef Opm::TabulatedComponent<Scalar, IapwsH2O> TabulatedH2O;
+
+    Scalar tempMin = 280.0;
+    Scalar tempMax = 400.0;
+    unsigned nTemp = 60;
+    Scalar pMin = 1e4;
+    Scalar pMax = 1e7;
+    unsigned nPress = 40;
+
+    bool isOwner = TabulatedH2O::initShared(segmentName,
+                                            tempMin, tempMax, nTemp,
+                                            pMin, pMax, nPress);
+
+    // the tables in the segment are only valid for the ranges used to compute them.
+    // attaching with other ranges must fail and keep the current tables intact.
+    bool caught = false;
+    try {
+        TabulatedH2O::initShared(segmentName,
+                                 tempMin, tempMax, nTemp,
+                                 pMin, 2*pMax, nPress);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "error: tables computed for different ranges were attached to\n";
+        return 0;
+    }
+
+    for (unsigned i = 0; i < 20; ++i) {
+        Scalar T = tempMin + (tempMax - tempMin)*(i + 0.5)/20;
+        Scalar p = 2.0*IapwsH2O::vaporPressure(T);
+        Scalar rhoRef = IapwsH2O::liquidDensity(T, p);
+        Scalar rho = TabulatedH2O::liquidDensity(T, p);
+        if (std::abs((rho - rhoRef)/rhoRef) > 1e-3) {
+            std::cout << "error: tabulated liquid density " << rho << " differs from " << rhoRef << "\n";
+            return 0;
+        }
+    }
+
+    return isOwner ? 2 : 1;
+}
+
+template <class Scalar>
+void testSharedTables()
+{
+    const unsigned numProcesses = 4;
+    const std::string segmentName =
+        "/opm-material-test-tables-" + std::to_string(getpid()) + "-" + std::to_string(sizeof(Scalar));
+    Opm::SharedMemoryRegion::unlink(segmentName);
+
+    std::vector<pid_t> children;
+    for (unsigned i = 0; i < numProcesses; ++i) {
+        pid_t pid = fork();
+        if (pid < 0)
+            throw std::runtime_error("Could not fork");
+        if (pid == 0) {
+            int result = 0;
+            try {
+                result = initAndCheckTables<Scalar>(segmentName);
+            }
+            catch (const std::exception& e) {
+                std::cout << "error: " << e.what() << "\n";
+            }
+
+            std::cout.flush();
+            _exit(result);
+        }
+        children.push_back(pid);
+    }
+
+    unsigned numOwners = 0;
+    for (pid_t pid : children) {
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) == 0)
+            throw std::logic_error("A process did not see the correct tables");
+        if (WEXITSTATUS(status) == 2)
+            ++numOwners;
+    }
+
+    // the children leave via _exit(), i.e., the owner did not remove the segment
+    Opm::SharedMemoryRegion::unlink(segmentName);
+
+    if (numOwners != 1)
+        throw std::logic_error("Exactly one process must compute the tables, got "+std::to_string(numOwners));
+}
+
+// the saturation functions are shared in place: the parameter objects of the process
+// which does not own the segment must refer to the tables of the owner afterwards
+template <class Scalar>
+void testSharedSaturationFunctions()
+{
+    typedef Opm::TwoPhaseMaterialTraits<Scalar, /*wettingPhaseIdx=*/0, /*nonWettingPhaseIdx=*/1> Traits;
+    typedef Opm::PiecewiseLinearTwoPhaseMaterial<Traits> MaterialLaw;
+    typedef typename MaterialLaw::Params Params;
+
+    const std::string name =
+        "/opm-material-test-satfuncs-" + std::to_string(getpid()) + "-" + std::to_string(sizeof(Scalar));
+    Opm::SharedMemoryRegion::unlink(name);
+    Opm::SharedMemoryRegion::unlink(name + "-data");
+
+    const std::vector<Scalar> Sw = {0.2, 0.5, 0.8, 1.0};
+    auto makeParams = [&Sw](Scalar krwMax) {
+        auto params = std::make_shared<Params>();
+        params->setPcnwSamples(Sw, std::vector<Scalar>{3e5, 1e5, 1e4, 0.0});
+        params->setKrwSamples(Sw, std::vector<Scalar>{0.0, Scalar(0.1)*krwMax, Scalar(0.5)*krwMax, krwMax});
+        params->setKrnSamples(Sw, std::vector<Scalar>{1.0, 0.4, 0.05, 0.0});
+        params->finalize();
+        return params;
+    };
+
+    auto ownerParams = makeParams(1.0);
+    auto serializeOwner = [&ownerParams](Opm::BinarySerializer& serializer) { serializer(*ownerParams); };
+    Opm::SharedTables owner(name, /*layoutKey=*/0, []() {}, serializeOwner);
+    if (!owner.isOwner())
+        throw std::logic_error("The first shared tables object must own the segment");
+
+    // the tables of the attached process differ, but they get replaced
+    auto params = makeParams(0.5);
+    auto serializeAttached = [&params](Opm::BinarySerializer& serializer) { serializer(*params); };
+    Opm::SharedTables attached(name, /*layoutKey=*/0, []() {}, serializeAttached);
+    if (attached.isOwner())
+        throw std::logic_error("The second shared tables object must not own the segment");
+
+    if (!params->krwSamples().isShared() || !ownerParams->krwSamples().isShared()
+        || params->krwSamples().data() == ownerParams->krwSamples().data())
+        throw std::logic_error("The saturation functions must refer to the shared segment");
+
+    for (unsigned i = 0; i <= 10; ++i) {
+        Scalar S = 0.2 + 0.08*i;
+        if (MaterialLaw::twoPhaseSatKrw(*params, S) != MaterialLaw::twoPhaseSatKrw(*ownerParams, S)
+            || MaterialLaw::twoPhaseSatKrn(*params, S) != MaterialLaw::twoPhaseSatKrn(*ownerParams, S)
+            || MaterialLaw::twoPhaseSatPcnw(*params, S) != MaterialLaw::twoPhaseSatPcnw(*ownerParams, S))
+            throw std::logic_error("The shared saturation functions differ from the ones of the owner");
+    }
+    if (MaterialLaw::twoPhaseSatKrw(*params, Scalar(1.0)) != 1.0)
+        throw std::logic_error("The attached process must use the tables of the owner");
+}
+
+template <class FluidSystem>
+void initFluidSystem(unsigned numRegions)
+{
+    typedef typename FluidSystem::Scalar Scalar;
+    typedef typename FluidSystem::OilPvt OilPvt;
+    typedef typename FluidSystem::GasPvt GasPvt;
+    typedef typename FluidSystem::WaterPvt WaterPvt;
+    typedef Opm::Tabulated1DFunction<Scalar> TabulatedFunction;
+
+    FluidSystem::initBegin(numRegions);
+    FluidSystem::setEnableDissolvedGas(false);
+    FluidSystem::setEnableVaporizedOil(false);
+
+    auto oilPvt = std::make_shared<OilPvt>();
+    oilPvt->setApproach(Opm::OilPvtApproach::DeadOilPvt);
+    auto& deadOil = oilPvt->template getRealPvt<Opm::OilPvtApproach::DeadOilPvt>();
+    deadOil.setNumRegions(numRegions);
+
+    auto gasPvt = std::make_shared<GasPvt>();
+    gasPvt->setApproach(Opm::GasPvtApproach::DryGasPvt);
+    auto& dryGas = gasPvt->template getRealPvt<Opm::GasPvtApproach::DryGasPvt>();
+    dryGas.setNumRegions(numRegions);
+
+    auto waterPvt = std::make_shared<WaterPvt>();
+    waterPvt->setApproach(Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt);
+    auto& water = waterPvt->template getRealPvt<Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt>();
+    water.setNumRegions(numRegions);
+
+    std::vector<Scalar> p = {1e5, 1e6, 1e7, 1e8};
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        Scalar rhoOil = 850.0 + 10*regionIdx;
+        deadOil.setReferenceDensities(regionIdx, rhoOil, 1.0, 1000.0);
+        deadOil.setInverseOilFormationVolumeFactor(regionIdx,
+                                                   TabulatedFunction(p, std::vector<Scalar>{0.90, 0.91, 0.92, 0.95}));
+        deadOil.setOilViscosity(regionIdx,
+                                TabulatedFunction(p, std::vector<Scalar>{1e-3, 1.1e-3, 1.2e-3, 1.5e-3}));
+
+        dryGas.setReferenceDensities(regionIdx, rhoOil, 1.0 + 0.1*regionIdx, 1000.0);
+        dryGas.setGasFormationVolumeFactor(regionIdx, {{1e5, 1.0}, {1e6, 0.1}, {1e7, 0.01}, {1e8, 0.005}});
+        dryGas.setGasViscosity(regionIdx,
+                               TabulatedFunction(p, std::vector<Scalar>{1e-5, 1.1e-5, 1.5e-5, 2e-5}));
+
+        water.setReferenceDensities(regionIdx, rhoOil, 1.0, 1000.0 + regionIdx);
+        water.setReferencePressure(regionIdx, 1e5);
+        water.setReferenceFormationVolumeFactor(regionIdx, 1.01);
+        water.setCompressibility(regionIdx, 4e-10);
+        water.setViscosity(regionIdx, 0.5e-3);
+
+        FluidSystem::setReferenceDensities(rhoOil,
+                                           1000.0 + regionIdx,
+                                           1.0 + 0.1*regionIdx,
+                                           regionIdx);
+    }
+
+    oilPvt->initEnd();
+    gasPvt->initEnd();
+    waterPvt->initEnd();
+
+    FluidSystem::setOilPvt(oilPvt);
+    FluidSystem::setGasPvt(gasPvt);
+    FluidSystem::setWaterPvt(waterPvt);
+    FluidSystem::initEnd();
+}
+
+// returns 0 if the fluid system is wrong, 1 if its tables were attached to and 2 if
+// they were computed by the calling process
+template <class Scalar>
+int initAndCheckFluidSystem(const std::string& segmentName)
+{
+    typedef Opm::BlackOilFluidSystem<Scalar> FluidSystem;
+    typedef Opm::Tabulated1DFunction<Scalar> TabulatedFunction;
+
+    const unsigned numRegions = 3;
+    bool isOwner = FluidSystem::initShared(segmentName,
+                                           [numRegions]() { initFluidSystem<FluidSystem>(numRegions); });
+
+    if (!FluidSystem::isInitialized() || FluidSystem::numRegions() != numRegions) {
+        std::cout << "error: the fluid system was not initialized from the shared tables\n";
+        return 0;
+    }
+
+    const auto& deadOil = FluidSystem::oilPvt().template getRealPvt<Opm::OilPvtApproach::DeadOilPvt>();
+    const auto& dryGas = FluidSystem::gasPvt().template getRealPvt<Opm::GasPvtApproach::DryGasPvt>();
+    const std::vector<Scalar> p = {1e5, 1e6, 1e7, 1e8};
+    TabulatedFunction invBoRef(p, std::vector<Scalar>{0.90, 0.91, 0.92, 0.95});
+    for (unsigned regionIdx = 0; regionIdx < numRegions; ++regionIdx) {
+        const auto& invBo = deadOil.inverseOilB()[regionIdx];
+        if (!invBo.xValues().isShared() || !invBo.yValues().isShared()
+            || !dryGas.gasMu()[regionIdx].yValues().isShared()) {
+            std::cout << "error: the PVT tables of region " << regionIdx << " are not shared\n";
+            return 0;
+        }
+
+        for (unsigned i = 0; i < 10; ++i) {
+            Scalar pressure = 2e5*std::pow(Scalar(10.0), Scalar(0.2)*i);
+            if (invBo.eval(pressure) != invBoRef.eval(pressure)) {
+                std::cout << "error: the shared oil formation volume factor is wrong\n";
+                return 0;
+            }
+        }
+
+        if (FluidSystem::referenceDensity(FluidSystem::oilPhaseIdx, regionIdx) != Scalar(850.0 + 10*regionIdx)
+            || FluidSystem::referenceDensity(FluidSystem::waterPhaseIdx, regionIdx) != Scalar(1000.0 + regionIdx)) {
+            std::cout << "error: the reference densities are wrong\n";
+            return 0;
+        }
+    }
+
+    return isOwner ? 2 : 1;
+}
+
+template <class Scalar>
+void testSharedFluidSystem()
+{
+    const unsigned numProcesses = 4;
+    const std::string segmentName =
+        "/opm-material-test-fluidsystem-" + std::to_string(getpid()) + "-" + std::to_string(sizeof(Scalar));
+    Opm::SharedMemoryRegion::unlink(segmentName);
+    Opm::SharedMemoryRegion::unlink(segmentName + "-data");
+
+    std::vector<pid_t> children;
+    for (unsigned i = 0; i < numProcesses; ++i) {
+        pid_t pid = fork();
+        if (pid < 0)
+            throw std::runtime_error("Could not fork");
+        if (pid == 0) {
+            int result = 0;
+            try {
+                result = initAndCheckFluidSystem<Scalar>(segmentName);
+            }
+            catch (const std::exception& e) {
+                std::cout << "error: " << e.what() << "\n";
+            }
+
+            std::cout.flush();
+            _exit(result);
+        }
+        children.push_back(pid);
+    }
+
+    unsigned numOwners = 0;
+    for (pid_t pid : children) {
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) == 0)
+            throw std::logic_error("A process did not see the correct fluid system");
+        if (WEXITSTATUS(status) == 2)
+            ++numOwners;
+    }
+
+    // the children leave via _exit(), i.e., the owner did not remove the segments
+    Opm::SharedMemoryRegion::unlink(segmentName);
+    Opm::SharedMemoryRegion::unlink(segmentName + "-data");
+
+    if (numOwners != 1)
+        throw std::logic_error("Exactly one process must initialize the fluid system, got "+std::to_string(numOwners));
+}
+
+int main()
+{
+    testRegion();
+    testDeadOwner();
+    testSharedTables<double>();
+    testSharedTables<float>();
+    testSharedSaturationFunctions<double>();
+    testSharedSaturationFunctions<float>();
+    testSharedFluidSystem<double>();
+    testSharedFluidSystem<float>();
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the SIMD pack value type.
+ *
+ * Every operation on packs or on evaluations of packs must yield the same result as
+ * doing the same operation lane by lane using plain scalars.
+ */
+#include "config.h"
+
+#include <opm/material/common/SimdPack.hpp>
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DeadOilPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DryGasPvt.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/WaterPvtMultiplexer.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+static const unsigned width = 4;
+typedef Opm::SimdPack<double, width> Pack;
+typedef Opm::DenseAd::Evaluation<Pack, 2> PackEval;
+typedef Opm::DenseAd::Evaluation<double, 2> ScalarEval;
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+void checkClose(double a, double b, const std::string& msg)
+{
+    if (std::abs(a - b) > 1e-12*std::max(1.0, std::abs(a) + std::abs(b)))
+        throw std::logic_error(msg+": "+std::to_string(a)+" != "+std::to_string(b));
+}
+
+// construct an evaluation of packs whose lanes correspond to the given scalar evaluations
+PackEval packEvals(const std::vector<ScalarEval>& evals)
+{
+    PackEval result = PackEval::createVariable(Pack(0.0), 0);
+    Pack value;
+    Pack deriv0;
+    Pack deriv1;
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        value[laneIdx] = evals[laneIdx].value();
+        deriv0[laneIdx] = evals[laneIdx].derivative(0);
+        deriv1[laneIdx] = evals[laneIdx].derivative(1);
+    }
+    result.setValue(value);
+    result.setDerivative(0, deriv0);
+    result.setDerivative(1, deriv1);
+    return result;
+}
+
+void checkLanes(const PackEval& packed, const std::vector<ScalarEval>& reference, const std::string& msg)
+{
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        checkClose(packed.value()[laneIdx], reference[laneIdx].value(), msg+" (value)");
+        for (int varIdx = 0; varIdx < 2; ++varIdx)
+            checkClose(packed.derivative(varIdx)[laneIdx],
+                       reference[laneIdx].derivative(varIdx),
+                       msg+" (derivative)");
+    }
+}
+
+void testPack()
+{
+    const double values[width] = { -2.0, 0.5, 1.0, 3.0 };
+    Pack a = Pack::load(values);
+    Pack b(1.0);
+
+    Pack c = 2.0*a + b/4.0 - 1.0;
+    double stored[width];
+    c.store(stored);
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        checkClose(stored[laneIdx], 2.0*values[laneIdx] + 0.25 - 1.0, "arithmetic");
+
+    Pack::Mask mask = a < b;
+    check(mask[0] && mask[1] && !mask[2] && !mask[3], "comparison");
+    check(mask.any() && !mask.all() && !mask.none(), "mask reduction");
+    check((a <= b).any() && (a == 1.0)[2] && !(a != 1.0)[2], "comparison");
+    check((!mask && a > 0.0)[3] && !(!mask && a > 0.0)[0], "mask logic");
+
+    Pack blended = Opm::select(mask, a, b);
+    checkClose(blended[0], -2.0, "select");
+    checkClose(blended[3], 1.0, "select");
+
+    const unsigned indices[width] = { 3, 2, 1, 0 };
+    Pack gathered = Pack::gather(values, indices);
+    checkClose(gathered[0], 3.0, "gather");
+    checkClose(gathered[3], -2.0, "gather");
+
+    typedef Opm::MathToolbox<Pack> Toolbox;
+    Pack absA = Opm::abs(a);
+    Pack maxAB = Opm::max(a, 0.75);
+    Pack expA = Toolbox::exp(a);
+    Pack powA = Opm::pow(Opm::abs(a), 1.5);
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        checkClose(absA[laneIdx], std::abs(values[laneIdx]), "abs");
+        checkClose(maxAB[laneIdx], std::max(values[laneIdx], 0.75), "max");
+        checkClose(expA[laneIdx], std::exp(values[laneIdx]), "exp");
+        checkClose(powA[laneIdx], std::pow(std::abs(values[laneIdx]), 1.5), "pow");
+    }
+
+    check(Toolbox::isSame(a, Pack::load(values), 1e-15), "isSame");
+    check(Toolbox::isfinite(a) && !Toolbox::isnan(a), "isfinite");
+    check(!Toolbox::isfinite(Toolbox::log(a)), "isfinite");
+}
+
+void testEvaluation()
+{
+    std::vector<ScalarEval> x(width);
+    std::vector<ScalarEval> y(width);
+    const double xValues[width] = { 0.0, 0.5, 1.5, 4.0 };
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        x[laneIdx] = ScalarEval::createVariable(xValues[laneIdx], 0);
+        y[laneIdx] = ScalarEval::createVariable(2.0 - xValues[laneIdx], 1);
+        y[laneIdx] *= x[laneIdx];
+    }
+    const PackEval px = packEvals(x);
+    const PackEval py = packEvals(y);
+
+    std::vector<ScalarEval> ref(width);
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = (x[laneIdx]*y[laneIdx] + 3.0)/(y[laneIdx] - 2.5);
+    checkLanes((px*py + 3.0)/(py - 2.5), ref, "arithmetic");
+
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = Opm::exp(x[laneIdx])*Opm::sqrt(x[laneIdx] + 1.0) - Opm::log(x[laneIdx] + 0.5);
+    checkLanes(Opm::exp(px)*Opm::sqrt(px + 1.0) - Opm::log(px + 0.5), ref, "exp, sqrt and log");
+
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = Opm::abs(y[laneIdx] - 0.5);
+    checkLanes(Opm::abs(py - 0.5), ref, "abs");
+
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = Opm::max(x[laneIdx], y[laneIdx]) + Opm::min(x[laneIdx], 1.0);
+    checkLanes(Opm::max(px, py) + Opm::min(px, 1.0), ref, "min and max");
+
+    // the base is zero for the first lane which needs to be special cased
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = Opm::pow(x[laneIdx], 2.5) + Opm::pow(2.0, x[laneIdx]);
+    checkLanes(Opm::pow(px, 2.5) + Opm::pow(2.0, px), ref, "pow");
+
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = Opm::pow(x[laneIdx], y[laneIdx] + 1.0);
+    checkLanes(Opm::pow(px, py + 1.0), ref, "pow");
+
+    // lane-wise branches
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        ref[laneIdx] = (x[laneIdx] < 1.0) ? x[laneIdx]*x[laneIdx] : 2.0*y[laneIdx];
+    checkLanes(Opm::DenseAd::select(px.value() < 1.0, px*px, 2.0*py), ref, "select");
+}
+
+void testTabulated()
+{
+    std::vector<double> xs = { 0.0, 1.0, 2.5, 3.0, 5.0 };
+    std::vector<double> ys = { 1.0, 3.0, 2.0, 2.5, -1.0 };
+    Opm::Tabulated1DFunction<double> table(xs, ys);
+
+    std::vector<ScalarEval> x(width);
+    std::vector<ScalarEval> ref(width);
+    std::vector<ScalarEval> refDeriv(width);
+    const double xValues[width] = { 0.2, 2.7, -1.0, 4.9 };
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        x[laneIdx] = ScalarEval::createVariable(xValues[laneIdx], 0);
+        ref[laneIdx] = table.eval(x[laneIdx], /*extrapolate=*/true);
+        refDeriv[laneIdx] = table.evalDerivative(x[laneIdx], /*extrapolate=*/true);
+    }
+    const PackEval px = packEvals(x);
+    checkLanes(table.eval(px, /*extrapolate=*/true), ref, "tabulated function");
+    checkLanes(table.evalDerivative(px, /*extrapolate=*/true), refDeriv, "tabulated derivative");
+
+    Pack value = table.eval(px.value(), /*extrapolate=*/true);
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        checkClose(value[laneIdx], ref[laneIdx].value(), "tabulated function");
+
+    bool caught = false;
+    try {
+        table.eval(px.value());
+    }
+    catch (const Opm::NumericalIssue&) {
+        caught = true;
+    }
+    check(caught, "Lanes outside of the table's range must be detected");
+}
+
+// evaluate the inverse formation volume factor and the viscosity of a PVT object for
+// packed and for scalar arguments and make sure that all lanes agree
+template <class Pvt>
+void checkPvt(const Pvt& pvt, const std::string& msg)
+{
+    std::vector<ScalarEval> T(width);
+    std::vector<ScalarEval> p(width);
+    std::vector<ScalarEval> Rs(width);
+    std::vector<ScalarEval> refB(width);
+    std::vector<ScalarEval> refMu(width);
+    // the last lane is outside of the tables' range to test the extrapolation
+    const double pValues[width] = { 30e5, 95e5, 212e5, 450e5 };
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx) {
+        T[laneIdx] = 300.0 + 10.0*laneIdx;
+        p[laneIdx] = ScalarEval::createVariable(pValues[laneIdx], 0);
+        Rs[laneIdx] = ScalarEval::createVariable(0.0, 1);
+        refB[laneIdx] = pvt.inverseFormationVolumeFactor(/*regionIdx=*/0, T[laneIdx], p[laneIdx], Rs[laneIdx]);
+        refMu[laneIdx] = pvt.viscosity(/*regionIdx=*/0, T[laneIdx], p[laneIdx], Rs[laneIdx]);
+    }
+
+    const PackEval pT = packEvals(T);
+    const PackEval pp = packEvals(p);
+    const PackEval pRs = packEvals(Rs);
+    checkLanes(pvt.inverseFormationVolumeFactor(/*regionIdx=*/0, pT, pp, pRs), refB,
+               msg+": inverse formation volume factor");
+    checkLanes(pvt.viscosity(/*regionIdx=*/0, pT, pp, pRs), refMu, msg+": viscosity");
+
+    const Pack b = pvt.inverseFormationVolumeFactor(/*regionIdx=*/0, pT.value(), pp.value(), pRs.value());
+    for (unsigned laneIdx = 0; laneIdx < width; ++laneIdx)
+        checkClose(b[laneIdx], refB[laneIdx].value(), msg+": inverse formation volume factor");
+}
+
+void testPvt()
+{
+    std::vector<double> pressures;
+    std::vector<double> invBo;
+    std::vector<double> muo;
+    std::vector<std::pair<double, double> > Bg;
+    std::vector<double> mug;
+    for (unsigned sampleIdx = 0; sampleIdx < 20; ++sampleIdx) {
+        double p = 1e5 + sampleIdx*20e5;
+        pressures.push_back(p);
+        invBo.push_back(1.0 + 1e-9*(p - 1e5));
+        muo.push_back(1e-3*(1.0 + 5e-9*(p - 1e5)));
+        Bg.push_back(std::make_pair(p, 1e5/p));
+        mug.push_back(1e-5*(1.0 + 1e-8*(p - 1e5)));
+    }
+
+    for (int compressed = 0; compressed < 2; ++compressed) {
+        Opm::DeadOilPvt<double> oilPvt;
+        oilPvt.setNumRegions(1);
+        oilPvt.setReferenceDensities(/*regionIdx=*/0, 850.0, 1.0, 1000.0);
+        oilPvt.setInverseOilFormationVolumeFactor(/*regionIdx=*/0, Opm::Tabulated1DFunction<double>(pressures, invBo));
+        oilPvt.setOilViscosity(/*regionIdx=*/0, Opm::Tabulated1DFunction<double>(pressures, muo));
+        oilPvt.initEnd();
+
+        Opm::DryGasPvt<double> gasPvt;
+        gasPvt.setNumRegions(1);
+        gasPvt.setReferenceDensities(/*regionIdx=*/0, 850.0, 1.0, 1000.0);
+        gasPvt.setGasFormationVolumeFactor(/*regionIdx=*/0, Bg);
+        gasPvt.setGasViscosity(/*regionIdx=*/0, Opm::Tabulated1DFunction<double>(pressures, mug));
+        gasPvt.initEnd();
+
+        std::string suffix;
+        if (compressed) {
+            oilPvt.compressTables(1e-4);
+            gasPvt.compressTables(1e-4);
+            suffix = " (compressed tables)";
+        }
+        checkPvt(oilPvt, "dead oil"+suffix);
+        checkPvt(gasPvt, "dry gas"+suffix);
+    }
+
+    // go through the multiplexer which is used by the black-oil fluid system
+    typedef Opm::WaterPvtMultiplexer<double> WaterPvt;
+    WaterPvt waterPvt;
+    waterPvt.setApproach(Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt);
+    auto& ccWaterPvt = waterPvt.getRealPvt<Opm::WaterPvtApproach::ConstantCompressibilityWaterPvt>();
+    ccWaterPvt.setNumRegions(1);
+    ccWaterPvt.setReferencePressure(/*regionIdx=*/0, 100e5);
+    ccWaterPvt.setReferenceFormationVolumeFactor(/*regionIdx=*/0, 1.02);
+    ccWaterPvt.setCompressibility(/*regionIdx=*/0, 4.5e-10);
+    ccWaterPvt.setViscosity(/*regionIdx=*/0, 0.5e-3, 2e-10);
+    waterPvt.initEnd();
+    checkPvt(waterPvt, "water");
+}
+
+int main()
+{
+    testPack();
+    testEvaluation();
+    testTabulated();
+    testPvt();
+
+    return 0;
+}
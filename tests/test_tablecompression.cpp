@@ -0,0 +1,237 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief This is the unit test for the compression of tabulated functions by
+ *        monotonic splines.
+ */
+#include "config.h"
+
+#include <opm/material/common/Tabulated1DFunction.hpp>
+#include <opm/material/common/UniformXTabulated2DFunction.hpp>
+#include <opm/material/common/SimdPack.hpp>
+#include <opm/material/common/BinarySerializer.hpp>
+#include <opm/material/fluidsystems/blackoilpvt/DeadOilPvt.hpp>
+#include <opm/material/densead/Evaluation.hpp>
+#include <opm/material/densead/Math.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void check(bool cond, const std::string& msg)
+{
+    if (!cond)
+        throw std::logic_error(msg);
+}
+
+// the inverse formation volume factor of a slightly compressible fluid
+template <class Scalar>
+Scalar invB(Scalar p)
+{ return 1.0 + 0.1*std::log(1.0 + p/1e7); }
+
+template <class Scalar>
+Scalar maxAbs(const std::vector<Scalar>& v)
+{
+    Scalar result = 0.0;
+    for (const auto& x : v)
+        result = std::max(result, std::abs(x));
+    return result;
+}
+
+template <class Scalar>
+void test1D(Scalar tolerance)
+{
+    typedef Opm::DenseAd::Evaluation<Scalar, 1> Evaluation;
+
+    const unsigned n = 500;
+    std::vector<Scalar> p(n), b(n);
+    for (unsigned i = 0; i < n; ++i) {
+        p[i] = 1e5 + i*(5e7 - 1e5)/(n - 1);
+        b[i] = invB(p[i]);
+    }
+
+    Opm::Tabulated1DFunction<Scalar> table(p, b);
+    Opm::Tabulated1DFunction<Scalar> linear(table);
+    check(!table.isCompressed(), "Tables must not be compressed initially");
+
+    size_t numSamples = table.compress(tolerance);
+    std::cout << "compressed 1D table from " << n << " to " << numSamples << " sampling points\n";
+    check(table.isCompressed(), "The table must be compressed");
+    check(numSamples == table.numSamples() && numSamples < n/10, "The compression must remove most sampling points");
+    check(table.xMin() == p.front() && table.xMax() == p.back(), "The range must not change");
+    check(table.monotonic() == 1, "The compressed function must stay monotonic");
+
+    // all original sampling points must be met within the tolerance
+    const Scalar absTolerance = tolerance*maxAbs(b);
+    for (unsigned i = 0; i < n; ++i)
+        check(std::abs(table.eval(p[i]) - b[i]) <= absTolerance*(1 + 1e-3), "The tolerance must be met");
+
+    // the derivatives must be continuous at the sampling points and consistent with
+    // the automatic differentiation
+    for (unsigned k = 1; k + 1 < table.numSamples(); ++k) {
+        Scalar x = table.xAt(k);
+        Scalar h = 1e-6*(table.xAt(k + 1) - table.xAt(k - 1));
+        Scalar left = table.evalDerivative(x - h);
+        Scalar right = table.evalDerivative(x + h);
+        check(std::abs(left - right) <= 1e-3*std::abs(left), "The derivative must be continuous");
+    }
+    for (unsigned i = 0; i < 50; ++i) {
+        Scalar x = 2e5 + i*4.9e7/50;
+        const Evaluation& y = table.eval(Evaluation::createVariable(x, 0));
+        Scalar dydx = table.evalDerivative(x);
+        check(std::abs(y.derivative(0) - dydx) <= 1e-5*std::abs(dydx), "The derivatives must be consistent");
+        check(std::abs(y.value() - linear.eval(x)) <= 2*absTolerance, "The spline must be close to the linear function");
+    }
+
+    // extrapolation continues the slopes at the end points
+    Scalar mRight = table.evalDerivative(p.back());
+    Scalar yRight = table.eval(p.back() + 1e6, /*extrapolate=*/true);
+    check(std::abs(yRight - (b.back() + mRight*1e6)) <= 1e-5*std::abs(yRight), "Linear extrapolation");
+
+    // SIMD packs must give the same results as scalars
+    typedef Opm::SimdPack<Scalar, 4> Pack;
+    Pack px;
+    const Scalar xs[4] = { 1e5, 3.3e6, 4.99e7, 6e7 };
+    for (unsigned laneIdx = 0; laneIdx < 4; ++laneIdx)
+        px[laneIdx] = xs[laneIdx];
+    const Pack& py = table.eval(px, /*extrapolate=*/true);
+    const Pack& pdy = table.evalDerivative(px, /*extrapolate=*/true);
+    for (unsigned laneIdx = 0; laneIdx < 4; ++laneIdx) {
+        check(py[laneIdx] == table.eval(xs[laneIdx], /*extrapolate=*/true), "Lanewise evaluation");
+        check(pdy[laneIdx] == table.evalDerivative(xs[laneIdx], /*extrapolate=*/true), "Lanewise derivative");
+    }
+
+    // the spline must survive serialization
+    Opm::BinarySerializer out;
+    out(table);
+    Opm::Tabulated1DFunction<Scalar> restored;
+    Opm::BinarySerializer in(out.buffer());
+    in(restored);
+    check(restored == table && restored.isCompressed(), "Serialization of compressed tables");
+
+    // setting new sampling points makes the function piecewise linear again
+    table.setXYContainers(p, b);
+    check(!table.isCompressed() && table == linear, "Resetting a compressed table");
+}
+
+template <class Scalar>
+void test2D(Scalar tolerance)
+{
+    typedef Opm::UniformXTabulated2DFunction<Scalar> Table;
+
+    // an undersaturated table for each of a few values of Rs
+    const unsigned numRs = 5;
+    const unsigned numP = 300;
+    Table table;
+    std::vector<Scalar> values;
+    for (unsigned rsIdx = 0; rsIdx < numRs; ++rsIdx) {
+        Scalar Rs = 20.0*rsIdx;
+        table.appendXPos(Rs);
+        Scalar pSat = 1e6 + 1e5*Rs;
+        for (unsigned pIdx = 0; pIdx < numP; ++pIdx) {
+            Scalar p = pSat + pIdx*4e7/(numP - 1);
+            Scalar v = (1.0 + 0.002*Rs)*invB(p - pSat);
+            table.appendSamplePoint(rsIdx, p, v);
+            values.push_back(v);
+        }
+    }
+
+    Table linear(table);
+    size_t numSamples = table.compress(tolerance);
+    std::cout << "compressed 2D table from " << numRs*numP << " to " << numSamples << " sampling points\n";
+    check(table.isCompressed(), "The 2D table must be compressed");
+    check(numSamples < numRs*numP/10, "The compression of the 2D table must remove most sampling points");
+
+    const Scalar absTolerance = tolerance*maxAbs(values);
+    for (unsigned rsIdx = 0; rsIdx < numRs; ++rsIdx) {
+        check(table.yMin(rsIdx) == linear.yMin(rsIdx) && table.yMax(rsIdx) == linear.yMax(rsIdx),
+              "The range of the columns must not change");
+        for (unsigned pIdx = 0; pIdx < numP; ++pIdx) {
+            Scalar Rs = linear.xAt(rsIdx);
+            Scalar p = linear.yAt(rsIdx, pIdx);
+            Scalar v = table.eval(Rs, p, /*extrapolate=*/true);
+            check(std::abs(v - linear.valueAt(rsIdx, pIdx)) <= absTolerance*(1 + 1e-3),
+                  "The tolerance must be met by the 2D table");
+        }
+    }
+
+    // between the columns, the interpolation stays linear
+    Scalar Rs = 30.0;
+    Scalar p = 1e6 + 1e5*Rs + 1e7;
+    check(std::abs(table.eval(Rs, p, /*extrapolate=*/true) - linear.eval(Rs, p, /*extrapolate=*/true)) <= 2*absTolerance,
+          "The interpolation between the columns must be close to the linear one");
+}
+
+template <class Scalar>
+void testPvt(Scalar tolerance)
+{
+    typedef Opm::DeadOilPvt<Scalar> Pvt;
+    typedef Opm::Tabulated1DFunction<Scalar> TabulatedFunction;
+
+    const unsigned n = 200;
+    std::vector<Scalar> p(n), b(n), mu(n);
+    for (unsigned i = 0; i < n; ++i) {
+        p[i] = 1e5 + i*(5e7 - 1e5)/(n - 1);
+        b[i] = invB(p[i]);
+        mu[i] = 1e-3*(1.0 + 0.2*p[i]/5e7);
+    }
+
+    Pvt pvt;
+    pvt.setNumRegions(1);
+    pvt.setReferenceDensities(0, 850.0, 1.0, 1000.0);
+    pvt.setInverseOilFormationVolumeFactor(0, TabulatedFunction(p, b));
+    pvt.setOilViscosity(0, TabulatedFunction(p, mu));
+    pvt.initEnd();
+
+    Pvt compressed(pvt);
+    compressed.compressTables(tolerance);
+    check(compressed.inverseOilB()[0].numSamples() < n/10, "The PVT tables must be compressed");
+    check(compressed.oilMu()[0].numSamples() == 2, "Linear tables must be reduced to their end points");
+
+    for (unsigned i = 0; i < n; i += 7) {
+        Scalar T = 300.0;
+        Scalar Rs = 0.0;
+        Scalar bRef = pvt.inverseFormationVolumeFactor(0, T, p[i], Rs);
+        Scalar muRef = pvt.viscosity(0, T, p[i], Rs);
+        check(std::abs(compressed.inverseFormationVolumeFactor(0, T, p[i], Rs) - bRef) <= 2*tolerance*bRef,
+              "The compressed formation volume factor must meet the tolerance");
+        check(std::abs(compressed.viscosity(0, T, p[i], Rs) - muRef) <= 4*tolerance*muRef,
+              "The compressed viscosity must meet the tolerance");
+    }
+}
+
+int main()
+{
+    test1D<double>(1e-6);
+    test1D<float>(1e-4);
+    test2D<double>(1e-6);
+    test2D<float>(1e-4);
+    testPvt<double>(1e-6);
+    testPvt<float>(1e-4);
+
+    return 0;
+}